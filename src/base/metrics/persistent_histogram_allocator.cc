@@ -6,6 +6,7 @@
 
 #include <limits>
 #include <utility>
+#include <vector>
 
 #include "base/atomicops.h"
 #include "base/files/file_path.h"
@@ -263,12 +264,19 @@ PersistentHistogramAllocator::Iterator::Iterator(
 
 std::unique_ptr<HistogramBase>
 PersistentHistogramAllocator::Iterator::GetNextWithIgnore(Reference ignore) {
+  Reference ref = GetNextReferenceWithIgnore(ignore);
+  return ref ? allocator_->GetHistogram(ref) : nullptr;
+}
+
+PersistentHistogramAllocator::Reference
+PersistentHistogramAllocator::Iterator::GetNextReferenceWithIgnore(
+    Reference ignore) {
   PersistentMemoryAllocator::Reference ref;
   while ((ref = memory_iter_.GetNextOfType<PersistentHistogramData>()) != 0) {
     if (ref != ignore)
-      return allocator_->GetHistogram(ref);
+      return ref;
   }
-  return nullptr;
+  return 0;
 }
 
 
@@ -949,7 +957,26 @@ GlobalHistogramAllocator::GlobalHistogramAllocator(
       import_iterator_(this) {
 }
 
+void GlobalHistogramAllocator::EnableLazyImport() {
+  lazy_import_enabled_.store(true, std::memory_order_relaxed);
+}
+
 void GlobalHistogramAllocator::ImportHistogramsToStatisticsRecorder() {
+  if (lazy_import_enabled()) {
+    IndexHistogramsForLazyImport();
+    std::vector<Reference> refs;
+    {
+      AutoLock lock(lazy_import_lock_);
+      refs.reserve(lazy_import_references_.size());
+      for (const auto& entry : lazy_import_references_)
+        refs.push_back(entry.second);
+      lazy_import_references_.clear();
+    }
+    for (Reference ref : refs)
+      ImportHistogramReference(ref);
+    return;
+  }
+
   // Skip the import if it's the histogram that was last created. Should a
   // race condition cause the "last created" to be overwritten before it
   // is recognized here then the histogram will be created and be ignored
@@ -970,4 +997,58 @@ void GlobalHistogramAllocator::ImportHistogramsToStatisticsRecorder() {
   }
 }
 
+void GlobalHistogramAllocator::ImportHistogramToStatisticsRecorder(
+    StringPiece name) {
+  if (!lazy_import_enabled()) {
+    ImportHistogramsToStatisticsRecorder();
+    return;
+  }
+
+  IndexHistogramsForLazyImport();
+  std::vector<Reference> refs;
+  {
+    AutoLock lock(lazy_import_lock_);
+    // Hashing the name is only worth it if there is something to look up.
+    if (lazy_import_references_.empty())
+      return;
+    auto range = lazy_import_references_.equal_range(HashMetricName(name));
+    for (auto it = range.first; it != range.second; ++it)
+      refs.push_back(it->second);
+    lazy_import_references_.erase(range.first, range.second);
+  }
+  // The references are imported outside of the lock, as registering them
+  // takes the lock of the StatisticsRecorder. Each reference is removed from
+  // the index by only one thread, so it is imported only once.
+  for (Reference ref : refs)
+    ImportHistogramReference(ref);
+}
+
+void GlobalHistogramAllocator::IndexHistogramsForLazyImport() {
+  // See ImportHistogramsToStatisticsRecorder() for why the last created
+  // histogram is skipped.
+  Reference record_to_ignore = last_created();
+
+  // The iterator returns each reference only once, but the index is updated
+  // under the lock as other threads may be looking up or importing it.
+  while (true) {
+    Reference ref =
+        import_iterator_.GetNextReferenceWithIgnore(record_to_ignore);
+    if (!ref)
+      break;
+    const PersistentHistogramData* data =
+        memory_allocator()->GetAsObject<PersistentHistogramData>(ref);
+    // Invalid records are indexed under a null hash, to be discarded by
+    // GetHistogram() on the full import.
+    const uint64_t name_hash = data ? data->samples_metadata.id : 0;
+    AutoLock lock(lazy_import_lock_);
+    lazy_import_references_.emplace(name_hash, ref);
+  }
+}
+
+void GlobalHistogramAllocator::ImportHistogramReference(Reference ref) {
+  std::unique_ptr<HistogramBase> histogram = GetHistogram(ref);
+  if (histogram)
+    StatisticsRecorder::RegisterOrDeleteDuplicate(histogram.release());
+}
+
 }  // namespace base
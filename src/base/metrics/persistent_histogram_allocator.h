@@ -5,6 +5,7 @@
 #ifndef BASE_METRICS_PERSISTENT_HISTOGRAM_ALLOCATOR_H_
 #define BASE_METRICS_PERSISTENT_HISTOGRAM_ALLOCATOR_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -18,6 +19,7 @@
 #include "base/process/process_handle.h"
 #include "base/strings/string_piece.h"
 #include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
 
 namespace base {
 
@@ -196,6 +198,10 @@ class BASE_EXPORT PersistentHistogramAllocator {
     // reference in the process. Pass |ignore| of zero (0) to ignore nothing.
     std::unique_ptr<HistogramBase> GetNextWithIgnore(Reference ignore);
 
+    // As GetNextWithIgnore() but returns the reference of the next histogram
+    // without recreating it, or zero if there are no more histograms.
+    Reference GetNextReferenceWithIgnore(Reference ignore);
+
    private:
     // Weak-pointer to histogram allocator being iterated over.
     PersistentHistogramAllocator* allocator_;
@@ -454,6 +460,18 @@ class BASE_EXPORT GlobalHistogramAllocator
   // deleted when the process exits.
   void DeletePersistentLocation();
 
+  // Enables the lazy import of the histograms created by other processes in
+  // the memory segment. Rather than recreating every new histogram whenever
+  // the StatisticsRecorder is queried, which is costly at startup with a
+  // large segment, only the references of the new histograms are indexed by
+  // name hash. A histogram is then recreated when it is looked up by name, or
+  // when all the histograms are listed to be snapshotted. This cannot be
+  // disabled once enabled.
+  void EnableLazyImport();
+  bool lazy_import_enabled() const {
+    return lazy_import_enabled_.load(std::memory_order_relaxed);
+  }
+
  private:
   friend class StatisticsRecorder;
 
@@ -469,6 +487,18 @@ class BASE_EXPORT GlobalHistogramAllocator
   // nothing new has been added.
   void ImportHistogramsToStatisticsRecorder();
 
+  // As above but, in lazy import mode, only imports the histograms named
+  // |name|. The other new histograms are indexed for a later import.
+  void ImportHistogramToStatisticsRecorder(StringPiece name);
+
+  // Indexes the new histograms of the memory segment by name hash, for lazy
+  // import.
+  void IndexHistogramsForLazyImport();
+
+  // Recreates the histogram at |ref| and registers it with the
+  // StatisticsRecorder.
+  void ImportHistogramReference(Reference ref);
+
   // Builds a FilePath for a metrics file.
   static FilePath MakeMetricsFilePath(const FilePath& dir, StringPiece name);
 
@@ -476,6 +506,15 @@ class BASE_EXPORT GlobalHistogramAllocator
   // iterator to continue the work.
   Iterator import_iterator_;
 
+  // Whether histograms are indexed rather than recreated on import.
+  std::atomic<bool> lazy_import_enabled_{false};
+
+  // The histograms indexed but not yet imported, by name hash. Different
+  // processes can create a histogram of the same name, hence the multimap.
+  Lock lazy_import_lock_;
+  std::multimap<uint64_t, Reference> lazy_import_references_
+      GUARDED_BY(lazy_import_lock_);
+
   // The location to which the data should be persisted.
   FilePath persistent_location_;
 
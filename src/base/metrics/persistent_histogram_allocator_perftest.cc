@@ -0,0 +1,106 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+
+#include "base/metrics/bucket_ranges.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/persistent_histogram_allocator.h"
+#include "base/metrics/persistent_memory_allocator.h"
+#include "base/metrics/statistics_recorder.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+
+namespace {
+
+constexpr size_t kAllocatorMemorySize = 16 << 20;  // 16 MiB
+// Number of histograms created in the segment by "another process".
+constexpr int kHistogramCount = 10000;
+
+struct ImportPerfTestParam {
+  const char* story;
+  bool lazy_import;
+};
+
+class PersistentHistogramImportPerfTest
+    : public testing::TestWithParam<ImportPerfTestParam> {
+ public:
+  PersistentHistogramImportPerfTest()
+      : statistics_recorder_(StatisticsRecorder::CreateTemporaryForTesting()) {}
+
+  void SetUp() override {
+    GlobalHistogramAllocator::ReleaseForTesting();
+    GlobalHistogramAllocator::CreateWithLocalMemory(kAllocatorMemorySize, 0,
+                                                    "ImportPerfTest");
+    GlobalHistogramAllocator* global_allocator =
+        GlobalHistogramAllocator::Get();
+    if (GetParam().lazy_import)
+      global_allocator->EnableLazyImport();
+
+    // Fill the segment through another allocator of the same memory, as the
+    // processes sharing it would.
+    PersistentHistogramAllocator other_allocator(
+        std::make_unique<PersistentMemoryAllocator>(
+            const_cast<void*>(global_allocator->data()),
+            global_allocator->length(), 0, 0, "", false));
+    BucketRanges ranges(11);
+    LinearHistogram::InitializeBucketRanges(1, 10, &ranges);
+    for (int i = 0; i < kHistogramCount; ++i) {
+      PersistentHistogramAllocator::Reference ref;
+      std::unique_ptr<HistogramBase> histogram =
+          other_allocator.AllocateHistogram(
+              LINEAR_HISTOGRAM, StringPrintf("ImportPerfTest.Histogram%d", i),
+              1, 10, &ranges, 0, &ref);
+      ASSERT_TRUE(histogram);
+      other_allocator.FinalizeHistogram(ref, /*registered=*/true);
+    }
+  }
+
+  void TearDown() override {
+    GlobalHistogramAllocator::ReleaseForTesting();
+    statistics_recorder_.reset();
+  }
+
+ private:
+  std::unique_ptr<StatisticsRecorder> statistics_recorder_;
+};
+
+}  // namespace
+
+// Measures the first lookup made after the segment was filled, as done when a
+// histogram is first used at startup, then the import of all the histograms,
+// as done when they are snapshotted.
+TEST_P(PersistentHistogramImportPerfTest, Import) {
+  const TimeTicks start = TimeTicks::Now();
+  EXPECT_TRUE(StatisticsRecorder::FindHistogram("ImportPerfTest.Histogram0"));
+  const TimeTicks first_lookup_end = TimeTicks::Now();
+  EXPECT_EQ(static_cast<size_t>(kHistogramCount),
+            StatisticsRecorder::GetHistograms().size());
+  const TimeTicks end = TimeTicks::Now();
+
+  perf_test::PerfResultReporter reporter("PersistentHistogramImport.",
+                                         GetParam().story);
+  reporter.RegisterImportantMetric("first_lookup_time", "us");
+  reporter.RegisterImportantMetric("total_time", "us");
+  reporter.AddResult("first_lookup_time", first_lookup_end - start);
+  reporter.AddResult("total_time", end - start);
+}
+
+const ImportPerfTestParam kPerfTestParams[] = {
+    {"eager", false},
+    {"lazy", true},
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         PersistentHistogramImportPerfTest,
+                         testing::ValuesIn(kPerfTestParams));
+
+}  // namespace base
@@ -371,4 +371,49 @@ TEST_F(PersistentHistogramAllocatorTest, RangesDeDuplication) {
   EXPECT_EQ(ranges_ref, data2[kRangesRefIndex]);
 }
 
+TEST_F(PersistentHistogramAllocatorTest, LazyImport) {
+  GlobalHistogramAllocator::Get()->EnableLazyImport();
+  const size_t starting_sr_count = StatisticsRecorder::GetHistogramCount();
+
+  // Create two histograms through another allocator of the same memory, as
+  // another process sharing the segment would.
+  PersistentHistogramAllocator other_allocator(
+      std::make_unique<PersistentMemoryAllocator>(
+          allocator_memory_.get(), kAllocatorMemorySize, 0, 0, "", false));
+  BucketRanges ranges(11);
+  LinearHistogram::InitializeBucketRanges(1, 10, &ranges);
+  for (const char* name : {"LazyHistogram1", "LazyHistogram2"}) {
+    PersistentHistogramAllocator::Reference ref;
+    std::unique_ptr<HistogramBase> histogram =
+        other_allocator.AllocateHistogram(LINEAR_HISTOGRAM, name, 1, 10,
+                                          &ranges, 0, &ref);
+    ASSERT_TRUE(histogram);
+    histogram->Add(3);
+    other_allocator.FinalizeHistogram(ref, /*registered=*/true);
+  }
+
+  // Looking up a histogram by name imports it alone.
+  HistogramBase* found = StatisticsRecorder::FindHistogram("LazyHistogram1");
+  ASSERT_TRUE(found);
+  EXPECT_EQ(1, found->SnapshotSamples()->GetCount(3));
+  EXPECT_EQ(starting_sr_count + 1, StatisticsRecorder::GetHistogramCount());
+  EXPECT_EQ(found, StatisticsRecorder::FindHistogram("LazyHistogram1"));
+
+  // Looking up another name imports nothing.
+  EXPECT_FALSE(StatisticsRecorder::FindHistogram("UnknownHistogram"));
+  EXPECT_EQ(starting_sr_count + 1, StatisticsRecorder::GetHistogramCount());
+
+  // A histogram created locally is not imported again.
+  HistogramBase* local_histogram =
+      LinearHistogram::FactoryGet("LocalHistogram", 1, 10, 10, 0);
+  ASSERT_TRUE(local_histogram);
+  EXPECT_EQ(starting_sr_count + 2, StatisticsRecorder::GetHistogramCount());
+
+  // Listing the histograms imports all the others.
+  EXPECT_EQ(starting_sr_count + 3, StatisticsRecorder::GetHistograms().size());
+  EXPECT_TRUE(StatisticsRecorder::FindHistogram("LazyHistogram2"));
+  EXPECT_EQ(local_histogram,
+            StatisticsRecorder::FindHistogram("LocalHistogram"));
+}
+
 }  // namespace base
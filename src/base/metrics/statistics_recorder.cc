@@ -199,11 +199,28 @@ std::vector<const BucketRanges*> StatisticsRecorder::GetBucketRanges() {
 
 // static
 HistogramBase* StatisticsRecorder::FindHistogram(base::StringPiece name) {
-  // This must be called *before* the lock is acquired below because it will
-  // call back into this object to register histograms. Those called methods
-  // will acquire the lock at that time.
+  // In lazy import mode, only the histograms named |name| are imported, and
+  // only if none is registered yet.
+  GlobalHistogramAllocator* allocator = GlobalHistogramAllocator::Get();
+  if (allocator && allocator->lazy_import_enabled()) {
+    if (HistogramBase* histogram = FindRegisteredHistogram(name))
+      return histogram;
+    // This must be called without the lock because it will call back into
+    // this object to register histograms.
+    allocator->ImportHistogramToStatisticsRecorder(name);
+    return FindRegisteredHistogram(name);
+  }
+
+  // This must be called without the lock because it will call back into this
+  // object to register histograms. Those called methods will acquire the lock
+  // at that time.
   ImportGlobalPersistentHistograms();
+  return FindRegisteredHistogram(name);
+}
 
+// static
+HistogramBase* StatisticsRecorder::FindRegisteredHistogram(
+    base::StringPiece name) {
   const AutoLock auto_lock(lock_.Get());
   EnsureGlobalRecorderWhileLocked();
 
@@ -333,6 +333,12 @@ class BASE_EXPORT StatisticsRecorder {
   // Precondition: The global lock must not be held during this call.
   static void ImportGlobalPersistentHistograms();
 
+  // Finds a histogram by name among the registered ones, without importing
+  // from global persistent memory.
+  //
+  // This method is thread safe.
+  static HistogramBase* FindRegisteredHistogram(base::StringPiece name);
+
   // Constructs a new StatisticsRecorder and sets it as the current global
   // recorder.
   //
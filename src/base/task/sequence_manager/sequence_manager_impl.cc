@@ -18,6 +18,7 @@
 #include "base/rand_util.h"
 #include "base/ranges/algorithm.h"
 #include "base/task/sequence_manager/real_time_domain.h"
+#include "base/task/sequence_manager/task_profiler.h"
 #include "base/task/sequence_manager/task_time_observer.h"
 #include "base/task/sequence_manager/thread_controller_impl.h"
 #include "base/task/sequence_manager/thread_controller_with_message_pump_impl.h"
@@ -658,6 +659,7 @@ Task* SequenceManagerImpl::SelectNextTaskImpl(SelectTaskOption option) {
     ExecutingTask& executing_task =
         *main_thread_only().task_execution_stack.rbegin();
     NotifyWillProcessTask(&executing_task, &lazy_now);
+    MaybeStartTaskProfilerSample(&executing_task);
 
     return &executing_task.pending_task;
   }
@@ -672,6 +674,7 @@ void SequenceManagerImpl::DidRunTask() {
   LazyNow lazy_now(controller_->GetClock());
   ExecutingTask& executing_task =
       *main_thread_only().task_execution_stack.rbegin();
+  MaybeRecordTaskProfilerSample(executing_task, &lazy_now);
 
   TRACE_EVENT_END0("sequence_manager", executing_task.task_queue_name);
   TRACE_EVENT_END0("sequence_manager",
@@ -899,6 +902,37 @@ void SequenceManagerImpl::NotifyDidProcessTask(ExecutingTask* executing_task,
   }
 }
 
+void SequenceManagerImpl::MaybeStartTaskProfilerSample(
+    ExecutingTask* executing_task) {
+  const int sampling_interval =
+      TaskProfiler::GetInstance()->sampling_interval();
+  if (LIKELY(!sampling_interval) ||
+      main_thread_only().random_generator.RandDouble() * sampling_interval >=
+          1) {
+    return;
+  }
+  executing_task->profiler_start_time = NowTicks();
+  if (ThreadTicks::IsSupported())
+    executing_task->profiler_start_thread_time = ThreadTicks::Now();
+}
+
+void SequenceManagerImpl::MaybeRecordTaskProfilerSample(
+    const ExecutingTask& executing_task,
+    LazyNow* time_after_task) {
+  if (LIKELY(executing_task.profiler_start_time.is_null()))
+    return;
+  TimeDelta thread_time;
+  if (!executing_task.profiler_start_thread_time.is_null()) {
+    thread_time =
+        ThreadTicks::Now() - executing_task.profiler_start_thread_time;
+  }
+  TaskProfiler::GetInstance()->RecordSample(
+      executing_task.pending_task.posted_from, executing_task.task_queue_name,
+      executing_task.priority,
+      time_after_task->Now() - executing_task.profiler_start_time,
+      thread_time);
+}
+
 void SequenceManagerImpl::SetWorkBatchSize(int work_batch_size) {
   DCHECK_CALLED_ON_VALID_THREAD(associated_thread_->thread_checker);
   DCHECK_GE(work_batch_size, 1);
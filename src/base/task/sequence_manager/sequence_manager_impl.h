@@ -252,6 +252,9 @@ class BASE_EXPORT SequenceManagerImpl
     // Save task metadata to use in after running a task as |pending_task|
     // won't be available then.
     int task_type;
+    // Set when the task is sampled by the TaskProfiler.
+    TimeTicks profiler_start_time;
+    ThreadTicks profiler_start_thread_time;
   };
 
   struct MainThreadOnly {
@@ -340,6 +343,12 @@ class BASE_EXPORT SequenceManagerImpl
   void NotifyWillProcessTask(ExecutingTask* task, LazyNow* time_before_task);
   void NotifyDidProcessTask(ExecutingTask* task, LazyNow* time_after_task);
 
+  // Start timing |task| if the TaskProfiler samples it, and record its sample
+  // once it has run.
+  void MaybeStartTaskProfilerSample(ExecutingTask* task);
+  void MaybeRecordTaskProfilerSample(const ExecutingTask& task,
+                                     LazyNow* time_after_task);
+
   EnqueueOrder GetNextSequenceNumber();
 
   bool GetAddQueueTimeToTasks();
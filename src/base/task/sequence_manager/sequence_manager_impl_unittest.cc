@@ -20,6 +20,7 @@
 #include "base/memory/scoped_refptr.h"
 #include "base/message_loop/message_pump_default.h"
 #include "base/message_loop/message_pump_type.h"
+#include "base/ranges/algorithm.h"
 #include "base/run_loop.h"
 #include "base/single_thread_task_runner.h"
 #include "base/strings/strcat.h"
@@ -32,6 +33,7 @@
 #include "base/task/sequence_manager/task_queue.h"
 #include "base/task/sequence_manager/task_queue_impl.h"
 #include "base/task/sequence_manager/task_queue_selector.h"
+#include "base/task/sequence_manager/task_profiler.h"
 #include "base/task/sequence_manager/tasks.h"
 #include "base/task/sequence_manager/test/mock_time_domain.h"
 #include "base/task/sequence_manager/test/mock_time_message_pump.h"
@@ -459,6 +461,31 @@ TEST_P(SequenceManagerTest, GetCorrectTaskRunnerForCurrentTask) {
   RunLoop().RunUntilIdle();
 }
 
+TEST_P(SequenceManagerTest, TaskProfilerSamplesTasks) {
+  TaskProfiler* profiler = TaskProfiler::GetInstance();
+  profiler->Enable(1);
+  auto queue = CreateTaskQueue(TaskQueue::Spec("profiled"));
+  queue->SetQueuePriority(TaskQueue::kHighPriority);
+
+  const Location posted_from = FROM_HERE;
+  queue->task_runner()->PostTask(
+      posted_from, BindLambdaForTesting([&]() {
+        AdvanceMockTickClock(TimeDelta::FromMilliseconds(5));
+      }));
+  RunLoop().RunUntilIdle();
+  profiler->Disable();
+
+  std::vector<TaskProfiler::Entry> entries = profiler->GetEntries();
+  auto it = ranges::find_if(entries, [&](const TaskProfiler::Entry& entry) {
+    return entry.task_queue_name == queue->GetName();
+  });
+  ASSERT_NE(it, entries.end());
+  EXPECT_EQ(posted_from.line_number(), it->posted_from.line_number());
+  EXPECT_EQ(TaskQueue::kHighPriority, it->priority);
+  EXPECT_EQ(1u, it->sample_count);
+  EXPECT_GE(it->total_wall_time, TimeDelta::FromMilliseconds(5));
+}
+
 TEST_P(SequenceManagerTest, NowNotCalledIfUnneeded) {
   sequence_manager()->SetWorkBatchSize(6);
 
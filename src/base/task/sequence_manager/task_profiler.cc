@@ -0,0 +1,173 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/sequence_manager/task_profiler.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "base/bits.h"
+#include "base/check_op.h"
+#include "base/hash/hash.h"
+#include "base/tracing_buildflags.h"
+
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+#include "base/trace_event/memory_dump_manager.h"  // no-presubmit-check
+#include "base/trace_event/process_memory_dump.h"  // no-presubmit-check
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+
+namespace base {
+namespace sequence_manager {
+
+namespace {
+
+size_t HashKey(const Location& posted_from,
+               const char* task_queue_name,
+               TaskQueue::QueuePriority priority) {
+  return HashInts(
+      HashInts(reinterpret_cast<uintptr_t>(posted_from.file_name()),
+               posted_from.line_number()),
+      HashInts(reinterpret_cast<uintptr_t>(task_queue_name), priority));
+}
+
+bool MatchesKey(const TaskProfiler::Entry& entry,
+                const Location& posted_from,
+                const char* task_queue_name,
+                TaskQueue::QueuePriority priority) {
+  // The names are compared by address, as they are string literals.
+  return entry.posted_from.file_name() == posted_from.file_name() &&
+         entry.posted_from.line_number() == posted_from.line_number() &&
+         entry.posted_from.function_name() == posted_from.function_name() &&
+         entry.task_queue_name == task_queue_name && entry.priority == priority;
+}
+
+}  // namespace
+
+TaskProfiler::Entry::Entry() = default;
+TaskProfiler::Entry::Entry(const Entry&) = default;
+TaskProfiler::Entry& TaskProfiler::Entry::operator=(const Entry&) = default;
+TaskProfiler::Entry::~Entry() = default;
+
+// static
+TaskProfiler* TaskProfiler::GetInstance() {
+  static NoDestructor<TaskProfiler> instance;
+  return instance.get();
+}
+
+TaskProfiler::TaskProfiler() = default;
+
+TaskProfiler::~TaskProfiler() = default;
+
+void TaskProfiler::Enable(int sampling_interval) {
+  DCHECK_GT(sampling_interval, 0);
+  bool register_dump_provider;
+  {
+    AutoLock lock(lock_);
+    register_dump_provider = !entries_;
+    entries_ = std::make_unique<Entry[]>(kMaxEntries);
+    entry_count_ = 0;
+    dropped_sample_count_ = 0;
+  }
+  sampling_interval_.store(sampling_interval, std::memory_order_relaxed);
+
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+  // Report the memory of the table, once it is allocated.
+  if (register_dump_provider) {
+    trace_event::MemoryDumpManager::GetInstance()->RegisterDumpProvider(
+        this, "TaskProfiler", nullptr);
+  }
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+}
+
+void TaskProfiler::Disable() {
+  sampling_interval_.store(0, std::memory_order_relaxed);
+}
+
+std::vector<TaskProfiler::Entry> TaskProfiler::GetEntries() const {
+  std::vector<Entry> entries;
+  {
+    AutoLock lock(lock_);
+    entries.reserve(entry_count_);
+    for (size_t i = 0; entries_ && i < kMaxEntries; ++i) {
+      if (entries_[i].sample_count)
+        entries.push_back(entries_[i]);
+    }
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) {
+              return a.total_wall_time > b.total_wall_time;
+            });
+  return entries;
+}
+
+uint64_t TaskProfiler::GetDroppedSampleCount() const {
+  AutoLock lock(lock_);
+  return dropped_sample_count_;
+}
+
+void TaskProfiler::RecordSample(const Location& posted_from,
+                                const char* task_queue_name,
+                                TaskQueue::QueuePriority priority,
+                                TimeDelta wall_time,
+                                TimeDelta thread_time) {
+  AutoLock lock(lock_);
+  if (!entries_)
+    return;
+
+  // Linear probing. The table is never full of keys when probing for a new
+  // one, so the loop ends.
+  size_t index = HashKey(posted_from, task_queue_name, priority) % kMaxEntries;
+  while (entries_[index].sample_count &&
+         !MatchesKey(entries_[index], posted_from, task_queue_name, priority)) {
+    index = (index + 1) % kMaxEntries;
+  }
+
+  Entry& entry = entries_[index];
+  if (!entry.sample_count) {
+    // Keep a free entry, so that probing always ends.
+    if (entry_count_ == kMaxEntries - 1) {
+      ++dropped_sample_count_;
+      return;
+    }
+    ++entry_count_;
+    entry.posted_from = posted_from;
+    entry.task_queue_name = task_queue_name;
+    entry.priority = priority;
+  }
+  ++entry.sample_count;
+  entry.total_wall_time += wall_time;
+  entry.total_thread_time += thread_time;
+  ++entry.wall_time_histogram[GetHistogramBucket(wall_time)];
+  ++entry.thread_time_histogram[GetHistogramBucket(thread_time)];
+}
+
+// static
+size_t TaskProfiler::GetHistogramBucket(TimeDelta duration) {
+  const int64_t microseconds = duration.InMicroseconds();
+  if (microseconds < 1)
+    return 0;
+  const uint32_t clamped_microseconds = static_cast<uint32_t>(std::min<int64_t>(
+      microseconds, std::numeric_limits<uint32_t>::max()));
+  return std::min<size_t>(1 + bits::Log2Floor(clamped_microseconds),
+                          kHistogramBuckets - 1);
+}
+
+bool TaskProfiler::OnMemoryDump(const trace_event::MemoryDumpArgs& args,
+                                trace_event::ProcessMemoryDump* pmd) {
+#if BUILDFLAG(ENABLE_BASE_TRACING)
+  AutoLock lock(lock_);
+  trace_event::MemoryAllocatorDump* dump =
+      pmd->CreateAllocatorDump("task_profiler");
+  dump->AddScalar(trace_event::MemoryAllocatorDump::kNameSize,
+                  trace_event::MemoryAllocatorDump::kUnitsBytes,
+                  entries_ ? kMaxEntries * sizeof(Entry) : 0);
+  dump->AddScalar(trace_event::MemoryAllocatorDump::kNameObjectCount,
+                  trace_event::MemoryAllocatorDump::kUnitsObjects,
+                  entry_count_);
+#endif  // BUILDFLAG(ENABLE_BASE_TRACING)
+  return true;
+}
+
+}  // namespace sequence_manager
+}  // namespace base
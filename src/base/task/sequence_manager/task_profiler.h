@@ -0,0 +1,119 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TASK_SEQUENCE_MANAGER_TASK_PROFILER_H_
+#define BASE_TASK_SEQUENCE_MANAGER_TASK_PROFILER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/location.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+#include "base/task/sequence_manager/task_queue.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+#include "base/trace_event/base_tracing.h"
+
+namespace base {
+namespace sequence_manager {
+
+// Aggregates the wall and thread time of a sample of the tasks run by the
+// SequenceManagers of the process, by posting location, task queue and
+// priority. It is cheap enough to leave enabled in production: while it is
+// disabled, SequenceManagers only check whether it is enabled, and while it is
+// enabled, they time one in |sampling_interval()| tasks on average. The
+// aggregates live in a fixed-size table, which is allocated on Enable().
+//
+// This class is thread-safe.
+class BASE_EXPORT TaskProfiler : public trace_event::MemoryDumpProvider {
+ public:
+  // Number of buckets of the duration histograms.
+  static constexpr size_t kHistogramBuckets = 20;
+  // Maximum number of (location, task queue, priority) keys. The samples of
+  // further keys are dropped.
+  static constexpr size_t kMaxEntries = 512;
+
+  // The samples of the tasks posted from one location to one task queue, at
+  // one priority.
+  struct BASE_EXPORT Entry {
+    Entry();
+    Entry(const Entry&);
+    Entry& operator=(const Entry&);
+    ~Entry();
+
+    Location posted_from;
+    const char* task_queue_name = nullptr;
+    TaskQueue::QueuePriority priority = TaskQueue::kNormalPriority;
+    uint64_t sample_count = 0;
+    TimeDelta total_wall_time;
+    TimeDelta total_thread_time;
+    // Samples by duration. Bucket 0 counts the durations under a microsecond,
+    // bucket i the durations in [2^(i-1), 2^i) microseconds, and the last
+    // bucket all the longer ones.
+    std::array<uint32_t, kHistogramBuckets> wall_time_histogram = {};
+    std::array<uint32_t, kHistogramBuckets> thread_time_histogram = {};
+  };
+
+  static TaskProfiler* GetInstance();
+
+  TaskProfiler(const TaskProfiler&) = delete;
+  TaskProfiler& operator=(const TaskProfiler&) = delete;
+
+  // Clears the previous samples, and starts sampling one in
+  // |sampling_interval| tasks.
+  void Enable(int sampling_interval);
+  // Stops sampling. The samples so far are kept until the next Enable().
+  void Disable();
+
+  // Returns 0 while disabled.
+  int sampling_interval() const {
+    return sampling_interval_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the entries by decreasing total wall time.
+  std::vector<Entry> GetEntries() const;
+  // Returns the number of samples dropped because the table was full.
+  uint64_t GetDroppedSampleCount() const;
+
+  // Records a sampled task. |thread_time| is zero if ThreadTicks are not
+  // supported.
+  void RecordSample(const Location& posted_from,
+                    const char* task_queue_name,
+                    TaskQueue::QueuePriority priority,
+                    TimeDelta wall_time,
+                    TimeDelta thread_time);
+
+  static size_t GetHistogramBucket(TimeDelta duration);
+
+ private:
+  friend class NoDestructor<TaskProfiler>;
+
+  TaskProfiler();
+  ~TaskProfiler() override;
+
+  // trace_event::MemoryDumpProvider implementation.
+  bool OnMemoryDump(const trace_event::MemoryDumpArgs& args,
+                    trace_event::ProcessMemoryDump* pmd) override;
+
+  std::atomic<int> sampling_interval_{0};
+
+  mutable Lock lock_;
+  // Open addressing hash table of |kMaxEntries| entries, an entry being free
+  // while its |sample_count| is zero.
+  std::unique_ptr<Entry[]> entries_ GUARDED_BY(lock_);
+  size_t entry_count_ GUARDED_BY(lock_) = 0;
+  uint64_t dropped_sample_count_ GUARDED_BY(lock_) = 0;
+};
+
+}  // namespace sequence_manager
+}  // namespace base
+
+#endif  // BASE_TASK_SEQUENCE_MANAGER_TASK_PROFILER_H_
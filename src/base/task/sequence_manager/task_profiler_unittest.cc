@@ -0,0 +1,128 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/task/sequence_manager/task_profiler.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace sequence_manager {
+
+namespace {
+
+constexpr char kFunctionName[] = "Function";
+constexpr char kFileName[] = "file.cc";
+constexpr char kQueueName[] = "queue";
+constexpr char kOtherQueueName[] = "other_queue";
+
+Location LocationForLine(int line_number) {
+  return Location(kFunctionName, kFileName, line_number, nullptr);
+}
+
+class TaskProfilerTest : public testing::Test {
+ public:
+  void SetUp() override { profiler()->Enable(1); }
+  void TearDown() override { profiler()->Disable(); }
+
+ protected:
+  TaskProfiler* profiler() { return TaskProfiler::GetInstance(); }
+};
+
+}  // namespace
+
+TEST_F(TaskProfilerTest, AggregatesByLocationQueueAndPriority) {
+  const TimeDelta kMillisecond = TimeDelta::FromMilliseconds(1);
+  profiler()->RecordSample(LocationForLine(1), kQueueName,
+                           TaskQueue::kNormalPriority, kMillisecond,
+                           kMillisecond);
+  profiler()->RecordSample(LocationForLine(1), kQueueName,
+                           TaskQueue::kNormalPriority, 2 * kMillisecond,
+                           kMillisecond);
+  profiler()->RecordSample(LocationForLine(1), kOtherQueueName,
+                           TaskQueue::kNormalPriority, 4 * kMillisecond,
+                           kMillisecond);
+  profiler()->RecordSample(LocationForLine(1), kQueueName,
+                           TaskQueue::kHighPriority, 5 * kMillisecond,
+                           kMillisecond);
+  profiler()->RecordSample(LocationForLine(2), kQueueName,
+                           TaskQueue::kNormalPriority, 6 * kMillisecond,
+                           kMillisecond);
+
+  std::vector<TaskProfiler::Entry> entries = profiler()->GetEntries();
+  ASSERT_EQ(4u, entries.size());
+
+  // The entries are sorted by decreasing total wall time.
+  EXPECT_EQ(2, entries[0].posted_from.line_number());
+  EXPECT_EQ(1u, entries[0].sample_count);
+  EXPECT_EQ(6 * kMillisecond, entries[0].total_wall_time);
+
+  EXPECT_EQ(TaskQueue::kHighPriority, entries[1].priority);
+  EXPECT_EQ(kOtherQueueName, entries[2].task_queue_name);
+
+  EXPECT_EQ(1, entries[3].posted_from.line_number());
+  EXPECT_EQ(kQueueName, entries[3].task_queue_name);
+  EXPECT_EQ(TaskQueue::kNormalPriority, entries[3].priority);
+  EXPECT_EQ(2u, entries[3].sample_count);
+  EXPECT_EQ(3 * kMillisecond, entries[3].total_wall_time);
+  EXPECT_EQ(2 * kMillisecond, entries[3].total_thread_time);
+  // 1000us and 2000us fall in the [2^9, 2^10) and [2^10, 2^11) buckets.
+  EXPECT_EQ(1u, entries[3].wall_time_histogram[10]);
+  EXPECT_EQ(1u, entries[3].wall_time_histogram[11]);
+  EXPECT_EQ(2u, entries[3].thread_time_histogram[10]);
+}
+
+TEST_F(TaskProfilerTest, HistogramBuckets) {
+  EXPECT_EQ(0u, TaskProfiler::GetHistogramBucket(TimeDelta()));
+  EXPECT_EQ(0u,
+            TaskProfiler::GetHistogramBucket(TimeDelta::FromNanoseconds(999)));
+  EXPECT_EQ(1u,
+            TaskProfiler::GetHistogramBucket(TimeDelta::FromMicroseconds(1)));
+  EXPECT_EQ(2u,
+            TaskProfiler::GetHistogramBucket(TimeDelta::FromMicroseconds(2)));
+  EXPECT_EQ(2u,
+            TaskProfiler::GetHistogramBucket(TimeDelta::FromMicroseconds(3)));
+  EXPECT_EQ(3u,
+            TaskProfiler::GetHistogramBucket(TimeDelta::FromMicroseconds(4)));
+  EXPECT_EQ(TaskProfiler::kHistogramBuckets - 1,
+            TaskProfiler::GetHistogramBucket(TimeDelta::FromMinutes(1)));
+  EXPECT_EQ(TaskProfiler::kHistogramBuckets - 1,
+            TaskProfiler::GetHistogramBucket(TimeDelta::FromDays(100)));
+}
+
+TEST_F(TaskProfilerTest, DropsSamplesWhenFull) {
+  for (int i = 0; i < static_cast<int>(TaskProfiler::kMaxEntries); ++i) {
+    profiler()->RecordSample(LocationForLine(i), kQueueName,
+                             TaskQueue::kNormalPriority,
+                             TimeDelta::FromMicroseconds(1), TimeDelta());
+  }
+  // A table entry is kept free.
+  EXPECT_EQ(TaskProfiler::kMaxEntries - 1, profiler()->GetEntries().size());
+  EXPECT_EQ(1u, profiler()->GetDroppedSampleCount());
+
+  // Keys already in the table are still sampled.
+  profiler()->RecordSample(LocationForLine(0), kQueueName,
+                           TaskQueue::kNormalPriority,
+                           TimeDelta::FromSeconds(1), TimeDelta());
+  EXPECT_EQ(0, profiler()->GetEntries()[0].posted_from.line_number());
+  EXPECT_EQ(2u, profiler()->GetEntries()[0].sample_count);
+  EXPECT_EQ(1u, profiler()->GetDroppedSampleCount());
+}
+
+TEST_F(TaskProfilerTest, KeepsSamplesUntilEnabledAgain) {
+  profiler()->RecordSample(LocationForLine(1), kQueueName,
+                           TaskQueue::kNormalPriority,
+                           TimeDelta::FromMilliseconds(1), TimeDelta());
+  profiler()->Disable();
+  EXPECT_EQ(0, profiler()->sampling_interval());
+  EXPECT_EQ(1u, profiler()->GetEntries().size());
+
+  profiler()->Enable(10);
+  EXPECT_EQ(10, profiler()->sampling_interval());
+  EXPECT_TRUE(profiler()->GetEntries().empty());
+}
+
+}  // namespace sequence_manager
+}  // namespace base
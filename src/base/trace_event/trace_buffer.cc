@@ -301,6 +301,48 @@ void TraceBufferChunk::EstimateTraceMemoryOverhead(
   overhead->Update(*cached_overhead_estimate_);
 }
 
+TraceBufferChunkHandoffList::TraceBufferChunkHandoffList() = default;
+
+TraceBufferChunkHandoffList::~TraceBufferChunkHandoffList() {
+  ReturnAllTo(nullptr, 0);
+}
+
+void TraceBufferChunkHandoffList::Push(std::unique_ptr<TraceBufferChunk> chunk,
+                                       size_t index,
+                                       int generation) {
+  DCHECK(chunk);
+  TraceBufferChunk* node = chunk.release();
+  node->handed_off_index_ = index;
+  node->handed_off_generation_ = generation;
+  node->next_handed_off_ = head_.load(std::memory_order_relaxed);
+  while (!head_.compare_exchange_weak(node->next_handed_off_, node,
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed)) {
+  }
+}
+
+void TraceBufferChunkHandoffList::ReturnAllTo(TraceBuffer* buffer,
+                                              int generation) {
+  TraceBufferChunk* node = head_.exchange(nullptr, std::memory_order_acquire);
+
+  // Reverse the list, so that a ring buffer recycles the oldest chunks first.
+  TraceBufferChunk* oldest = nullptr;
+  while (node) {
+    TraceBufferChunk* next = node->next_handed_off_;
+    node->next_handed_off_ = oldest;
+    oldest = node;
+    node = next;
+  }
+
+  while (oldest) {
+    std::unique_ptr<TraceBufferChunk> chunk(oldest);
+    oldest = chunk->next_handed_off_;
+    chunk->next_handed_off_ = nullptr;
+    if (buffer && chunk->handed_off_generation_ == generation)
+      buffer->ReturnChunk(chunk->handed_off_index_, std::move(chunk));
+  }
+}
+
 TraceResultBuffer::OutputCallback
 TraceResultBuffer::SimpleOutput::GetCallback() {
   return BindRepeating(&SimpleOutput::Append, Unretained(this));
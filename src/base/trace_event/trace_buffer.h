@@ -8,6 +8,9 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <atomic>
+#include <memory>
+
 #include "base/base_export.h"
 #include "base/trace_event/trace_event.h"
 #include "base/trace_event/trace_event_impl.h"
@@ -48,10 +51,17 @@ class BASE_EXPORT TraceBufferChunk {
   static const size_t kTraceBufferChunkSize = 64;
 
  private:
+  friend class TraceBufferChunkHandoffList;
+
   size_t next_free_;
   std::unique_ptr<TraceEventMemoryOverhead> cached_overhead_estimate_;
   TraceEvent chunk_[kTraceBufferChunkSize];
   uint32_t seq_;
+
+  // Used while the chunk is in a TraceBufferChunkHandoffList.
+  TraceBufferChunk* next_handed_off_ = nullptr;
+  size_t handed_off_index_ = 0;
+  int handed_off_generation_ = 0;
 };
 
 // TraceBuffer holds the events as they are collected.
@@ -81,6 +91,37 @@ class BASE_EXPORT TraceBuffer {
   static TraceBuffer* CreateTraceBufferVectorOfSize(size_t max_chunks);
 };
 
+// A lock-free list of the chunks which threads have filled, waiting to be
+// returned to the TraceBuffer they were taken from. Any thread can hand a chunk
+// off without taking a lock; the chunks are returned all at once by a thread
+// which owns the TraceBuffer.
+class BASE_EXPORT TraceBufferChunkHandoffList {
+ public:
+  TraceBufferChunkHandoffList();
+  TraceBufferChunkHandoffList(const TraceBufferChunkHandoffList&) = delete;
+  TraceBufferChunkHandoffList& operator=(const TraceBufferChunkHandoffList&) =
+      delete;
+  ~TraceBufferChunkHandoffList();
+
+  // Hands off |chunk|, taken at |index| from the TraceBuffer of |generation|.
+  void Push(std::unique_ptr<TraceBufferChunk> chunk,
+            size_t index,
+            int generation);
+
+  // Returns the chunks handed off from the TraceBuffer of |generation| to
+  // |buffer|, in the order they were handed off, and deletes the others.
+  // |buffer| may be null to delete all the chunks.
+  void ReturnAllTo(TraceBuffer* buffer, int generation);
+
+  bool empty() const { return !head_.load(std::memory_order_relaxed); }
+
+ private:
+  // The most recently handed off chunk, linked to the previous ones through
+  // |TraceBufferChunk::next_handed_off_|. Chunks are only ever removed all at
+  // once, so pushing with a compare-and-swap is not subject to ABA.
+  std::atomic<TraceBufferChunk*> head_{nullptr};
+};
+
 // TraceResultBuffer collects and converts trace fragments returned by TraceLog
 // to JSON output.
 class BASE_EXPORT TraceResultBuffer {
@@ -831,6 +831,15 @@ void TraceManyInstantEvents(int thread_id, int num_events,
     task_complete_event->Signal();
 }
 
+void TraceLongScopeEvent(int num_nested_events,
+                         WaitableEvent* task_complete_event) {
+  {
+    TRACE_EVENT0("test_all", "long scope event");
+    TraceManyInstantEvents(0, num_nested_events, nullptr);
+  }
+  task_complete_event->Signal();
+}
+
 void ValidateInstantEventPresentOnEveryThread(const Value& trace_parsed,
                                               int num_threads,
                                               int num_events) {
@@ -1482,6 +1491,30 @@ TEST_F(TraceEventTestFixture, DataCapturedManyThreads) {
   }
 }
 
+// Test that the duration of an event is recorded after its thread has handed
+// off the chunk the event is in.
+TEST_F(TraceEventTestFixture, CompleteEventSpanningChunksOnThread) {
+  BeginTrace();
+
+  const int num_events = 10 * TraceBufferChunk::kTraceBufferChunkSize;
+  Thread thread("1");
+  WaitableEvent task_complete_event(WaitableEvent::ResetPolicy::AUTOMATIC,
+                                    WaitableEvent::InitialState::NOT_SIGNALED);
+  thread.Start();
+  thread.task_runner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&TraceLongScopeEvent, num_events, &task_complete_event));
+  task_complete_event.Wait();
+
+  EndTraceAndFlushInThreadWithMessageLoop();
+  thread.Stop();
+
+  const Value* item = FindNamePhase("long scope event", "X");
+  ASSERT_TRUE(item);
+  EXPECT_TRUE(item->FindKey("dur"));
+  ValidateInstantEventPresentOnEveryThread(trace_parsed_, 1, num_events);
+}
+
 // Test that thread and process names show up in the trace
 TEST_F(TraceEventTestFixture, ThreadNames) {
   // Create threads before we enable tracing to make sure
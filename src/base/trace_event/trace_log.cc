@@ -92,6 +92,13 @@ const size_t kTraceEventRingBufferChunks = kTraceEventVectorBufferChunks / 4;
 // ECHO_TO_CONSOLE needs a small buffer to hold the unfinished COMPLETE events.
 const size_t kEchoToConsoleTraceEventBufferChunks = 256;
 
+// Number of empty chunks a thread local buffer reserves ahead, so that it takes
+// the lock once every few chunks. Buffers smaller than a ring buffer, such as
+// the ECHO_TO_CONSOLE one, are not reserved from, as they could run out of
+// chunks with many threads.
+const size_t kThreadLocalReservedChunks = 2;
+const size_t kMinChunksForThreadLocalReservation = kTraceEventRingBufferChunks;
+
 const size_t kTraceEventBufferSizeInBytes = 100 * 1024;
 #if !BUILDFLAG(USE_PERFETTO_CLIENT_LIBRARY)
 const int kThreadFlushTimeoutMs = 3000;
@@ -528,6 +535,10 @@ class TraceLog::ThreadLocalEventBuffer
   TraceLog* trace_log_;
   std::unique_ptr<TraceBufferChunk> chunk_;
   size_t chunk_index_ = 0;
+  // Empty chunks taken ahead from the trace buffer, with their indices. The
+  // last one is used next.
+  std::vector<std::pair<size_t, std::unique_ptr<TraceBufferChunk>>>
+      reserved_chunks_;
   int generation_;
 };
 
@@ -546,6 +557,7 @@ TraceLog::ThreadLocalEventBuffer::ThreadLocalEventBuffer(TraceLog* trace_log)
 
   AutoLock lock(trace_log->lock_);
   trace_log->thread_task_runners_[thread_id] = ThreadTaskRunnerHandle::Get();
+  reserved_chunks_.reserve(trace_log->thread_local_reserved_chunks_);
 }
 
 TraceLog::ThreadLocalEventBuffer::~ThreadLocalEventBuffer() {
@@ -568,13 +580,32 @@ TraceEvent* TraceLog::ThreadLocalEventBuffer::AddTraceEvent(
   CheckThisIsCurrentBuffer();
 
   if (chunk_ && chunk_->IsFull()) {
-    AutoLock lock(trace_log_->lock_);
-    FlushWhileLocked();
-    chunk_.reset();
+    // The chunk is returned to the trace buffer by the next thread which takes
+    // the lock, or by the flush.
+    trace_log_->handed_off_chunks_->Push(std::move(chunk_), chunk_index_,
+                                         generation_);
+  }
+  if (!chunk_ && !reserved_chunks_.empty()) {
+    chunk_index_ = reserved_chunks_.back().first;
+    chunk_ = std::move(reserved_chunks_.back().second);
+    reserved_chunks_.pop_back();
   }
   if (!chunk_) {
     AutoLock lock(trace_log_->lock_);
-    chunk_ = trace_log_->logged_events_->GetChunk(&chunk_index_);
+    trace_log_->ReturnHandedOffChunksWhileLocked();
+    TraceBuffer* logged_events = trace_log_->logged_events_.get();
+    chunk_ = logged_events->GetChunk(&chunk_index_);
+    if (logged_events->Capacity() >=
+        kMinChunksForThreadLocalReservation * kTraceBufferChunkSize) {
+      while (reserved_chunks_.size() <
+                 trace_log_->thread_local_reserved_chunks_ &&
+             !logged_events->IsFull()) {
+        size_t index;
+        std::unique_ptr<TraceBufferChunk> chunk =
+            logged_events->GetChunk(&index);
+        reserved_chunks_.emplace_back(index, std::move(chunk));
+      }
+    }
     trace_log_->CheckIfBufferIsFullWhileLocked();
   }
   if (!chunk_)
@@ -600,21 +631,31 @@ bool TraceLog::ThreadLocalEventBuffer::OnMemoryDump(const MemoryDumpArgs& args,
       "tracing/thread_%d", static_cast<int>(PlatformThread::CurrentId()));
   TraceEventMemoryOverhead overhead;
   chunk_->EstimateTraceMemoryOverhead(&overhead);
+  for (const auto& reserved_chunk : reserved_chunks_)
+    reserved_chunk.second->EstimateTraceMemoryOverhead(&overhead);
   overhead.DumpInto(dump_base_name.c_str(), pmd);
   return true;
 }
 
 void TraceLog::ThreadLocalEventBuffer::FlushWhileLocked() {
-  if (!chunk_)
+  if (!chunk_ && reserved_chunks_.empty())
     return;
 
   trace_log_->lock_.AssertAcquired();
   if (trace_log_->CheckGeneration(generation_)) {
-    // Return the chunk to the buffer only if the generation matches.
-    trace_log_->logged_events_->ReturnChunk(chunk_index_, std::move(chunk_));
+    // Return the chunks to the buffer only if the generation matches.
+    if (chunk_) {
+      trace_log_->logged_events_->ReturnChunk(chunk_index_,
+                                              std::move(chunk_));
+    }
+    for (auto& reserved_chunk : reserved_chunks_) {
+      trace_log_->logged_events_->ReturnChunk(
+          reserved_chunk.first, std::move(reserved_chunk.second));
+    }
   }
   // Otherwise this method may be called from the destructor, or TraceLog will
   // find the generation mismatch and delete this buffer soon.
+  reserved_chunks_.clear();
 }
 
 void TraceLog::SetAddTraceEventOverrides(
@@ -678,6 +719,8 @@ TraceLog::TraceLog(int generation)
       trace_options_(kInternalRecordUntilFull),
       trace_config_(TraceConfig()),
       thread_shared_chunk_index_(0),
+      handed_off_chunks_(std::make_unique<TraceBufferChunkHandoffList>()),
+      thread_local_reserved_chunks_(kThreadLocalReservedChunks),
       generation_(generation),
       use_worker_thread_(false) {
   CategoryRegistry::Initialize();
@@ -1298,6 +1341,11 @@ void TraceLog::CheckIfBufferIsFullWhileLocked() {
   }
 }
 
+void TraceLog::ReturnHandedOffChunksWhileLocked() {
+  if (!handed_off_chunks_->empty())
+    handed_off_chunks_->ReturnAllTo(logged_events_.get(), generation());
+}
+
 // Flush() works as the following:
 // 1. Flush() is called in thread A whose task runner is saved in
 //    flush_task_runner_;
@@ -1468,6 +1516,7 @@ void TraceLog::FinishFlush(int generation, bool discard_events) {
   {
     AutoLock lock(lock_);
 
+    ReturnHandedOffChunksWhileLocked();
     previous_logged_events.swap(logged_events_);
     UseNextTraceBuffer();
     thread_task_runners_.clear();
@@ -2132,8 +2181,10 @@ TraceEvent* TraceLog::GetEventByHandleInternal(TraceEventHandle handle,
   // The event has been out-of-control of the thread local buffer.
   // Try to get the event from the main buffer with a lock.
   // NO_THREAD_SAFETY_ANALYSIS: runtime-dependent locking here.
-  if (lock)
+  if (lock) {
     lock->EnsureAcquired();
+    ReturnHandedOffChunksWhileLocked();
+  }
 
   if (thread_shared_chunk_ &&
       handle.chunk_index == thread_shared_chunk_index_) {
@@ -2252,9 +2303,16 @@ void TraceLog::UpdateETWCategoryGroupEnabledFlags() {
 void TraceLog::SetTraceBufferForTesting(
     std::unique_ptr<TraceBuffer> trace_buffer) {
   AutoLock lock(lock_);
+  // The handed off chunks belong to the previous buffer.
+  handed_off_chunks_->ReturnAllTo(nullptr, generation());
   logged_events_ = std::move(trace_buffer);
 }
 
+void TraceLog::SetThreadLocalReservedChunksForTesting(size_t count) {
+  AutoLock lock(lock_);
+  thread_local_reserved_chunks_ = count;
+}
+
 #if BUILDFLAG(USE_PERFETTO_CLIENT_LIBRARY)
 tracing::PerfettoPlatform* TraceLog::GetOrCreatePerfettoPlatform() {
   if (!perfetto_platform_) {
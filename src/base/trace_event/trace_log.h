@@ -47,6 +47,7 @@ namespace trace_event {
 struct TraceCategory;
 class TraceBuffer;
 class TraceBufferChunk;
+class TraceBufferChunkHandoffList;
 class TraceEvent;
 class TraceEventFilter;
 class TraceEventMemoryOverhead;
@@ -418,6 +419,11 @@ class BASE_EXPORT TraceLog :
   // Replaces |logged_events_| with a new TraceBuffer for testing.
   void SetTraceBufferForTesting(std::unique_ptr<TraceBuffer> trace_buffer);
 
+  // Sets the number of empty chunks each thread local buffer reserves ahead,
+  // for testing. With no reserved chunks, the thread local buffers take
+  // |lock_| every time they fill a chunk.
+  void SetThreadLocalReservedChunksForTesting(size_t count);
+
 #if BUILDFLAG(USE_PERFETTO_CLIENT_LIBRARY)
   // perfetto::TrackEventSessionObserver implementation.
   void OnSetup(const perfetto::DataSourceBase::SetupArgs&) override;
@@ -489,6 +495,7 @@ class BASE_EXPORT TraceLog :
                                                      bool check_buffer_is_full)
       EXCLUSIVE_LOCKS_REQUIRED(lock_);
   void CheckIfBufferIsFullWhileLocked() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void ReturnHandedOffChunksWhileLocked() EXCLUSIVE_LOCKS_REQUIRED(lock_);
   void SetDisabledWhileLocked(uint8_t modes) EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
   TraceEvent* GetEventByHandleInternal(TraceEventHandle handle,
@@ -601,6 +608,13 @@ class BASE_EXPORT TraceLog :
   std::unique_ptr<TraceBufferChunk> thread_shared_chunk_;
   size_t thread_shared_chunk_index_;
 
+  // Chunks filled by the thread local buffers, which hand them off without
+  // taking |lock_|. They are returned to |logged_events_| by the next thread
+  // which takes |lock_| to reserve chunks, look up an event or flush.
+  std::unique_ptr<TraceBufferChunkHandoffList> handed_off_chunks_;
+  // Number of empty chunks each thread local buffer reserves ahead.
+  size_t thread_local_reserved_chunks_ GUARDED_BY(lock_);
+
   // Set when asynchronous Flush is in progress.
   OutputCallback flush_output_callback_;
   scoped_refptr<SequencedTaskRunner> flush_task_runner_;
@@ -0,0 +1,112 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "base/trace_event/trace_config.h"
+#include "base/trace_event/trace_event.h"
+#include "base/trace_event/trace_log.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace base {
+namespace trace_event {
+
+namespace {
+
+// Number of events added by each thread.
+constexpr int kEventsPerThread = 250000;
+
+struct TraceLogPerfTestParam {
+  const char* story;
+  int threads;
+  // Whether the threads add their events to a thread local buffer, rather
+  // than to the chunk shared by the threads without a message loop.
+  bool thread_local_buffer;
+  // Whether the thread local buffers reserve empty chunks ahead, rather than
+  // take the lock of the TraceLog every time they fill a chunk.
+  bool reserve_chunks;
+};
+
+void AddTraceEvents(bool thread_local_buffer, WaitableEvent* start_event) {
+  if (!thread_local_buffer)
+    TraceLog::GetInstance()->SetCurrentThreadBlocksMessageLoop();
+  start_event->Wait();
+  for (int i = 0; i < kEventsPerThread; ++i) {
+    TRACE_EVENT_INSTANT1("perf", "event", TRACE_EVENT_SCOPE_THREAD, "event",
+                         i);
+  }
+}
+
+class TraceLogPerfTest : public testing::TestWithParam<TraceLogPerfTestParam> {
+ public:
+  void SetUp() override {
+    TraceLog* trace_log = TraceLog::GetInstance();
+    if (!GetParam().reserve_chunks)
+      trace_log->SetThreadLocalReservedChunksForTesting(0);
+    // Record continuously, so that the buffer never fills up.
+    trace_log->SetEnabled(TraceConfig("perf", "record-continuously"),
+                          TraceLog::RECORDING_MODE);
+  }
+
+  void TearDown() override {
+    TraceLog::GetInstance()->SetDisabled();
+    TraceLog::ResetForTesting();
+  }
+};
+
+}  // namespace
+
+TEST_P(TraceLogPerfTest, AddTraceEvent) {
+  WaitableEvent start_event;
+  std::vector<std::unique_ptr<Thread>> threads;
+  for (int i = 0; i < GetParam().threads; ++i) {
+    threads.push_back(
+        std::make_unique<Thread>(StringPrintf("TraceLogPerfTest%d", i)));
+    ASSERT_TRUE(threads.back()->Start());
+    threads.back()->task_runner()->PostTask(
+        FROM_HERE, BindOnce(&AddTraceEvents, GetParam().thread_local_buffer,
+                            Unretained(&start_event)));
+  }
+
+  const TimeTicks start = TimeTicks::Now();
+  start_event.Signal();
+  // Stopping the threads waits for their events to be added.
+  for (auto& thread : threads)
+    thread->Stop();
+  const TimeDelta total_time = TimeTicks::Now() - start;
+
+  // The threads add their events concurrently, so this is the time each of
+  // them spends per event.
+  perf_test::PerfResultReporter reporter("TraceLog.", GetParam().story);
+  reporter.RegisterImportantMetric("time_per_event", "ns");
+  reporter.AddResult("time_per_event",
+                     total_time.InNanoseconds() /
+                         static_cast<double>(kEventsPerThread));
+}
+
+const TraceLogPerfTestParam kPerfTestParams[] = {
+    {"1_thread_shared_chunk", 1, false, false},
+    {"1_thread_local_buffer_unreserved", 1, true, false},
+    {"1_thread_local_buffer", 1, true, true},
+    {"4_threads_shared_chunk", 4, false, false},
+    {"4_threads_local_buffer_unreserved", 4, true, false},
+    {"4_threads_local_buffer", 4, true, true},
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         TraceLogPerfTest,
+                         testing::ValuesIn(kPerfTestParams));
+
+}  // namespace trace_event
+}  // namespace base
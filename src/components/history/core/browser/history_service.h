@@ -663,6 +663,7 @@ class HistoryService : public KeyedService {
  private:
   class BackendDelegate;
   friend class base::RefCountedThreadSafe<HistoryService>;
+  friend class AutocompleteControllerPerfTest;
   friend class BackendDelegate;
   friend class favicon::FaviconServiceImpl;
   friend class HistoryBackend;
@@ -670,7 +671,7 @@ class HistoryService : public KeyedService {
   friend class ::HistoryQuickProviderTest;
   friend class HistoryServiceTest;
   friend class ::HistoryURLProvider;
-  friend class HQPPerfTestOnePopularURL;
+  friend class HQPPerfTest;
   friend class ::InMemoryURLIndexTest;
   friend std::unique_ptr<HistoryService> CreateHistoryService(
       const base::FilePath& history_dir,
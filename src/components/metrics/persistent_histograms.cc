@@ -9,6 +9,7 @@
 #include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
 #include "base/metrics/field_trial.h"
+#include "base/metrics/field_trial_params.h"
 #include "base/metrics/histogram_functions.h"
 #include "base/metrics/persistent_histogram_allocator.h"
 #include "base/strings/string_util.h"
@@ -237,6 +238,13 @@ void InstantiatePersistentHistogramsImpl(const base::FilePath& metrics_dir,
   // Create tracking histograms for the allocator and record storage file.
   allocator->CreateTrackingHistograms(kBrowserMetricsName);
 
+  // Index the histograms created in the allocator by name rather than
+  // recreate them all each time the StatisticsRecorder is queried.
+  if (base::GetFieldTrialParamByFeatureAsBool(
+          base::kPersistentHistogramsFeature, "lazy_import", false)) {
+    allocator->EnableLazyImport();
+  }
+
 #if defined(OS_WIN)
   base::ThreadPool::PostDelayedTask(
       FROM_HERE,
@@ -15,6 +15,7 @@
 
 #include "base/bind.h"
 #include "base/check_op.h"
+#include "base/containers/contains.h"
 #include "base/feature_list.h"
 #include "base/format_macros.h"
 #include "base/metrics/histogram.h"
@@ -423,20 +424,39 @@ void AutocompleteController::Start(const AutocompleteInput& input) {
   //
   // NOTE: This comes after constructing |input_| above since that construction
   // can change the text string (e.g. by stripping off a leading '?').
+  //
+  // The providers deferred by the previous call, if they did not start since,
+  // hold matches for an older input, so this is not a minimal change for them.
   const bool minimal_changes =
-      (input_.text() == old_input_text) &&
+      deferred_providers_.empty() && (input_.text() == old_input_text) &&
       (input_.allow_exact_keyword_match() == old_allow_exact_keyword_match) &&
       (input_.want_asynchronous_matches() == old_want_asynchronous_matches) &&
       (input_.focus_type() == old_focus_type);
 
   expire_timer_.Stop();
   stop_timer_.Stop();
+  deferred_providers_timer_.Stop();
+  deferred_providers_.clear();
+
+  // The providers past the deadline are deferred only if observers are
+  // notified of the asynchronous matches, which their matches then are.
+  const bool defer_providers_past_deadline =
+      input.want_asynchronous_matches() &&
+      OmniboxFieldTrial::IsDeferProvidersPastDeadlineEnabled();
+  const base::TimeDelta deadline = base::TimeDelta::FromMilliseconds(
+      OmniboxFieldTrial::kDeferProvidersDeadlineMs.Get());
 
   // Start the new query.
   in_start_ = true;
   base::TimeTicks start_time = base::TimeTicks::Now();
   for (auto i(providers_.begin()); i != providers_.end(); ++i) {
     base::TimeTicks provider_start_time = base::TimeTicks::Now();
+    // The first provider always starts, so that there is a synchronous match.
+    if (defer_providers_past_deadline && i != providers_.begin() &&
+        provider_start_time - start_time >= deadline) {
+      deferred_providers_.assign(i, providers_.end());
+      break;
+    }
     (*i)->Start(input_, minimal_changes);
     if (!input.want_asynchronous_matches())
       DCHECK((*i)->done());
@@ -498,6 +518,13 @@ void AutocompleteController::Start(const AutocompleteInput& input) {
     StartExpireTimer();
     StartStopTimer();
   }
+
+  if (!deferred_providers_.empty()) {
+    deferred_providers_timer_.Start(
+        FROM_HERE, base::TimeDelta(),
+        base::BindOnce(&AutocompleteController::StartDeferredProviders,
+                       base::Unretained(this)));
+  }
 }
 
 void AutocompleteController::Stop(bool clear_result) {
@@ -700,8 +727,11 @@ void AutocompleteController::UpdateResult(
   old_matches_to_reuse.Swap(&result_);
 
   for (Providers::const_iterator i(providers_.begin());
-       i != providers_.end(); ++i)
-    result_.AppendMatches(input_, (*i)->matches());
+       i != providers_.end(); ++i) {
+    // The matches of deferred providers are for an older input.
+    if (!base::Contains(deferred_providers_, *i))
+      result_.AppendMatches(input_, (*i)->matches());
+  }
 
   if (OmniboxFieldTrial::IsTabSwitchSuggestionsEnabled())
     result_.ConvertOpenTabMatches(provider_client_.get(), &input_);
@@ -966,6 +996,10 @@ void AutocompleteController::NotifyChanged(bool notify_default_match) {
 }
 
 void AutocompleteController::CheckIfDone() {
+  if (!deferred_providers_.empty()) {
+    done_ = false;
+    return;
+  }
   for (Providers::const_iterator i(providers_.begin()); i != providers_.end();
        ++i) {
     if (!(*i)->done()) {
@@ -995,8 +1029,34 @@ void AutocompleteController::StartStopTimer() {
                                    base::Unretained(this), false, true));
 }
 
+void AutocompleteController::StartDeferredProviders() {
+  TRACE_EVENT0("omnibox", "AutocompleteController::StartDeferredProviders");
+  DCHECK(!deferred_providers_.empty());
+
+  // The providers are started as in the synchronous pass of Start(), so that
+  // they do not update the result one by one. Their matches are then merged
+  // as an asynchronous update, which keeps the default match that is already
+  // shown: the user may be about to accept it.
+  Providers providers;
+  providers.swap(deferred_providers_);
+  in_start_ = true;
+  for (const auto& provider : providers)
+    provider->Start(input_, /*minimal_changes=*/false);
+  in_start_ = false;
+  CheckIfDone();
+  UpdateResult(false, false);
+
+  // Start() started the timers, as it was not done.
+  if (done_) {
+    expire_timer_.Stop();
+    stop_timer_.Stop();
+  }
+}
+
 void AutocompleteController::StopHelper(bool clear_result,
                                         bool due_to_user_inactivity) {
+  deferred_providers_timer_.Stop();
+  deferred_providers_.clear();
   for (Providers::const_iterator i(providers_.begin()); i != providers_.end();
        ++i) {
     (*i)->Stop(clear_result, due_to_user_inactivity);
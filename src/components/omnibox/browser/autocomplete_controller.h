@@ -265,6 +265,10 @@ class AutocompleteController : public AutocompleteProviderListener,
   // Starts |stop_timer_|.
   void StartStopTimer();
 
+  // Starts the providers deferred by Start() past the deadline of its
+  // synchronous pass, and merges their matches as an asynchronous update.
+  void StartDeferredProviders();
+
   // Helper function for Stop().  |due_to_user_inactivity| means this call was
   // triggered by a user's idleness, i.e., not an explicit user action.
   void StopHelper(bool clear_result,
@@ -329,6 +333,12 @@ class AutocompleteController : public AutocompleteProviderListener,
   // Timer used to tell the providers to Stop() searching for matches.
   base::OneShotTimer stop_timer_;
 
+  // The providers that Start() did not start because its synchronous pass
+  // exceeded its deadline. Their matches are stale until they are started by
+  // |deferred_providers_timer_|, right after Start() returns.
+  Providers deferred_providers_;
+  base::OneShotTimer deferred_providers_timer_;
+
   // Amount of time between when the user stops typing and when we send Stop()
   // to every provider.  This is intended to avoid the disruptive effect of
   // belated omnibox updates, updates that come after the user has had to time
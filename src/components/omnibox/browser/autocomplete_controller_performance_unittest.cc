@@ -0,0 +1,225 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/omnibox/browser/autocomplete_controller.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "components/history/core/browser/history_backend.h"
+#include "components/history/core/browser/history_database.h"
+#include "components/history/core/browser/history_service.h"
+#include "components/history/core/test/history_service_test_util.h"
+#include "components/omnibox/browser/autocomplete_input.h"
+#include "components/omnibox/browser/autocomplete_provider.h"
+#include "components/omnibox/browser/fake_autocomplete_provider_client.h"
+#include "components/omnibox/browser/history_test_util.h"
+#include "components/omnibox/browser/in_memory_url_index.h"
+#include "components/omnibox/browser/in_memory_url_index_test_util.h"
+#include "components/omnibox/browser/test_scheme_classifier.h"
+#include "components/omnibox/common/omnibox_features.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/metrics_proto/omnibox_event.pb.h"
+
+namespace history {
+
+namespace {
+
+// The sizes of the history and bookmarks of a heavy user.
+constexpr size_t kHistoryURLCount = 100000;
+constexpr size_t kBookmarkCount = 10000;
+
+// The providers which match the local history and bookmarks.
+constexpr int kProviderTypes = AutocompleteProvider::TYPE_BOOKMARK |
+                               AutocompleteProvider::TYPE_BUILTIN |
+                               AutocompleteProvider::TYPE_HISTORY_QUICK |
+                               AutocompleteProvider::TYPE_HISTORY_URL |
+                               AutocompleteProvider::TYPE_SHORTCUTS;
+
+constexpr char kMetricKeystrokeLatency[] = ".keystroke_latency";
+constexpr char kMetricResultLatency[] = ".result_latency";
+
+std::string GetHost(size_t index) {
+  return "site" + base::NumberToString(index) + ".example.com";
+}
+
+URLRow GenerateURLRow(size_t index) {
+  URLRow row{GURL("https://www." + GetHost(index) + "/articles/page" +
+                  base::NumberToString(index % 100))};
+  EXPECT_TRUE(row.url().is_valid());
+  row.set_title(u"Article " + base::NumberToString16(index) + u" of site " +
+                base::NumberToString16(index % 1000));
+  row.set_visit_count(1 + index % 5);
+  row.set_typed_count(index % 3);
+  row.set_last_visit(base::Time::Now() -
+                     base::TimeDelta::FromHours(1 + index % 1000));
+  return row;
+}
+
+}  // namespace
+
+// Measures the latency of AutocompleteController::Start(), which blocks the
+// keystroke, and of the final result, on a large history and bookmark set.
+class AutocompleteControllerPerfTest
+    : public testing::Test,
+      public AutocompleteController::Observer {
+ protected:
+  AutocompleteControllerPerfTest() = default;
+  AutocompleteControllerPerfTest(const AutocompleteControllerPerfTest&) =
+      delete;
+  AutocompleteControllerPerfTest& operator=(
+      const AutocompleteControllerPerfTest&) = delete;
+
+  void SetUp() override;
+  void TearDown() override;
+
+  // Types each prefix of |text| in turn, and reports the latencies under
+  // |story_name|.
+  void RunTypingTest(const std::string& story_name, const std::string& text);
+
+ private:
+  // Populates history and bookmarks.
+  void PrepareData(FakeAutocompleteProviderClient* client);
+
+  // AutocompleteController::Observer:
+  void OnResultChanged(AutocompleteController* controller,
+                       bool default_match_changed) override;
+
+  base::test::TaskEnvironment task_environment_;
+  std::unique_ptr<AutocompleteController> controller_;
+  base::OnceClosure quit_closure_;
+};
+
+void AutocompleteControllerPerfTest::SetUp() {
+  auto client = std::make_unique<FakeAutocompleteProviderClient>();
+  ASSERT_TRUE(client->GetHistoryService());
+  ASSERT_NO_FATAL_FAILURE(PrepareData(client.get()));
+  controller_ =
+      std::make_unique<AutocompleteController>(std::move(client),
+                                               kProviderTypes);
+  controller_->AddObserver(this);
+}
+
+void AutocompleteControllerPerfTest::TearDown() {
+  controller_.reset();
+  task_environment_.RunUntilIdle();
+}
+
+void AutocompleteControllerPerfTest::PrepareData(
+    FakeAutocompleteProviderClient* client) {
+#if defined NDEBUG
+  const size_t history_url_count = kHistoryURLCount;
+  const size_t bookmark_count = kBookmarkCount;
+#else
+  LOG(ERROR) << "Autocomplete performance test is running on a debug build, "
+                "results may not be accurate.";
+  const size_t history_url_count = kHistoryURLCount / 100;
+  const size_t bookmark_count = kBookmarkCount / 100;
+#endif
+  HistoryService* history_service = client->GetHistoryService();
+  HistoryDatabase* history_db = history_service->history_backend_->db();
+  for (size_t i = 0; i < history_url_count; ++i)
+    AddFakeURLToHistoryDB(history_db, GenerateURLRow(i));
+
+  InMemoryURLIndex* url_index = client->GetInMemoryURLIndex();
+  url_index->RebuildFromHistory(history_db);
+  BlockUntilInMemoryURLIndexIsRefreshed(url_index);
+  BlockUntilHistoryProcessesPendingRequests(history_service);
+
+  // Every tenth history URL is also bookmarked.
+  bookmarks::BookmarkModel* bookmark_model = client->GetBookmarkModel();
+  ASSERT_TRUE(bookmark_model->loaded());
+  for (size_t i = 0; i < bookmark_count; ++i) {
+    const URLRow row = GenerateURLRow(i * 10);
+    bookmark_model->AddURL(bookmark_model->bookmark_bar_node(), i,
+                           row.title(), row.url());
+  }
+}
+
+void AutocompleteControllerPerfTest::RunTypingTest(
+    const std::string& story_name,
+    const std::string& text) {
+  std::vector<base::TimeDelta> keystroke_latencies;
+  std::vector<base::TimeDelta> result_latencies;
+  for (size_t length = 1; length <= text.size(); ++length) {
+    base::RunLoop().RunUntilIdle();
+    AutocompleteInput input(base::UTF8ToUTF16(text.substr(0, length)),
+                            metrics::OmniboxEventProto::OTHER,
+                            TestSchemeClassifier());
+
+    const base::TimeTicks start = base::TimeTicks::Now();
+    controller_->Start(input);
+    keystroke_latencies.push_back(base::TimeTicks::Now() - start);
+
+    if (!controller_->done()) {
+      base::RunLoop run_loop;
+      quit_closure_ = run_loop.QuitClosure();
+      run_loop.Run();
+    }
+    result_latencies.push_back(base::TimeTicks::Now() - start);
+    EXPECT_FALSE(controller_->result().empty());
+  }
+
+  auto to_list = [](const std::vector<base::TimeDelta>& latencies) {
+    std::string list;
+    for (base::TimeDelta latency : latencies)
+      list += base::NumberToString(latency.InMillisecondsF()) + ',';
+    // Strip off trailing comma.
+    list.pop_back();
+    return list;
+  };
+  perf_test::PerfResultReporter reporter("AutocompleteControllerPerfTest",
+                                         story_name);
+  reporter.RegisterImportantMetric(kMetricKeystrokeLatency, "ms");
+  reporter.RegisterImportantMetric(kMetricResultLatency, "ms");
+  reporter.AddResultList(kMetricKeystrokeLatency,
+                         to_list(keystroke_latencies));
+  reporter.AddResultList(kMetricResultLatency, to_list(result_latencies));
+}
+
+void AutocompleteControllerPerfTest::OnResultChanged(
+    AutocompleteController* controller,
+    bool default_match_changed) {
+  if (controller->done() && quit_closure_)
+    std::move(quit_closure_).Run();
+}
+
+TEST_F(AutocompleteControllerPerfTest, TypingURL) {
+  RunTypingTest("TypingURL", "www." + GetHost(1230) + "/articles");
+}
+
+TEST_F(AutocompleteControllerPerfTest, TypingTitle) {
+  RunTypingTest("TypingTitle", "article 1230 of site");
+}
+
+// The same keystrokes with the providers past the synchronous deadline
+// deferred, so that Start() returns after the first provider.
+TEST_F(AutocompleteControllerPerfTest, TypingURLWithDeferredProviders) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeatureWithParameters(
+      omnibox::kDeferProvidersPastDeadline,
+      {{"DeferProvidersDeadlineMs", "0"}});
+  RunTypingTest("TypingURLWithDeferredProviders",
+                "www." + GetHost(1230) + "/articles");
+}
+
+TEST_F(AutocompleteControllerPerfTest, TypingTitleWithDeferredProviders) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeatureWithParameters(
+      omnibox::kDeferProvidersPastDeadline,
+      {{"DeferProvidersDeadlineMs", "0"}});
+  RunTypingTest("TypingTitleWithDeferredProviders", "article 1230 of site");
+}
+
+}  // namespace history
@@ -6,6 +6,7 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -19,6 +20,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/task_environment.h"
 #include "base/test/values_test_util.h"
 #include "base/threading/thread_task_runner_handle.h"
@@ -31,6 +33,7 @@
 #include "components/omnibox/browser/omnibox_prefs.h"
 #include "components/omnibox/browser/search_provider.h"
 #include "components/omnibox/browser/zero_suggest_provider.h"
+#include "components/omnibox/common/omnibox_features.h"
 #include "components/open_from_clipboard/fake_clipboard_recent_content.h"
 #include "components/prefs/testing_pref_service.h"
 #include "components/search_engines/omnibox_focus_type.h"
@@ -330,6 +333,9 @@ class AutocompleteProviderTest : public testing::Test {
             controller_->zero_suggest_provider_->headers_map());
     provider_headers_map = headers_map;
   }
+  const AutocompleteController::Providers& deferred_providers() const {
+    return controller_->deferred_providers_;
+  }
 
   TestingPrefServiceSimple* GetPrefs() { return &pref_service_; }
 
@@ -642,6 +648,51 @@ TEST_F(AutocompleteProviderTest, Query) {
   EXPECT_EQ(provider2, result_.default_match()->provider);
 }
 
+// Tests that the providers deferred past the deadline of the synchronous pass
+// are started later, and that their matches do not replace the default match
+// of the synchronous pass.
+TEST_F(AutocompleteProviderTest, DeferProvidersPastDeadline) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeatureWithParameters(
+      omnibox::kDeferProvidersPastDeadline,
+      {{"DeferProvidersDeadlineMs", "0"}});
+  TestProvider* provider1 = nullptr;
+  TestProvider* provider2 = nullptr;
+  ResetControllerWithTestProviders(false, &provider1, &provider2);
+
+  AutocompleteInput input(u"a", metrics::OmniboxEventProto::OTHER,
+                          TestingSchemeClassifier());
+  input.set_prevent_inline_autocomplete(true);
+  controller_->Start(input);
+  // Only the first provider started before the deadline.
+  ASSERT_EQ(1u, deferred_providers().size());
+  EXPECT_EQ(provider2, deferred_providers()[0].get());
+  EXPECT_FALSE(controller_->done());
+  for (const auto& match : controller_->result())
+    EXPECT_NE(provider2, match.provider);
+  ASSERT_TRUE(controller_->result().default_match());
+  EXPECT_EQ(provider1, controller_->result().default_match()->provider);
+  const GURL default_url =
+      controller_->result().default_match()->destination_url;
+  base::RunLoop().Run();
+
+  // The matches of the second provider were merged, but the default match
+  // stayed the one shown after the synchronous pass, even though the second
+  // provider has more relevant matches.
+  EXPECT_TRUE(deferred_providers().empty());
+  EXPECT_TRUE(controller_->done());
+  EXPECT_EQ(
+      std::min(AutocompleteResult::GetMaxMatches(), kResultsPerProvider * 2),
+      result_.size());
+  EXPECT_TRUE(std::any_of(result_.begin(), result_.end(),
+                          [provider2](const AutocompleteMatch& match) {
+                            return match.provider == provider2;
+                          }));
+  ASSERT_TRUE(result_.default_match());
+  EXPECT_EQ(provider1, result_.default_match()->provider);
+  EXPECT_EQ(default_url, result_.default_match()->destination_url);
+}
+
 // Tests assisted query stats.
 TEST_F(AutocompleteProviderTest, AssistedQueryStats) {
   ResetControllerWithTestProviders(false, nullptr, nullptr);
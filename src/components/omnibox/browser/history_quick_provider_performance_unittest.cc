@@ -4,11 +4,16 @@
 
 #include "components/omnibox/browser/history_quick_provider.h"
 
+#include <algorithm>
 #include <memory>
 #include <random>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "base/cxx17_backports.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/no_destructor.h"
 #include "base/run_loop.h"
 #include "base/strings/string_util.h"
@@ -21,6 +26,7 @@
 #include "components/omnibox/browser/fake_autocomplete_provider_client.h"
 #include "components/omnibox/browser/history_test_util.h"
 #include "components/omnibox/browser/in_memory_url_index_test_util.h"
+#include "components/omnibox/browser/url_index_private_data.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_result_reporter.h"
 
@@ -46,6 +52,48 @@ std::string GenerateFakeHashedString(size_t sym_count) {
   return res;
 }
 
+// Not threadsafe.
+std::string GenerateFakeWord() {
+  static constexpr char kLetters[] = "abcdefghijklmnopqrstuvwxyz";
+  static std::mt19937 engine;
+  std::uniform_int_distribution<size_t> length_distribution(3, 10);
+  std::uniform_int_distribution<size_t> index_distribution(
+      0, base::size(kLetters) - 2 /* trailing \0 */);
+
+  std::string res(length_distribution(engine), 'a');
+  for (char& c : res)
+    c = kLetters[index_distribution(engine)];
+  return res;
+}
+
+// Not threadsafe.
+const std::string& GetRandomVocabularyWord() {
+  static constexpr size_t kVocabularySize = 5000;
+  static const base::NoDestructor<std::vector<std::string>> vocabulary([] {
+    std::vector<std::string> words(kVocabularySize);
+    std::generate(words.begin(), words.end(), &GenerateFakeWord);
+    return words;
+  }());
+  static std::mt19937 engine;
+  std::uniform_int_distribution<size_t> index_distribution(
+      0, kVocabularySize - 1);
+  return (*vocabulary)[index_distribution(engine)];
+}
+
+URLRow GenerateVariedURLRow() {
+  const std::string& host = GetRandomVocabularyWord();
+  const std::string& path = GetRandomVocabularyWord();
+  const std::string& page = GetRandomVocabularyWord();
+  URLRow row{GURL("https://www." + host + ".com/" + path + "/" + page)};
+  EXPECT_TRUE(row.url().is_valid());
+  row.set_title(base::UTF8ToUTF16(host + " " + page + " " +
+                                  GetRandomVocabularyWord()));
+  row.set_visit_count(3);
+  row.set_typed_count(1);
+  row.set_last_visit(base::Time::Now() - base::TimeDelta::FromDays(1));
+  return row;
+}
+
 URLRow GeneratePopularURLRow() {
   static constexpr char kPopularUrl[] =
       "http://long.popular_url_with.many_variations/";
@@ -74,16 +122,18 @@ StringPieces AllPrefixes(const std::string& str) {
 
 }  // namespace
 
-class HQPPerfTestOnePopularURL : public testing::Test {
+// Measures the HQP on a history of |url_count| URLs of |generate_url_row|.
+class HQPPerfTest : public testing::Test {
  protected:
-  HQPPerfTestOnePopularURL() = default;
-  HQPPerfTestOnePopularURL(const HQPPerfTestOnePopularURL&) = delete;
-  HQPPerfTestOnePopularURL& operator=(const HQPPerfTestOnePopularURL&) = delete;
+  HQPPerfTest(size_t url_count, URLRow (*generate_url_row)())
+      : url_count_(url_count), generate_url_row_(generate_url_row) {}
+  HQPPerfTest(const HQPPerfTest&) = delete;
+  HQPPerfTest& operator=(const HQPPerfTest&) = delete;
 
   void SetUp() override;
   void TearDown() override;
 
-  // Populates history with variations of the same URL.
+  // Populates history with the generated URLs.
   void PrepareData();
 
   // Runs HQP on a banch of consecutive pieces of an input string and times
@@ -102,13 +152,16 @@ class HQPPerfTestOnePopularURL : public testing::Test {
  private:
   base::TimeDelta RunTest(const std::u16string& text);
 
+  const size_t url_count_;
+  URLRow (*const generate_url_row_)();
+
   base::test::TaskEnvironment task_environment_;
   std::unique_ptr<FakeAutocompleteProviderClient> client_;
 
   scoped_refptr<HistoryQuickProvider> provider_;
 };
 
-void HQPPerfTestOnePopularURL::SetUp() {
+void HQPPerfTest::SetUp() {
   if (base::ThreadTicks::IsSupported())
     base::ThreadTicks::WaitUntilInitialized();
   client_ = std::make_unique<FakeAutocompleteProviderClient>();
@@ -116,26 +169,26 @@ void HQPPerfTestOnePopularURL::SetUp() {
   ASSERT_NO_FATAL_FAILURE(PrepareData());
 }
 
-void HQPPerfTestOnePopularURL::TearDown() {
+void HQPPerfTest::TearDown() {
   provider_ = nullptr;
   client_.reset();
   task_environment_.RunUntilIdle();
 }
 
-void HQPPerfTestOnePopularURL::PrepareData() {
+void HQPPerfTest::PrepareData() {
 // Adding fake urls to db must be done before RebuildFromHistory(). This will
 // ensure that the index is properly populated with data from the database.
 // Note: on debug builds these tests can be slow. Use a smaller data set in
 // that case. See crbug.com/822624.
 #if defined NDEBUG
-  constexpr size_t kSimilarUrlCount = 10000;
+  const size_t url_count = url_count_;
 #else
   LOG(ERROR) << "HQP performance test is running on a debug build, results may "
                 "not be accurate.";
-  constexpr size_t kSimilarUrlCount = 100;
+  const size_t url_count = url_count_ / 100;
 #endif
-  for (size_t i = 0; i < kSimilarUrlCount; ++i)
-    AddFakeURLToHistoryDB(history_backend()->db(), GeneratePopularURLRow());
+  for (size_t i = 0; i < url_count; ++i)
+    AddFakeURLToHistoryDB(history_backend()->db(), generate_url_row_());
 
   InMemoryURLIndex* url_index = client_->GetInMemoryURLIndex();
   url_index->RebuildFromHistory(
@@ -150,7 +203,7 @@ void HQPPerfTestOnePopularURL::PrepareData() {
   provider_ = new HistoryQuickProvider(client_.get());
 }
 
-void HQPPerfTestOnePopularURL::PrintMeasurements(
+void HQPPerfTest::PrintMeasurements(
     const std::string& story_name,
     const std::vector<base::TimeDelta>& measurements) {
   auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
@@ -168,7 +221,7 @@ void HQPPerfTestOnePopularURL::PrintMeasurements(
   reporter.AddResultList(".duration", durations);
 }
 
-base::TimeDelta HQPPerfTestOnePopularURL::RunTest(const std::u16string& text) {
+base::TimeDelta HQPPerfTest::RunTest(const std::u16string& text) {
   base::RunLoop().RunUntilIdle();
   AutocompleteInput input(text, metrics::OmniboxEventProto::OTHER,
                           TestSchemeClassifier());
@@ -185,7 +238,7 @@ base::TimeDelta HQPPerfTestOnePopularURL::RunTest(const std::u16string& text) {
 }
 
 template <typename PieceIt>
-void HQPPerfTestOnePopularURL::RunAllTests(PieceIt first, PieceIt last) {
+void HQPPerfTest::RunAllTests(PieceIt first, PieceIt last) {
   constexpr size_t kTestGroupSize = 5;
   std::vector<base::TimeDelta> measurements;
   measurements.reserve(kTestGroupSize);
@@ -207,6 +260,17 @@ void HQPPerfTestOnePopularURL::RunAllTests(PieceIt first, PieceIt last) {
   }
 }
 
+class HQPPerfTestOnePopularURL : public HQPPerfTest {
+ protected:
+  HQPPerfTestOnePopularURL() : HQPPerfTest(10000, &GeneratePopularURLRow) {}
+};
+
+// History of varied URLs, of the size of a heavy user's.
+class HQPPerfTestManyURLs : public HQPPerfTest {
+ protected:
+  HQPPerfTestManyURLs() : HQPPerfTest(100000, &GenerateVariedURLRow) {}
+};
+
 TEST_F(HQPPerfTestOnePopularURL, Typing) {
   std::string test_url = GeneratePopularURLRow().url().spec();
   StringPieces prefixes = AllPrefixes(test_url);
@@ -219,4 +283,48 @@ TEST_F(HQPPerfTestOnePopularURL, Backspacing) {
   RunAllTests(prefixes.rbegin(), prefixes.rend());
 }
 
+TEST_F(HQPPerfTestManyURLs, Typing) {
+  std::string test_url = GenerateVariedURLRow().url().spec();
+  StringPieces prefixes = AllPrefixes(test_url);
+  RunAllTests(prefixes.begin(), prefixes.end());
+}
+
+TEST_F(HQPPerfTestManyURLs, TypingTitleWords) {
+  std::string text =
+      GetRandomVocabularyWord() + " " + GetRandomVocabularyWord();
+  StringPieces prefixes = AllPrefixes(text);
+  RunAllTests(prefixes.begin(), prefixes.end());
+}
+
+// Measures the startup cost of the index, when it is rebuilt from the history
+// database and when it is restored from its cache file.
+TEST_F(HQPPerfTestManyURLs, RebuildAndRestore) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath cache_path = temp_dir.GetPath().AppendASCII("cache");
+  const std::set<std::string> scheme_allowlist = {"http", "https"};
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  scoped_refptr<URLIndexPrivateData> rebuilt_data =
+      URLIndexPrivateData::RebuildFromHistory(history_backend()->db(),
+                                              scheme_allowlist);
+  const base::TimeDelta rebuild_duration = base::TimeTicks::Now() - start;
+  ASSERT_FALSE(rebuilt_data->Empty());
+  ASSERT_TRUE(URLIndexPrivateData::WritePrivateDataToCacheFileTask(
+      rebuilt_data, cache_path));
+
+  start = base::TimeTicks::Now();
+  scoped_refptr<URLIndexPrivateData> restored_data =
+      URLIndexPrivateData::RestoreFromFile(cache_path);
+  const base::TimeDelta restore_duration = base::TimeTicks::Now() - start;
+  ASSERT_FALSE(restored_data->Empty());
+
+  perf_test::PerfResultReporter reporter("HQPPerfTestManyURLs_Index",
+                                         "startup");
+  reporter.RegisterImportantMetric(".rebuild_duration", "ms");
+  reporter.RegisterImportantMetric(".restore_duration", "ms");
+  reporter.AddResult(".rebuild_duration", rebuild_duration);
+  reporter.AddResult(".restore_duration", restore_duration);
+}
+
 }  // namespace history
@@ -42,8 +42,9 @@ class BookmarkModel;
 }
 
 namespace history {
+class AutocompleteControllerPerfTest;
 class HistoryDatabase;
-class HQPPerfTestOnePopularURL;
+class HQPPerfTest;
 }
 
 class URLIndexPrivateData;
@@ -148,7 +149,8 @@ class InMemoryURLIndex : public KeyedService,
  private:
   friend class ::FakeAutocompleteProviderClient;
   friend class ::HistoryQuickProviderTest;
-  friend class history::HQPPerfTestOnePopularURL;
+  friend class history::AutocompleteControllerPerfTest;
+  friend class history::HQPPerfTest;
   friend class InMemoryURLIndexTest;
   friend class InMemoryURLIndexCacheTest;
   FRIEND_TEST_ALL_PREFIXES(InMemoryURLIndexTest, ExpireRow);
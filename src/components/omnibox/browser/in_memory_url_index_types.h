@@ -7,11 +7,13 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "base/containers/cxx20_erase.h"
 #include "base/containers/flat_set.h"
 #include "components/history/core/browser/history_types.h"
 #include "url/gurl.h"
@@ -126,6 +128,29 @@ String16Vector String16VectorFromString16(
 // the UI can highlight the matched sections.
 Char16Set Char16SetFromString16(const std::u16string& uni_word);
 
+// Removes from the sorted |items| those which are not in the sorted |set|.
+// Rather than walking |set| linearly, each item is looked up with steps
+// doubling from the position of the previous one, so that the cost depends on
+// the size of |items| rather than on the size of |set| when |items| is much
+// smaller, as when narrowing down a few candidates with the posting list of a
+// common character or word.
+template <typename Items, typename Set>
+void IntersectWithSortedSet(Items* items, const Set& set) {
+  auto set_iter = set.begin();
+  base::EraseIf(*items, [&set, &set_iter](const auto& item) {
+    auto low = set_iter;
+    auto high = set_iter;
+    size_t step = 1;
+    while (high != set.end() && *high < item) {
+      low = high;
+      high += std::min<size_t>(step, set.end() - high);
+      step *= 2;
+    }
+    set_iter = std::lower_bound(low, high, item);
+    return set_iter == set.end() || item < *set_iter;
+  });
+}
+
 // Support for InMemoryURLIndex Private Data -----------------------------------
 
 // An index into a list of all of the words we have indexed.
@@ -160,3 +160,30 @@ TEST_F(InMemoryURLIndexTypesTest, DISABLED_OffsetsAndTermMatches) {
   for (size_t i = 0; i < matches_b.size(); ++i)
     EXPECT_EQ(expected_offsets_b[i], matches_b[i].offset);
 }
+
+TEST_F(InMemoryURLIndexTypesTest, IntersectWithSortedSet) {
+  WordIDSet large_set;
+  for (WordID word_id = 0; word_id < 1000; word_id += 3)
+    large_set.insert(word_id);
+
+  // Few items spread over a large set.
+  WordIDSet word_ids = {0, 1, 3, 500, 501, 999, 1000};
+  IntersectWithSortedSet(&word_ids, large_set);
+  EXPECT_EQ(WordIDSet({0, 3, 501, 999}), word_ids);
+
+  // Items past the end of the set.
+  HistoryIDVector history_ids = {2, 4, 6, 8};
+  IntersectWithSortedSet(&history_ids, HistoryIDSet({1, 2, 3}));
+  EXPECT_EQ(HistoryIDVector({2}), history_ids);
+
+  // Empty inputs.
+  IntersectWithSortedSet(&history_ids, HistoryIDSet());
+  EXPECT_TRUE(history_ids.empty());
+  IntersectWithSortedSet(&history_ids, HistoryIDSet({1, 2, 3}));
+  EXPECT_TRUE(history_ids.empty());
+
+  // Every item of a set.
+  WordIDSet copy = large_set;
+  IntersectWithSortedSet(&copy, large_set);
+  EXPECT_EQ(large_set, copy);
+}
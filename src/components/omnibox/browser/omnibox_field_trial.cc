@@ -965,6 +965,15 @@ const base::FeatureParam<int>
         "ShortBookmarkSuggestionsByTotalInputLengthThreshold",
         3);
 
+bool IsDeferProvidersPastDeadlineEnabled() {
+  return base::FeatureList::IsEnabled(omnibox::kDeferProvidersPastDeadline);
+}
+
+const base::FeatureParam<int> kDeferProvidersDeadlineMs(
+    &omnibox::kDeferProvidersPastDeadline,
+    "DeferProvidersDeadlineMs",
+    20);
+
 }  // namespace OmniboxFieldTrial
 
 std::string OmniboxFieldTrial::internal::GetValueForRuleInContext(
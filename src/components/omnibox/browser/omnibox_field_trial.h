@@ -551,6 +551,14 @@ extern const base::FeatureParam<bool>
 extern const base::FeatureParam<int>
     kShortBookmarkSuggestionsByTotalInputLengthThreshold;
 
+// Provider deadline.
+// True if the providers past the deadline of the synchronous pass are
+// deferred.
+bool IsDeferProvidersPastDeadlineEnabled();
+// Duration of the synchronous pass, in milliseconds, after which the remaining
+// providers are deferred.
+extern const base::FeatureParam<int> kDeferProvidersDeadlineMs;
+
 // New params should be inserted above this comment and formatted as:
 // - Short comment categorizing the relevant features & params.
 // - Optional: `bool Is[FeatureName]Enabled();` helpers that check if the
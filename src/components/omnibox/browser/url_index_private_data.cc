@@ -7,12 +7,14 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <numeric>
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/containers/cxx20_erase.h"
 #include "base/containers/stack.h"
@@ -81,6 +83,18 @@ bool LengthGreater(const std::u16string& string_a,
   return string_a.length() > string_b.length();
 }
 
+// Returns the set of the |values| restored from the cache. These were saved
+// from a set, hence sorted and unique, in which case they are not sorted
+// again.
+template <typename Set, typename Values>
+Set SetFromCachedValues(const Values& values) {
+  if (std::adjacent_find(values.begin(), values.end(),
+                         std::greater_equal<>()) == values.end()) {
+    return Set(base::sorted_unique, values.begin(), values.end());
+  }
+  return Set(values.begin(), values.end());
+}
+
 }  // namespace
 
 // UpdateRecentVisitsFromHistoryDBTask -----------------------------------------
@@ -547,7 +561,7 @@ HistoryIDVector URLIndexPrivateData::HistoryIDsFromWords(
       history_ids = {term_history_set.begin(), term_history_set.end()};
     } else {
       // set-intersection
-      base::EraseIf(history_ids, base::IsNotIn<HistoryIDSet>(term_history_set));
+      IntersectWithSortedSet(&history_ids, term_history_set);
     }
   }
   return history_ids;
@@ -639,7 +653,7 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
         word_id_set = std::move(leftover_set);
       } else {
         // set-intersection
-        base::EraseIf(word_id_set, base::IsNotIn<WordIDSet>(leftover_set));
+        IntersectWithSortedSet(&word_id_set, leftover_set);
       }
     }
 
@@ -677,11 +691,10 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
 
 WordIDSet URLIndexPrivateData::WordIDSetForTermChars(
     const Char16Set& term_chars) {
-  // TODO(dyaroshev): write a generic algorithm(crbug.com/696167).
-
-  WordIDSet word_id_set;
-  for (auto c_iter = term_chars.begin(); c_iter != term_chars.end(); ++c_iter) {
-    auto char_iter = char_word_map_.find(*c_iter);
+  std::vector<const WordIDSet*> char_word_id_sets;
+  char_word_id_sets.reserve(term_chars.size());
+  for (char16_t c : term_chars) {
+    auto char_iter = char_word_map_.find(c);
     // A character was not found so there are no matching results: bail.
     if (char_iter == char_word_map_.end())
       return WordIDSet();
@@ -691,14 +704,20 @@ WordIDSet URLIndexPrivateData::WordIDSetForTermChars(
     // a particular character. Give up in that case.
     if (char_word_id_set.empty())
       return WordIDSet();
-
-    if (c_iter == term_chars.begin()) {
-      word_id_set = char_word_id_set;
-    } else {
-      // set-intersection
-      base::EraseIf(word_id_set, base::IsNotIn<WordIDSet>(char_word_id_set));
-    }
+    char_word_id_sets.push_back(&char_word_id_set);
   }
+  if (char_word_id_sets.empty())
+    return WordIDSet();
+
+  // Start from the rarest character, so that only its words are copied and
+  // then looked up in the sets of the more common characters.
+  std::sort(char_word_id_sets.begin(), char_word_id_sets.end(),
+            [](const WordIDSet* a, const WordIDSet* b) {
+              return a->size() < b->size();
+            });
+  WordIDSet word_id_set = *char_word_id_sets.front();
+  for (size_t i = 1; i < char_word_id_sets.size() && !word_id_set.empty(); ++i)
+    IntersectWithSortedSet(&word_id_set, *char_word_id_sets[i]);
   return word_id_set;
 }
 
@@ -1130,8 +1149,11 @@ bool URLIndexPrivateData::RestoreWordMap(
   uint32_t actual_item_count = list_item.word_map_entry_size();
   if (actual_item_count == 0 || actual_item_count != expected_item_count)
     return false;
-  for (const auto& entry : list_item.word_map_entry())
-    word_map_[base::UTF8ToUTF16(entry.word())] = entry.word_id();
+  // The words were saved in order, so each one is inserted at the end.
+  for (const auto& entry : list_item.word_map_entry()) {
+    word_map_.emplace_hint(word_map_.end(), base::UTF8ToUTF16(entry.word()),
+                           entry.word_id());
+  }
 
   return true;
 }
@@ -1153,7 +1175,7 @@ bool URLIndexPrivateData::RestoreCharWordMap(
       return false;
     char16_t uni_char = entry.char_16();
     const RepeatedField<int32_t>& word_ids = entry.word_id();
-    char_word_map_[uni_char] = WordIDSet(word_ids.begin(), word_ids.end());
+    char_word_map_[uni_char] = SetFromCachedValues<WordIDSet>(word_ids);
   }
   return true;
 }
@@ -1175,9 +1197,13 @@ bool URLIndexPrivateData::RestoreWordIDHistoryMap(
     WordID word_id = entry.word_id();
     const RepeatedField<int64_t>& history_ids = entry.history_id();
     word_id_history_map_[word_id] =
-        HistoryIDSet(history_ids.begin(), history_ids.end());
-    for (HistoryID history_id : history_ids)
-      history_id_word_map_[history_id].insert(word_id);
+        SetFromCachedValues<HistoryIDSet>(history_ids);
+    // The entries were saved by increasing word ID, so each word ID is
+    // appended to the sets of its history items.
+    for (HistoryID history_id : history_ids) {
+      WordIDSet& word_ids = history_id_word_map_[history_id];
+      word_ids.insert(word_ids.end(), word_id);
+    }
   }
   return true;
 }
@@ -335,4 +335,12 @@ const char kDefaultTypedNavigationsToHttpsTimeoutParam[] = "timeout";
 // Spare renderer warmup for faster website loading.
 const base::Feature kOmniboxSpareRenderer{"OmniboxSpareRenderer",
                                           base::FEATURE_ENABLED_BY_DEFAULT};
+
+// If enabled, the providers which are not started yet when the synchronous
+// pass of the AutocompleteController exceeds its deadline are started in a
+// task posted right after, so that the results of the providers that ran are
+// shown without waiting for them.
+const base::Feature kDeferProvidersPastDeadline{
+    "OmniboxDeferProvidersPastDeadline", base::FEATURE_DISABLED_BY_DEFAULT};
+
 }  // namespace omnibox
@@ -95,6 +95,9 @@ extern const base::Feature kDefaultTypedNavigationsToHttps;
 extern const char kDefaultTypedNavigationsToHttpsTimeoutParam[];
 extern const base::Feature kOmniboxSpareRenderer;
 
+// Controller - these affect how the AutocompleteController runs providers.
+extern const base::Feature kDeferProvidersPastDeadline;
+
 }  // namespace omnibox
 
 #endif  // COMPONENTS_OMNIBOX_COMMON_OMNIBOX_FEATURES_H_
@@ -6,6 +6,9 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
 
 #include "base/check_op.h"
 #include "third_party/smhasher/src/MurmurHash3.h"
@@ -14,7 +17,7 @@ namespace optimization_guide {
 
 namespace {
 
-uint64_t MurmurHash3(const std::string& str, uint32_t seed) {
+uint64_t MurmurHash3(base::StringPiece str, uint32_t seed) {
   // Uses MurmurHash3 in coordination with server as it is a fast hashing
   // function with compatible public client and private server implementations.
   // DO NOT CHANGE this hashing function without coordination and migration
@@ -25,6 +28,115 @@ uint64_t MurmurHash3(const std::string& str, uint32_t seed) {
   return output[0];
 }
 
+uint64_t RotateLeft(uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+uint64_t FinalizationMix(uint64_t k) {
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return k;
+}
+
+// Computes the same hashes as MurmurHash3() above, for any number of seeds.
+// MurmurHash3_x64_128 mixes each 16-byte block of the string into two 64-bit
+// values, independently of the seed, then folds those into its seeded state.
+// The mixed values are computed once here, so that each seed only costs the
+// folding and the finalization. Strings longer than |kMaxBlocks| blocks are
+// hashed by MurmurHash3_x64_128 directly.
+class MurmurHash3Hasher {
+ public:
+  explicit MurmurHash3Hasher(base::StringPiece str) : str_(str) {
+    num_blocks_ = str.size() / 16;
+    if (num_blocks_ > kMaxBlocks)
+      return;
+
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(str.data());
+    for (size_t i = 0; i < num_blocks_; ++i) {
+      uint64_t k1;
+      uint64_t k2;
+      memcpy(&k1, data + i * 16, sizeof(k1));
+      memcpy(&k2, data + i * 16 + 8, sizeof(k2));
+      mixed_[i] = {MixK1(k1), MixK2(k2)};
+    }
+
+    // Mixing zero gives zero, so the tail is always folded in, even when the
+    // string has no tail bytes.
+    const uint8_t* tail = data + num_blocks_ * 16;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    for (size_t i = str.size() % 16; i > 8; --i)
+      k2 ^= static_cast<uint64_t>(tail[i - 1]) << ((i - 9) * 8);
+    for (size_t i = std::min<size_t>(str.size() % 16, 8); i > 0; --i)
+      k1 ^= static_cast<uint64_t>(tail[i - 1]) << ((i - 1) * 8);
+    mixed_[num_blocks_] = {MixK1(k1), MixK2(k2)};
+  }
+
+  MurmurHash3Hasher(const MurmurHash3Hasher&) = delete;
+  MurmurHash3Hasher& operator=(const MurmurHash3Hasher&) = delete;
+
+  // Returns MurmurHash3(|str|, |seed|).
+  uint64_t Hash(uint32_t seed) const {
+    if (num_blocks_ > kMaxBlocks)
+      return MurmurHash3(str_, seed);
+
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+    for (size_t i = 0; i < num_blocks_; ++i) {
+      h1 ^= mixed_[i].k1;
+      h1 = RotateLeft(h1, 27);
+      h1 += h2;
+      h1 = h1 * 5 + 0x52dce729;
+      h2 ^= mixed_[i].k2;
+      h2 = RotateLeft(h2, 31);
+      h2 += h1;
+      h2 = h2 * 5 + 0x38495ab5;
+    }
+    h2 ^= mixed_[num_blocks_].k2;
+    h1 ^= mixed_[num_blocks_].k1;
+
+    h1 ^= str_.size();
+    h2 ^= str_.size();
+    h1 += h2;
+    h2 += h1;
+    h1 = FinalizationMix(h1);
+    h2 = FinalizationMix(h2);
+    return h1 + h2;
+  }
+
+ private:
+  // Covers every host name.
+  static constexpr size_t kMaxBlocks = 16;
+
+  struct MixedBlock {
+    uint64_t k1;
+    uint64_t k2;
+  };
+
+  static uint64_t MixK1(uint64_t k1) {
+    k1 *= kC1;
+    k1 = RotateLeft(k1, 31);
+    return k1 * kC2;
+  }
+
+  static uint64_t MixK2(uint64_t k2) {
+    k2 *= kC2;
+    k2 = RotateLeft(k2, 33);
+    return k2 * kC1;
+  }
+
+  static constexpr uint64_t kC1 = 0x87c37b91114253d5ULL;
+  static constexpr uint64_t kC2 = 0x4cf5ad432745937fULL;
+
+  const base::StringPiece str_;
+  size_t num_blocks_;
+  // The mixed blocks, followed by the mixed tail.
+  MixedBlock mixed_[kMaxBlocks + 1];
+};
+
 }  // namespace
 
 BloomFilter::BloomFilter(uint32_t num_hash_functions, uint32_t num_bits)
@@ -53,26 +165,41 @@ BloomFilter::BloomFilter(uint32_t num_hash_functions,
 
 BloomFilter::~BloomFilter() = default;
 
-bool BloomFilter::Contains(const std::string& str) const {
+bool BloomFilter::Contains(base::StringPiece str) const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return ContainsInternal(str);
+}
+
+bool BloomFilter::ContainsAny(base::span<const base::StringPiece> strs) const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  for (base::StringPiece str : strs) {
+    if (ContainsInternal(str))
+      return true;
+  }
+  return false;
+}
+
+void BloomFilter::Add(base::StringPiece str) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  MurmurHash3Hasher hasher(str);
   for (size_t i = 0; i < num_hash_functions_; ++i) {
-    uint64_t n = MurmurHash3(str, i) % num_bits_;
+    uint64_t n = hasher.Hash(i) % num_bits_;
     uint32_t byte_index = (n / 8);
     uint32_t bit_index = n % 8;
-    if ((bytes_[byte_index] & (1 << bit_index)) == 0)
-      return false;
+    bytes_[byte_index] |= 1 << bit_index;
   }
-  return true;
 }
 
-void BloomFilter::Add(const std::string& str) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+bool BloomFilter::ContainsInternal(base::StringPiece str) const {
+  MurmurHash3Hasher hasher(str);
   for (size_t i = 0; i < num_hash_functions_; ++i) {
-    uint64_t n = MurmurHash3(str, i) % num_bits_;
+    uint64_t n = hasher.Hash(i) % num_bits_;
     uint32_t byte_index = (n / 8);
     uint32_t bit_index = n % 8;
-    bytes_[byte_index] |= 1 << bit_index;
+    if ((bytes_[byte_index] & (1 << bit_index)) == 0)
+      return false;
   }
+  return true;
 }
 
 }  // namespace optimization_guide
@@ -9,8 +9,10 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/span.h"
 #include "base/macros.h"
 #include "base/sequence_checker.h"
+#include "base/strings/string_piece.h"
 
 namespace optimization_guide {
 
@@ -20,6 +22,11 @@ typedef std::vector<uint8_t> ByteVector;
 // BloomFilter is a simple Bloom filter for keeping track of a set of strings.
 // The implementation is specifically defined to be compatible with data
 // and details provided from a server using the OptimizationGuide hints.proto.
+//
+// Each hash function is MurmurHash3 with a different seed. The part of the
+// hash that mixes in the bytes of a string does not depend on the seed, so it
+// is done once per string, and each additional hash function only costs the
+// per-seed steps and the finalization.
 class BloomFilter {
  public:
   // Constructs a Bloom filter of |num_bits| size with zero-ed data and using
@@ -36,15 +43,21 @@ class BloomFilter {
   ~BloomFilter();
 
   // Returns whether this Bloom filter contains |str|.
-  bool Contains(const std::string& str) const;
+  bool Contains(base::StringPiece str) const;
+
+  // Returns whether this Bloom filter contains any of |strs|, such as the
+  // host suffixes of a URL.
+  bool ContainsAny(base::span<const base::StringPiece> strs) const;
 
   // Adds |str| to this Bloom filter.
-  void Add(const std::string& str);
+  void Add(base::StringPiece str);
 
   // Returns the bit array data of this Bloom filter as vector of bytes.
   const ByteVector& bytes() const { return bytes_; }
 
  private:
+  bool ContainsInternal(base::StringPiece str) const;
+
   // Number of bits to set for each added string.
   uint32_t num_hash_functions_;
 
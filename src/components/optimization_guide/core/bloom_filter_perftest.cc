@@ -0,0 +1,146 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "components/optimization_guide/core/bloom_filter.h"
+#include "components/optimization_guide/core/optimization_filter.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/smhasher/src/MurmurHash3.h"
+#include "url/gurl.h"
+
+namespace optimization_guide {
+
+namespace {
+
+constexpr char kMetricMedianLookupTimeNs[] = "median_lookup_time";
+
+// The shape of a server-provided filter: 10 bits and 7 hash functions per
+// host, for a false positive rate under 1%.
+constexpr size_t kNumHosts = 100000;
+constexpr uint32_t kNumHashFunctions = 7;
+constexpr uint32_t kNumBits = kNumHosts * 10;
+
+constexpr int kNumRuns = 5;
+
+std::string GetHost(size_t index) {
+  return base::StringPrintf("site%zu.example.com", index);
+}
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter("BloomFilter.", story_name);
+  reporter.RegisterImportantMetric(kMetricMedianLookupTimeNs, "ns");
+  return reporter;
+}
+
+// Runs |lookup| on each of |inputs| |kNumRuns| times, and reports the median
+// time per lookup.
+template <typename Input, typename Lookup>
+void RunLookupTest(const std::string& story_name,
+                   const std::vector<Input>& inputs,
+                   Lookup lookup) {
+  std::vector<double> results;
+  size_t num_matches = 0;
+  for (int i = 0; i < kNumRuns; ++i) {
+    base::ElapsedTimer timer;
+    for (const Input& input : inputs)
+      num_matches += lookup(input);
+    results.push_back(timer.Elapsed().InNanoseconds() /
+                      static_cast<double>(inputs.size()));
+  }
+  // Keeps the lookups from being optimized out.
+  EXPECT_GT(num_matches, 0u);
+
+  std::sort(results.begin(), results.end());
+  SetUpReporter(story_name)
+      .AddResult(kMetricMedianLookupTimeNs, results[kNumRuns / 2]);
+}
+
+}  // namespace
+
+class BloomFilterPerftest : public testing::Test {
+ public:
+  BloomFilterPerftest() = default;
+  BloomFilterPerftest(const BloomFilterPerftest&) = delete;
+  BloomFilterPerftest& operator=(const BloomFilterPerftest&) = delete;
+  ~BloomFilterPerftest() override = default;
+
+  void SetUp() override {
+    bloom_filter_ = CreateBloomFilter();
+    // Half of the hosts looked up are in the filter.
+    for (size_t i = 0; i < 2 * kNumHosts; i += 2)
+      hosts_.push_back(GetHost(i));
+  }
+
+  std::unique_ptr<BloomFilter> CreateBloomFilter() const {
+    auto bloom_filter =
+        std::make_unique<BloomFilter>(kNumHashFunctions, kNumBits);
+    for (size_t i = 0; i < kNumHosts; ++i)
+      bloom_filter->Add(GetHost(i));
+    return bloom_filter;
+  }
+
+  const BloomFilter& bloom_filter() const { return *bloom_filter_; }
+
+  const std::vector<std::string>& hosts() const { return hosts_; }
+
+ private:
+  std::unique_ptr<BloomFilter> bloom_filter_;
+  std::vector<std::string> hosts_;
+};
+
+// The cost of hashing each host once per hash function, as a reference for the
+// lookups below.
+TEST_F(BloomFilterPerftest, MurmurHash3PerHashFunction) {
+  RunLookupTest("MurmurHash3PerHashFunction", hosts(),
+                [](const std::string& host) {
+                  uint64_t bits = 0;
+                  for (uint32_t seed = 0; seed < kNumHashFunctions; ++seed) {
+                    uint64_t output[2];
+                    MurmurHash3_x64_128(host.data(), host.size(), seed,
+                                        &output);
+                    bits |= uint64_t{1} << (output[0] % 64);
+                  }
+                  return bits != 0;
+                });
+}
+
+TEST_F(BloomFilterPerftest, Contains) {
+  RunLookupTest("Contains", hosts(), [this](const std::string& host) {
+    return bloom_filter().Contains(host);
+  });
+}
+
+// Every lookup probes all the hash functions.
+TEST_F(BloomFilterPerftest, ContainsEverythingMatches) {
+  BloomFilter bloom_filter(kNumHashFunctions, kNumBits,
+                           std::string((kNumBits + 7) / 8, '\xff'));
+  RunLookupTest("ContainsEverythingMatches", hosts(),
+                [&bloom_filter](const std::string& host) {
+                  return bloom_filter.Contains(host);
+                });
+}
+
+// Matches URLs against a filter of host suffixes, as for each navigation.
+TEST_F(BloomFilterPerftest, OptimizationFilterMatches) {
+  OptimizationFilter optimization_filter(CreateBloomFilter(),
+                                         /*regexps=*/nullptr,
+                                         /*exclusion_regexps=*/nullptr,
+                                         /*skip_host_suffix_checking=*/false);
+  std::vector<GURL> urls;
+  for (const std::string& host : hosts())
+    urls.emplace_back("https://www.cdn." + host + "/path/to/page.html");
+  RunLookupTest("OptimizationFilterMatches", urls,
+                [&optimization_filter](const GURL& url) {
+                  return optimization_filter.Matches(url);
+                });
+}
+
+}  // namespace optimization_guide
@@ -7,8 +7,10 @@
 #include <stdint.h>
 #include <string>
 
+#include "base/strings/string_piece.h"
 #include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/smhasher/src/MurmurHash3.h"
 
 namespace optimization_guide {
 
@@ -102,6 +104,41 @@ TEST(BloomFilterTest, EverythingMatches) {
   EXPECT_TRUE(filter.Contains("Echo"));
 }
 
+TEST(BloomFilterTest, ContainsAny) {
+  BloomFilter filter(7 /* num_hash_functions */, 8191 /* num_bits */);
+  filter.Add("Bravo");
+
+  const base::StringPiece strs[] = {"Alfa", "Bravo", "Charlie"};
+  EXPECT_FALSE(filter.ContainsAny({}));
+  EXPECT_FALSE(filter.ContainsAny(base::make_span(strs, 1)));
+  EXPECT_TRUE(filter.ContainsAny(strs));
+  EXPECT_FALSE(filter.ContainsAny(base::make_span(strs + 2, 1)));
+}
+
+// The bits of a string must be the ones the server sets, from the first 64 bits
+// of MurmurHash3_x64_128, for strings of any length.
+TEST(BloomFilterTest, BitsMatchMurmurHash3) {
+  const uint32_t kNumHashFunctions = 11;
+  const uint32_t kNumBits = 65521;
+  std::string str;
+  for (int length = 0; length < 300; ++length) {
+    BloomFilter filter(kNumHashFunctions, kNumBits);
+    filter.Add(str);
+
+    ByteVector expected_bytes((kNumBits + 7) / 8, 0);
+    for (uint32_t seed = 0; seed < kNumHashFunctions; ++seed) {
+      uint64_t output[2];
+      MurmurHash3_x64_128(str.data(), str.size(), seed, &output);
+      const uint64_t n = output[0] % kNumBits;
+      expected_bytes[n / 8] |= 1 << (n % 8);
+    }
+    EXPECT_EQ(expected_bytes, filter.bytes()) << "length " << length;
+    EXPECT_TRUE(filter.Contains(str));
+
+    str.push_back(static_cast<char>('a' + length * 7 % 26));
+  }
+}
+
 // Disable this test in configurations that don't print CHECK failures.
 #if !defined(OS_IOS) && !(defined(OFFICIAL_BUILD) && defined(NDEBUG))
 TEST(BloomFilterTest, ByteVectorTooSmall) {
@@ -9,6 +9,7 @@
 #include "base/bind.h"
 #include "base/time/default_clock.h"
 #include "components/optimization_guide/core/hints_processing_util.h"
+#include "components/optimization_guide/core/host_hint_index.h"
 #include "components/optimization_guide/core/optimization_guide_features.h"
 #include "components/optimization_guide/core/store_update_data.h"
 #include "url/gurl.h"
@@ -59,6 +60,20 @@ std::unique_ptr<StoreUpdateData> HintCache::CreateUpdateDataForFetchedHints(
   return nullptr;
 }
 
+void HintCache::SetComponentHostHintIndex(
+    std::unique_ptr<HostHintIndex> component_host_hint_index) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  component_host_hint_index_ = std::move(component_host_hint_index);
+
+  // Unlike fetched hints, component hints do not have an expiry time.
+  for (auto it = host_keyed_cache_.begin(); it != host_keyed_cache_.end();) {
+    if (it->second && !it->second->expiry_time())
+      it = host_keyed_cache_.Erase(it);
+    else
+      ++it;
+  }
+}
+
 void HintCache::UpdateComponentHints(
     std::unique_ptr<StoreUpdateData> component_data,
     base::OnceClosure callback) {
@@ -160,6 +175,10 @@ bool HintCache::HasHint(const std::string& host) {
 
   auto hint_it = host_keyed_cache_.Get(host);
   if (hint_it == host_keyed_cache_.end()) {
+    if (component_host_hint_index_ &&
+        component_host_hint_index_->Contains(host)) {
+      return true;
+    }
     if (optimization_guide_store_) {
       // If not in-memory, check database.
       OptimizationGuideStore::EntryKey hint_entry_key;
@@ -185,8 +204,11 @@ void HintCache::LoadHint(const std::string& host, HintLoadedCallback callback) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   // Search for the entry key in the host-keyed cache; if it is not already
-  // there, then asynchronously load it from the store and return.
+  // there and not in the component index, then asynchronously load it from the
+  // store and return.
   auto hint_it = host_keyed_cache_.Get(host);
+  if (hint_it == host_keyed_cache_.end())
+    hint_it = MaybeLoadHintFromComponentIndex(host);
   if (hint_it == host_keyed_cache_.end()) {
     if (!optimization_guide_store_) {
       std::move(callback).Run(nullptr);
@@ -219,8 +241,11 @@ const proto::Hint* HintCache::GetHostKeyedHintIfLoaded(
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   // Find the hint within the host-keyed cache. It will only be available here
-  // if it has been loaded recently enough to be retained within the MRU cache.
+  // if it has been loaded recently enough to be retained within the MRU cache,
+  // or if it can be loaded from the component index.
   auto hint_it = host_keyed_cache_.Get(host);
+  if (hint_it == host_keyed_cache_.end())
+    hint_it = MaybeLoadHintFromComponentIndex(host);
   if (hint_it == host_keyed_cache_.end() || !hint_it->second)
     return nullptr;
 
@@ -324,6 +349,26 @@ void HintCache::OnLoadStoreHint(
   std::move(callback).Run(hint_it->second.get()->hint());
 }
 
+HintCache::HostKeyedHintCache::iterator
+HintCache::MaybeLoadHintFromComponentIndex(const std::string& host) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  if (!component_host_hint_index_ ||
+      !component_host_hint_index_->Contains(host)) {
+    return host_keyed_cache_.end();
+  }
+  if (optimization_guide_store_ &&
+      optimization_guide_store_->HasFetchedHintEntryKey(host)) {
+    return host_keyed_cache_.end();
+  }
+
+  std::unique_ptr<proto::Hint> hint = component_host_hint_index_->GetHint(host);
+  if (!hint)
+    return host_keyed_cache_.end();
+  return host_keyed_cache_.Put(
+      host, std::make_unique<MemoryHint>(absl::nullopt, std::move(hint)));
+}
+
 bool HintCache::ProcessAndCacheHints(
     google::protobuf::RepeatedPtrField<proto::Hint>* hints,
     optimization_guide::StoreUpdateData* update_data) {
@@ -332,6 +377,12 @@ bool HintCache::ProcessAndCacheHints(
     return false;
   }
 
+  // The host-keyed component hints are loaded from the component index on use,
+  // if there is one, rather than all copied into the host-keyed cache.
+  const bool has_indexed_host_keyed_hints =
+      component_host_hint_index_ && update_data &&
+      update_data->component_version().has_value();
+
   bool processed_hints_to_store = false;
   // Process each hint in the the hint configuration. The hints are mutable
   // because once processing is completed on each individual hint, it is moved
@@ -355,11 +406,13 @@ bool HintCache::ProcessAndCacheHints(
 
     switch (hint.key_representation()) {
       case proto::HOST:
-        host_keyed_cache_.Put(
-            hint_key,
-            std::make_unique<MemoryHint>(
-                expiry_time,
-                std::make_unique<optimization_guide::proto::Hint>(hint)));
+        if (!has_indexed_host_keyed_hints) {
+          host_keyed_cache_.Put(
+              hint_key,
+              std::make_unique<MemoryHint>(
+                  expiry_time,
+                  std::make_unique<optimization_guide::proto::Hint>(hint)));
+        }
         if (update_data)
           update_data->MoveHintIntoUpdateData(std::move(hint));
         processed_hints_to_store = true;
@@ -20,6 +20,7 @@
 class GURL;
 
 namespace optimization_guide {
+class HostHintIndex;
 class StoreUpdateData;
 
 using HintLoadedCallback = base::OnceCallback<void(const proto::Hint*)>;
@@ -30,7 +31,9 @@ using HintLoadedCallback = base::OnceCallback<void(const proto::Hint*)>;
 // via host name and full URL. The cache itself consists of a backing store,
 // which allows for asynchronous loading of any available host-keyed hint, and
 // an MRU host-keyed cache and a url-keyed cache, which can be used to
-// synchronously retrieve recently loaded hints keyed by URL or host.
+// synchronously retrieve recently loaded hints keyed by URL or host. If a host
+// index of the component hints is set, the host-keyed hints of the component
+// are instead synchronously loaded from it.
 class HintCache {
  public:
   // Construct the HintCache with an optional backing store and max host-keyed
@@ -64,6 +67,12 @@ class HintCache {
   std::unique_ptr<StoreUpdateData> CreateUpdateDataForFetchedHints(
       base::Time update_time) const;
 
+  // Sets the index of the host-keyed hints of the hints component, from which
+  // they are then synchronously loaded, unless the store has a fetched hint for
+  // the host. The component hints already in the host-keyed cache are evicted.
+  void SetComponentHostHintIndex(
+      std::unique_ptr<HostHintIndex> component_host_hint_index);
+
   // Updates the store's component data using the provided StoreUpdateData
   // and asynchronously runs the provided callback after the update finishes.
   void UpdateComponentHints(std::unique_ptr<StoreUpdateData> component_data,
@@ -108,8 +117,8 @@ class HintCache {
   // not initialized, base::Time() is returned.
   base::Time GetFetchedHintsUpdateTime() const;
 
-  // Returns the hint data for |host| if found in the host-keyed cache,
-  // otherwise nullptr.
+  // Returns the hint data for |host| if found in the host-keyed cache or the
+  // host index of the component hints, otherwise nullptr.
   const proto::Hint* GetHostKeyedHintIfLoaded(const std::string& host);
 
   // Returns an unepxired hint data for |url| if found in the url-keyed cache,
@@ -179,6 +188,13 @@ class HintCache {
       const OptimizationGuideStore::EntryKey& store_hint_entry_key,
       std::unique_ptr<MemoryHint> hint);
 
+  // Loads the hint for |host| from |component_host_hint_index_| into the
+  // host-keyed cache if the index has one, and the store does not have a
+  // fetched hint for |host|, which takes precedence. Returns the cached hint,
+  // or |host_keyed_cache_.end()| if none was loaded.
+  HostKeyedHintCache::iterator MaybeLoadHintFromComponentIndex(
+      const std::string& host);
+
   // The backing store used with this hint cache. Set during construction. Not
   // owned. Guaranteed to outlive |this|.
   OptimizationGuideStore* optimization_guide_store_;
@@ -196,6 +212,9 @@ class HintCache {
   // maintained within the cache and are not persisted to disk.
   URLKeyedHintCache url_keyed_hint_cache_;
 
+  // The index of the host-keyed hints of the hints component, if built.
+  std::unique_ptr<HostHintIndex> component_host_hint_index_;
+
   // The clock used to determine if hints have expired.
   const base::Clock* clock_;
 
@@ -5,6 +5,8 @@
 #include "components/optimization_guide/core/hint_cache.h"
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/files/scoped_temp_dir.h"
@@ -13,6 +15,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/test/metrics/histogram_tester.h"
 #include "base/test/task_environment.h"
+#include "components/optimization_guide/core/host_hint_index.h"
 #include "components/optimization_guide/core/optimization_guide_features.h"
 #include "components/optimization_guide/core/optimization_guide_store.h"
 #include "components/optimization_guide/core/proto_database_provider_test_base.h"
@@ -30,6 +33,21 @@ std::string GetHostDomainOrg(int index) {
   return "host.domain" + base::NumberToString(index) + ".org";
 }
 
+// Returns an index of host-keyed component hints, each with a single page hint
+// with the given page pattern.
+std::unique_ptr<HostHintIndex> CreateComponentHostHintIndex(
+    const std::vector<std::pair<std::string, std::string>>&
+        hosts_and_page_patterns) {
+  proto::Configuration config;
+  for (const auto& host_and_page_pattern : hosts_and_page_patterns) {
+    proto::Hint* hint = config.add_hints();
+    hint->set_key(host_and_page_pattern.first);
+    hint->set_key_representation(proto::HOST);
+    hint->add_page_hints()->set_page_pattern(host_and_page_pattern.second);
+  }
+  return HostHintIndex::Build(config.hints());
+}
+
 class HintCacheTest : public ProtoDatabaseProviderTestBase,
                       public testing::WithParamInterface<bool> {
  public:
@@ -1076,6 +1094,73 @@ TEST_P(HintCacheTest, RemoveHintsForHosts) {
   EXPECT_TRUE(hint_cache()->HasURLKeyedEntryForURL(url));
 }
 
+TEST_P(HintCacheTest, ComponentHostHintIndex) {
+  const int kMemoryCacheSize = 5;
+  CreateAndInitializeHintCache(kMemoryCacheSize);
+
+  hint_cache()->SetComponentHostHintIndex(CreateComponentHostHintIndex(
+      {{"host.domain.org", "v1"}, {"otherhost.domain.org", "v1"}}));
+
+  EXPECT_TRUE(hint_cache()->HasHint("host.domain.org"));
+  EXPECT_TRUE(hint_cache()->HasHint("otherhost.domain.org"));
+  EXPECT_FALSE(hint_cache()->HasHint("domain.org"));
+
+  // The hints are available without being loaded first.
+  const proto::Hint* hint =
+      hint_cache()->GetHostKeyedHintIfLoaded("host.domain.org");
+  ASSERT_TRUE(hint);
+  EXPECT_EQ("host.domain.org", hint->key());
+  EXPECT_EQ("v1", hint->page_hints(0).page_pattern());
+  EXPECT_FALSE(hint_cache()->GetHostKeyedHintIfLoaded("domain.org"));
+
+  LoadHint("otherhost.domain.org");
+  ASSERT_TRUE(GetLoadedHint());
+  EXPECT_EQ("otherhost.domain.org", GetLoadedHint()->key());
+  LoadHint("domain.org");
+  EXPECT_FALSE(GetLoadedHint());
+
+  // The hints of the previous component are not served from the host-keyed
+  // cache once a new index is set.
+  hint_cache()->SetComponentHostHintIndex(
+      CreateComponentHostHintIndex({{"host.domain.org", "v2"}}));
+  hint = hint_cache()->GetHostKeyedHintIfLoaded("host.domain.org");
+  ASSERT_TRUE(hint);
+  EXPECT_EQ("v2", hint->page_hints(0).page_pattern());
+  EXPECT_FALSE(hint_cache()->HasHint("otherhost.domain.org"));
+}
+
+TEST_P(HintCacheTest, FetchedHintPreferredOverComponentHostHintIndex) {
+  if (!IsBackedByPersistentStore())
+    return;
+
+  // With a single entry, loading any other hint evicts the fetched hint from
+  // the host-keyed cache.
+  const int kMemoryCacheSize = 1;
+  CreateAndInitializeHintCache(kMemoryCacheSize);
+
+  hint_cache()->SetComponentHostHintIndex(
+      CreateComponentHostHintIndex({{"host.domain.org", "component"},
+                                    {"otherhost.domain.org", "component"}}));
+
+  std::unique_ptr<proto::GetHintsResponse> get_hints_response =
+      std::make_unique<proto::GetHintsResponse>();
+  proto::Hint* fetched_hint = get_hints_response->add_hints();
+  fetched_hint->set_key_representation(proto::HOST);
+  fetched_hint->set_key("host.domain.org");
+  fetched_hint->add_page_hints()->set_page_pattern("fetched");
+  UpdateFetchedHintsAndWait(std::move(get_hints_response), base::Time().Now(),
+                            {"host.domain.org"}, {});
+
+  ASSERT_TRUE(hint_cache()->GetHostKeyedHintIfLoaded("otherhost.domain.org"));
+
+  // The fetched hint is loaded from the store, not from the index.
+  EXPECT_TRUE(hint_cache()->HasHint("host.domain.org"));
+  EXPECT_FALSE(hint_cache()->GetHostKeyedHintIfLoaded("host.domain.org"));
+  LoadHint("host.domain.org");
+  ASSERT_TRUE(GetLoadedHint());
+  EXPECT_EQ("fetched", GetLoadedHint()->page_hints(0).page_pattern());
+}
+
 }  // namespace
 
 }  // namespace optimization_guide
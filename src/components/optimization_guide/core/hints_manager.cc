@@ -27,6 +27,7 @@
 #include "components/optimization_guide/core/hints_component_util.h"
 #include "components/optimization_guide/core/hints_fetcher_factory.h"
 #include "components/optimization_guide/core/hints_processing_util.h"
+#include "components/optimization_guide/core/host_hint_index.h"
 #include "components/optimization_guide/core/insertion_ordered_set.h"
 #include "components/optimization_guide/core/optimization_filter.h"
 #include "components/optimization_guide/core/optimization_guide_constants.h"
@@ -243,10 +244,13 @@ bool ShouldIgnoreNewlyRegisteredOptimizationType(
   }
 }
 
-// Reads component file and parses it into a Configuration proto. Should not be
-// called on the UI thread.
+// Reads component file and parses it into a Configuration proto. If
+// |out_component_host_hint_index| is provided, it is populated with an index of
+// the host-keyed hints of the component. Should not be called on the UI thread.
 std::unique_ptr<optimization_guide::proto::Configuration> ReadComponentFile(
-    const optimization_guide::HintsComponentInfo& info) {
+    const optimization_guide::HintsComponentInfo& info,
+    std::unique_ptr<optimization_guide::HostHintIndex>*
+        out_component_host_hint_index) {
   optimization_guide::ProcessHintsComponentResult out_result;
   std::unique_ptr<optimization_guide::proto::Configuration> config =
       optimization_guide::ProcessHintsComponent(info, &out_result);
@@ -255,6 +259,11 @@ std::unique_ptr<optimization_guide::proto::Configuration> ReadComponentFile(
     return nullptr;
   }
 
+  if (out_component_host_hint_index) {
+    *out_component_host_hint_index =
+        optimization_guide::HostHintIndex::Build(config->hints());
+  }
+
   // Do not record the process hints component result for success cases until
   // we processed all of the hints and filters in it.
   return config;
@@ -383,12 +392,26 @@ void HintsManager::OnHintsComponentAvailable(
   // processing will be skipped.
   // base::Unretained(this) is safe since |this| owns |background_task_runner_|
   // and the callback will be canceled if destroyed.
+  //
+  // The host index of the component hints, if enabled, is built on the
+  // background thread as well, and owned by the reply until it is handed to
+  // the hint cache.
   is_processing_component_ = true;
+  auto component_host_hint_index =
+      std::make_unique<std::unique_ptr<optimization_guide::HostHintIndex>>();
+  std::unique_ptr<optimization_guide::HostHintIndex>*
+      out_component_host_hint_index =
+          optimization_guide::features::ShouldIndexComponentHintsByHost() &&
+                  !is_off_the_record_
+              ? component_host_hint_index.get()
+              : nullptr;
   background_task_runner_->PostTaskAndReplyWithResult(
-      FROM_HERE, base::BindOnce(&ReadComponentFile, info),
-      base::BindOnce(&HintsManager::UpdateComponentHints,
+      FROM_HERE,
+      base::BindOnce(&ReadComponentFile, info, out_component_host_hint_index),
+      base::BindOnce(&HintsManager::OnComponentFileRead,
                      weak_ptr_factory_.GetWeakPtr(),
-                     std::move(next_update_closure_), std::move(update_data)));
+                     std::move(next_update_closure_), std::move(update_data),
+                     base::Owned(std::move(component_host_hint_index))));
 
   // Only replace hints component info if it is not the same - otherwise we will
   // destruct the object and it will be invalid later.
@@ -502,6 +525,27 @@ void HintsManager::OnHintCacheInitialized() {
       ->AddObserver(this);
 }
 
+void HintsManager::OnComponentFileRead(
+    base::OnceClosure update_closure,
+    std::unique_ptr<optimization_guide::StoreUpdateData> update_data,
+    std::unique_ptr<optimization_guide::HostHintIndex>*
+        component_host_hint_index,
+    std::unique_ptr<optimization_guide::proto::Configuration> config) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  // The index of the previous component is replaced even if none could be
+  // built for this one, so that it does not shadow the new hints, which are
+  // then cached as they are processed.
+  if (config &&
+      optimization_guide::features::ShouldIndexComponentHintsByHost() &&
+      !is_off_the_record_) {
+    hint_cache_->SetComponentHostHintIndex(
+        std::move(*component_host_hint_index));
+  }
+  UpdateComponentHints(std::move(update_closure), std::move(update_data),
+                       std::move(config));
+}
+
 void HintsManager::UpdateComponentHints(
     base::OnceClosure update_closure,
     std::unique_ptr<optimization_guide::StoreUpdateData> update_data,
@@ -13,6 +13,7 @@
 #include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
 #include "base/containers/mru_cache.h"
+#include "base/gtest_prod_util.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequenced_task_runner.h"
@@ -38,6 +39,7 @@ class NetworkConnectionTracker;
 namespace optimization_guide {
 class HintCache;
 class HintsFetcherFactory;
+class HostHintIndex;
 class OptimizationFilter;
 class OptimizationMetadata;
 class OptimizationGuideStore;
@@ -188,6 +190,9 @@ class HintsManager : public OptimizationHintsComponentObserver,
       const absl::optional<optimization_guide::OptimizationMetadata>& metadata);
 
  private:
+  FRIEND_TEST_ALL_PREFIXES(HintsManagerTest,
+                           ComponentWithoutHostHintIndexReplacesIndex);
+
   // Processes the optimization filters contained in the hints component.
   void ProcessOptimizationFilters(
       const google::protobuf::RepeatedPtrField<
@@ -210,6 +215,16 @@ class HintsManager : public OptimizationHintsComponentObserver,
   // the HintsManager is ready to process hints.
   void OnHintCacheInitialized();
 
+  // Sets the host index of the component hints built along with reading
+  // |config|, which replaces that of the previous component even if it is
+  // null, then updates the cache with the hints in |config|.
+  void OnComponentFileRead(
+      base::OnceClosure update_closure,
+      std::unique_ptr<optimization_guide::StoreUpdateData> update_data,
+      std::unique_ptr<optimization_guide::HostHintIndex>*
+          component_host_hint_index,
+      std::unique_ptr<optimization_guide::proto::Configuration> config);
+
   // Updates the cache with the latest hints sent by the Component Updater.
   void UpdateComponentHints(
       base::OnceClosure update_closure,
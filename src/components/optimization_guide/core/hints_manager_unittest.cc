@@ -21,6 +21,7 @@
 #include "components/optimization_guide/core/hints_component_util.h"
 #include "components/optimization_guide/core/hints_fetcher.h"
 #include "components/optimization_guide/core/hints_fetcher_factory.h"
+#include "components/optimization_guide/core/host_hint_index.h"
 #include "components/optimization_guide/core/optimization_guide_constants.h"
 #include "components/optimization_guide/core/optimization_guide_enums.h"
 #include "components/optimization_guide/core/optimization_guide_features.h"
@@ -29,6 +30,7 @@
 #include "components/optimization_guide/core/optimization_guide_store.h"
 #include "components/optimization_guide/core/optimization_guide_switches.h"
 #include "components/optimization_guide/core/proto_database_provider_test_base.h"
+#include "components/optimization_guide/core/store_update_data.h"
 #include "components/optimization_guide/core/tab_url_provider.h"
 #include "components/optimization_guide/core/top_host_provider.h"
 #include "components/prefs/pref_registry_simple.h"
@@ -738,6 +740,40 @@ TEST_F(HintsManagerTest, ComponentInfoDidNotContainConfig) {
       optimization_guide::ProcessHintsComponentResult::kFailedReadingFile, 1);
 }
 
+TEST_F(HintsManagerTest, ComponentWithoutHostHintIndexReplacesIndex) {
+  base::test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitAndEnableFeature(
+      optimization_guide::features::kHostHintIndex);
+  InitializeWithDefaultConfig("1.0.0.0");
+  optimization_guide::HintCache* hint_cache = hints_manager()->hint_cache();
+  EXPECT_TRUE(hint_cache->GetHostKeyedHintIfLoaded("somedomain.org"));
+
+  // Process a newer component as if its index could not be built.
+  optimization_guide::proto::Configuration config;
+  optimization_guide::proto::Hint* hint = config.add_hints();
+  hint->set_key("otherdomain.org");
+  hint->set_key_representation(optimization_guide::proto::HOST);
+  hint->set_version("someversion");
+  hint->add_allowlisted_optimizations()->set_optimization_type(
+      optimization_guide::proto::NOSCRIPT);
+  std::unique_ptr<optimization_guide::StoreUpdateData> update_data =
+      hint_cache->MaybeCreateUpdateDataForComponentHints(
+          base::Version("2.0.0.0"));
+  ASSERT_TRUE(update_data);
+  std::unique_ptr<optimization_guide::HostHintIndex> component_host_hint_index;
+  base::RunLoop run_loop;
+  hints_manager()->OnComponentFileRead(
+      run_loop.QuitClosure(), std::move(update_data),
+      &component_host_hint_index,
+      std::make_unique<optimization_guide::proto::Configuration>(config));
+  run_loop.Run();
+
+  // The hints of the previous component are no longer served, and those of the
+  // new one are cached as they are processed.
+  EXPECT_FALSE(hint_cache->GetHostKeyedHintIfLoaded("somedomain.org"));
+  EXPECT_TRUE(hint_cache->GetHostKeyedHintIfLoaded("otherdomain.org"));
+}
+
 TEST_F(HintsManagerTest, ProcessHintsWithExistingPref) {
   // Write hints processing pref for version 2.0.0.
   pref_service()->SetString(
@@ -0,0 +1,168 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/optimization_guide/core/host_hint_index.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "base/check_op.h"
+#include "base/hash/hash.h"
+#include "base/memory/ptr_util.h"
+#include "base/memory/read_only_shared_memory_region.h"
+
+namespace optimization_guide {
+
+namespace {
+
+// The index is only used within the process that builds it, so the hash does
+// not need to be stable.
+uint32_t HashHost(base::StringPiece host) {
+  return static_cast<uint32_t>(base::FastHash(host));
+}
+
+}  // namespace
+
+HostHintIndex::HostHintIndex(base::ReadOnlySharedMemoryMapping mapping,
+                             size_t num_entries)
+    : mapping_(std::move(mapping)),
+      entries_(mapping_.GetMemoryAsSpan<Entry>(num_entries)) {
+  DCHECK_EQ(num_entries, entries_.size());
+}
+
+HostHintIndex::~HostHintIndex() = default;
+
+// static
+std::unique_ptr<HostHintIndex> HostHintIndex::Build(
+    const google::protobuf::RepeatedPtrField<proto::Hint>& hints) {
+  std::vector<std::pair<std::string, std::string>> serialized_hints;
+  serialized_hints.reserve(hints.size());
+  for (const proto::Hint& hint : hints) {
+    if (hint.key_representation() != proto::HOST || hint.key().empty())
+      continue;
+    if (hint.page_hints().empty() && hint.allowlisted_optimizations().empty())
+      continue;
+    serialized_hints.emplace_back(hint.key(), hint.SerializeAsString());
+  }
+  return BuildFromSerializedHints(serialized_hints);
+}
+
+// static
+std::unique_ptr<HostHintIndex> HostHintIndex::BuildFromSerializedHints(
+    const std::vector<std::pair<std::string, std::string>>& hints) {
+  struct PendingEntry {
+    uint32_t host_hash;
+    size_t index;
+  };
+  std::vector<PendingEntry> pending_entries;
+  pending_entries.reserve(hints.size());
+  for (size_t i = 0; i < hints.size(); ++i)
+    pending_entries.push_back({HashHost(hints[i].first), i});
+
+  // The sort is stable so that the last hint of a host ends its run of
+  // entries.
+  std::stable_sort(pending_entries.begin(), pending_entries.end(),
+                   [&hints](const PendingEntry& a, const PendingEntry& b) {
+                     if (a.host_hash != b.host_hash)
+                       return a.host_hash < b.host_hash;
+                     return hints[a.index].first < hints[b.index].first;
+                   });
+  std::vector<PendingEntry> unique_entries;
+  unique_entries.reserve(pending_entries.size());
+  for (size_t i = 0; i < pending_entries.size(); ++i) {
+    if (i + 1 < pending_entries.size() &&
+        hints[pending_entries[i].index].first ==
+            hints[pending_entries[i + 1].index].first) {
+      continue;
+    }
+    unique_entries.push_back(pending_entries[i]);
+  }
+
+  size_t total_size = unique_entries.size() * sizeof(Entry);
+  for (const PendingEntry& pending_entry : unique_entries) {
+    total_size += hints[pending_entry.index].first.size() +
+                  hints[pending_entry.index].second.size();
+  }
+  if (total_size > std::numeric_limits<uint32_t>::max())
+    return nullptr;
+
+  // Shared memory regions cannot be empty.
+  base::MappedReadOnlyRegion region =
+      base::ReadOnlySharedMemoryRegion::Create(std::max<size_t>(total_size, 1));
+  if (!region.IsValid())
+    return nullptr;
+
+  char* memory = static_cast<char*>(region.mapping.memory());
+  Entry* entries = reinterpret_cast<Entry*>(memory);
+  size_t offset = unique_entries.size() * sizeof(Entry);
+  for (size_t i = 0; i < unique_entries.size(); ++i) {
+    const std::string& host = hints[unique_entries[i].index].first;
+    const std::string& hint = hints[unique_entries[i].index].second;
+    entries[i] = {unique_entries[i].host_hash, static_cast<uint32_t>(offset),
+                  static_cast<uint32_t>(host.size()),
+                  static_cast<uint32_t>(hint.size())};
+    memcpy(memory + offset, host.data(), host.size());
+    offset += host.size();
+    memcpy(memory + offset, hint.data(), hint.size());
+    offset += hint.size();
+  }
+  DCHECK_EQ(total_size, offset);
+
+  // The writable mapping is released along with |region|, so that the index
+  // can no longer be modified.
+  base::ReadOnlySharedMemoryMapping mapping = region.region.Map();
+  if (!mapping.IsValid())
+    return nullptr;
+  return base::WrapUnique(
+      new HostHintIndex(std::move(mapping), unique_entries.size()));
+}
+
+bool HostHintIndex::Contains(base::StringPiece host) const {
+  return FindEntry(host) != nullptr;
+}
+
+base::StringPiece HostHintIndex::GetSerializedHint(
+    base::StringPiece host) const {
+  const Entry* entry = FindEntry(host);
+  if (!entry)
+    return base::StringPiece();
+  return base::StringPiece(
+      static_cast<const char*>(mapping_.memory()) + entry->offset +
+          entry->host_size,
+      entry->hint_size);
+}
+
+std::unique_ptr<proto::Hint> HostHintIndex::GetHint(
+    base::StringPiece host) const {
+  const Entry* entry = FindEntry(host);
+  if (!entry)
+    return nullptr;
+
+  auto hint = std::make_unique<proto::Hint>();
+  if (!hint->ParseFromArray(static_cast<const char*>(mapping_.memory()) +
+                                entry->offset + entry->host_size,
+                            entry->hint_size)) {
+    return nullptr;
+  }
+  return hint;
+}
+
+const HostHintIndex::Entry* HostHintIndex::FindEntry(
+    base::StringPiece host) const {
+  const uint32_t host_hash = HashHost(host);
+  auto it = std::lower_bound(entries_.begin(), entries_.end(), host_hash,
+                             [](const Entry& entry, uint32_t host_hash) {
+                               return entry.host_hash < host_hash;
+                             });
+  const char* memory = static_cast<const char*>(mapping_.memory());
+  for (; it != entries_.end() && it->host_hash == host_hash; ++it) {
+    if (base::StringPiece(memory + it->offset, it->host_size) == host)
+      return &*it;
+  }
+  return nullptr;
+}
+
+}  // namespace optimization_guide
@@ -0,0 +1,89 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COMPONENTS_OPTIMIZATION_GUIDE_CORE_HOST_HINT_INDEX_H_
+#define COMPONENTS_OPTIMIZATION_GUIDE_CORE_HOST_HINT_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/memory/shared_memory_mapping.h"
+#include "base/strings/string_piece.h"
+#include "components/optimization_guide/proto/hints.pb.h"
+
+namespace optimization_guide {
+
+// A read-only index of the host-keyed hints of the Optimization Hints
+// component, which makes their availability and contents synchronously
+// queryable without going through the OptimizationGuideStore.
+//
+// The hints are kept serialized, next to a table of their hosts sorted by
+// hash, in a single read-only memory mapping: looking up a host is a binary
+// search that does not allocate, and a hint is only parsed when it is used.
+// The index is built on a background sequence, when the component is
+// processed, and is then only read.
+class HostHintIndex {
+ public:
+  HostHintIndex(const HostHintIndex&) = delete;
+  HostHintIndex& operator=(const HostHintIndex&) = delete;
+  ~HostHintIndex();
+
+  // Builds an index of the host-keyed hints among |hints| that provide any
+  // optimization, as processed by HintCache::ProcessAndCacheHints(). If a host
+  // has several hints, the last one is kept. Returns nullptr if the memory for
+  // the index cannot be mapped.
+  static std::unique_ptr<HostHintIndex> Build(
+      const google::protobuf::RepeatedPtrField<proto::Hint>& hints);
+
+  // Builds an index of the given host and serialized hint pairs. If a host has
+  // several hints, the last one is kept. Returns nullptr if the memory for the
+  // index cannot be mapped.
+  static std::unique_ptr<HostHintIndex> BuildFromSerializedHints(
+      const std::vector<std::pair<std::string, std::string>>& hints);
+
+  // Returns whether the index has a hint for |host|.
+  bool Contains(base::StringPiece host) const;
+
+  // Returns the serialized hint for |host|, which points into the index, or an
+  // empty StringPiece if there is none.
+  base::StringPiece GetSerializedHint(base::StringPiece host) const;
+
+  // Parses and returns the hint for |host|, or nullptr if there is none or it
+  // cannot be parsed.
+  std::unique_ptr<proto::Hint> GetHint(base::StringPiece host) const;
+
+  // Returns the number of hosts in the index.
+  size_t size() const { return entries_.size(); }
+
+  // Returns the number of bytes mapped by the index.
+  size_t memory_size() const { return mapping_.size(); }
+
+ private:
+  // An entry of the host table. |offset| is the offset in the mapping of the
+  // host, which is immediately followed by the serialized hint.
+  struct Entry {
+    uint32_t host_hash;
+    uint32_t offset;
+    uint32_t host_size;
+    uint32_t hint_size;
+  };
+
+  HostHintIndex(base::ReadOnlySharedMemoryMapping mapping, size_t num_entries);
+
+  const Entry* FindEntry(base::StringPiece host) const;
+
+  base::ReadOnlySharedMemoryMapping mapping_;
+  // The host table at the start of |mapping_|, sorted by hash then host.
+  base::span<const Entry> entries_;
+};
+
+}  // namespace optimization_guide
+
+#endif  // COMPONENTS_OPTIMIZATION_GUIDE_CORE_HOST_HINT_INDEX_H_
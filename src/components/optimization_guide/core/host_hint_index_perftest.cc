@@ -0,0 +1,162 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/flat_set.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
+#include "components/optimization_guide/core/host_hint_index.h"
+#include "components/optimization_guide/proto/hints.pb.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace optimization_guide {
+
+namespace {
+
+constexpr char kMetricMedianLookupTimeNs[] = "median_lookup_time";
+constexpr char kMetricBuildTimeMs[] = "build_time";
+constexpr char kMetricMemorySizeBytes[] = "memory_size";
+
+// The number of hosts of a large Optimization Hints component.
+constexpr size_t kNumHosts = 100000;
+
+constexpr int kNumRuns = 5;
+
+// The prefixes of the entry keys of the fetched and component hints in the
+// OptimizationGuideStore, which keeps all of its entry keys in memory.
+constexpr char kFetchedHintEntryKeyPrefix[] = "3_";
+constexpr char kComponentHintEntryKeyPrefix[] = "2_1.0.0_";
+
+std::string GetHost(size_t index) {
+  return base::StringPrintf("site%zu.example.com", index);
+}
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter("HostHintIndex.", story_name);
+  reporter.RegisterImportantMetric(kMetricMedianLookupTimeNs, "ns");
+  reporter.RegisterImportantMetric(kMetricBuildTimeMs, "ms");
+  reporter.RegisterImportantMetric(kMetricMemorySizeBytes, "bytes");
+  return reporter;
+}
+
+// Runs |lookup| on each of |hosts| |kNumRuns| times, and reports the median
+// time per lookup.
+template <typename Lookup>
+void RunLookupTest(const std::string& story_name,
+                   const std::vector<std::string>& hosts,
+                   Lookup lookup) {
+  std::vector<double> results;
+  size_t num_matches = 0;
+  for (int i = 0; i < kNumRuns; ++i) {
+    base::ElapsedTimer timer;
+    for (const std::string& host : hosts)
+      num_matches += lookup(host);
+    results.push_back(timer.Elapsed().InNanoseconds() /
+                      static_cast<double>(hosts.size()));
+  }
+  // Keeps the lookups from being optimized out.
+  EXPECT_GT(num_matches, 0u);
+
+  std::sort(results.begin(), results.end());
+  SetUpReporter(story_name)
+      .AddResult(kMetricMedianLookupTimeNs, results[kNumRuns / 2]);
+}
+
+}  // namespace
+
+class HostHintIndexPerftest : public testing::Test {
+ public:
+  HostHintIndexPerftest() = default;
+  HostHintIndexPerftest(const HostHintIndexPerftest&) = delete;
+  HostHintIndexPerftest& operator=(const HostHintIndexPerftest&) = delete;
+  ~HostHintIndexPerftest() override = default;
+
+  void SetUp() override {
+    for (size_t i = 0; i < kNumHosts; ++i) {
+      proto::Hint* hint = hints_.Add();
+      hint->set_key(GetHost(i));
+      hint->set_key_representation(proto::HOST);
+      hint->set_version("someversion");
+      for (int j = 0; j < 2; ++j) {
+        proto::PageHint* page_hint = hint->add_page_hints();
+        page_hint->set_page_pattern(base::StringPrintf("/path%d/*", j));
+        page_hint->add_allowlisted_optimizations()->set_optimization_type(
+            proto::NOSCRIPT);
+        page_hint->add_allowlisted_optimizations()->set_optimization_type(
+            proto::DEFER_ALL_SCRIPT);
+      }
+    }
+
+    base::ElapsedTimer timer;
+    host_hint_index_ = HostHintIndex::Build(hints_);
+    build_time_ = timer.Elapsed();
+    ASSERT_TRUE(host_hint_index_);
+    ASSERT_EQ(kNumHosts, host_hint_index_->size());
+
+    // Half of the hosts looked up have a hint.
+    for (size_t i = 0; i < 2 * kNumHosts; i += 2)
+      hosts_.push_back(GetHost(i));
+  }
+
+  const google::protobuf::RepeatedPtrField<proto::Hint>& hints() const {
+    return hints_;
+  }
+
+  const HostHintIndex& host_hint_index() const { return *host_hint_index_; }
+
+  base::TimeDelta build_time() const { return build_time_; }
+
+  const std::vector<std::string>& hosts() const { return hosts_; }
+
+ private:
+  google::protobuf::RepeatedPtrField<proto::Hint> hints_;
+  std::unique_ptr<HostHintIndex> host_hint_index_;
+  base::TimeDelta build_time_;
+  std::vector<std::string> hosts_;
+};
+
+TEST_F(HostHintIndexPerftest, Build) {
+  auto reporter = SetUpReporter("Build");
+  reporter.AddResult(kMetricBuildTimeMs, build_time().InMillisecondsF());
+  reporter.AddResult(kMetricMemorySizeBytes, host_hint_index().memory_size());
+}
+
+TEST_F(HostHintIndexPerftest, Contains) {
+  RunLookupTest("Contains", hosts(), [this](const std::string& host) {
+    return host_hint_index().Contains(host);
+  });
+}
+
+// Looking up a hint includes parsing it, as done when it is loaded into the
+// HintCache.
+TEST_F(HostHintIndexPerftest, GetHint) {
+  RunLookupTest("GetHint", hosts(), [this](const std::string& host) {
+    return host_hint_index().GetHint(host) != nullptr;
+  });
+}
+
+// The lookup of a host among the entry keys of the store, as done by
+// OptimizationGuideStore::FindHintEntryKey() without the index, for reference.
+TEST_F(HostHintIndexPerftest, EntryKeySetFind) {
+  std::vector<std::string> entry_keys;
+  entry_keys.reserve(hints().size());
+  for (const proto::Hint& hint : hints())
+    entry_keys.push_back(kComponentHintEntryKeyPrefix + hint.key());
+  base::flat_set<std::string> entry_key_set(std::move(entry_keys));
+
+  RunLookupTest(
+      "EntryKeySetFind", hosts(), [&entry_key_set](const std::string& host) {
+        return entry_key_set.contains(kFetchedHintEntryKeyPrefix + host) ||
+               entry_key_set.contains(kComponentHintEntryKeyPrefix + host);
+      });
+}
+
+}  // namespace optimization_guide
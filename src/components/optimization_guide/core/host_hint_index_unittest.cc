@@ -0,0 +1,101 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/optimization_guide/core/host_hint_index.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "components/optimization_guide/proto/hints.pb.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace optimization_guide {
+namespace {
+
+proto::Hint* AddHint(proto::Configuration* config,
+                     const std::string& key,
+                     proto::KeyRepresentation key_representation) {
+  proto::Hint* hint = config->add_hints();
+  hint->set_key(key);
+  hint->set_key_representation(key_representation);
+  return hint;
+}
+
+TEST(HostHintIndexTest, Empty) {
+  proto::Configuration config;
+  std::unique_ptr<HostHintIndex> index = HostHintIndex::Build(config.hints());
+  ASSERT_TRUE(index);
+  EXPECT_EQ(0u, index->size());
+  EXPECT_FALSE(index->Contains("host.domain.org"));
+  EXPECT_FALSE(index->GetHint("host.domain.org"));
+  EXPECT_TRUE(index->GetSerializedHint("host.domain.org").empty());
+}
+
+TEST(HostHintIndexTest, OnlyIndexesHostKeyedHintsWithOptimizations) {
+  proto::Configuration config;
+  AddHint(&config, "host.domain.org", proto::HOST)
+      ->add_page_hints()
+      ->set_page_pattern("page pattern");
+  AddHint(&config, "allowlisted.domain.org", proto::HOST)
+      ->add_allowlisted_optimizations()
+      ->set_optimization_type(proto::PERFORMANCE_HINTS);
+  AddHint(&config, "empty.domain.org", proto::HOST);
+  AddHint(&config, "https://url.domain.org/", proto::FULL_URL)
+      ->add_page_hints()
+      ->set_page_pattern("page pattern");
+
+  std::unique_ptr<HostHintIndex> index = HostHintIndex::Build(config.hints());
+  ASSERT_TRUE(index);
+  EXPECT_EQ(2u, index->size());
+  EXPECT_TRUE(index->Contains("host.domain.org"));
+  EXPECT_TRUE(index->Contains("allowlisted.domain.org"));
+  EXPECT_FALSE(index->Contains("empty.domain.org"));
+  EXPECT_FALSE(index->Contains("https://url.domain.org/"));
+  EXPECT_FALSE(index->Contains("domain.org"));
+
+  std::unique_ptr<proto::Hint> hint = index->GetHint("host.domain.org");
+  ASSERT_TRUE(hint);
+  EXPECT_EQ("host.domain.org", hint->key());
+  ASSERT_EQ(1, hint->page_hints_size());
+  EXPECT_EQ("page pattern", hint->page_hints(0).page_pattern());
+  EXPECT_EQ(config.hints(0).SerializeAsString(),
+            index->GetSerializedHint("host.domain.org"));
+}
+
+TEST(HostHintIndexTest, LastHintOfHostKept) {
+  std::unique_ptr<HostHintIndex> index =
+      HostHintIndex::BuildFromSerializedHints({{"host.domain.org", "first"},
+                                               {"other.domain.org", "other"},
+                                               {"host.domain.org", "last"}});
+  ASSERT_TRUE(index);
+  EXPECT_EQ(2u, index->size());
+  EXPECT_EQ("last", index->GetSerializedHint("host.domain.org"));
+  EXPECT_EQ("other", index->GetSerializedHint("other.domain.org"));
+}
+
+TEST(HostHintIndexTest, ManyHosts) {
+  const int kHostCount = 10000;
+  std::vector<std::pair<std::string, std::string>> hints;
+  for (int i = 0; i < kHostCount; ++i) {
+    hints.emplace_back("host" + base::NumberToString(i) + ".org",
+                       "hint" + base::NumberToString(i));
+  }
+  std::unique_ptr<HostHintIndex> index =
+      HostHintIndex::BuildFromSerializedHints(hints);
+  ASSERT_TRUE(index);
+  EXPECT_EQ(static_cast<size_t>(kHostCount), index->size());
+
+  for (int i = 0; i < kHostCount; ++i) {
+    EXPECT_EQ("hint" + base::NumberToString(i),
+              index->GetSerializedHint("host" + base::NumberToString(i) +
+                                       ".org"));
+  }
+  for (int i = kHostCount; i < 2 * kHostCount; ++i)
+    EXPECT_FALSE(index->Contains("host" + base::NumberToString(i) + ".org"));
+}
+
+}  // namespace
+}  // namespace optimization_guide
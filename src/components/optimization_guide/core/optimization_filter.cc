@@ -6,6 +6,8 @@
 
 #include <string>
 
+#include "base/containers/span.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 
 namespace optimization_guide {
@@ -65,30 +67,27 @@ bool OptimizationFilter::ContainsHostSuffix(const GURL& url) const {
   if (!bloom_filter_)
     return false;
 
-  // First check full host name.
-  if (bloom_filter_->Contains(url.host()))
-    return true;
+  // The full host name is checked first, then its suffixes. The candidates
+  // point into the host of |url|, so that none of them is copied.
+  base::StringPiece candidates[kMaxSuffixCount];
+  const base::StringPiece full_host = url.host_piece();
+  candidates[0] = full_host;
+  int suffix_count = 1;
 
   // Do not check host suffixes if we are told to skip host suffix checking.
-  if (skip_host_suffix_checking_)
-    return false;
-
-  // Now check host suffixes from shortest to longest but skipping the
+  // Otherwise, check host suffixes from shortest to longest but skipping the
   // root domain (eg, skipping "com", "org", "in", "uk").
-  std::string full_host(url.host());
-  int suffix_count = 1;
-  auto left_pos = full_host.find_last_of('.');  // root domain position
-  while ((left_pos = full_host.find_last_of('.', left_pos - 1)) !=
-             std::string::npos &&
-         suffix_count < kMaxSuffixCount) {
-    if (full_host.length() - left_pos > kMinHostSuffix) {
-      std::string suffix = full_host.substr(left_pos + 1);
-      suffix_count++;
-      if (bloom_filter_->Contains(suffix))
-        return true;
+  if (!skip_host_suffix_checking_) {
+    auto left_pos = full_host.find_last_of('.');  // root domain position
+    while ((left_pos = full_host.find_last_of('.', left_pos - 1)) !=
+               base::StringPiece::npos &&
+           suffix_count < kMaxSuffixCount) {
+      if (full_host.length() - left_pos > kMinHostSuffix)
+        candidates[suffix_count++] = full_host.substr(left_pos + 1);
     }
   }
-  return false;
+  return bloom_filter_->ContainsAny(
+      base::make_span(candidates, static_cast<size_t>(suffix_count)));
 }
 
 }  // namespace optimization_guide
@@ -84,6 +84,11 @@ const base::Feature kPageTextExtraction{
 const base::Feature kLoadModelFileForEachExecution{
     "LoadModelFileForEachExecution", base::FEATURE_ENABLED_BY_DEFAULT};
 
+// Enables the in-memory index of the host-keyed hints of the hints component,
+// which serves them synchronously instead of loading them from the store.
+const base::Feature kHostHintIndex{"OptimizationGuideHostHintIndex",
+                                   base::FEATURE_DISABLED_BY_DEFAULT};
+
 // The default value here is a bit of a guess.
 // TODO(crbug/1163244): This should be tuned once metrics are available.
 base::TimeDelta PageTextExtractionOutstandingRequestsGracePeriod() {
@@ -184,6 +189,10 @@ bool IsPushNotificationsEnabled() {
   return base::FeatureList::IsEnabled(kPushNotifications);
 }
 
+bool ShouldIndexComponentHintsByHost() {
+  return base::FeatureList::IsEnabled(kHostHintIndex);
+}
+
 bool IsRemoteFetchingForAnonymousDataConsentEnabled() {
   return base::FeatureList::IsEnabled(
       kRemoteOptimizationGuideFetchingAnonymousDataConsent);
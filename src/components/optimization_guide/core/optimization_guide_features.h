@@ -32,6 +32,7 @@ extern const base::Feature kPageContentAnnotations;
 extern const base::Feature kPageTextExtraction;
 extern const base::Feature kLoadModelFileForEachExecution;
 extern const base::Feature kPushNotifications;
+extern const base::Feature kHostHintIndex;
 
 // The grace period duration for how long to give outstanding page text dump
 // requests to respond after DidFinishLoad.
@@ -84,6 +85,10 @@ bool IsRemoteFetchingExplicitlyAllowedForPerformanceInfo();
 // Returns true if the feature to use push notifications is enabled.
 bool IsPushNotificationsEnabled();
 
+// Returns true if the host-keyed hints of the hints component should be served
+// from a HostHintIndex built when the component is processed.
+bool ShouldIndexComponentHintsByHost();
+
 // The maximum data byte size for a server-provided bloom filter. This is
 // a client-side safety limit for RAM use in case server sends too large of
 // a bloom filter.
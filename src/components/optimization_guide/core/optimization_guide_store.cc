@@ -419,6 +419,15 @@ bool OptimizationGuideStore::FindHintEntryKey(
   return false;
 }
 
+bool OptimizationGuideStore::HasFetchedHintEntryKey(
+    const std::string& host) const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  EntryKey hint_entry_key;
+  return FindEntryKeyForHostWithPrefix(host, &hint_entry_key,
+                                       GetFetchedHintEntryKeyPrefix());
+}
+
 bool OptimizationGuideStore::FindEntryKeyForHostWithPrefix(
     const std::string& host,
     EntryKey* out_entry_key,
@@ -153,6 +153,9 @@ class OptimizationGuideStore {
   bool FindHintEntryKey(const std::string& host,
                         EntryKey* out_hint_entry_key) const;
 
+  // Returns whether the store has a kFetched hint entry key for |host|.
+  bool HasFetchedHintEntryKey(const std::string& host) const;
+
   // Loads the hint specified by |hint_entry_key|.
   // After the load finishes, the hint data is passed to |callback|. In the case
   // where the hint cannot be loaded, the callback is run with a nullptr.
@@ -0,0 +1,158 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/safe_browsing/core/browser/db/hash_prefix_index.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "base/big_endian.h"
+#include "base/check_op.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+namespace safe_browsing {
+
+namespace {
+
+// The 4-byte prefixes are bucketed so that a bucket holds at most this many
+// prefixes on average, which span a single cache line.
+constexpr size_t kTargetBucketSize = 16;
+// Caps the size of the bucket table, to 4 MiB.
+constexpr size_t kMaxBucketBits = 20;
+
+uint32_t ReadLeadingKey(const char* prefix) {
+  uint32_t key;
+  base::ReadBigEndian(prefix, &key);
+  return key;
+}
+
+size_t GetBucket(uint32_t key, size_t bucket_bits) {
+  return bucket_bits ? key >> (32 - bucket_bits) : 0;
+}
+
+}  // namespace
+
+HashPrefixIndex::LongerPrefixes::LongerPrefixes(PrefixSize prefix_size,
+                                                base::StringPiece prefixes)
+    : prefix_size(prefix_size), prefixes(prefixes) {
+  const size_t count = prefixes.size() / prefix_size;
+  leading_keys.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    leading_keys.push_back(ReadLeadingKey(prefixes.data() + i * prefix_size));
+}
+
+HashPrefixIndex::LongerPrefixes::LongerPrefixes(LongerPrefixes&& other) =
+    default;
+
+HashPrefixIndex::LongerPrefixes& HashPrefixIndex::LongerPrefixes::operator=(
+    LongerPrefixes&& other) = default;
+
+HashPrefixIndex::LongerPrefixes::~LongerPrefixes() = default;
+
+HashPrefixIndex::HashPrefixIndex() = default;
+
+HashPrefixIndex::~HashPrefixIndex() = default;
+
+void HashPrefixIndex::AddHashPrefixes(PrefixSize prefix_size,
+                                      base::StringPiece prefixes) {
+  DCHECK_GE(prefix_size, kMinHashPrefixLength);
+  DCHECK_LE(prefix_size, kMaxHashPrefixLength);
+  DCHECK_EQ(0u, prefixes.size() % prefix_size);
+  const size_t count = prefixes.size() / prefix_size;
+  CHECK_LE(count, std::numeric_limits<uint32_t>::max());
+
+  if (prefix_size != kMinHashPrefixLength) {
+    DCHECK(std::none_of(longer_prefixes_.begin(), longer_prefixes_.end(),
+                        [prefix_size](const LongerPrefixes& longer) {
+                          return longer.prefix_size == prefix_size;
+                        }));
+    longer_prefixes_.emplace_back(prefix_size, prefixes);
+    return;
+  }
+
+  DCHECK(bucket_offsets_.empty());
+  prefixes_ = prefixes;
+  bucket_bits_ = 0;
+  while (bucket_bits_ < kMaxBucketBits &&
+         (count >> bucket_bits_) > kTargetBucketSize) {
+    ++bucket_bits_;
+  }
+
+  // Count the prefixes of each bucket, then turn the counts into offsets.
+  // Unlike relying on the order of the prefixes, this keeps every offset in
+  // bounds even if they are not sorted.
+  bucket_offsets_.assign((size_t{1} << bucket_bits_) + 1, 0);
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t key = ReadLeadingKey(prefixes.data() + i * prefix_size);
+    ++bucket_offsets_[GetBucket(key, bucket_bits_) + 1];
+  }
+  for (size_t i = 1; i < bucket_offsets_.size(); ++i)
+    bucket_offsets_[i] += bucket_offsets_[i - 1];
+}
+
+base::StringPiece HashPrefixIndex::GetMatchingHashPrefix(
+    base::StringPiece full_hash) const {
+  DCHECK_GE(full_hash.size(), kMinHashPrefixLength);
+  if (Contains4BytePrefix(full_hash))
+    return full_hash.substr(0, kMinHashPrefixLength);
+
+  const uint32_t key = ReadLeadingKey(full_hash.data());
+  for (const LongerPrefixes& longer : longer_prefixes_) {
+    if (longer.prefix_size > full_hash.size())
+      continue;
+    const base::StringPiece hash_prefix =
+        full_hash.substr(0, longer.prefix_size);
+    auto range = std::equal_range(longer.leading_keys.begin(),
+                                  longer.leading_keys.end(), key);
+    for (auto it = range.first; it != range.second; ++it) {
+      const size_t index = it - longer.leading_keys.begin();
+      if (longer.prefixes.substr(index * longer.prefix_size,
+                                 longer.prefix_size) == hash_prefix) {
+        return hash_prefix;
+      }
+    }
+  }
+  return base::StringPiece();
+}
+
+bool HashPrefixIndex::Contains4BytePrefix(base::StringPiece full_hash) const {
+  if (bucket_offsets_.empty())
+    return false;
+
+  const size_t bucket =
+      GetBucket(ReadLeadingKey(full_hash.data()), bucket_bits_);
+  size_t i = bucket_offsets_[bucket];
+  const size_t end = bucket_offsets_[bucket + 1];
+
+  // Only equality matters within a bucket, so the prefixes are compared as
+  // raw bytes, without converting them to integers.
+  uint32_t needle;
+  memcpy(&needle, full_hash.data(), kMinHashPrefixLength);
+  const char* data = prefixes_.data();
+#if defined(ARCH_CPU_X86_FAMILY)
+  const __m128i needles = _mm_set1_epi32(static_cast<int32_t>(needle));
+  for (; i + 4 <= end; i += 4) {
+    const __m128i candidates = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + i * kMinHashPrefixLength));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(candidates, needles)))
+      return true;
+  }
+#endif
+  for (; i < end; ++i) {
+    if (!memcmp(data + i * kMinHashPrefixLength, &needle,
+                kMinHashPrefixLength)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace safe_browsing
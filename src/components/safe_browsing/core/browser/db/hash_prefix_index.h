@@ -0,0 +1,74 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COMPONENTS_SAFE_BROWSING_CORE_BROWSER_DB_HASH_PREFIX_INDEX_H_
+#define COMPONENTS_SAFE_BROWSING_CORE_BROWSER_DB_HASH_PREFIX_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/strings/string_piece.h"
+#include "components/safe_browsing/core/browser/db/v4_protocol_manager_util.h"
+
+namespace safe_browsing {
+
+// An index over the sorted hash prefixes of a store, to look up a full hash
+// faster than by binary searching the prefixes of each size.
+//
+// The 4-byte prefixes, which make up nearly all of a list, are bucketed by
+// their leading bits. Since they are sorted, the prefixes of a bucket are
+// contiguous and only the offset of each bucket is stored, so a lookup is one
+// load from the bucket table then a (SIMD) scan of a few prefixes. The longer
+// prefixes are looked up by binary search in a dense table of their leading 4
+// bytes, instead of in the strided prefixes.
+//
+// The index does not copy the prefixes, which must outlive it unchanged.
+class HashPrefixIndex {
+ public:
+  HashPrefixIndex();
+  HashPrefixIndex(const HashPrefixIndex&) = delete;
+  HashPrefixIndex& operator=(const HashPrefixIndex&) = delete;
+  ~HashPrefixIndex();
+
+  // Adds the lexicographically sorted |prefixes|, each of |prefix_size|
+  // bytes, to the index. Each prefix size must only be added once.
+  void AddHashPrefixes(PrefixSize prefix_size, base::StringPiece prefixes);
+
+  // Returns the prefix of |full_hash| that is in the index, if any; an empty
+  // StringPiece otherwise.
+  base::StringPiece GetMatchingHashPrefix(base::StringPiece full_hash) const;
+
+  // Returns the number of bits of the 4-byte prefixes used to bucket them.
+  size_t bucket_bits_for_testing() const { return bucket_bits_; }
+
+ private:
+  struct LongerPrefixes {
+    LongerPrefixes(PrefixSize prefix_size, base::StringPiece prefixes);
+    LongerPrefixes(LongerPrefixes&& other);
+    LongerPrefixes& operator=(LongerPrefixes&& other);
+    ~LongerPrefixes();
+
+    PrefixSize prefix_size;
+    base::StringPiece prefixes;
+    // The leading 4 bytes of each prefix, as big-endian integers.
+    std::vector<uint32_t> leading_keys;
+  };
+
+  bool Contains4BytePrefix(base::StringPiece full_hash) const;
+
+  // The 4-byte prefixes.
+  base::StringPiece prefixes_;
+  size_t bucket_bits_ = 0;
+  // The index in |prefixes_| of the first prefix of each bucket, followed by
+  // the number of prefixes.
+  std::vector<uint32_t> bucket_offsets_;
+
+  std::vector<LongerPrefixes> longer_prefixes_;
+};
+
+}  // namespace safe_browsing
+
+#endif  // COMPONENTS_SAFE_BROWSING_CORE_BROWSER_DB_HASH_PREFIX_INDEX_H_
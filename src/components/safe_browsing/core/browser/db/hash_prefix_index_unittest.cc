@@ -0,0 +1,89 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/safe_browsing/core/browser/db/hash_prefix_index.h"
+
+#include <set>
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "crypto/sha2.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace safe_browsing {
+
+TEST(HashPrefixIndexTest, Empty) {
+  HashPrefixIndex index;
+  EXPECT_TRUE(
+      index.GetMatchingHashPrefix("22222222222222222222222222222222").empty());
+
+  index.AddHashPrefixes(4, "");
+  EXPECT_EQ(0u, index.bucket_bits_for_testing());
+  EXPECT_TRUE(
+      index.GetMatchingHashPrefix("22222222222222222222222222222222").empty());
+}
+
+TEST(HashPrefixIndexTest, SmallList) {
+  HashPrefixIndex index;
+  index.AddHashPrefixes(4, "22223333aaaa");
+  EXPECT_EQ(0u, index.bucket_bits_for_testing());
+
+  EXPECT_EQ("2222",
+            index.GetMatchingHashPrefix("22222222222222222222222222222222"));
+  EXPECT_EQ("aaaa",
+            index.GetMatchingHashPrefix("aaaa2222222222222222222222222222"));
+  EXPECT_TRUE(
+      index.GetMatchingHashPrefix("22232222222222222222222222222222").empty());
+}
+
+TEST(HashPrefixIndexTest, LargeList) {
+  // Uniformly distributed prefixes, as in the lists.
+  std::set<std::string> prefix_set;
+  for (int i = 0; i < 100000; i++) {
+    prefix_set.insert(crypto::SHA256HashString(base::NumberToString(i))
+                          .substr(0, kMinHashPrefixLength));
+  }
+  std::string prefixes;
+  for (const std::string& prefix : prefix_set)
+    prefixes += prefix;
+
+  HashPrefixIndex index;
+  index.AddHashPrefixes(kMinHashPrefixLength, prefixes);
+  EXPECT_LT(0u, index.bucket_bits_for_testing());
+
+  for (int i = 0; i < 200000; i++) {
+    const std::string full_hash =
+        crypto::SHA256HashString(base::NumberToString(i));
+    const std::string prefix = full_hash.substr(0, kMinHashPrefixLength);
+    if (prefix_set.count(prefix))
+      EXPECT_EQ(prefix, index.GetMatchingHashPrefix(full_hash));
+    else
+      EXPECT_TRUE(index.GetMatchingHashPrefix(full_hash).empty());
+  }
+}
+
+TEST(HashPrefixIndexTest, LongerPrefixes) {
+  HashPrefixIndex index;
+  index.AddHashPrefixes(4, "3333");
+  // The first two prefixes have the same leading 4 bytes.
+  index.AddHashPrefixes(8, "11112222111133332222bbbb");
+  index.AddHashPrefixes(32, "11112222333344445555666677778888");
+
+  EXPECT_EQ("3333",
+            index.GetMatchingHashPrefix("33332222333344445555666677778888"));
+  EXPECT_EQ("11112222",
+            index.GetMatchingHashPrefix("11112222333344445555666677779999"));
+  EXPECT_EQ("11113333",
+            index.GetMatchingHashPrefix("11113333333344445555666677778888"));
+  EXPECT_EQ("2222bbbb",
+            index.GetMatchingHashPrefix("2222bbbb333344445555666677778888"));
+  EXPECT_EQ("11112222333344445555666677778888",
+            index.GetMatchingHashPrefix("11112222333344445555666677778888"));
+  EXPECT_TRUE(
+      index.GetMatchingHashPrefix("11114444333344445555666677778888").empty());
+  // The 32-byte prefix does not match a 21-byte full hash.
+  EXPECT_TRUE(index.GetMatchingHashPrefix("111144443333444455556").empty());
+}
+
+}  // namespace safe_browsing
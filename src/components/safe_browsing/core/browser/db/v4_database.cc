@@ -13,8 +13,10 @@
 #include "base/lazy_instance.h"
 #include "base/memory/ptr_util.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/task/thread_pool.h"
 #include "base/task_runner_util.h"
 #include "base/threading/sequenced_task_runner_handle.h"
+#include "components/safe_browsing/core/common/features.h"
 #include "components/safe_browsing/core/common/proto/webui.pb.h"
 
 using base::TimeTicks;
@@ -168,10 +170,11 @@ void V4Database::ApplyUpdate(
 
   db_updated_callback_ = db_updated_callback;
 
-  // Post the V4Store update task on the DB sequence but get the callback on the
-  // current sequence.
-  const scoped_refptr<base::SequencedTaskRunner> current_task_runner =
-      base::SequencedTaskRunnerHandle::Get();
+  // The stores are updated one after the other on the DB sequence. The lists
+  // are independent though, so their Rice-encoded entries, which take most
+  // of the time to apply a large update, can first be decoded concurrently.
+  const bool decode_concurrently =
+      base::FeatureList::IsEnabled(kV4DecodeUpdatesConcurrently);
   for (std::unique_ptr<ListUpdateResponse>& response :
        *parsed_server_response) {
     ListIdentifier identifier(*response);
@@ -181,14 +184,18 @@ void V4Database::ApplyUpdate(
       if (old_store->state() != response->new_client_state()) {
         // A different state implies there are updates to process.
         pending_store_updates_++;
-        UpdatedStoreReadyCallback store_ready_callback =
-            base::BindOnce(&V4Database::UpdatedStoreReady,
-                           weak_factory_on_io_.GetWeakPtr(), identifier);
-        db_task_runner_->PostTask(
-            FROM_HERE, base::BindOnce(&V4Store::ApplyUpdate,
-                                      base::Unretained(old_store.get()),
-                                      std::move(response), current_task_runner,
-                                      std::move(store_ready_callback)));
+        if (decode_concurrently) {
+          // The store is looked up again once the entries are decoded,
+          // rather than bound to the decoding task, which may outlive it.
+          base::ThreadPool::PostTaskAndReplyWithResult(
+              FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+              base::BindOnce(&V4Store::DecodeRiceEncodedEntries,
+                             old_store->store_path(), std::move(response)),
+              base::BindOnce(&V4Database::ApplyUpdateToStore,
+                             weak_factory_on_io_.GetWeakPtr(), identifier));
+        } else {
+          ApplyUpdateToStore(identifier, std::move(response));
+        }
       }
     } else {
       NOTREACHED() << "Got update for unexpected identifier: " << identifier;
@@ -196,11 +203,32 @@ void V4Database::ApplyUpdate(
   }
 
   if (!pending_store_updates_) {
-    current_task_runner->PostTask(FROM_HERE, db_updated_callback_);
+    base::SequencedTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+                                                     db_updated_callback_);
     db_updated_callback_.Reset();
   }
 }
 
+void V4Database::ApplyUpdateToStore(
+    ListIdentifier identifier,
+    std::unique_ptr<ListUpdateResponse> response) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  StoreMap::const_iterator iter = store_map_->find(identifier);
+  DCHECK(iter != store_map_->end());
+
+  // Post the V4Store update task on the DB sequence but get the callback on the
+  // current sequence.
+  UpdatedStoreReadyCallback store_ready_callback =
+      base::BindOnce(&V4Database::UpdatedStoreReady,
+                     weak_factory_on_io_.GetWeakPtr(), identifier);
+  db_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&V4Store::ApplyUpdate,
+                                base::Unretained(iter->second.get()),
+                                std::move(response),
+                                base::SequencedTaskRunnerHandle::Get(),
+                                std::move(store_ready_callback)));
+}
+
 void V4Database::UpdatedStoreReady(ListIdentifier identifier,
                                    std::unique_ptr<V4Store> new_store) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
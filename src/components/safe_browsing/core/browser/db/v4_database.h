@@ -197,6 +197,8 @@ class V4Database {
   FRIEND_TEST_ALL_PREFIXES(V4DatabaseTest,
                            TestSetupDatabaseWithFakeStoresFailsReset);
   FRIEND_TEST_ALL_PREFIXES(V4DatabaseTest, TestApplyUpdateWithNewStates);
+  FRIEND_TEST_ALL_PREFIXES(V4DatabaseTest,
+                           TestApplyUpdateDecodingConcurrently);
   FRIEND_TEST_ALL_PREFIXES(V4DatabaseTest, TestApplyUpdateWithNoNewState);
   FRIEND_TEST_ALL_PREFIXES(V4DatabaseTest, TestApplyUpdateWithEmptyUpdate);
   FRIEND_TEST_ALL_PREFIXES(V4DatabaseTest, TestApplyUpdateWithInvalidUpdate);
@@ -221,6 +223,11 @@ class V4Database {
   static void RegisterStoreFactoryForTest(
       std::unique_ptr<V4StoreFactory> factory);
 
+  // Posts the task that applies |response| to the store for |identifier| on
+  // the DB sequence.
+  void ApplyUpdateToStore(ListIdentifier identifier,
+                          std::unique_ptr<ListUpdateResponse> response);
+
   // Callback called when a new store has been created and is ready to be used.
   // This method updates the store_map_ to point to the new store, which causes
   // the old store to get deleted.
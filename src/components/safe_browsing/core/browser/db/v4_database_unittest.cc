@@ -10,10 +10,12 @@
 #include "base/debug/leak_annotations.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/run_loop.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/task_environment.h"
 #include "base/test/test_simple_task_runner.h"
 #include "components/safe_browsing/core/browser/db/v4_database.h"
 #include "components/safe_browsing/core/browser/db/v4_store.h"
+#include "components/safe_browsing/core/common/features.h"
 #include "testing/platform_test.h"
 
 namespace safe_browsing {
@@ -259,6 +261,39 @@ TEST_F(V4DatabaseTest, TestApplyUpdateWithNewStates) {
   WaitForTasksOnTaskRunner();
 }
 
+TEST_F(V4DatabaseTest, TestApplyUpdateDecodingConcurrently) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeature(kV4DecodeUpdatesConcurrently);
+  RegisterFactory();
+
+  V4Database::Create(task_runner_, database_dirname_, list_infos_,
+                     std::move(callback_db_ready_));
+  created_but_not_called_back_ = true;
+  WaitForTasksOnTaskRunner();
+
+  EXPECT_TRUE(v4_database_);
+  const StoreMap* db_stores = v4_database_->store_map_.get();
+  for (const auto& store_iter : *db_stores) {
+    V4Store* store = store_iter.second.get();
+    expected_store_state_map_[store_iter.first] = store->state() + "_fake";
+    old_stores_map_[store_iter.first] = store;
+  }
+
+  v4_database_->ApplyUpdate(
+      CreateFakeServerResponse(expected_store_state_map_, true),
+      callback_db_updated_);
+
+  // Wait for the entries to get decoded on the thread pool, then for the
+  // ApplyUpdate callback to get called.
+  task_environment_.RunUntilIdle();
+  WaitForTasksOnTaskRunner();
+
+  VerifyExpectedStoresState(true);
+
+  // Wait for the old stores to get destroyed on task runner.
+  WaitForTasksOnTaskRunner();
+}
+
 // Test to ensure no state updates leads to no store updates.
 TEST_F(V4DatabaseTest, TestApplyUpdateWithNoNewState) {
   RegisterFactory();
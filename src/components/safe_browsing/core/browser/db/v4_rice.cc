@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <vector>
 
+#include "base/bits.h"
 #include "base/check_op.h"
 #include "base/notreached.h"
 #include "base/numerics/safe_math.h"
@@ -32,6 +33,37 @@ namespace {
 
 const int kBitsPerByte = 8;
 const unsigned int kMaxBitIndex = kBitsPerByte * sizeof(uint32_t);
+const unsigned int kBitBufferSize = kBitsPerByte * sizeof(uint64_t);
+
+// The range of Rice parameters that ReadMode::kWordAtATime supports. It is
+// the range that the server uses.
+const int32 kMinWordAtATimeRiceParameter = 2;
+const int32 kMaxWordAtATimeRiceParameter = 28;
+
+// Below this many values, std::sort is as fast as RadixSort.
+const size_t kMinRadixSortSize = 256;
+
+// Sorts |values| a byte at a time, from the least significant one, in linear
+// time. Much faster than std::sort for the large lists of hash prefixes.
+void RadixSort(std::vector<uint32_t>* values) {
+  std::vector<uint32_t> sorted(values->size());
+  for (unsigned int shift = 0; shift < kMaxBitIndex; shift += kBitsPerByte) {
+    // The number of values with each byte, then the index in |sorted| of the
+    // next value with it.
+    size_t offsets[256] = {};
+    for (uint32_t value : *values)
+      offsets[(value >> shift) & 0xFF]++;
+    size_t offset = 0;
+    for (size_t& byte_offset : offsets) {
+      const size_t count = byte_offset;
+      byte_offset = offset;
+      offset += count;
+    }
+    for (uint32_t value : *values)
+      sorted[offsets[(value >> shift) & 0xFF]++] = value;
+    values->swap(sorted);
+  }
+}
 
 }  // namespace
 
@@ -66,7 +98,8 @@ V4DecodeResult V4RiceDecoder::DecodeIntegers(const int64 first_value,
                                              const int32 rice_parameter,
                                              const int32 num_entries,
                                              const std::string& encoded_data,
-                                             RepeatedField<int32>* out) {
+                                             RepeatedField<int32>* out,
+                                             ReadMode read_mode) {
   DCHECK(out);
 
   V4DecodeResult result =
@@ -82,7 +115,8 @@ V4DecodeResult V4RiceDecoder::DecodeIntegers(const int64 first_value,
     return DECODE_SUCCESS;
   }
 
-  V4RiceDecoder decoder(rice_parameter, num_entries, encoded_data);
+  V4RiceDecoder decoder(rice_parameter, num_entries, encoded_data,
+                        read_mode);
   while (decoder.HasAnotherValue()) {
     uint32_t offset;
     result = decoder.GetNextValue(&offset);
@@ -107,7 +141,8 @@ V4DecodeResult V4RiceDecoder::DecodePrefixes(const int64 first_value,
                                              const int32 rice_parameter,
                                              const int32 num_entries,
                                              const std::string& encoded_data,
-                                             std::vector<uint32_t>* out) {
+                                             std::vector<uint32_t>* out,
+                                             ReadMode read_mode) {
   DCHECK(out);
 
   V4DecodeResult result =
@@ -121,7 +156,8 @@ V4DecodeResult V4RiceDecoder::DecodePrefixes(const int64 first_value,
   out->push_back(htonl(last_value.ValueOrDie()));
 
   if (num_entries > 0) {
-    V4RiceDecoder decoder(rice_parameter, num_entries, encoded_data);
+    V4RiceDecoder decoder(rice_parameter, num_entries, encoded_data,
+                          read_mode);
     while (decoder.HasAnotherValue()) {
       uint32_t offset;
       result = decoder.GetNextValue(&offset);
@@ -143,7 +179,11 @@ V4DecodeResult V4RiceDecoder::DecodePrefixes(const int64 first_value,
 
   // Flipping the bytes, as done above, destroys the sort order. Sort the
   // values back.
-  std::sort(out->begin(), out->end());
+  if (out->size() < kMinRadixSortSize) {
+    std::sort(out->begin(), out->end());
+  } else {
+    RadixSort(out);
+  }
 
   // This flipping is done so that when the vector is interpreted as a string,
   // the bytes are in the correct order.
@@ -156,11 +196,16 @@ V4DecodeResult V4RiceDecoder::DecodePrefixes(const int64 first_value,
 
 V4RiceDecoder::V4RiceDecoder(const int rice_parameter,
                              const int num_entries,
-                             const std::string& encoded_data)
+                             const std::string& encoded_data,
+                             ReadMode read_mode)
     : rice_parameter_(rice_parameter),
       num_entries_(num_entries),
       data_(encoded_data),
-      current_word_(0) {
+      current_word_(0),
+      read_mode_(rice_parameter >= kMinWordAtATimeRiceParameter &&
+                         rice_parameter <= kMaxWordAtATimeRiceParameter
+                     ? read_mode
+                     : ReadMode::kBitByBit) {
   DCHECK_LE(0, num_entries_);
   DCHECK_LE(2u, rice_parameter_);
   DCHECK_GE(28u, rice_parameter_);
@@ -180,6 +225,9 @@ V4DecodeResult V4RiceDecoder::GetNextValue(uint32_t* value) {
     return DECODE_NO_MORE_ENTRIES_FAILURE;
   }
 
+  if (read_mode_ == ReadMode::kWordAtATime)
+    return GetNextValueWordAtATime(value);
+
   V4DecodeResult result;
   uint32_t q = 0;
   uint32_t bit;
@@ -201,6 +249,54 @@ V4DecodeResult V4RiceDecoder::GetNextValue(uint32_t* value) {
   return DECODE_SUCCESS;
 }
 
+V4DecodeResult V4RiceDecoder::GetNextValueWordAtATime(uint32_t* value) {
+  // The quotient is unary-coded as a run of one bits ended by a zero bit. The
+  // bits above |bit_buffer_size_| are zero, so the run ends within the buffer.
+  uint32_t q = 0;
+  while (true) {
+    RefillBitBuffer();
+    if (bit_buffer_size_ == 0)
+      return DECODE_RAN_OUT_OF_BITS_FAILURE;
+    const unsigned int num_ones =
+        base::bits::CountTrailingZeroBits(~bit_buffer_);
+    if (num_ones < bit_buffer_size_) {
+      q += num_ones;
+      ConsumeBits(num_ones + 1);
+      break;
+    }
+    q += bit_buffer_size_;
+    ConsumeBits(bit_buffer_size_);
+  }
+
+  RefillBitBuffer();
+  if (bit_buffer_size_ < rice_parameter_)
+    return DECODE_RAN_OUT_OF_BITS_FAILURE;
+  const uint32_t r = static_cast<uint32_t>(bit_buffer_) &
+                     (0xFFFFFFFF >> (kMaxBitIndex - rice_parameter_));
+  ConsumeBits(rice_parameter_);
+
+  *value = (q << rice_parameter_) + r;
+  num_entries_--;
+  return DECODE_SUCCESS;
+}
+
+void V4RiceDecoder::RefillBitBuffer() {
+  if (bit_buffer_size_ > kBitBufferSize - kMaxBitIndex)
+    return;
+  uint32_t word;
+  if (GetNextWord(&word) != DECODE_SUCCESS)
+    return;
+  bit_buffer_ |= uint64_t{word} << bit_buffer_size_;
+  bit_buffer_size_ += kMaxBitIndex;
+}
+
+void V4RiceDecoder::ConsumeBits(unsigned int num_bits) {
+  DCHECK_LE(num_bits, bit_buffer_size_);
+  // Shifting a 64-bit value by 64 bits is undefined.
+  bit_buffer_ = num_bits < kBitBufferSize ? bit_buffer_ >> num_bits : 0;
+  bit_buffer_size_ -= num_bits;
+}
+
 V4DecodeResult V4RiceDecoder::GetNextWord(uint32_t* word) {
   if (data_byte_index_ >= data_.size()) {
     return DECODE_RAN_OUT_OF_BITS_FAILURE;
@@ -52,6 +52,16 @@ enum V4DecodeResult {
 
 class V4RiceDecoder {
  public:
+  // How the decoder reads the bits of the encoded data. Both modes decode the
+  // same values and fail the same way.
+  enum class ReadMode {
+    // One bit at a time.
+    kBitByBit,
+    // From a 64-bit buffer, refilled a word at a time. The unary-coded part
+    // of a value is read at once by counting the trailing one bits.
+    kWordAtATime,
+  };
+
   // Decodes the Rice-encoded string in |encoded_data| as a list of integers
   // and stores them in |out|. |rice_parameter| is the exponent of 2 for
   // calculating 'M', |first_value| is the first value in the output sequence,
@@ -65,7 +75,8 @@ class V4RiceDecoder {
       const ::google::protobuf::int32 rice_parameter,
       const ::google::protobuf::int32 num_entries,
       const std::string& encoded_data,
-      ::google::protobuf::RepeatedField<::google::protobuf::int32>* out);
+      ::google::protobuf::RepeatedField<::google::protobuf::int32>* out,
+      ReadMode read_mode = ReadMode::kWordAtATime);
 
   // Decodes the Rice-encoded string in |encoded_data| as a string of 4-byte
   // hash prefixes and stores them in |out|. The rest of the arguments are the
@@ -88,7 +99,8 @@ class V4RiceDecoder {
       const ::google::protobuf::int32 rice_parameter,
       const ::google::protobuf::int32 num_entries,
       const std::string& encoded_data,
-      std::vector<uint32_t>* out);
+      std::vector<uint32_t>* out,
+      ReadMode read_mode = ReadMode::kWordAtATime);
 
   virtual ~V4RiceDecoder();
 
@@ -109,10 +121,13 @@ class V4RiceDecoder {
 
   // The |rice_parameter| is the exponent of 2 for calculating 'M',
   // |num_entries| is the number of encoded entries in the |encoded_data| and
-  // |encoded_data| is the Rice-encoded string to decode.
+  // |encoded_data| is the Rice-encoded string to decode. |read_mode| is
+  // ignored, and the bits read one at a time, for a |rice_parameter| out of
+  // the expected range.
   V4RiceDecoder(const ::google::protobuf::int32 rice_parameter,
                 const ::google::protobuf::int32 num_entries,
-                const std::string& encoded_data);
+                const std::string& encoded_data,
+                ReadMode read_mode = ReadMode::kWordAtATime);
 
   // Returns true until |num_entries| entries have been decoded.
   bool HasAnotherValue() const;
@@ -132,6 +147,15 @@ class V4RiceDecoder {
   // Reads |num_requested_bits| from |current_word_|.
   uint32_t GetBitsFromCurrentWord(unsigned int num_requested_bits);
 
+  // Same as GetNextValue, in ReadMode::kWordAtATime.
+  V4DecodeResult GetNextValueWordAtATime(uint32_t* value);
+
+  // Appends the next word of |data_| to |bit_buffer_| if it has room for it.
+  void RefillBitBuffer();
+
+  // Drops the |num_bits| least significant bits of |bit_buffer_|.
+  void ConsumeBits(unsigned int num_bits);
+
   // The Rice parameter, which is the exponent of two for calculating 'M'. 'M'
   // is used as the base to calculate the quotient and remainder in the
   // algorithm.
@@ -155,6 +179,13 @@ class V4RiceDecoder {
   // The 32-bit value read from |data_|. All bit reading operations operate on
   // |current_word_|.
   uint32_t current_word_;
+
+  const ReadMode read_mode_;
+
+  // In ReadMode::kWordAtATime, the bits read from |data_| but not yet
+  // consumed, starting from the least significant bit, and their number.
+  uint64_t bit_buffer_ = 0;
+  unsigned int bit_buffer_size_ = 0;
 };
 
 std::ostream& operator<<(std::ostream& os, const V4RiceDecoder& rice_decoder);
@@ -3,7 +3,14 @@
 // found in the LICENSE file.
 
 #include "components/safe_browsing/core/browser/db/v4_rice.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <random>
+
 #include "base/logging.h"
+#include "components/safe_browsing/core/browser/db/v4_test_util.h"
 #include "testing/platform_test.h"
 
 using ::google::protobuf::int32;
@@ -30,15 +37,40 @@ class V4RiceTest : public PlatformTest {
   };
 
   void VerifyRiceDecoding(const RiceDecodingTestInfo& test_info) {
-    const uint32_t num_entries = test_info.expected_values.size();
-    V4RiceDecoder decoder(test_info.rice_parameter, num_entries,
-                          test_info.encoded_string);
-    uint32_t word;
-    for (const auto& expected : test_info.expected_values) {
-      EXPECT_EQ(DECODE_SUCCESS, decoder.GetNextValue(&word));
-      EXPECT_EQ(expected, word);
+    for (auto read_mode : {V4RiceDecoder::ReadMode::kBitByBit,
+                           V4RiceDecoder::ReadMode::kWordAtATime}) {
+      const uint32_t num_entries = test_info.expected_values.size();
+      V4RiceDecoder decoder(test_info.rice_parameter, num_entries,
+                            test_info.encoded_string, read_mode);
+      uint32_t word;
+      for (const auto& expected : test_info.expected_values) {
+        EXPECT_EQ(DECODE_SUCCESS, decoder.GetNextValue(&word));
+        EXPECT_EQ(expected, word);
+      }
+      ASSERT_FALSE(decoder.HasAnotherValue());
+    }
+  }
+
+  // Decodes |num_entries| values from |encoded_data| in both read modes, and
+  // checks that they decode the same values and fail the same way.
+  void VerifyReadModesMatch(uint32_t rice_parameter,
+                            uint32_t num_entries,
+                            const std::string& encoded_data) {
+    V4RiceDecoder bit_decoder(rice_parameter, num_entries, encoded_data,
+                              V4RiceDecoder::ReadMode::kBitByBit);
+    V4RiceDecoder word_decoder(rice_parameter, num_entries, encoded_data,
+                               V4RiceDecoder::ReadMode::kWordAtATime);
+    while (bit_decoder.HasAnotherValue()) {
+      ASSERT_TRUE(word_decoder.HasAnotherValue());
+      uint32_t bit_value = 0;
+      uint32_t word_value = 0;
+      const V4DecodeResult result = bit_decoder.GetNextValue(&bit_value);
+      ASSERT_EQ(result, word_decoder.GetNextValue(&word_value));
+      if (result != DECODE_SUCCESS)
+        return;
+      EXPECT_EQ(bit_value, word_value);
     }
-    ASSERT_FALSE(decoder.HasAnotherValue());
+    EXPECT_FALSE(word_decoder.HasAnotherValue());
   }
 };
 
@@ -263,6 +295,92 @@ TEST_F(V4RiceTest, TestDecoderPrefixesWithMultipleValues) {
   }
 }
 
+TEST_F(V4RiceTest, TestDecoderReadModesMatchOnRandomData) {
+  std::mt19937 generator(42);
+  for (uint32_t rice_parameter = 2; rice_parameter <= 28; rice_parameter++) {
+    for (size_t size = 0; size <= 40; size++) {
+      std::string encoded_data(size, 0);
+      for (char& c : encoded_data)
+        c = static_cast<char>(generator());
+      VerifyReadModesMatch(rice_parameter, 100, encoded_data);
+    }
+    // Long runs of one bits, within and across words.
+    VerifyReadModesMatch(rice_parameter, 10, std::string(20, '\xff'));
+    VerifyReadModesMatch(rice_parameter, 10,
+                         std::string(9, '\xff') + std::string(11, '\0'));
+  }
+}
+
+TEST_F(V4RiceTest, TestDecoderPrefixesReadModesMatch) {
+  std::mt19937 generator(42);
+  for (uint32_t rice_parameter : {2u, 11u, 20u, 28u}) {
+    std::vector<uint32_t> prefixes(5000);
+    for (uint32_t& prefix : prefixes)
+      prefix = generator();
+    std::sort(prefixes.begin(), prefixes.end());
+    prefixes.erase(std::unique(prefixes.begin(), prefixes.end()),
+                   prefixes.end());
+    std::vector<uint32_t> deltas;
+    for (size_t i = 1; i < prefixes.size(); i++)
+      deltas.push_back(prefixes[i] - prefixes[i - 1]);
+    const std::string encoded_data = RiceEncode(rice_parameter, deltas);
+
+    std::vector<uint32_t> bit_out;
+    EXPECT_EQ(DECODE_SUCCESS,
+              V4RiceDecoder::DecodePrefixes(
+                  prefixes[0], rice_parameter, deltas.size(), encoded_data,
+                  &bit_out, V4RiceDecoder::ReadMode::kBitByBit));
+    std::vector<uint32_t> word_out;
+    EXPECT_EQ(DECODE_SUCCESS,
+              V4RiceDecoder::DecodePrefixes(
+                  prefixes[0], rice_parameter, deltas.size(), encoded_data,
+                  &word_out, V4RiceDecoder::ReadMode::kWordAtATime));
+    EXPECT_EQ(bit_out, word_out);
+
+    // The decoded prefixes are sorted as strings of 4 bytes.
+    std::vector<uint32_t> expected = prefixes;
+    std::sort(expected.begin(), expected.end(), [](uint32_t a, uint32_t b) {
+      return memcmp(&a, &b, sizeof(uint32_t)) < 0;
+    });
+    EXPECT_EQ(expected, word_out);
+
+    // A truncated update fails the same way in both modes.
+    const std::string truncated_data =
+        encoded_data.substr(0, encoded_data.size() / 2);
+    bit_out.clear();
+    word_out.clear();
+    EXPECT_EQ(DECODE_RAN_OUT_OF_BITS_FAILURE,
+              V4RiceDecoder::DecodePrefixes(
+                  prefixes[0], rice_parameter, deltas.size(), truncated_data,
+                  &bit_out, V4RiceDecoder::ReadMode::kBitByBit));
+    EXPECT_EQ(DECODE_RAN_OUT_OF_BITS_FAILURE,
+              V4RiceDecoder::DecodePrefixes(
+                  prefixes[0], rice_parameter, deltas.size(), truncated_data,
+                  &word_out, V4RiceDecoder::ReadMode::kWordAtATime));
+    EXPECT_EQ(bit_out, word_out);
+  }
+}
+
+TEST_F(V4RiceTest, TestDecoderIntegersReadModesMatch) {
+  std::mt19937 generator(42);
+  std::vector<uint32_t> deltas(5000);
+  for (uint32_t& delta : deltas)
+    delta = generator() % 5000;
+  const std::string encoded_data = RiceEncode(10, deltas);
+
+  RepeatedField<int32> bit_out;
+  EXPECT_EQ(DECODE_SUCCESS,
+            V4RiceDecoder::DecodeIntegers(3, 10, deltas.size(), encoded_data,
+                                          &bit_out,
+                                          V4RiceDecoder::ReadMode::kBitByBit));
+  RepeatedField<int32> word_out;
+  EXPECT_EQ(DECODE_SUCCESS, V4RiceDecoder::DecodeIntegers(
+                                3, 10, deltas.size(), encoded_data, &word_out,
+                                V4RiceDecoder::ReadMode::kWordAtATime));
+  ASSERT_EQ(bit_out.size(), word_out.size());
+  EXPECT_TRUE(std::equal(bit_out.begin(), bit_out.end(), word_out.begin()));
+}
+
 #if defined(NDEBUG) && !defined(DCHECK_ALWAYS_ON)
 // This test hits a NOTREACHED so it is a release mode only test.
 TEST_F(V4RiceTest, TestDecoderPrefixesWithOverflowValues) {
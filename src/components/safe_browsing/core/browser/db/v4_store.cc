@@ -10,6 +10,7 @@
 #include "base/base64.h"
 #include "base/bind.h"
 #include "base/cxx17_backports.h"
+#include "base/feature_list.h"
 #include "base/files/file_util.h"
 #include "base/logging.h"
 #include "base/metrics/histogram_functions.h"
@@ -17,9 +18,11 @@
 #include "base/strings/string_piece.h"
 #include "base/strings/stringprintf.h"
 #include "base/timer/elapsed_timer.h"
+#include "components/safe_browsing/core/browser/db/hash_prefix_index.h"
 #include "components/safe_browsing/core/browser/db/prefix_iterator.h"
 #include "components/safe_browsing/core/browser/db/v4_rice.h"
 #include "components/safe_browsing/core/browser/db/v4_store.pb.h"
+#include "components/safe_browsing/core/common/features.h"
 #include "components/safe_browsing/core/common/proto/webui.pb.h"
 #include "crypto/secure_hash.h"
 #include "crypto/sha2.h"
@@ -240,6 +243,7 @@ void V4Store::Destroy(std::unique_ptr<V4Store> v4_store) {
 
 void V4Store::Reset() {
   expected_checksum_.clear();
+  hash_prefix_index_.reset();
   hash_prefix_map_.clear();
   state_ = "";
 }
@@ -356,6 +360,7 @@ ApplyUpdateResult V4Store::ProcessUpdate(
     }
   }
 
+  UpdateHashPrefixIndex();
   state_ = response->new_client_state();
   return APPLY_UPDATE_SUCCESS;
 }
@@ -408,6 +413,79 @@ void V4Store::ApplyUpdate(
       FROM_HERE, base::BindOnce(std::move(callback), std::move(new_store)));
 }
 
+// static
+std::unique_ptr<ListUpdateResponse> V4Store::DecodeRiceEncodedEntries(
+    const base::FilePath& store_path,
+    std::unique_ptr<ListUpdateResponse> response) {
+  std::string metric;
+  if (response->response_type() == ListUpdateResponse::PARTIAL_UPDATE) {
+    metric = kProcessPartialUpdate;
+  } else if (response->response_type() == ListUpdateResponse::FULL_UPDATE) {
+    metric = kProcessFullUpdate;
+  } else {
+    return response;
+  }
+
+  // The entries are decoded in the same order as by ProcessUpdate, and only up
+  // to where it would stop, so that the decode results are recorded as they
+  // would be without pre-decoding: the successful decodes here, since
+  // ProcessUpdate won't see them, and the first failure by ProcessUpdate.
+  if (response->removals_size() > 0) {
+    ThreatEntrySet* removal = response->mutable_removals(0);
+    if (removal->compression_type() == RICE) {
+      const RiceDeltaEncoding& rice_indices = removal->rice_indices();
+      RepeatedField<int32> raw_removals;
+      V4DecodeResult decode_result = V4RiceDecoder::DecodeIntegers(
+          rice_indices.first_value(), rice_indices.rice_parameter(),
+          rice_indices.num_entries(), rice_indices.encoded_data(),
+          &raw_removals);
+      if (decode_result != DECODE_SUCCESS)
+        return response;
+      RecordDecodeRemovalsResult(metric, decode_result, store_path);
+      removal->set_compression_type(RAW);
+      removal->clear_rice_indices();
+      removal->mutable_raw_indices()->mutable_indices()->Swap(&raw_removals);
+    } else if (removal->compression_type() != RAW) {
+      return response;
+    }
+  }
+
+  for (ThreatEntrySet& addition : *response->mutable_additions()) {
+    if (addition.compression_type() == RAW) {
+      // Stop where AddUnlumpedHashes would reject the hashes.
+      const PrefixSize prefix_size = addition.raw_hashes().prefix_size();
+      if (prefix_size < kMinHashPrefixLength ||
+          prefix_size > kMaxHashPrefixLength ||
+          addition.raw_hashes().raw_hashes().size() % prefix_size != 0) {
+        break;
+      }
+      continue;
+    }
+    if (addition.compression_type() != RICE)
+      break;
+    const RiceDeltaEncoding& rice_hashes = addition.rice_hashes();
+    std::vector<uint32_t> raw_hashes;
+    V4DecodeResult decode_result = V4RiceDecoder::DecodePrefixes(
+        rice_hashes.first_value(), rice_hashes.rice_parameter(),
+        rice_hashes.num_entries(), rice_hashes.encoded_data(), &raw_hashes);
+    if (decode_result != DECODE_SUCCESS)
+      break;
+    RecordDecodeAdditionsResult(metric, decode_result, store_path);
+    const char* raw_hashes_start = reinterpret_cast<char*>(raw_hashes.data());
+    size_t raw_hashes_size = sizeof(uint32_t) * raw_hashes.size();
+    RecordAdditionsHashesCount(metric, raw_hashes_size, store_path);
+
+    // See UpdateHashPrefixMapFromAdditions for the prefix size.
+    const PrefixSize kPrefixSize = 4;
+    addition.set_compression_type(RAW);
+    addition.clear_rice_hashes();
+    addition.mutable_raw_hashes()->set_prefix_size(kPrefixSize);
+    addition.mutable_raw_hashes()->set_raw_hashes(raw_hashes_start,
+                                                  raw_hashes_size);
+  }
+  return response;
+}
+
 ApplyUpdateResult V4Store::UpdateHashPrefixMapFromAdditions(
     const std::string& metric,
     const RepeatedPtrField<ThreatEntrySet>& additions,
@@ -517,6 +595,24 @@ bool V4Store::GetNextSmallestUnmergedPrefix(
   return has_unmerged;
 }
 
+// static
+bool V4Store::GetCommonPrefixSize(const HashPrefixMap& old_prefixes_map,
+                                  const HashPrefixMap& additions_map,
+                                  PrefixSize* prefix_size) {
+  bool has_prefixes = false;
+  for (const HashPrefixMap* prefix_map : {&old_prefixes_map, &additions_map}) {
+    for (const auto& pair : *prefix_map) {
+      if (pair.second.empty())
+        continue;
+      if (has_prefixes && pair.first != *prefix_size)
+        return false;
+      has_prefixes = true;
+      *prefix_size = pair.first;
+    }
+  }
+  return has_prefixes;
+}
+
 // static
 void V4Store::InitializeIteratorMap(const HashPrefixMap& hash_prefix_map,
                                     IteratorMap* iterator_map) {
@@ -558,6 +654,33 @@ ApplyUpdateResult V4Store::MergeUpdate(const HashPrefixMap& old_prefixes_map,
   ReserveSpaceInPrefixMap(old_prefixes_map, &hash_prefix_map_);
   ReserveSpaceInPrefixMap(additions_map, &hash_prefix_map_);
 
+  std::unique_ptr<crypto::SecureHash> checksum_ctx(
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256));
+
+  // Lists usually only have 4-byte hash prefixes, which are then merged as
+  // one sorted string, itself the input of the checksum.
+  PrefixSize common_prefix_size;
+  if (GetCommonPrefixSize(old_prefixes_map, additions_map,
+                          &common_prefix_size)) {
+    auto old_it = old_prefixes_map.find(common_prefix_size);
+    auto additions_it = additions_map.find(common_prefix_size);
+    ApplyUpdateResult result = MergeUpdateWithPrefixSize(
+        common_prefix_size,
+        old_it != old_prefixes_map.end() ? old_it->second : base::StringPiece(),
+        additions_it != additions_map.end() ? additions_it->second
+                                            : base::StringPiece(),
+        raw_removals);
+    if (result != APPLY_UPDATE_SUCCESS)
+      return result;
+    if (calculate_checksum) {
+      const HashPrefixes& merged = hash_prefix_map_[common_prefix_size];
+      checksum_ctx->Update(merged.data(), merged.size());
+      if (!ChecksumMatches(checksum_ctx.get(), expected_checksum))
+        return CHECKSUM_MISMATCH_FAILURE;
+    }
+    return APPLY_UPDATE_SUCCESS;
+  }
+
   IteratorMap old_iterator_map;
   HashPrefix next_smallest_prefix_old;
   InitializeIteratorMap(old_prefixes_map, &old_iterator_map);
@@ -575,9 +698,6 @@ ApplyUpdateResult V4Store::MergeUpdate(const HashPrefixMap& old_prefixes_map,
   // At least one of the maps still has elements that need to be merged into the
   // new store.
 
-  std::unique_ptr<crypto::SecureHash> checksum_ctx(
-      crypto::SecureHash::Create(crypto::SecureHash::SHA256));
-
   // Keep track of the number of elements picked from the old map. This is used
   // to determine which elements to drop based on the raw_removals. Note that
   // picked is not the same as merged. A picked element isn't merged if its
@@ -654,28 +774,103 @@ ApplyUpdateResult V4Store::MergeUpdate(const HashPrefixMap& old_prefixes_map,
     return REMOVALS_INDEX_TOO_LARGE_FAILURE;
   }
 
-  if (calculate_checksum) {
-    char checksum[crypto::kSHA256Length];
-    checksum_ctx->Finish(checksum, sizeof(checksum));
-    for (size_t i = 0; i < crypto::kSHA256Length; i++) {
-      if (checksum[i] != expected_checksum[i]) {
-#if DCHECK_IS_ON()
-        std::string checksum_b64, expected_checksum_b64;
-        base::Base64Encode(base::StringPiece(checksum, base::size(checksum)),
-                           &checksum_b64);
-        base::Base64Encode(expected_checksum, &expected_checksum_b64);
-        DVLOG(1) << "Failure: Checksum mismatch: calculated: " << checksum_b64
-                 << "; expected: " << expected_checksum_b64
-                 << "; store: " << *this;
-#endif
-        return CHECKSUM_MISMATCH_FAILURE;
+  if (calculate_checksum &&
+      !ChecksumMatches(checksum_ctx.get(), expected_checksum)) {
+    return CHECKSUM_MISMATCH_FAILURE;
+  }
+
+  return APPLY_UPDATE_SUCCESS;
+}
+
+ApplyUpdateResult V4Store::MergeUpdateWithPrefixSize(
+    PrefixSize prefix_size,
+    base::StringPiece old_prefixes,
+    base::StringPiece additions,
+    const RepeatedField<int32>* raw_removals) {
+  CHECK_EQ(0u, old_prefixes.size() % prefix_size);
+  CHECK_EQ(0u, additions.size() % prefix_size);
+  const size_t old_count = old_prefixes.size() / prefix_size;
+  const size_t additions_count = additions.size() / prefix_size;
+  const PrefixIterator old_begin(old_prefixes, 0, prefix_size);
+  const PrefixIterator old_end(old_prefixes, old_count, prefix_size);
+  HashPrefixes& merged = hash_prefix_map_[prefix_size];
+
+  // As in MergeUpdate, |old_index| counts the hash prefixes picked from the
+  // old store, including the removed ones.
+  size_t old_index = 0;
+  size_t additions_index = 0;
+  const int* removals_iter = raw_removals ? raw_removals->begin() : nullptr;
+  const int* removals_end = raw_removals ? raw_removals->end() : nullptr;
+  while (old_index < old_count || additions_index < additions_count) {
+    base::StringPiece addition;
+    size_t run_end = old_count;
+    if (additions_index < additions_count) {
+      addition = additions.substr(additions_index * prefix_size, prefix_size);
+      run_end = std::lower_bound(old_begin + static_cast<int>(old_index),
+                                 old_end, addition) -
+                old_begin;
+    }
+
+    // Copy the old hash prefixes smaller than |addition|, except the removed
+    // ones. A removal index that was passed is never matched again, so the
+    // update fails below as in MergeUpdate.
+    while (old_index < run_end) {
+      size_t copy_end = run_end;
+      if (removals_iter != removals_end && *removals_iter >= 0 &&
+          static_cast<size_t>(*removals_iter) >= old_index &&
+          static_cast<size_t>(*removals_iter) < run_end) {
+        copy_end = *removals_iter;
       }
+      merged.append(old_prefixes.data() + old_index * prefix_size,
+                    (copy_end - old_index) * prefix_size);
+      old_index = copy_end;
+      if (old_index < run_end) {
+        // Skip the removed hash prefix.
+        old_index++;
+        removals_iter++;
+      }
+    }
+
+    if (additions_index < additions_count) {
+      // If the same hash prefix appears in the existing store and the
+      // additions list, something is clearly wrong. Discard the update.
+      if (old_index < old_count &&
+          old_begin[static_cast<int>(old_index)] == addition) {
+        return ADDITIONS_HAS_EXISTING_PREFIX_FAILURE;
+      }
+      merged.append(addition.data(), addition.size());
+      additions_index++;
     }
   }
 
+  if (raw_removals && removals_iter != removals_end) {
+    return REMOVALS_INDEX_TOO_LARGE_FAILURE;
+  }
+
   return APPLY_UPDATE_SUCCESS;
 }
 
+bool V4Store::ChecksumMatches(crypto::SecureHash* checksum_ctx,
+                              const std::string& expected_checksum) const {
+  char checksum[crypto::kSHA256Length];
+  checksum_ctx->Finish(checksum, sizeof(checksum));
+  for (size_t i = 0; i < crypto::kSHA256Length; i++) {
+    if (checksum[i] != expected_checksum[i]) {
+#if DCHECK_IS_ON()
+      std::string checksum_b64, expected_checksum_b64;
+      base::Base64Encode(base::StringPiece(checksum, base::size(checksum)),
+                         &checksum_b64);
+      base::Base64Encode(expected_checksum, &expected_checksum_b64);
+      DVLOG(1) << "Failure: Checksum mismatch: calculated: " << checksum_b64
+               << "; expected: " << expected_checksum_b64
+               << "; store: " << *this;
+#endif
+      return false;
+    }
+  }
+  return true;
+}
+
 StoreReadResult V4Store::ReadFromDisk() {
   DCHECK(task_runner_->RunsTasksInCurrentSequence());
 
@@ -719,6 +914,7 @@ StoreReadResult V4Store::ReadFromDisk() {
   RecordApplyUpdateResult(kReadFromDisk, apply_update_result, store_path_);
   last_apply_update_result_ = apply_update_result;
   if (apply_update_result != APPLY_UPDATE_SUCCESS) {
+    hash_prefix_index_.reset();
     hash_prefix_map_.clear();
     return HASH_PREFIX_MAP_GENERATION_FAILURE;
   }
@@ -781,6 +977,8 @@ HashPrefix V4Store::GetMatchingHashPrefix(base::StringPiece full_hash) {
   // It does not guarantee which one of those will be returned.
   DCHECK(full_hash.size() == 32u || full_hash.size() == 21u);
   checks_attempted_++;
+  if (hash_prefix_index_)
+    return std::string(hash_prefix_index_->GetMatchingHashPrefix(full_hash));
   for (const auto& pair : hash_prefix_map_) {
     const PrefixSize& prefix_size = pair.first;
     base::StringPiece hash_prefix = full_hash.substr(0, prefix_size);
@@ -790,6 +988,16 @@ HashPrefix V4Store::GetMatchingHashPrefix(base::StringPiece full_hash) {
   return HashPrefix();
 }
 
+void V4Store::UpdateHashPrefixIndex() {
+  if (!base::FeatureList::IsEnabled(kV4HashPrefixIndex)) {
+    hash_prefix_index_.reset();
+    return;
+  }
+  hash_prefix_index_ = std::make_unique<HashPrefixIndex>();
+  for (const auto& pair : hash_prefix_map_)
+    hash_prefix_index_->AddHashPrefixes(pair.first, pair.second);
+}
+
 bool V4Store::HashPrefixMatches(base::StringPiece prefix,
                                 const HashPrefixes& prefixes,
                                 const PrefixSize& size) {
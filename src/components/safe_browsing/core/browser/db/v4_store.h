@@ -14,11 +14,17 @@
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/sequenced_task_runner.h"
+#include "base/strings/string_piece.h"
 #include "components/safe_browsing/core/browser/db/v4_protocol_manager_util.h"
 #include "components/safe_browsing/core/common/proto/webui.pb.h"
 
+namespace crypto {
+class SecureHash;
+}  // namespace crypto
+
 namespace safe_browsing {
 
+class HashPrefixIndex;
 class V4Store;
 
 using UpdatedStoreReadyCallback =
@@ -198,6 +204,16 @@ class V4Store {
                    const scoped_refptr<base::SequencedTaskRunner>& runner,
                    UpdatedStoreReadyCallback callback);
 
+  // Replaces the Rice-encoded additions and removals of |response|, an update
+  // for the store at |store_path|, with their decoded raw hashes and indices,
+  // and returns it. Applying the update then skips decoding them. Decoding
+  // stops at the first entry which ApplyUpdate would fail on, which is left as
+  // it is, along with the following ones, for ApplyUpdate to report.
+  // Does not touch any store, so can run on any sequence.
+  static std::unique_ptr<ListUpdateResponse> DecodeRiceEncodedEntries(
+      const base::FilePath& store_path,
+      std::unique_ptr<ListUpdateResponse> response);
+
   // Records (in kilobytes) and returns the size of the file on disk for this
   // store using |base_metric| as prefix and the filename as suffix.
   int64_t RecordAndReturnFileSize(const std::string& base_metric);
@@ -225,6 +241,10 @@ class V4Store {
       const std::string& base_metric);
 
  protected:
+  // Rebuilds the index over |hash_prefix_map_|, if enabled. Must be called
+  // after |hash_prefix_map_| changes, before the next lookup.
+  void UpdateHashPrefixIndex();
+
   HashPrefixMap hash_prefix_map_;
 
  private:
@@ -256,6 +276,7 @@ class V4Store {
                            TestMergeUpdatesFailsForRepeatedHashPrefix);
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest,
                            TestMergeUpdatesFailsWhenRemovalsIndexTooLarge);
+  FRIEND_TEST_ALL_PREFIXES(V4StoreTest, TestMergeUpdatesWithSinglePrefixSize);
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest, TestMergeUpdatesRemovesOnlyElement);
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest, TestMergeUpdatesRemovesFirstElement);
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest, TestMergeUpdatesRemovesMiddleElement);
@@ -286,6 +307,8 @@ class V4Store {
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest,
                            TestHashPrefixDoesNotExistInMapWithDifferentSizes);
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest, GetMatchingHashPrefixSize32Or21);
+  FRIEND_TEST_ALL_PREFIXES(V4StoreTest,
+                           GetMatchingHashPrefixWithHashPrefixIndex);
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest,
                            TestAdditionsWithRiceEncodingFailsWithInvalidInput);
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest, TestAdditionsWithRiceEncodingSucceeds);
@@ -294,8 +317,8 @@ class V4Store {
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest, TestChecksumErrorOnStartup);
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest, WriteToDiskFails);
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest, FullUpdateFailsChecksumSynchronously);
-  FRIEND_TEST_ALL_PREFIXES(V4StorePerftest, StressTest);
 
+  friend class V4StorePerftest;
   friend class V4StoreTest;
   friend class V4StoreFuzzer;
 
@@ -323,6 +346,12 @@ class V4Store {
       const IteratorMap& iterator_map,
       HashPrefix* smallest_hash_prefix);
 
+  // Returns true if all the hash prefixes in |old_prefixes_map| and
+  // |additions_map| have the same size, which is then set in |prefix_size|.
+  static bool GetCommonPrefixSize(const HashPrefixMap& old_prefixes_map,
+                                  const HashPrefixMap& additions_map,
+                                  PrefixSize* prefix_size);
+
   // Returns true if |hash_prefix| with PrefixSize |size| exists in |prefixes|.
   // This small method is exposed in the header so it can be tested separately.
   static bool HashPrefixMatches(base::StringPiece prefix,
@@ -359,6 +388,21 @@ class V4Store {
           raw_removals,
       const std::string& expected_checksum);
 
+  // Same as MergeUpdate, without the checksum, when all the hash prefixes
+  // have the same |prefix_size|. The runs of old hash prefixes between two
+  // additions are copied at once, instead of one hash prefix at a time.
+  ApplyUpdateResult MergeUpdateWithPrefixSize(
+      PrefixSize prefix_size,
+      base::StringPiece old_prefixes,
+      base::StringPiece additions,
+      const ::google::protobuf::RepeatedField<::google::protobuf::int32>*
+          raw_removals);
+
+  // Returns true if the SHA256 checksum computed by |checksum_ctx| is
+  // |expected_checksum|.
+  bool ChecksumMatches(crypto::SecureHash* checksum_ctx,
+                       const std::string& expected_checksum) const;
+
   // Processes the FULL_UPDATE |response| from the server, and writes the
   // merged V4Store to disk. If processing the |response| succeeds, it returns
   // APPLY_UPDATE_SUCCESS. The UMA metrics for all interesting sub-operations
@@ -442,6 +486,9 @@ class V4Store {
   std::string state_;
   const base::FilePath store_path_;
   const scoped_refptr<base::SequencedTaskRunner> task_runner_;
+
+  // The index over |hash_prefix_map_| used for lookups, if enabled.
+  std::unique_ptr<HashPrefixIndex> hash_prefix_index_;
 };
 
 std::ostream& operator<<(std::ostream& os, const V4Store& store);
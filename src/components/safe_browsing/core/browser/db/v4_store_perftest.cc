@@ -2,19 +2,32 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/barrier_closure.h"
+#include "base/bind.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/numerics/checked_math.h"
+#include "base/run_loop.h"
 #include "base/strings/stringprintf.h"
+#include "base/task/thread_pool.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/test/task_environment.h"
 #include "base/test/test_simple_task_runner.h"
 #include "base/timer/elapsed_timer.h"
 #include "components/safe_browsing/core/browser/db/v4_protocol_manager_util.h"
+#include "components/safe_browsing/core/browser/db/v4_rice.h"
+#include "components/safe_browsing/core/browser/db/v4_store.h"
 #include "components/safe_browsing/core/browser/db/v4_test_util.h"
+#include "components/safe_browsing/core/common/features.h"
 #include "crypto/sha2.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_result_reporter.h"
@@ -25,59 +38,283 @@ namespace {
 
 constexpr char kMetricPrefixV4Store[] = "V4Store.";
 constexpr char kMetricGetMatchingHashPrefixMs[] = "get_matching_hash_prefix";
+constexpr char kMetricMergeUpdateMs[] = "merge_update";
+constexpr char kMetricDecodeMs[] = "decode";
+
+// Debug builds can be quite slow. Use a smaller number of prefixes to test.
+#if defined(NDEBUG)
+constexpr size_t kNumPrefixes = 2000000;
+#else
+constexpr size_t kNumPrefixes = 20000;
+#endif
+
+// The number of additions and removals in a partial update.
+constexpr size_t kNumPartialUpdatePrefixes = 10000;
+
+// The number of lists in a synthetic update, each with |kNumPrefixes| /
+// |kNumUpdateLists| hash prefixes.
+constexpr size_t kNumUpdateLists = 8;
 
 perf_test::PerfResultReporter SetUpV4StoreReporter(const std::string& story) {
   perf_test::PerfResultReporter reporter(kMetricPrefixV4Store, story);
   reporter.RegisterImportantMetric(kMetricGetMatchingHashPrefixMs, "ms");
+  reporter.RegisterImportantMetric(kMetricMergeUpdateMs, "ms");
+  reporter.RegisterImportantMetric(kMetricDecodeMs, "ms");
   return reporter;
 }
 
+// Returns the sorted and unique 4-byte hash prefixes of the full hashes of the
+// numbers in [begin, end).
+std::vector<HashPrefix> GetSortedHashPrefixes(size_t begin, size_t end) {
+  std::vector<HashPrefix> prefixes;
+  prefixes.reserve(end - begin);
+  for (size_t i = begin; i < end; i++) {
+    prefixes.push_back(crypto::SHA256HashString(base::StringPrintf("%zu", i))
+                           .substr(0, kMinHashPrefixLength));
+  }
+  std::sort(prefixes.begin(), prefixes.end());
+  prefixes.erase(std::unique(prefixes.begin(), prefixes.end()),
+                 prefixes.end());
+  return prefixes;
+}
+
+HashPrefixes ConcatenateHashPrefixes(const std::vector<HashPrefix>& prefixes) {
+  HashPrefixes hash_prefixes;
+  hash_prefixes.reserve(prefixes.size() * kMinHashPrefixLength);
+  for (const HashPrefix& prefix : prefixes)
+    hash_prefixes += prefix;
+  return hash_prefixes;
+}
+
+// Returns a full update whose additions are the 4-byte hash prefixes of the
+// full hashes of the numbers in [begin, end), Rice-encoded as by the server.
+std::unique_ptr<ListUpdateResponse> CreateRiceEncodedUpdate(size_t begin,
+                                                            size_t end) {
+  // The server encodes the prefixes as sorted little-endian integers.
+  std::vector<uint32_t> values;
+  for (const HashPrefix& prefix : GetSortedHashPrefixes(begin, end)) {
+    uint32_t value;
+    memcpy(&value, prefix.data(), sizeof(value));
+    values.push_back(value);
+  }
+  std::sort(values.begin(), values.end());
+  std::vector<uint32_t> deltas;
+  for (size_t i = 1; i < values.size(); i++)
+    deltas.push_back(values[i] - values[i - 1]);
+
+  // Makes the deltas about 2^|rice_parameter|, as the server does.
+  uint32_t rice_parameter = 2;
+  while (rice_parameter < 28 &&
+         (uint64_t{values.size()} << (rice_parameter + 1)) <=
+             (uint64_t{1} << 32)) {
+    rice_parameter++;
+  }
+
+  auto response = std::make_unique<ListUpdateResponse>();
+  response->set_response_type(ListUpdateResponse::FULL_UPDATE);
+  ThreatEntrySet* addition = response->add_additions();
+  addition->set_compression_type(RICE);
+  RiceDeltaEncoding* rice_hashes = addition->mutable_rice_hashes();
+  rice_hashes->set_first_value(values[0]);
+  rice_hashes->set_num_entries(deltas.size());
+  rice_hashes->set_rice_parameter(rice_parameter);
+  rice_hashes->set_encoded_data(RiceEncode(rice_parameter, deltas));
+  return response;
+}
+
 }  // namespace
 
-class V4StorePerftest : public testing::Test {};
+class V4StorePerftest : public testing::Test {
+ protected:
+  // Looks up |kNumPrefixes| full hashes, each of which matches a hash prefix
+  // in the store.
+  void RunStressTest(const std::string& story) {
+    static_assert(kMaxHashPrefixLength == crypto::kSHA256Length,
+                  "SHA256 produces a valid FullHash");
+    CHECK(base::IsValidForType<size_t>(
+        base::CheckMul(kNumPrefixes, kMaxHashPrefixLength)));
+
+    // Keep the full hashes as one big string to avoid tons of allocations /
+    // deallocations in the test.
+    std::string full_hashes(kNumPrefixes * kMaxHashPrefixLength, 0);
+    base::StringPiece full_hashes_piece = base::StringPiece(full_hashes);
+    std::vector<std::string> prefixes;
+    for (size_t i = 0; i < kNumPrefixes; i++) {
+      size_t index = i * kMaxHashPrefixLength;
+      crypto::SHA256HashString(base::StringPrintf("%zu", i),
+                               &full_hashes[index], kMaxHashPrefixLength);
+      prefixes.push_back(full_hashes.substr(index, kMinHashPrefixLength));
+    }
+
+    auto store = std::make_unique<TestV4Store>(
+        base::MakeRefCounted<base::TestSimpleTaskRunner>(), base::FilePath());
+    store->SetPrefixes(std::move(prefixes), kMinHashPrefixLength);
+
+    size_t matches = 0;
+    auto reporter = SetUpV4StoreReporter(story);
+    base::ElapsedTimer timer;
+    for (size_t i = 0; i < kNumPrefixes; i++) {
+      size_t index = i * kMaxHashPrefixLength;
+      base::StringPiece full_hash =
+          full_hashes_piece.substr(index, kMaxHashPrefixLength);
+      matches += !store->GetMatchingHashPrefix(full_hash).empty();
+    }
+    reporter.AddResult(kMetricGetMatchingHashPrefixMs,
+                       timer.Elapsed().InMillisecondsF());
+
+    EXPECT_EQ(kNumPrefixes, matches);
+  }
+
+  // Merges |additions| and the |old_prefixes| of a store, less the
+  // |raw_removals|.
+  void RunMergeUpdateTest(
+      const std::string& story,
+      const HashPrefixes& old_prefixes,
+      const HashPrefixes& additions,
+      const ::google::protobuf::RepeatedField<::google::protobuf::int32>*
+          raw_removals) {
+    HashPrefixMap old_prefixes_map;
+    if (!old_prefixes.empty())
+      old_prefixes_map[kMinHashPrefixLength] = old_prefixes;
+    HashPrefixMap additions_map;
+    additions_map[kMinHashPrefixLength] = additions;
+
+    auto store = std::make_unique<V4Store>(
+        base::MakeRefCounted<base::TestSimpleTaskRunner>(), base::FilePath());
+    auto reporter = SetUpV4StoreReporter(story);
+    base::ElapsedTimer timer;
+    EXPECT_EQ(APPLY_UPDATE_SUCCESS,
+              store->MergeUpdate(old_prefixes_map, additions_map, raw_removals,
+                                 /*expected_checksum=*/std::string()));
+    reporter.AddResult(kMetricMergeUpdateMs, timer.Elapsed().InMillisecondsF());
+  }
+
+  // Decodes the additions of an update with |kNumPrefixes| hash prefixes.
+  void RunDecodeTest(const std::string& story,
+                     V4RiceDecoder::ReadMode read_mode) {
+    const std::unique_ptr<ListUpdateResponse> response =
+        CreateRiceEncodedUpdate(0, kNumPrefixes);
+    const RiceDeltaEncoding& rice_hashes =
+        response->additions(0).rice_hashes();
+
+    std::vector<uint32_t> raw_hashes;
+    auto reporter = SetUpV4StoreReporter(story);
+    base::ElapsedTimer timer;
+    EXPECT_EQ(DECODE_SUCCESS,
+              V4RiceDecoder::DecodePrefixes(
+                  rice_hashes.first_value(), rice_hashes.rice_parameter(),
+                  rice_hashes.num_entries(), rice_hashes.encoded_data(),
+                  &raw_hashes, read_mode));
+    reporter.AddResult(kMetricDecodeMs, timer.Elapsed().InMillisecondsF());
+
+    EXPECT_EQ(static_cast<size_t>(rice_hashes.num_entries()) + 1,
+              raw_hashes.size());
+  }
+
+  // Returns the updates of |kNumUpdateLists| lists.
+  std::vector<std::unique_ptr<ListUpdateResponse>> CreateUpdates() {
+    std::vector<std::unique_ptr<ListUpdateResponse>> responses;
+    const size_t list_size = kNumPrefixes / kNumUpdateLists;
+    for (size_t i = 0; i < kNumUpdateLists; i++) {
+      responses.push_back(
+          CreateRiceEncodedUpdate(i * list_size, (i + 1) * list_size));
+    }
+    return responses;
+  }
+
+  base::test::TaskEnvironment task_environment_;
+};
 
 TEST_F(V4StorePerftest, StressTest) {
-// Debug builds can be quite slow. Use a smaller number of prefixes to test.
-#if defined(NDEBUG)
-  const size_t kNumPrefixes = 2000000;
-#else
-  const size_t kNumPrefixes = 20000;
-#endif
+  RunStressTest("stress_test");
+}
+
+TEST_F(V4StorePerftest, StressTestWithHashPrefixIndex) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeature(kV4HashPrefixIndex);
+  RunStressTest("stress_test_hash_prefix_index");
+}
+
+TEST_F(V4StorePerftest, MergeFullUpdate) {
+  RunMergeUpdateTest(
+      "merge_full_update", HashPrefixes(),
+      ConcatenateHashPrefixes(GetSortedHashPrefixes(0, kNumPrefixes)), nullptr);
+}
+
+TEST_F(V4StorePerftest, MergePartialUpdate) {
+  const std::vector<HashPrefix> old_prefixes =
+      GetSortedHashPrefixes(0, kNumPrefixes);
+  const std::vector<HashPrefix> new_prefixes = GetSortedHashPrefixes(
+      kNumPrefixes, kNumPrefixes + kNumPartialUpdatePrefixes);
+  // Drop the additions already in the store.
+  std::vector<HashPrefix> additions;
+  std::set_difference(new_prefixes.begin(), new_prefixes.end(),
+                      old_prefixes.begin(), old_prefixes.end(),
+                      std::back_inserter(additions));
+
+  // Spread the removals over the old hash prefixes.
+  ::google::protobuf::RepeatedField<::google::protobuf::int32> raw_removals;
+  for (size_t i = 0; i < kNumPartialUpdatePrefixes; i++) {
+    raw_removals.Add(
+        static_cast<int>(i * old_prefixes.size() / kNumPartialUpdatePrefixes));
+  }
+
+  RunMergeUpdateTest("merge_partial_update",
+                     ConcatenateHashPrefixes(old_prefixes),
+                     ConcatenateHashPrefixes(additions), &raw_removals);
+}
+
+TEST_F(V4StorePerftest, DecodeBitByBit) {
+  RunDecodeTest("decode_bit_by_bit", V4RiceDecoder::ReadMode::kBitByBit);
+}
+
+TEST_F(V4StorePerftest, DecodeWordAtATime) {
+  RunDecodeTest("decode_word_at_a_time",
+                V4RiceDecoder::ReadMode::kWordAtATime);
+}
+
+TEST_F(V4StorePerftest, DecodeUpdateSerially) {
+  std::vector<std::unique_ptr<ListUpdateResponse>> responses = CreateUpdates();
 
-  static_assert(kMaxHashPrefixLength == crypto::kSHA256Length,
-                "SHA256 produces a valid FullHash");
-  CHECK(base::IsValidForType<size_t>(
-      base::CheckMul(kNumPrefixes, kMaxHashPrefixLength)));
-
-  // Keep the full hashes as one big string to avoid tons of allocations /
-  // deallocations in the test.
-  std::string full_hashes(kNumPrefixes * kMaxHashPrefixLength, 0);
-  base::StringPiece full_hashes_piece = base::StringPiece(full_hashes);
-  std::vector<std::string> prefixes;
-  for (size_t i = 0; i < kNumPrefixes; i++) {
-    size_t index = i * kMaxHashPrefixLength;
-    crypto::SHA256HashString(base::StringPrintf("%zu", i), &full_hashes[index],
-                             kMaxHashPrefixLength);
-    prefixes.push_back(full_hashes.substr(index, kMinHashPrefixLength));
+  auto reporter = SetUpV4StoreReporter("decode_update_serially");
+  base::ElapsedTimer timer;
+  for (std::unique_ptr<ListUpdateResponse>& response : responses) {
+    response = V4Store::DecodeRiceEncodedEntries(base::FilePath(),
+                                                 std::move(response));
   }
+  reporter.AddResult(kMetricDecodeMs, timer.Elapsed().InMillisecondsF());
+
+  for (const std::unique_ptr<ListUpdateResponse>& response : responses)
+    EXPECT_EQ(RAW, response->additions(0).compression_type());
+}
 
-  auto store = std::make_unique<TestV4Store>(
-      base::MakeRefCounted<base::TestSimpleTaskRunner>(), base::FilePath());
-  store->SetPrefixes(std::move(prefixes), kMinHashPrefixLength);
+TEST_F(V4StorePerftest, DecodeUpdateConcurrently) {
+  std::vector<std::unique_ptr<ListUpdateResponse>> responses = CreateUpdates();
 
-  size_t matches = 0;
-  auto reporter = SetUpV4StoreReporter("stress_test");
+  auto reporter = SetUpV4StoreReporter("decode_update_concurrently");
   base::ElapsedTimer timer;
-  for (size_t i = 0; i < kNumPrefixes; i++) {
-    size_t index = i * kMaxHashPrefixLength;
-    base::StringPiece full_hash =
-        full_hashes_piece.substr(index, kMaxHashPrefixLength);
-    matches += !store->GetMatchingHashPrefix(full_hash).empty();
+  base::RunLoop run_loop;
+  base::RepeatingClosure barrier =
+      base::BarrierClosure(responses.size(), run_loop.QuitClosure());
+  for (std::unique_ptr<ListUpdateResponse>& response : responses) {
+    base::ThreadPool::PostTaskAndReplyWithResult(
+        FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+        base::BindOnce(&V4Store::DecodeRiceEncodedEntries, base::FilePath(),
+                       std::move(response)),
+        base::BindOnce(
+            [](std::unique_ptr<ListUpdateResponse>* slot,
+               base::RepeatingClosure barrier,
+               std::unique_ptr<ListUpdateResponse> response) {
+              *slot = std::move(response);
+              barrier.Run();
+            },
+            &response, barrier));
   }
-  reporter.AddResult(kMetricGetMatchingHashPrefixMs,
-                     timer.Elapsed().InMillisecondsF());
+  run_loop.Run();
+  reporter.AddResult(kMetricDecodeMs, timer.Elapsed().InMillisecondsF());
 
-  EXPECT_EQ(kNumPrefixes, matches);
+  for (const std::unique_ptr<ListUpdateResponse>& response : responses)
+    EXPECT_EQ(RAW, response->additions(0).compression_type());
 }
 
 }  // namespace safe_browsing
@@ -10,10 +10,13 @@
 #include "base/files/scoped_temp_dir.h"
 #include "base/logging.h"
 #include "base/run_loop.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/task_environment.h"
 #include "base/test/test_simple_task_runner.h"
 #include "base/time/time.h"
 #include "components/safe_browsing/core/browser/db/v4_store.pb.h"
+#include "components/safe_browsing/core/common/features.h"
 #include "crypto/sha2.h"
 #include "testing/platform_test.h"
 
@@ -359,6 +362,31 @@ TEST_F(V4StoreTest, TestMergeUpdatesFailsForRepeatedHashPrefix) {
                               expected_checksum));
 }
 
+TEST_F(V4StoreTest, TestMergeUpdatesWithSinglePrefixSize) {
+  HashPrefixMap prefix_map_old;
+  EXPECT_EQ(APPLY_UPDATE_SUCCESS,
+            V4Store::AddUnlumpedHashes(4, "1111333355557777", &prefix_map_old));
+  HashPrefixMap prefix_map_additions;
+  EXPECT_EQ(
+      APPLY_UPDATE_SUCCESS,
+      V4Store::AddUnlumpedHashes(4, "000022226666", &prefix_map_additions));
+
+  V4Store store(task_runner_, store_path_);
+  RepeatedField<int32> raw_removals;
+  // old_store: ["1111", "3333", "5555", "7777"]
+  raw_removals.Add(1);  // Removes "3333"
+  raw_removals.Add(3);  // Removes "7777"
+  std::string expected_checksum =
+      crypto::SHA256HashString("00001111222255556666");
+  EXPECT_EQ(APPLY_UPDATE_SUCCESS,
+            store.MergeUpdate(prefix_map_old, prefix_map_additions,
+                              &raw_removals, expected_checksum));
+
+  const HashPrefixMap& prefix_map = store.hash_prefix_map_;
+  EXPECT_EQ(1u, prefix_map.size());
+  EXPECT_EQ("00001111222255556666", prefix_map.at(4));
+}
+
 TEST_F(V4StoreTest, TestMergeUpdatesFailsWhenRemovalsIndexTooLarge) {
   HashPrefixMap prefix_map_old;
   EXPECT_EQ(APPLY_UPDATE_SUCCESS,
@@ -684,6 +712,32 @@ TEST_F(V4StoreTest, GetMatchingHashPrefixSize32Or21) {
 #endif
 }
 
+TEST_F(V4StoreTest, GetMatchingHashPrefixWithHashPrefixIndex) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeature(kV4HashPrefixIndex);
+  V4Store store(task_runner_, store_path_);
+  store.hash_prefix_map_[4] = "22223333aaaa";
+  store.hash_prefix_map_[5] = "11111hhhhh";
+  store.hash_prefix_map_[32] = "11112222333344445555666677778888";
+  store.UpdateHashPrefixIndex();
+
+  FullHash full_hash = "22222222222222222222222222222222";
+  EXPECT_EQ("2222", store.GetMatchingHashPrefix(full_hash));
+  full_hash = "hhhhh222222222222222222222222222";
+  EXPECT_EQ("hhhhh", store.GetMatchingHashPrefix(full_hash));
+  full_hash = "11112222333344445555666677778888";
+  EXPECT_EQ(full_hash, store.GetMatchingHashPrefix(full_hash));
+  full_hash = "11112222333344445555666677779999";
+  EXPECT_TRUE(store.GetMatchingHashPrefix(full_hash).empty());
+  // The 32-byte prefix does not match a 21-byte full hash.
+  full_hash = "111122223333444455556";
+  EXPECT_TRUE(store.GetMatchingHashPrefix(full_hash).empty());
+
+  store.Reset();
+  full_hash = "22222222222222222222222222222222";
+  EXPECT_TRUE(store.GetMatchingHashPrefix(full_hash).empty());
+}
+
 #if defined(NDEBUG) && !defined(DCHECK_ALWAYS_ON)
 // This test hits a NOTREACHED so it is a release mode only test.
 TEST_F(V4StoreTest, TestAdditionsWithRiceEncodingFailsWithInvalidInput) {
@@ -777,6 +831,108 @@ TEST_F(V4StoreTest, TestRemovalsWithRiceEncodingSucceeds) {
   EXPECT_TRUE(updated_store_->HasValidData());
 }
 
+TEST_F(V4StoreTest, TestDecodeRiceEncodedEntries) {
+  auto lur = std::make_unique<ListUpdateResponse>();
+  lur->set_response_type(ListUpdateResponse::PARTIAL_UPDATE);
+  ThreatEntrySet* addition = lur->add_additions();
+  addition->set_compression_type(RICE);
+  RiceDeltaEncoding* rice_hashes = addition->mutable_rice_hashes();
+  rice_hashes->set_first_value(5);
+  rice_hashes->set_num_entries(3);
+  rice_hashes->set_rice_parameter(28);
+  rice_hashes->set_encoded_data(
+      "\xbf\xa8\x3f\xfb\xf\xf\x5e\x27\xe6\xc3\x1d\xc6\x38");
+  // Runs out of bits after ten values, so is left for ApplyUpdate to report.
+  ThreatEntrySet* invalid_addition = lur->add_additions();
+  invalid_addition->set_compression_type(RICE);
+  RiceDeltaEncoding* invalid_rice_hashes =
+      invalid_addition->mutable_rice_hashes();
+  invalid_rice_hashes->set_first_value(5);
+  invalid_rice_hashes->set_num_entries(20);
+  invalid_rice_hashes->set_rice_parameter(2);
+  invalid_rice_hashes->set_encoded_data(std::string(1, '\0'));
+  ThreatEntrySet* removal = lur->add_removals();
+  removal->set_compression_type(RICE);
+  RiceDeltaEncoding* rice_indices = removal->mutable_rice_indices();
+  rice_indices->set_first_value(0);
+  rice_indices->set_num_entries(2);
+  rice_indices->set_rice_parameter(2);
+  rice_indices->set_encoded_data("\x16");
+
+  lur = V4Store::DecodeRiceEncodedEntries(store_path_, std::move(lur));
+
+  ASSERT_EQ(2, lur->additions_size());
+  EXPECT_EQ(RAW, lur->additions(0).compression_type());
+  EXPECT_FALSE(lur->additions(0).has_rice_hashes());
+  EXPECT_EQ(4, lur->additions(0).raw_hashes().prefix_size());
+  EXPECT_EQ(std::string("\x5\0\0\0\fL\x93\xADV\x7F\xF6o\xCEo1\x81", 16),
+            lur->additions(0).raw_hashes().raw_hashes());
+  EXPECT_EQ(RICE, lur->additions(1).compression_type());
+  EXPECT_TRUE(lur->additions(1).has_rice_hashes());
+
+  ASSERT_EQ(1, lur->removals_size());
+  EXPECT_EQ(RAW, lur->removals(0).compression_type());
+  EXPECT_FALSE(lur->removals(0).has_rice_indices());
+  const RepeatedField<int32>& indices =
+      lur->removals(0).raw_indices().indices();
+  ASSERT_EQ(3, indices.size());
+  EXPECT_EQ(0, indices.Get(0));
+  EXPECT_EQ(3, indices.Get(1));
+  EXPECT_EQ(4, indices.Get(2));
+}
+
+TEST_F(V4StoreTest, TestDecodeRiceEncodedEntriesRecordsDecodesAsApplyUpdate) {
+  // The removal runs out of bits after ten values, so ApplyUpdate fails
+  // without decoding the additions.
+  auto create_update = [] {
+    auto lur = std::make_unique<ListUpdateResponse>();
+    lur->set_response_type(ListUpdateResponse::PARTIAL_UPDATE);
+    ThreatEntrySet* addition = lur->add_additions();
+    addition->set_compression_type(RICE);
+    RiceDeltaEncoding* rice_hashes = addition->mutable_rice_hashes();
+    rice_hashes->set_first_value(5);
+    rice_hashes->set_num_entries(3);
+    rice_hashes->set_rice_parameter(28);
+    rice_hashes->set_encoded_data(
+        "\xbf\xa8\x3f\xfb\xf\xf\x5e\x27\xe6\xc3\x1d\xc6\x38");
+    ThreatEntrySet* removal = lur->add_removals();
+    removal->set_compression_type(RICE);
+    RiceDeltaEncoding* rice_indices = removal->mutable_rice_indices();
+    rice_indices->set_first_value(0);
+    rice_indices->set_num_entries(20);
+    rice_indices->set_rice_parameter(2);
+    rice_indices->set_encoded_data(std::string(1, '\0'));
+    return lur;
+  };
+  const char kDecodeAdditionsResult[] =
+      "SafeBrowsing.V4ProcessPartialUpdate.DecodeAdditions.Result";
+  const char kDecodeRemovalsResult[] =
+      "SafeBrowsing.V4ProcessPartialUpdate.DecodeRemovals.Result";
+
+  for (bool decode_first : {false, true}) {
+    SCOPED_TRACE(decode_first);
+    base::HistogramTester histogram_tester;
+    std::unique_ptr<ListUpdateResponse> lur = create_update();
+    if (decode_first)
+      lur = V4Store::DecodeRiceEncodedEntries(store_path_, std::move(lur));
+
+    bool called_back = false;
+    V4Store store(task_runner_, store_path_);
+    store.ApplyUpdate(
+        std::move(lur), task_runner_,
+        base::BindOnce(&V4StoreTest::UpdatedStoreReady, base::Unretained(this),
+                       &called_back, false /* expect_store */));
+    task_runner_->RunPendingTasks();
+    base::RunLoop().RunUntilIdle();
+    EXPECT_TRUE(called_back);
+
+    histogram_tester.ExpectTotalCount(kDecodeAdditionsResult, 0);
+    histogram_tester.ExpectTotalCount(kDecodeRemovalsResult, 1);
+    histogram_tester.ExpectBucketCount(kDecodeRemovalsResult, DECODE_SUCCESS,
+                                       0);
+  }
+}
+
 TEST_F(V4StoreTest, TestMergeUpdatesFailsChecksum) {
   // Proof of checksum mismatch using python:
   // >>> import hashlib
@@ -54,6 +54,7 @@ void TestV4Store::MarkPrefixAsBad(HashPrefix prefix) {
   auto& vec = mock_prefixes_[prefix.size()];
   vec.insert(std::upper_bound(vec.begin(), vec.end(), prefix), prefix);
   hash_prefix_map_[prefix.size()] = base::StrCat(vec);
+  UpdateHashPrefixIndex();
 }
 
 void TestV4Store::SetPrefixes(std::vector<HashPrefix> prefixes,
@@ -61,6 +62,7 @@ void TestV4Store::SetPrefixes(std::vector<HashPrefix> prefixes,
   std::sort(prefixes.begin(), prefixes.end());
   mock_prefixes_[size] = prefixes;
   hash_prefix_map_[size] = base::StrCat(prefixes);
+  UpdateHashPrefixIndex();
 }
 
 TestV4Database::TestV4Database(
@@ -150,4 +152,25 @@ FullHashInfo GetFullHashInfoWithMetadata(
   return fhi;
 }
 
+std::string RiceEncode(uint32_t rice_parameter,
+                       const std::vector<uint32_t>& values) {
+  std::string encoded;
+  size_t num_bits = 0;
+  auto append_bit = [&encoded, &num_bits](bool bit) {
+    if (num_bits % 8 == 0)
+      encoded.push_back(0);
+    if (bit)
+      encoded.back() |= 1 << (num_bits % 8);
+    num_bits++;
+  };
+  for (uint32_t value : values) {
+    for (uint32_t q = value >> rice_parameter; q > 0; q--)
+      append_bit(true);
+    append_bit(false);
+    for (uint32_t i = 0; i < rice_parameter; i++)
+      append_bit((value >> i) & 1);
+  }
+  return encoded;
+}
+
 }  // namespace safe_browsing
@@ -10,6 +10,7 @@
 #include <map>
 #include <memory>
 #include <ostream>
+#include <string>
 #include <vector>
 
 #include "components/safe_browsing/core/browser/db/v4_database.h"
@@ -122,6 +123,12 @@ FullHashInfo GetFullHashInfoWithMetadata(const GURL& url,
                                          const ListIdentifier& list_id,
                                          const ThreatMetadata& threat_metadata);
 
+// Rice-encodes |values| the way the server does: each value as its quotient
+// by 2^|rice_parameter| in unary, then its remainder, least significant bit
+// first.
+std::string RiceEncode(uint32_t rice_parameter,
+                       const std::vector<uint32_t>& values);
+
 }  // namespace safe_browsing
 
 #endif  // COMPONENTS_SAFE_BROWSING_CORE_BROWSER_DB_V4_TEST_UTIL_H_
@@ -144,6 +144,13 @@ const base::Feature kTriggerThrottlerDailyQuotaFeature{
 const base::Feature kUseNewDownloadWarnings{"UseNewDownloadWarnings",
                                             base::FEATURE_DISABLED_BY_DEFAULT};
 
+const base::Feature kV4DecodeUpdatesConcurrently{
+    "SafeBrowsingV4DecodeUpdatesConcurrently",
+    base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::Feature kV4HashPrefixIndex{"SafeBrowsingV4HashPrefixIndex",
+                                       base::FEATURE_DISABLED_BY_DEFAULT};
+
 const base::Feature kVisualFeaturesInPasswordProtectionAndroid{
     "VisualFeaturesInPasswordProtectionAndroid",
     base::FEATURE_ENABLED_BY_DEFAULT};
@@ -180,6 +187,8 @@ constexpr struct {
     {&kSuspiciousSiteTriggerQuotaFeature, true},
     {&kThreatDomDetailsTagAndAttributeFeature, false},
     {&kTriggerThrottlerDailyQuotaFeature, false},
+    {&kV4DecodeUpdatesConcurrently, true},
+    {&kV4HashPrefixIndex, true},
 };
 
 // Adds the name and the enabled/disabled status of a given feature.
@@ -146,6 +146,14 @@ extern const base::Feature kTriggerThrottlerDailyQuotaFeature;
 // Controls whether Chrome uses new download warning UX.
 extern const base::Feature kUseNewDownloadWarnings;
 
+// Controls whether the V4 database decodes the Rice-encoded entries of the
+// lists in an update concurrently, on the thread pool, before applying them.
+extern const base::Feature kV4DecodeUpdatesConcurrently;
+
+// Controls whether the V4 stores look up full hashes in a bucketed index of
+// their hash prefixes instead of binary searching them.
+extern const base::Feature kV4HashPrefixIndex;
+
 // Controls whether we include visual features in password protection pings on
 // Android.
 extern const base::Feature kVisualFeaturesInPasswordProtectionAndroid;
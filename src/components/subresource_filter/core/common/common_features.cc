@@ -8,4 +8,7 @@ namespace subresource_filter {
 
 const base::Feature kAdTagging{"AdTagging", base::FEATURE_ENABLED_BY_DEFAULT};
 
+const base::Feature kDocumentSubresourceFilterMatchCache{
+    "SubresourceFilterDocumentMatchCache", base::FEATURE_DISABLED_BY_DEFAULT};
+
 }  // namespace subresource_filter
@@ -13,6 +13,10 @@ namespace subresource_filter {
 // subresource_filter component in dry-run mode.
 extern const base::Feature kAdTagging;
 
+// Enables caching, in each document, the rule matched by its recent
+// subresource loads, so that loads repeated in a page are only matched once.
+extern const base::Feature kDocumentSubresourceFilterMatchCache;
+
 // Enables the artificial delaying of ads that are considered unsafe (e.g. http
 // or same-domain to the top-level).
 extern const base::Feature kDelayUnsafeAds;
@@ -8,7 +8,9 @@
 #include <utility>
 
 #include "base/check_op.h"
+#include "base/feature_list.h"
 #include "base/trace_event/trace_event.h"
+#include "components/subresource_filter/core/common/common_features.h"
 #include "components/subresource_filter/core/common/first_party_origin.h"
 #include "components/subresource_filter/core/common/memory_mapped_ruleset.h"
 #include "components/subresource_filter/core/common/scoped_timers.h"
@@ -18,13 +20,24 @@
 
 namespace subresource_filter {
 
+namespace {
+
+// The number of subresource loads whose matched rule is cached. Most pages
+// make fewer requests than this.
+constexpr size_t kMatchedRulesCacheSize = 256;
+
+}  // namespace
+
 DocumentSubresourceFilter::DocumentSubresourceFilter(
     url::Origin document_origin,
     mojom::ActivationState activation_state,
     scoped_refptr<const MemoryMappedRuleset> ruleset)
     : activation_state_(activation_state),
       ruleset_(std::move(ruleset)),
-      ruleset_matcher_(ruleset_->data(), ruleset_->length()) {
+      ruleset_matcher_(ruleset_->data(), ruleset_->length()),
+      use_matched_rules_cache_(
+          base::FeatureList::IsEnabled(kDocumentSubresourceFilterMatchCache)),
+      matched_rules_(kMatchedRulesCacheSize) {
   DCHECK_NE(activation_state_.activation_level,
             mojom::ActivationLevel::kDisabled);
   if (!activation_state_.filtering_disabled_for_document) {
@@ -68,9 +81,8 @@ LoadPolicy DocumentSubresourceFilter::GetLoadPolicy(
 
   ++statistics_.num_loads_evaluated;
   DCHECK(document_origin_);
-  LoadPolicy result = ruleset_matcher_.GetLoadPolicyForResourceLoad(
-      subresource_url, *document_origin_, subresource_type,
-      activation_state_.generic_blocking_rules_disabled);
+  LoadPolicy result = IndexedRulesetMatcher::GetLoadPolicyForMatchedRule(
+      MatchUrlRule(subresource_url, subresource_type));
   DCHECK_NE(LoadPolicy::WOULD_DISALLOW, result);
   if (result == LoadPolicy::DISALLOW) {
     ++statistics_.num_loads_matching_rules;
@@ -95,9 +107,30 @@ DocumentSubresourceFilter::FindMatchingUrlRule(
   if (subresource_url.SchemeIs(url::kDataScheme))
     return nullptr;
 
-  return ruleset_matcher_.MatchedUrlRule(
-      subresource_url, *document_origin_, subresource_type,
-      activation_state_.generic_blocking_rules_disabled);
+  return MatchUrlRule(subresource_url, subresource_type);
+}
+
+const url_pattern_index::flat::UrlRule* DocumentSubresourceFilter::MatchUrlRule(
+    const GURL& subresource_url,
+    url_pattern_index::proto::ElementType subresource_type) {
+  DCHECK(document_origin_);
+  if (!use_matched_rules_cache_ || !subresource_url.is_valid()) {
+    return ruleset_matcher_.MatchedUrlRule(
+        subresource_url, *document_origin_, subresource_type,
+        activation_state_.generic_blocking_rules_disabled);
+  }
+
+  auto key = std::make_pair(subresource_url.spec(), subresource_type);
+  auto it = matched_rules_.Get(key);
+  if (it != matched_rules_.end())
+    return it->second;
+
+  const url_pattern_index::flat::UrlRule* rule =
+      ruleset_matcher_.MatchedUrlRule(
+          subresource_url, *document_origin_, subresource_type,
+          activation_state_.generic_blocking_rules_disabled);
+  matched_rules_.Put(std::move(key), rule);
+  return rule;
 }
 
 }  // namespace subresource_filter
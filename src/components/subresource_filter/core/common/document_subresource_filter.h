@@ -8,7 +8,10 @@
 #include <stddef.h>
 
 #include <memory>
+#include <string>
+#include <utility>
 
+#include "base/containers/mru_cache.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "components/subresource_filter/core/common/indexed_ruleset.h"
@@ -67,9 +70,16 @@ class DocumentSubresourceFilter {
   // subresources.
   void set_activation_state(const mojom::ActivationState& state) {
     activation_state_ = state;
+    matched_rules_.Clear();
   }
 
  private:
+  // Returns the rule matched by |ruleset_matcher_| for the subresource load,
+  // from |matched_rules_| if it was recently matched.
+  const url_pattern_index::flat::UrlRule* MatchUrlRule(
+      const GURL& subresource_url,
+      url_pattern_index::proto::ElementType subresource_type);
+
   mojom::ActivationState activation_state_;
   const scoped_refptr<const MemoryMappedRuleset> ruleset_;
   const IndexedRulesetMatcher ruleset_matcher_;
@@ -79,6 +89,14 @@ class DocumentSubresourceFilter {
 
   mojom::DocumentLoadStatistics statistics_;
 
+  // The rules matched by the most recent subresource loads, or nullptr for
+  // the loads that did not match any, by URL spec and element type. Only
+  // used if kDocumentSubresourceFilterMatchCache is enabled.
+  const bool use_matched_rules_cache_;
+  base::MRUCache<std::pair<std::string, url_pattern_index::proto::ElementType>,
+                 const url_pattern_index::flat::UrlRule*>
+      matched_rules_;
+
   DISALLOW_COPY_AND_ASSIGN(DocumentSubresourceFilter);
 };
 
@@ -7,6 +7,8 @@
 #include "base/files/file.h"
 #include "base/macros.h"
 #include "base/strings/string_piece.h"
+#include "base/test/scoped_feature_list.h"
+#include "components/subresource_filter/core/common/common_features.h"
 #include "components/subresource_filter/core/common/memory_mapped_ruleset.h"
 #include "components/subresource_filter/core/common/test_ruleset_creator.h"
 #include "components/subresource_filter/core/common/test_ruleset_utils.h"
@@ -172,4 +174,43 @@ TEST_F(DocumentSubresourceFilterTest, MatchingRuleEnabled) {
             filter.FindMatchingUrlRule(GURL(kTestBetaURL), kSubdocumentType));
 }
 
+TEST_F(DocumentSubresourceFilterTest, MatchCache) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeature(kDocumentSubresourceFilterMatchCache);
+  mojom::ActivationState activation_state;
+  activation_state.activation_level = kEnabled;
+  activation_state.measure_performance = false;
+  DocumentSubresourceFilter filter(url::Origin(), activation_state, ruleset());
+
+  // Repeated loads are counted, and get the same policy, whether or not their
+  // rule was cached.
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(LoadPolicy::DISALLOW,
+              filter.GetLoadPolicy(GURL(kTestAlphaURL), kImageType));
+    EXPECT_EQ(LoadPolicy::ALLOW,
+              filter.GetLoadPolicy(GURL(kTestBetaURL), kImageType));
+    EXPECT_EQ(LoadPolicy::DISALLOW,
+              filter.GetLoadPolicy(GURL(kTestAlphaURL), kSubdocumentType));
+    EXPECT_NE(nullptr,
+              filter.FindMatchingUrlRule(GURL(kTestAlphaURL), kImageType));
+    EXPECT_EQ(nullptr,
+              filter.FindMatchingUrlRule(GURL(kTestBetaURL), kImageType));
+  }
+
+  const auto& statistics = filter.statistics();
+  EXPECT_EQ(6, statistics.num_loads_total);
+  EXPECT_EQ(6, statistics.num_loads_evaluated);
+  EXPECT_EQ(4, statistics.num_loads_matching_rules);
+  EXPECT_EQ(4, statistics.num_loads_disallowed);
+
+  // The rules cached for the previous activation state are dropped. The test
+  // rule is generic, so no longer matches.
+  activation_state.generic_blocking_rules_disabled = true;
+  filter.set_activation_state(activation_state);
+  EXPECT_EQ(LoadPolicy::ALLOW,
+            filter.GetLoadPolicy(GURL(kTestAlphaURL), kImageType));
+  EXPECT_EQ(nullptr,
+            filter.FindMatchingUrlRule(GURL(kTestAlphaURL), kImageType));
+}
+
 }  // namespace subresource_filter
@@ -4,6 +4,9 @@
 
 #include "components/subresource_filter/core/common/indexed_ruleset.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "base/check.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/trace_event/trace_event.h"
@@ -146,9 +149,51 @@ LoadPolicy IndexedRulesetMatcher::GetLoadPolicyForResourceLoad(
     const FirstPartyOrigin& first_party,
     proto::ElementType element_type,
     bool disable_generic_rules) const {
-  const url_pattern_index::flat::UrlRule* rule =
-      MatchedUrlRule(url, first_party, element_type, disable_generic_rules);
+  return GetLoadPolicyForMatchedRule(
+      MatchedUrlRule(url, first_party, element_type, disable_generic_rules));
+}
+
+std::vector<LoadPolicy> IndexedRulesetMatcher::GetLoadPoliciesForResourceLoads(
+    const std::vector<ResourceLoad>& loads,
+    const FirstPartyOrigin& first_party,
+    bool disable_generic_rules) const {
+  // Visit the loads sorted by host, which hits the one-entry third-partiness
+  // cache of |first_party| for all but the first load from each host, then by
+  // URL and element type, which makes the duplicate loads adjacent.
+  std::vector<size_t> order(loads.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&loads](size_t lhs, size_t rhs) {
+    const ResourceLoad& a = loads[lhs];
+    const ResourceLoad& b = loads[rhs];
+    const int host_order = a.url.host_piece().compare(b.url.host_piece());
+    if (host_order)
+      return host_order < 0;
+    const int spec_order =
+        a.url.possibly_invalid_spec().compare(b.url.possibly_invalid_spec());
+    if (spec_order)
+      return spec_order < 0;
+    return a.element_type < b.element_type;
+  });
+
+  std::vector<LoadPolicy> policies(loads.size(), LoadPolicy::ALLOW);
+  const ResourceLoad* previous_load = nullptr;
+  for (size_t index : order) {
+    const ResourceLoad& load = loads[index];
+    if (previous_load && previous_load->element_type == load.element_type &&
+        previous_load->url == load.url) {
+      policies[index] = policies[previous_load - loads.data()];
+      continue;
+    }
+    policies[index] = GetLoadPolicyForResourceLoad(
+        load.url, first_party, load.element_type, disable_generic_rules);
+    previous_load = &load;
+  }
+  return policies;
+}
 
+// static
+LoadPolicy IndexedRulesetMatcher::GetLoadPolicyForMatchedRule(
+    const url_pattern_index::flat::UrlRule* rule) {
   if (!rule)
     return LoadPolicy::ALLOW;
 
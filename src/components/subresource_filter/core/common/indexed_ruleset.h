@@ -8,14 +8,15 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <vector>
+
 #include "base/macros.h"
 #include "base/numerics/safe_conversions.h"
 #include "components/subresource_filter/core/common/flat/indexed_ruleset_generated.h"
 #include "components/subresource_filter/core/common/load_policy.h"
 #include "components/url_pattern_index/url_pattern_index.h"
 #include "third_party/flatbuffers/src/include/flatbuffers/flatbuffers.h"
-
-class GURL;
+#include "url/gurl.h"
 
 namespace url {
 class Origin;
@@ -96,6 +97,12 @@ class RulesetIndexer {
 // Matches URLs against the FlatBuffer representation of an indexed ruleset.
 class IndexedRulesetMatcher {
  public:
+  // A network request to match with GetLoadPoliciesForResourceLoads.
+  struct ResourceLoad {
+    GURL url;
+    url_pattern_index::proto::ElementType element_type;
+  };
+
   // Returns whether the |buffer| of the given |size| contains a valid
   // flat::IndexedRuleset FlatBuffer.
   static bool Verify(const uint8_t* buffer, size_t size, int expected_checksum);
@@ -125,6 +132,21 @@ class IndexedRulesetMatcher {
       url_pattern_index::proto::ElementType element_type,
       bool disable_generic_rules) const;
 
+  // Returns the LoadPolicy of each of |loads|, all initiated by |first_party|,
+  // as GetLoadPolicyForResourceLoad would. The loads are matched grouped by
+  // host, so the third-partiness of each host is checked once, and the loads
+  // with the same URL and element type, common in a page load, are matched
+  // once.
+  std::vector<LoadPolicy> GetLoadPoliciesForResourceLoads(
+      const std::vector<ResourceLoad>& loads,
+      const FirstPartyOrigin& first_party,
+      bool disable_generic_rules) const;
+
+  // Returns the LoadPolicy for a network request that |rule| was matched for
+  // by MatchedUrlRule, or ALLOW if no rule was matched.
+  static LoadPolicy GetLoadPolicyForMatchedRule(
+      const url_pattern_index::flat::UrlRule* rule);
+
   // Like ShouldDisallowResourceLoad, but returns the matching rule that
   // determines whether the request should be allowed or not. Allowlist rules
   // override blocklist rules. If no rule matches, returns nullptr.
@@ -5,6 +5,7 @@
 #include "components/subresource_filter/core/common/indexed_ruleset.h"
 
 #include <memory>
+#include <vector>
 
 #include "base/check.h"
 #include "base/macros.h"
@@ -276,6 +277,50 @@ TEST_F(SubresourceFilterIndexedRulesetTest, SimpleBlocklistAndAllowlist) {
   EXPECT_EQ(LoadPolicy::ALLOW, GetLoadPolicy("https://notblocklisted.com"));
 }
 
+TEST_F(SubresourceFilterIndexedRulesetTest, BatchOfResourceLoads) {
+  ASSERT_TRUE(AddSimpleRule("?filter="));
+  ASSERT_TRUE(AddSimpleAllowlistRule("allowlisted.com/?filter="));
+  auto third_party_rule =
+      MakeUrlRule(UrlPattern("tracker.js", testing::kSubstring));
+  third_party_rule.set_source_type(proto::SOURCE_TYPE_THIRD_PARTY);
+  ASSERT_TRUE(AddUrlRule(third_party_rule));
+  Finish();
+
+  const std::vector<IndexedRulesetMatcher::ResourceLoad> loads = {
+      {GURL("https://example.com/tracker.js"), testing::kOther},
+      {GURL("https://cdn.com/tracker.js"), testing::kOther},
+      {GURL("https://example.com/?filter=on"), testing::kOther},
+      {GURL("https://allowlisted.com/?filter=on"), testing::kOther},
+      {GURL("https://cdn.com/tracker.js"), testing::kOther},
+      {GURL("https://cdn.com/tracker.js"), testing::kSubdocument},
+      {GURL("https://example.com/image.png"), testing::kOther},
+      {GURL("https://allowlisted.com/?filter=on"), testing::kSubdocument},
+      {GURL("https://example.com/?filter=on"), testing::kOther},
+      {GURL(), testing::kOther},
+  };
+  const std::vector<LoadPolicy> expected_policies = {
+      LoadPolicy::ALLOW,           LoadPolicy::DISALLOW,
+      LoadPolicy::DISALLOW,        LoadPolicy::EXPLICITLY_ALLOW,
+      LoadPolicy::DISALLOW,        LoadPolicy::DISALLOW,
+      LoadPolicy::ALLOW,           LoadPolicy::EXPLICITLY_ALLOW,
+      LoadPolicy::DISALLOW,        LoadPolicy::ALLOW,
+  };
+
+  const FirstPartyOrigin first_party(testing::GetOrigin("https://example.com"));
+  EXPECT_EQ(expected_policies,
+            matcher_->GetLoadPoliciesForResourceLoads(loads, first_party,
+                                                      false));
+  for (size_t i = 0; i < loads.size(); ++i) {
+    EXPECT_EQ(expected_policies[i],
+              GetLoadPolicy(loads[i].url.possibly_invalid_spec(),
+                            "https://example.com", loads[i].element_type))
+        << loads[i].url.possibly_invalid_spec();
+  }
+  EXPECT_TRUE(
+      matcher_->GetLoadPoliciesForResourceLoads({}, first_party, false)
+          .empty());
+}
+
 TEST_F(SubresourceFilterIndexedRulesetTest,
        OneBlocklistAndOneDeactivationRule) {
   ASSERT_TRUE(AddSimpleRule("example.com"));
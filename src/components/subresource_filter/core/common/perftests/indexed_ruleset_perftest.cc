@@ -8,6 +8,7 @@
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/files/file.h"
 #include "base/files/file_path.h"
@@ -17,13 +18,23 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/path_service.h"
+#include "base/stl_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/time/time.h"
 #include "base/timer/elapsed_timer.h"
+#include "components/subresource_filter/core/common/common_features.h"
+#include "components/subresource_filter/core/common/document_subresource_filter.h"
+#include "components/subresource_filter/core/common/first_party_origin.h"
+#include "components/subresource_filter/core/common/indexed_ruleset.h"
+#include "components/subresource_filter/core/common/load_policy.h"
 #include "components/subresource_filter/core/common/memory_mapped_ruleset.h"
 #include "components/subresource_filter/tools/filter_tool.h"
 #include "components/subresource_filter/tools/indexing_tool.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_result_reporter.h"
+#include "url/gurl.h"
+#include "url/origin.h"
 
 namespace subresource_filter {
 
@@ -32,6 +43,68 @@ namespace {
 static constexpr char kMetricIndexAndWriteTimeUs[] = "index_and_write_time";
 static constexpr char kMetricMedianMatchTimeUs[] = "median_match_time";
 
+namespace proto = url_pattern_index::proto;
+
+// The shape of the synthetic page loads: each page makes |kRequestsPerPage|
+// requests, spread over its own host, a CDN and a few third-party hosts shared
+// by all the pages, and repeats some of them.
+constexpr size_t kNumPages = 100;
+constexpr size_t kRequestsPerPage = 200;
+constexpr size_t kDistinctPathsPerHost = 30;
+
+constexpr const char* kSharedHosts[] = {
+    "https://www.google-analytics.com",
+    "https://securepubads.g.doubleclick.net",
+    "https://pagead2.googlesyndication.com",
+    "https://connect.facebook.net",
+    "https://fonts.gstatic.com",
+};
+
+constexpr proto::ElementType kElementTypes[] = {
+    proto::ELEMENT_TYPE_SCRIPT, proto::ELEMENT_TYPE_IMAGE,
+    proto::ELEMENT_TYPE_STYLESHEET, proto::ELEMENT_TYPE_XMLHTTPREQUEST,
+    proto::ELEMENT_TYPE_SUBDOCUMENT};
+
+struct PageLoad {
+  url::Origin origin;
+  std::vector<IndexedRulesetMatcher::ResourceLoad> loads;
+};
+
+std::vector<PageLoad> CreatePageLoads() {
+  std::vector<PageLoad> pages;
+  for (size_t page = 0; page < kNumPages; ++page) {
+    const std::string host =
+        base::StringPrintf("https://www.site%zu.com", page);
+    const std::string cdn_host =
+        base::StringPrintf("https://cdn.site%zu.net", page);
+    PageLoad page_load;
+    page_load.origin = url::Origin::Create(GURL(host));
+    for (size_t i = 0; i < kRequestsPerPage; ++i) {
+      std::string request_host;
+      switch (i % 4) {
+        case 0:
+          request_host = host;
+          break;
+        case 1:
+          request_host = cdn_host;
+          break;
+        default:
+          request_host = kSharedHosts[i % base::size(kSharedHosts)];
+          break;
+      }
+      const size_t path = (i * 7) % kDistinctPathsPerHost;
+      const proto::ElementType element_type =
+          kElementTypes[path % base::size(kElementTypes)];
+      page_load.loads.push_back(
+          {GURL(base::StringPrintf("%s/assets/%zu/resource.js?v=%zu",
+                                   request_host.c_str(), path, page)),
+           element_type});
+    }
+    pages.push_back(std::move(page_load));
+  }
+  return pages;
+}
+
 }  // namespace
 
 class IndexedRulesetPerftest : public testing::Test {
@@ -64,17 +137,42 @@ class IndexedRulesetPerftest : public testing::Test {
     base::File indexed_file =
         base::File(indexed_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
     ASSERT_TRUE(indexed_file.IsValid());
-    auto ruleset = subresource_filter::MemoryMappedRuleset::CreateAndInitialize(
+    ruleset_ = subresource_filter::MemoryMappedRuleset::CreateAndInitialize(
         std::move(indexed_file));
-    filter_tool_ = std::make_unique<FilterTool>(std::move(ruleset), &output_);
+    filter_tool_ = std::make_unique<FilterTool>(ruleset_, &output_);
   }
 
   FilterTool* filter_tool() { return filter_tool_.get(); }
 
+  scoped_refptr<const MemoryMappedRuleset> ruleset() const { return ruleset_; }
+
   const std::string& requests() const { return requests_; }
 
   const base::FilePath& unindexed_path() const { return unindexed_path_; }
 
+  // Matches the requests of each synthetic page load through a document
+  // filter, as a renderer does.
+  void RunDocumentFilterTest(const std::string& story_name) {
+    const std::vector<PageLoad> pages = CreatePageLoads();
+    mojom::ActivationState activation_state;
+    activation_state.activation_level = mojom::ActivationLevel::kEnabled;
+    std::vector<int64_t> results;
+    for (int i = 0; i < 5; ++i) {
+      base::ElapsedTimer timer;
+      for (const PageLoad& page : pages) {
+        DocumentSubresourceFilter filter(page.origin, activation_state,
+                                         ruleset());
+        for (const auto& load : page.loads)
+          filter.GetLoadPolicy(load.url, load.element_type);
+      }
+      results.push_back(timer.Elapsed().InMicroseconds());
+    }
+    std::sort(results.begin(), results.end());
+    perf_test::PerfResultReporter reporter = SetUpReporter(story_name);
+    reporter.AddResult(kMetricMedianMatchTimeUs,
+                       static_cast<size_t>(results[2]));
+  }
+
   perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
     perf_test::PerfResultReporter reporter("IndexedRuleset.", story_name);
     reporter.RegisterImportantMetric(kMetricIndexAndWriteTimeUs, "us");
@@ -92,6 +190,7 @@ class IndexedRulesetPerftest : public testing::Test {
   // fail so things should be a bit faster than writing to a string.
   std::ofstream output_;
 
+  scoped_refptr<const MemoryMappedRuleset> ruleset_;
   std::unique_ptr<FilterTool> filter_tool_;
   DISALLOW_COPY_AND_ASSIGN(IndexedRulesetPerftest);
 };
@@ -122,4 +221,57 @@ TEST_F(IndexedRulesetPerftest, MatchAll) {
   reporter.AddResult(kMetricMedianMatchTimeUs, static_cast<size_t>(results[2]));
 }
 
+// Matches the requests of each synthetic page load one by one, as a document
+// does.
+TEST_F(IndexedRulesetPerftest, MatchPageLoads) {
+  const std::vector<PageLoad> pages = CreatePageLoads();
+  IndexedRulesetMatcher matcher(ruleset()->data(), ruleset()->length());
+  std::vector<int64_t> results;
+  for (int i = 0; i < 5; ++i) {
+    base::ElapsedTimer timer;
+    for (const PageLoad& page : pages) {
+      const FirstPartyOrigin first_party(page.origin);
+      for (const auto& load : page.loads) {
+        matcher.GetLoadPolicyForResourceLoad(load.url, first_party,
+                                             load.element_type, false);
+      }
+    }
+    results.push_back(timer.Elapsed().InMicroseconds());
+  }
+  std::sort(results.begin(), results.end());
+  perf_test::PerfResultReporter reporter = SetUpReporter("MatchPageLoads");
+  reporter.AddResult(kMetricMedianMatchTimeUs, static_cast<size_t>(results[2]));
+}
+
+// Matches the requests of each synthetic page load in one batch.
+TEST_F(IndexedRulesetPerftest, MatchPageLoadsBatched) {
+  const std::vector<PageLoad> pages = CreatePageLoads();
+  IndexedRulesetMatcher matcher(ruleset()->data(), ruleset()->length());
+  std::vector<int64_t> results;
+  for (int i = 0; i < 5; ++i) {
+    base::ElapsedTimer timer;
+    for (const PageLoad& page : pages) {
+      matcher.GetLoadPoliciesForResourceLoads(
+          page.loads, FirstPartyOrigin(page.origin), false);
+    }
+    results.push_back(timer.Elapsed().InMicroseconds());
+  }
+  std::sort(results.begin(), results.end());
+  perf_test::PerfResultReporter reporter =
+      SetUpReporter("MatchPageLoadsBatched");
+  reporter.AddResult(kMetricMedianMatchTimeUs, static_cast<size_t>(results[2]));
+}
+
+TEST_F(IndexedRulesetPerftest, MatchPageLoadsInDocument) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndDisableFeature(kDocumentSubresourceFilterMatchCache);
+  RunDocumentFilterTest("MatchPageLoadsInDocument");
+}
+
+TEST_F(IndexedRulesetPerftest, MatchPageLoadsInDocumentWithMatchCache) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeature(kDocumentSubresourceFilterMatchCache);
+  RunDocumentFilterTest("MatchPageLoadsInDocumentWithMatchCache");
+}
+
 }  // namespace subresource_filter
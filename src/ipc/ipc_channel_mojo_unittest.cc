@@ -8,6 +8,7 @@
 #include <stdint.h>
 
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "base/base_paths.h"
@@ -661,6 +662,60 @@ DEFINE_IPC_CHANNEL_MOJO_TEST_CLIENT(IPCChannelMojoTestSendOkClient) {
   Close();
 }
 
+// Larger than IPC::MessageView::kMaxInlineBytes, so that the message is sent
+// in shared memory.
+constexpr size_t kLargeMessageSize = 1024 * 1024;
+
+std::string GetLargeMessagePayload() {
+  std::string payload(kLargeMessageSize, 'a');
+  for (size_t i = 0; i < payload.size(); i += 4096)
+    payload[i] = 'a' + (i / 4096) % 26;
+  return payload;
+}
+
+class ListenerThatExpectsLargeMessage : public TestListenerBase {
+ public:
+  explicit ListenerThatExpectsLargeMessage(base::OnceClosure quit_closure)
+      : TestListenerBase(std::move(quit_closure)) {}
+
+  bool OnMessageReceived(const IPC::Message& message) override {
+    base::PickleIterator iter(message);
+    std::string payload;
+    EXPECT_TRUE(iter.ReadString(&payload));
+    EXPECT_EQ(GetLargeMessagePayload(), payload);
+    ListenerThatExpectsOK::SendOK(sender());
+    return true;
+  }
+};
+
+TEST_F(IPCChannelMojoTest, SendLargeMessage) {
+  Init("IPCChannelMojoTestSendLargeMessageClient");
+
+  base::RunLoop run_loop;
+  ListenerThatExpectsOK listener(run_loop.QuitClosure());
+  CreateChannel(&listener);
+  ASSERT_TRUE(ConnectChannel());
+
+  SendString(channel(), GetLargeMessagePayload());
+  run_loop.Run();
+
+  channel()->Close();
+
+  EXPECT_TRUE(WaitForClientShutdown());
+  DestroyChannel();
+}
+
+DEFINE_IPC_CHANNEL_MOJO_TEST_CLIENT(IPCChannelMojoTestSendLargeMessageClient) {
+  base::RunLoop run_loop;
+  ListenerThatExpectsLargeMessage listener(run_loop.QuitClosure());
+  Connect(&listener);
+  listener.set_sender(channel());
+
+  run_loop.Run();
+
+  Close();
+}
+
 class ListenerWithSimpleAssociatedInterface
     : public IPC::Listener,
       public IPC::mojom::SimpleTestDriver {
@@ -3,6 +3,8 @@
 // found in the LICENSE file.
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/check_op.h"
@@ -52,6 +54,18 @@ std::vector<TestParams> GetDefaultTestParams() {
   return list;
 }
 
+// Payloads like pickled bitmaps or clipboard data. Those larger than
+// MessageView::kMaxInlineBytes are sent in shared memory by ChannelMojo.
+std::vector<TestParams> GetLargeMessageTestParams() {
+  std::vector<TestParams> list;
+  list.push_back({64 * 1024, 20, 1, 5});
+  list.push_back({256 * 1024, 20, 1, 5});
+  list.push_back({1024 * 1024, 20, 1, 5});
+  list.push_back({4 * 1024 * 1024, 20, 1, 5});
+  list.push_back({16 * 1024 * 1024, 20, 1, 5});
+  return list;
+}
+
 std::string GetLogTitle(const std::string& label, const TestParams& params) {
   return base::StringPrintf(
       "%s_MsgSize_%zu_FrmPerSec_%zu_MsgPerFrm_%zu", label.c_str(),
@@ -218,7 +232,9 @@ class ChannelSteadyPingPongTest : public IPCChannelMojoTestBase {
   ChannelSteadyPingPongTest() = default;
   ~ChannelSteadyPingPongTest() override = default;
 
-  void RunPingPongServer(const std::string& label, bool sync) {
+  void RunPingPongServer(const std::string& label,
+                         bool sync,
+                         const std::vector<TestParams>& params_list) {
     Init("MojoPerfTestClient");
 
     // Set up IPC channel and start client.
@@ -243,7 +259,6 @@ class ChannelSteadyPingPongTest : public IPCChannelMojoTestBase {
     listener.Init(channel_proxy.get());
 
     LockThreadAffinity thread_locker(kSharedCore);
-    std::vector<TestParams> params_list = GetDefaultTestParams();
     for (const auto& params : params_list) {
       base::RunLoop run_loop;
 
@@ -265,11 +280,19 @@ class ChannelSteadyPingPongTest : public IPCChannelMojoTestBase {
 };
 
 TEST_F(ChannelSteadyPingPongTest, AsyncPingPong) {
-  RunPingPongServer("IPC_CPU_Async", false);
+  RunPingPongServer("IPC_CPU_Async", false, GetDefaultTestParams());
 }
 
 TEST_F(ChannelSteadyPingPongTest, SyncPingPong) {
-  RunPingPongServer("IPC_CPU_Sync", true);
+  RunPingPongServer("IPC_CPU_Sync", true, GetDefaultTestParams());
+}
+
+TEST_F(ChannelSteadyPingPongTest, AsyncPingPongLargeMessages) {
+  RunPingPongServer("IPC_CPU_Async", false, GetLargeMessageTestParams());
+}
+
+TEST_F(ChannelSteadyPingPongTest, SyncPingPongLargeMessages) {
+  RunPingPongServer("IPC_CPU_Sync", true, GetLargeMessageTestParams());
 }
 
 class MojoSteadyPingPongTest : public mojo::core::test::MojoTestBase {
@@ -277,7 +300,10 @@ class MojoSteadyPingPongTest : public mojo::core::test::MojoTestBase {
   MojoSteadyPingPongTest() = default;
 
  protected:
-  void RunPingPongServer(MojoHandle mp, const std::string& label, bool sync) {
+  void RunPingPongServer(MojoHandle mp,
+                         const std::string& label,
+                         bool sync,
+                         const std::vector<TestParams>& params_list) {
     label_ = label;
     sync_ = sync;
 
@@ -287,7 +313,6 @@ class MojoSteadyPingPongTest : public mojo::core::test::MojoTestBase {
         mojo::PendingRemote<IPC::mojom::Reflector>(std::move(scoped_mp), 0u));
 
     LockThreadAffinity thread_locker(kSharedCore);
-    std::vector<TestParams> params_list = GetDefaultTestParams();
     for (const auto& params : params_list) {
       params_ = params;
       payload_ = std::string(params.message_size, 'a');
@@ -413,14 +438,30 @@ DEFINE_TEST_CLIENT_WITH_PIPE(PingPongClient, MojoSteadyPingPongTest, h) {
 TEST_F(MojoSteadyPingPongTest, AsyncPingPong) {
   RunTestClient("PingPongClient", [&](MojoHandle h) {
     base::test::SingleThreadTaskEnvironment task_environment;
-    RunPingPongServer(h, "Mojo_CPU_Async", false);
+    RunPingPongServer(h, "Mojo_CPU_Async", false, GetDefaultTestParams());
   });
 }
 
 TEST_F(MojoSteadyPingPongTest, SyncPingPong) {
   RunTestClient("PingPongClient", [&](MojoHandle h) {
     base::test::SingleThreadTaskEnvironment task_environment;
-    RunPingPongServer(h, "Mojo_CPU_Sync", true);
+    RunPingPongServer(h, "Mojo_CPU_Sync", true, GetDefaultTestParams());
+  });
+}
+
+// Large payloads always travel inline in mojo messages, which gives a baseline
+// for the shared memory path of ChannelSteadyPingPongTest.
+TEST_F(MojoSteadyPingPongTest, AsyncPingPongLargeMessages) {
+  RunTestClient("PingPongClient", [&](MojoHandle h) {
+    base::test::SingleThreadTaskEnvironment task_environment;
+    RunPingPongServer(h, "Mojo_CPU_Async", false, GetLargeMessageTestParams());
+  });
+}
+
+TEST_F(MojoSteadyPingPongTest, SyncPingPongLargeMessages) {
+  RunTestClient("PingPongClient", [&](MojoHandle h) {
+    base::test::SingleThreadTaskEnvironment task_environment;
+    RunPingPongServer(h, "Mojo_CPU_Sync", true, GetLargeMessageTestParams());
   });
 }
 
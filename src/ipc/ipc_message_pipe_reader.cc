@@ -5,8 +5,10 @@
 #include "ipc/ipc_message_pipe_reader.h"
 
 #include <stdint.h>
+#include <string.h>
 
 #include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback_helpers.h"
@@ -14,6 +16,8 @@
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/macros.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/memory/shared_memory_mapping.h"
 #include "base/single_thread_task_runner.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/trace_event/trace_event.h"
@@ -120,6 +124,19 @@ bool MessagePipeReader::Send(std::unique_ptr<Message> message) {
 
   base::span<const uint8_t> bytes(static_cast<const uint8_t*>(message->data()),
                                   message->size());
+  if (bytes.size() > MessageView::kMaxInlineBytes) {
+    // Copy large messages to shared memory rather than into the mojo message,
+    // which the channel would copy again through the pipe. The bytes are sent
+    // inline if the region cannot be created.
+    base::MappedReadOnlyRegion shm =
+        base::ReadOnlySharedMemoryRegion::Create(bytes.size());
+    if (shm.IsValid()) {
+      memcpy(shm.mapping.memory(), bytes.data(), bytes.size());
+      sender_->Receive(MessageView(std::move(shm.region), std::move(handles)));
+      DVLOG(4) << "Send " << message->type() << ": " << message->size();
+      return true;
+    }
+  }
   sender_->Receive(MessageView(bytes, std::move(handles)));
   DVLOG(4) << "Send " << message->type() << ": " << message->size();
   return true;
@@ -137,12 +154,34 @@ void MessagePipeReader::SetPeerPid(int32_t peer_pid) {
 }
 
 void MessagePipeReader::Receive(MessageView message_view) {
-  if (message_view.bytes().empty()) {
+  base::span<const uint8_t> bytes = message_view.bytes();
+  std::vector<uint8_t> payload;
+  base::ReadOnlySharedMemoryRegion payload_region =
+      message_view.TakePayloadRegion();
+  if (payload_region.IsValid()) {
+    if (payload_region.GetSize() > Channel::kMaximumMessageSize) {
+      delegate_->OnBrokenDataReceived();
+      return;
+    }
+    base::ReadOnlySharedMemoryMapping mapping = payload_region.Map();
+    if (!mapping.IsValid()) {
+      delegate_->OnBrokenDataReceived();
+      return;
+    }
+    // The sender may still write to the region, so the message is copied out
+    // once before its header is validated, and the region is unmapped.
+    base::span<const uint8_t> mapped_bytes =
+        mapping.GetMemoryAsSpan<uint8_t>();
+    payload.assign(mapped_bytes.begin(), mapped_bytes.end());
+    bytes = payload;
+  }
+
+  if (bytes.empty()) {
     delegate_->OnBrokenDataReceived();
     return;
   }
-  Message message(reinterpret_cast<const char*>(message_view.bytes().data()),
-                  message_view.bytes().size());
+  // Only references |bytes|, which outlive the dispatch below.
+  Message message(reinterpret_cast<const char*>(bytes.data()), bytes.size());
   if (!message.IsValid()) {
     delegate_->OnBrokenDataReceived();
     return;
@@ -20,6 +20,12 @@ StructTraits<IPC::mojom::MessageDataView, IPC::MessageView>::handles(
   return view.TakeHandles();
 }
 
+base::ReadOnlySharedMemoryRegion
+StructTraits<IPC::mojom::MessageDataView, IPC::MessageView>::payload_region(
+    IPC::MessageView& view) {
+  return view.TakePayloadRegion();
+}
+
 // static
 bool StructTraits<IPC::mojom::MessageDataView, IPC::MessageView>::Read(
     IPC::mojom::MessageDataView data,
@@ -31,6 +37,18 @@ bool StructTraits<IPC::mojom::MessageDataView, IPC::MessageView>::Read(
   if (!data.ReadHandles(&handles))
     return false;
 
+  base::ReadOnlySharedMemoryRegion payload_region;
+  if (!data.ReadPayloadRegion(&payload_region))
+    return false;
+
+  if (payload_region.IsValid()) {
+    // A message is carried either inline or in shared memory, never both.
+    if (bytes.size())
+      return false;
+    *out = IPC::MessageView(std::move(payload_region), std::move(handles));
+    return true;
+  }
+
   *out = IPC::MessageView(bytes, std::move(handles));
   return true;
 }
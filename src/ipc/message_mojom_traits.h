@@ -8,8 +8,10 @@
 #include <vector>
 
 #include "base/containers/span.h"
+#include "base/memory/read_only_shared_memory_region.h"
 #include "ipc/ipc.mojom-shared.h"
 #include "ipc/message_view.h"
+#include "mojo/public/cpp/base/shared_memory_mojom_traits.h"
 #include "mojo/public/cpp/bindings/struct_traits.h"
 #include "mojo/public/interfaces/bindings/native_struct.mojom.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
@@ -22,6 +24,8 @@ class StructTraits<IPC::mojom::MessageDataView, IPC::MessageView> {
   static base::span<const uint8_t> bytes(IPC::MessageView& view);
   static absl::optional<std::vector<mojo::native::SerializedHandlePtr>> handles(
       IPC::MessageView& view);
+  static base::ReadOnlySharedMemoryRegion payload_region(
+      IPC::MessageView& view);
 
   static bool Read(IPC::mojom::MessageDataView data, IPC::MessageView* out);
 };
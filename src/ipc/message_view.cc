@@ -8,6 +8,8 @@
 
 namespace IPC {
 
+constexpr size_t MessageView::kMaxInlineBytes;
+
 MessageView::MessageView() = default;
 
 MessageView::MessageView(
@@ -15,6 +17,12 @@ MessageView::MessageView(
     absl::optional<std::vector<mojo::native::SerializedHandlePtr>> handles)
     : bytes_(bytes), handles_(std::move(handles)) {}
 
+MessageView::MessageView(
+    base::ReadOnlySharedMemoryRegion payload_region,
+    absl::optional<std::vector<mojo::native::SerializedHandlePtr>> handles)
+    : handles_(std::move(handles)),
+      payload_region_(std::move(payload_region)) {}
+
 MessageView::MessageView(MessageView&&) = default;
 
 MessageView::~MessageView() = default;
@@ -26,4 +34,8 @@ MessageView::TakeHandles() {
   return std::move(handles_);
 }
 
+base::ReadOnlySharedMemoryRegion MessageView::TakePayloadRegion() {
+  return std::move(payload_region_);
+}
+
 }  // namespace IPC
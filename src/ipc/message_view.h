@@ -5,11 +5,14 @@
 #ifndef IPC_MESSAGE_VIEW_H_
 #define IPC_MESSAGE_VIEW_H_
 
+#include <stddef.h>
+
 #include <vector>
 
 #include "base/component_export.h"
 #include "base/containers/span.h"
 #include "base/macros.h"
+#include "base/memory/read_only_shared_memory_region.h"
 #include "ipc/ipc_message.h"
 #include "mojo/public/interfaces/bindings/native_struct.mojom-forward.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
@@ -18,10 +21,17 @@ namespace IPC {
 
 class COMPONENT_EXPORT(IPC_MOJOM) MessageView {
  public:
+  // Messages larger than this are sent in a shared memory region, which spares
+  // the copies of the bytes through the message pipe.
+  static constexpr size_t kMaxInlineBytes = 64 * 1024;
+
   MessageView();
   MessageView(
       base::span<const uint8_t> bytes,
       absl::optional<std::vector<mojo::native::SerializedHandlePtr>> handles);
+  MessageView(
+      base::ReadOnlySharedMemoryRegion payload_region,
+      absl::optional<std::vector<mojo::native::SerializedHandlePtr>> handles);
   MessageView(MessageView&&);
   ~MessageView();
 
@@ -29,10 +39,13 @@ class COMPONENT_EXPORT(IPC_MOJOM) MessageView {
 
   base::span<const uint8_t> bytes() const { return bytes_; }
   absl::optional<std::vector<mojo::native::SerializedHandlePtr>> TakeHandles();
+  base::ReadOnlySharedMemoryRegion TakePayloadRegion();
 
  private:
   base::span<const uint8_t> bytes_;
   absl::optional<std::vector<mojo::native::SerializedHandlePtr>> handles_;
+  // Holds the bytes of the message instead of |bytes_| for large messages.
+  base::ReadOnlySharedMemoryRegion payload_region_;
 
   DISALLOW_COPY_AND_ASSIGN(MessageView);
 };
@@ -62,6 +62,29 @@ TEST(AudioConverterPerfTest, ConvertBenchmark) {
   RunConvertBenchmark(input_params, output_params, false, "convert");
 }
 
+TEST(AudioConverterPerfTest, ConvertBenchmarkMultiChannel) {
+  // Resample surround content between the most common rates, with and without
+  // a downmix to stereo.
+  AudioParameters input_5_1_params(AudioParameters::AUDIO_PCM_LINEAR,
+                                   CHANNEL_LAYOUT_5_1, 48000, 2048);
+  AudioParameters output_5_1_params(AudioParameters::AUDIO_PCM_LINEAR,
+                                    CHANNEL_LAYOUT_5_1, 44100, 440);
+  RunConvertBenchmark(input_5_1_params, output_5_1_params, false,
+                      "convert_6_channels");
+
+  AudioParameters input_7_1_params(AudioParameters::AUDIO_PCM_LINEAR,
+                                   CHANNEL_LAYOUT_7_1, 48000, 2048);
+  AudioParameters output_7_1_params(AudioParameters::AUDIO_PCM_LINEAR,
+                                    CHANNEL_LAYOUT_7_1, 44100, 440);
+  RunConvertBenchmark(input_7_1_params, output_7_1_params, false,
+                      "convert_8_channels");
+
+  AudioParameters output_stereo_params(AudioParameters::AUDIO_PCM_LINEAR,
+                                       CHANNEL_LAYOUT_STEREO, 44100, 440);
+  RunConvertBenchmark(input_7_1_params, output_stereo_params, false,
+                      "convert_8_channels_downmix");
+}
+
 TEST(AudioConverterPerfTest, ConvertBenchmarkFIFO) {
   // Create input and output parameters to convert between common buffer sizes
   // without any resampling for the FIFO vs no FIFO benchmarks.
@@ -7,6 +7,7 @@
 #include <sstream>
 
 #include "base/debug/alias.h"
+#include "media/base/decoder_buffer_pool.h"
 
 namespace media {
 
@@ -23,7 +24,17 @@ DecoderBuffer::DecoderBuffer(const uint8_t* data,
                              size_t size,
                              const uint8_t* side_data,
                              size_t side_data_size)
-    : size_(size), side_data_size_(side_data_size), is_key_frame_(false) {
+    : DecoderBuffer(nullptr, data, size, side_data, side_data_size) {}
+
+DecoderBuffer::DecoderBuffer(scoped_refptr<DecoderBufferPool> pool,
+                             const uint8_t* data,
+                             size_t size,
+                             const uint8_t* side_data,
+                             size_t side_data_size)
+    : size_(size),
+      side_data_size_(side_data_size),
+      is_key_frame_(false),
+      pool_(std::move(pool)) {
   if (!data) {
     CHECK_EQ(size_, 0u);
     CHECK(!side_data);
@@ -65,12 +76,17 @@ DecoderBuffer::DecoderBuffer(
       is_key_frame_(false) {}
 
 DecoderBuffer::~DecoderBuffer() {
+  if (pool_ && data_)
+    pool_->Recycle(std::move(data_), size_);
   data_.reset();
   side_data_.reset();
 }
 
 void DecoderBuffer::Initialize() {
-  data_.reset(new uint8_t[size_]);
+  if (pool_)
+    data_ = pool_->Allocate(size_);
+  else
+    data_.reset(new uint8_t[size_]);
   if (side_data_size_ > 0)
     side_data_.reset(new uint8_t[side_data_size_]);
 }
@@ -29,6 +29,8 @@
 
 namespace media {
 
+class DecoderBufferPool;
+
 // A specialized buffer for interfacing with audio / video decoders.
 //
 // Also includes decoder specific functionality for decryption.
@@ -218,6 +220,7 @@ class MEDIA_EXPORT DecoderBuffer
 
  protected:
   friend class base::RefCountedThreadSafe<DecoderBuffer>;
+  friend class DecoderBufferPool;
 
   // Allocates a buffer of size |size| >= 0 and copies |data| into it. If |data|
   // is NULL then |data_| is set to NULL and |buffer_size_| to 0.
@@ -227,6 +230,15 @@ class MEDIA_EXPORT DecoderBuffer
                 const uint8_t* side_data,
                 size_t side_data_size);
 
+  // Same as above, but |data_| is allocated from |pool| and returned to it on
+  // destruction. |pool| may be null, in which case |data_| is allocated from
+  // the heap.
+  DecoderBuffer(scoped_refptr<DecoderBufferPool> pool,
+                const uint8_t* data,
+                size_t size,
+                const uint8_t* side_data,
+                size_t side_data_size);
+
   DecoderBuffer(std::unique_ptr<uint8_t[]> data, size_t size);
 
   DecoderBuffer(std::unique_ptr<UnalignedSharedMemory> shm, size_t size);
@@ -274,6 +286,9 @@ class MEDIA_EXPORT DecoderBuffer
   rtc::scoped_refptr<webrtc::EncodedImageBufferInterface> encoded_data_;
 #endif
 
+  // Pool |data_| was allocated from, if any.
+  scoped_refptr<DecoderBufferPool> pool_;
+
   // Constructor helper method for memory allocations.
   void Initialize();
 
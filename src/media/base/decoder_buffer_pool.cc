@@ -0,0 +1,136 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/decoder_buffer_pool.h"
+
+#include <utility>
+
+#include "base/bits.h"
+#include "base/check_op.h"
+#include "media/base/decoder_buffer.h"
+#include "media/base/demuxer_memory_limit.h"
+
+namespace media {
+
+// static
+constexpr size_t DecoderBufferPool::kMinPooledSize;
+// static
+constexpr size_t DecoderBufferPool::kMaxPooledSize;
+// static
+constexpr size_t DecoderBufferPool::kDemuxerMemoryLimitDivisor;
+
+DecoderBufferPool::DecoderBufferPool(size_t max_cached_bytes)
+    : max_cached_bytes_(max_cached_bytes),
+      free_lists_(GetSizeClass(kMaxPooledSize) + 1) {}
+
+DecoderBufferPool::~DecoderBufferPool() = default;
+
+// static
+scoped_refptr<DecoderBufferPool> DecoderBufferPool::CreateForDemuxer(
+    Demuxer::DemuxerTypes demuxer_type) {
+  return base::MakeRefCounted<DecoderBufferPool>(
+      GetDemuxerMemoryLimit(demuxer_type) / kDemuxerMemoryLimitDivisor);
+}
+
+scoped_refptr<DecoderBuffer> DecoderBufferPool::CopyFrom(const uint8_t* data,
+                                                         size_t size) {
+  // If you hit this CHECK you likely have a bug in a demuxer. Go fix it.
+  CHECK(data);
+  return base::WrapRefCounted(
+      new DecoderBuffer(this, data, size, nullptr, 0));
+}
+
+scoped_refptr<DecoderBuffer> DecoderBufferPool::CopyFrom(
+    const uint8_t* data,
+    size_t size,
+    const uint8_t* side_data,
+    size_t side_data_size) {
+  // If you hit this CHECK you likely have a bug in a demuxer. Go fix it.
+  CHECK(data);
+  CHECK(side_data);
+  return base::WrapRefCounted(
+      new DecoderBuffer(this, data, size, side_data, side_data_size));
+}
+
+// static
+size_t DecoderBufferPool::GetSizeClass(size_t size) {
+  DCHECK_LE(size, kMaxPooledSize);
+  if (size <= kMinPooledSize)
+    return 0;
+
+  // |size| is in the octave (kMinPooledSize << octave, kMinPooledSize <<
+  // (octave + 1)], which is split in four size classes.
+  const int octave =
+      base::bits::Log2Floor(static_cast<uint32_t>((size - 1) / kMinPooledSize));
+  const size_t octave_base = kMinPooledSize << octave;
+  const size_t quarter = (size - 1 - octave_base) / (octave_base / 4);
+  return octave * 4 + quarter + 1;
+}
+
+// static
+size_t DecoderBufferPool::GetSizeClassCapacity(size_t size_class) {
+  if (size_class == 0)
+    return kMinPooledSize;
+  const size_t octave_base = kMinPooledSize << ((size_class - 1) / 4);
+  return octave_base + ((size_class - 1) % 4 + 1) * (octave_base / 4);
+}
+
+size_t DecoderBufferPool::allocation_count() const {
+  base::AutoLock auto_lock(lock_);
+  return allocation_count_;
+}
+
+size_t DecoderBufferPool::reuse_count() const {
+  base::AutoLock auto_lock(lock_);
+  return reuse_count_;
+}
+
+size_t DecoderBufferPool::cached_bytes() const {
+  base::AutoLock auto_lock(lock_);
+  return cached_bytes_;
+}
+
+std::unique_ptr<uint8_t[]> DecoderBufferPool::Allocate(size_t size) {
+  if (size > kMaxPooledSize) {
+    base::AutoLock auto_lock(lock_);
+    ++allocation_count_;
+    return std::unique_ptr<uint8_t[]>(new uint8_t[size]);
+  }
+
+  const size_t size_class = GetSizeClass(size);
+  {
+    base::AutoLock auto_lock(lock_);
+    auto& free_list = free_lists_[size_class];
+    if (!free_list.empty()) {
+      std::unique_ptr<uint8_t[]> data = std::move(free_list.back());
+      free_list.pop_back();
+      cached_bytes_ -= GetSizeClassCapacity(size_class);
+      ++reuse_count_;
+      return data;
+    }
+    ++allocation_count_;
+  }
+
+  // Allocate outside of the lock. The whole capacity of the size class is
+  // allocated so that the memory can be reused by any buffer of the class.
+  return std::unique_ptr<uint8_t[]>(
+      new uint8_t[GetSizeClassCapacity(size_class)]);
+}
+
+void DecoderBufferPool::Recycle(std::unique_ptr<uint8_t[]> data,
+                                size_t size) {
+  DCHECK(data);
+  if (size > kMaxPooledSize)
+    return;
+
+  const size_t size_class = GetSizeClass(size);
+  const size_t capacity = GetSizeClassCapacity(size_class);
+  base::AutoLock auto_lock(lock_);
+  if (cached_bytes_ + capacity > max_cached_bytes_)
+    return;
+  free_lists_[size_class].push_back(std::move(data));
+  cached_bytes_ += capacity;
+}
+
+}  // namespace media
@@ -0,0 +1,104 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MEDIA_BASE_DECODER_BUFFER_POOL_H_
+#define MEDIA_BASE_DECODER_BUFFER_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "media/base/demuxer.h"
+#include "media/base/media_export.h"
+
+namespace media {
+
+class DecoderBuffer;
+
+// Recycles the data memory of DecoderBuffers created from it, so that a
+// demuxer emitting a packet after another does not allocate and free a heap
+// buffer for each of them. The memory of a released buffer is kept in a free
+// list of its size class, up to |max_cached_bytes| for all the free lists, and
+// handed to the next buffer of the same size class.
+//
+// Buffers hold a reference to their pool, and may be released on any thread.
+class MEDIA_EXPORT DecoderBufferPool
+    : public base::RefCountedThreadSafe<DecoderBufferPool> {
+ public:
+  // Smallest and largest capacities of the size classes. Buffers larger than
+  // kMaxPooledSize are allocated and freed as usual.
+  static constexpr size_t kMinPooledSize = 256;
+  static constexpr size_t kMaxPooledSize = 4 * 1024 * 1024;
+
+  // Fraction of the demuxer memory limit which a pool created by
+  // CreateForDemuxer() may keep in its free lists.
+  static constexpr size_t kDemuxerMemoryLimitDivisor = 32;
+
+  explicit DecoderBufferPool(size_t max_cached_bytes);
+
+  // Creates a pool for a demuxer of type |demuxer_type|, which caches up to
+  // 1 / kDemuxerMemoryLimitDivisor of the GetDemuxerMemoryLimit() bytes the
+  // demuxer may keep in memory.
+  static scoped_refptr<DecoderBufferPool> CreateForDemuxer(
+      Demuxer::DemuxerTypes demuxer_type);
+
+  // Same as DecoderBuffer::CopyFrom(), but the data of the returned buffer is
+  // recycled from a previously released buffer of this pool when possible.
+  scoped_refptr<DecoderBuffer> CopyFrom(const uint8_t* data, size_t size);
+  scoped_refptr<DecoderBuffer> CopyFrom(const uint8_t* data,
+                                        size_t size,
+                                        const uint8_t* side_data,
+                                        size_t side_data_size);
+
+  // Returns the index of the size class of buffers of |size| bytes, and the
+  // capacity of the buffers of a size class. There are four size classes per
+  // power of two, so that rounding up to a size class wastes at most 25% of
+  // the buffer.
+  static size_t GetSizeClass(size_t size);
+  static size_t GetSizeClassCapacity(size_t size_class);
+
+  // Number of buffers whose data was allocated from the heap, and of buffers
+  // whose data was recycled.
+  size_t allocation_count() const;
+  size_t reuse_count() const;
+
+  // Bytes of memory currently held in the free lists.
+  size_t cached_bytes() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<DecoderBufferPool>;
+  friend class DecoderBuffer;
+
+  ~DecoderBufferPool();
+
+  // Returns memory for a buffer of |size| bytes, from the free list of its
+  // size class if possible.
+  std::unique_ptr<uint8_t[]> Allocate(size_t size);
+
+  // Returns the |data| of a released buffer of |size| bytes, which must have
+  // been returned by Allocate(|size|), to its free list. |data| is freed if
+  // the free lists are full.
+  void Recycle(std::unique_ptr<uint8_t[]> data, size_t size);
+
+  const size_t max_cached_bytes_;
+
+  mutable base::Lock lock_;
+  std::vector<std::vector<std::unique_ptr<uint8_t[]>>> free_lists_
+      GUARDED_BY(lock_);
+  size_t cached_bytes_ GUARDED_BY(lock_) = 0;
+  size_t allocation_count_ GUARDED_BY(lock_) = 0;
+  size_t reuse_count_ GUARDED_BY(lock_) = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(DecoderBufferPool);
+};
+
+}  // namespace media
+
+#endif  // MEDIA_BASE_DECODER_BUFFER_POOL_H_
@@ -0,0 +1,100 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/containers/circular_deque.h"
+#include "base/time/time.h"
+#include "media/base/decoder_buffer.h"
+#include "media/base/decoder_buffer_pool.h"
+#include "media/base/demuxer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace media {
+
+// Number of packets demuxed by each benchmark, ten minutes of 60fps video.
+static const int kPackets = 10 * 60 * 60;
+
+// Number of packets alive at once, buffered between the demuxer and the
+// decoder, and in the decoder itself.
+static const size_t kPacketsInFlight = 64;
+
+struct DecoderBufferPoolPerfTestParam {
+  const char* story;
+  // Average sizes of key and non key video frames.
+  size_t keyframe_size;
+  size_t frame_size;
+  int frames_per_keyframe;
+  bool use_pool;
+};
+
+static void RunDemuxBenchmark(const DecoderBufferPoolPerfTestParam& param) {
+  // Frame sizes vary by up to 50% around their average, like the output of a
+  // real encoder does.
+  std::vector<size_t> sizes(kPackets);
+  uint32_t seed = 1;
+  size_t total_bytes = 0;
+  for (int i = 0; i < kPackets; ++i) {
+    seed = seed * 1103515245 + 12345;
+    const size_t average_size = i % param.frames_per_keyframe == 0
+                                    ? param.keyframe_size
+                                    : param.frame_size;
+    sizes[i] = average_size / 2 + (seed >> 8) % average_size;
+    total_bytes += sizes[i];
+  }
+  const std::vector<uint8_t> packet_data(2 * param.keyframe_size);
+
+  scoped_refptr<DecoderBufferPool> pool =
+      DecoderBufferPool::CreateForDemuxer(
+          Demuxer::DemuxerTypes::kFFmpegDemuxer);
+  base::circular_deque<scoped_refptr<DecoderBuffer>> buffers_in_flight;
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kPackets; ++i) {
+    buffers_in_flight.push_back(
+        param.use_pool ? pool->CopyFrom(packet_data.data(), sizes[i])
+                       : DecoderBuffer::CopyFrom(packet_data.data(), sizes[i]));
+    if (buffers_in_flight.size() > kPacketsInFlight)
+      buffers_in_flight.pop_front();
+  }
+  buffers_in_flight.clear();
+  base::TimeDelta total_time = base::TimeTicks::Now() - start;
+
+  // Without a pool, every packet allocates its data.
+  const size_t allocations =
+      param.use_pool ? pool->allocation_count() : kPackets;
+
+  perf_test::PerfResultReporter reporter("decoder_buffer_pool", param.story);
+  reporter.RegisterImportantMetric("_throughput", "MB/s");
+  reporter.RegisterImportantMetric("_allocations", "count");
+  reporter.AddResult("_throughput",
+                     total_bytes / total_time.InSecondsF() / 1e6);
+  reporter.AddResult("_allocations", allocations);
+}
+
+class DecoderBufferPoolPerfTest
+    : public testing::TestWithParam<DecoderBufferPoolPerfTestParam> {};
+
+TEST_P(DecoderBufferPoolPerfTest, Demux) {
+  RunDemuxBenchmark(GetParam());
+}
+
+static const DecoderBufferPoolPerfTestParam kPerfTestParams[] = {
+    // 1080p60 at about 20Mbps, with two second GOPs.
+    {"1080p60_20mbps_heap", 400 * 1024, 40 * 1024, 120, false},
+    {"1080p60_20mbps_pool", 400 * 1024, 40 * 1024, 120, true},
+    // 2160p60 at about 60Mbps, with one second GOPs.
+    {"2160p60_60mbps_heap", 1024 * 1024, 120 * 1024, 60, false},
+    {"2160p60_60mbps_pool", 1024 * 1024, 120 * 1024, 60, true},
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         DecoderBufferPoolPerfTest,
+                         testing::ValuesIn(kPerfTestParams));
+
+}  // namespace media
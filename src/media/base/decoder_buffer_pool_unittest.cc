@@ -0,0 +1,138 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/decoder_buffer_pool.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "media/base/decoder_buffer.h"
+#include "media/base/stream_parser_buffer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+static std::vector<uint8_t> CreateData(size_t size, uint8_t seed) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i)
+    data[i] = static_cast<uint8_t>(seed + i);
+  return data;
+}
+
+TEST(DecoderBufferPoolTest, SizeClasses) {
+  EXPECT_EQ(0u, DecoderBufferPool::GetSizeClass(0));
+  EXPECT_EQ(0u, DecoderBufferPool::GetSizeClass(
+                    DecoderBufferPool::kMinPooledSize));
+  EXPECT_EQ(DecoderBufferPool::kMinPooledSize,
+            DecoderBufferPool::GetSizeClassCapacity(0));
+
+  // Every size fits in the capacity of its class, which is the smallest
+  // capacity that fits it and is no more than 25% larger than it.
+  size_t last_size_class = 0;
+  for (size_t size = DecoderBufferPool::kMinPooledSize + 1;
+       size <= DecoderBufferPool::kMaxPooledSize; size += size / 7 + 1) {
+    SCOPED_TRACE(size);
+    const size_t size_class = DecoderBufferPool::GetSizeClass(size);
+    const size_t capacity = DecoderBufferPool::GetSizeClassCapacity(size_class);
+    EXPECT_GE(size_class, last_size_class);
+    EXPECT_GE(capacity, size);
+    EXPECT_LT(DecoderBufferPool::GetSizeClassCapacity(size_class - 1), size);
+    EXPECT_LE(capacity, size + size / 4);
+    EXPECT_EQ(size_class, DecoderBufferPool::GetSizeClass(capacity));
+    last_size_class = size_class;
+  }
+  EXPECT_EQ(DecoderBufferPool::kMaxPooledSize,
+            DecoderBufferPool::GetSizeClassCapacity(
+                DecoderBufferPool::GetSizeClass(
+                    DecoderBufferPool::kMaxPooledSize)));
+}
+
+TEST(DecoderBufferPoolTest, RecyclesReleasedBuffers) {
+  auto pool = base::MakeRefCounted<DecoderBufferPool>(1024 * 1024);
+  const std::vector<uint8_t> data = CreateData(1000, 1);
+  scoped_refptr<DecoderBuffer> buffer =
+      pool->CopyFrom(data.data(), data.size());
+  ASSERT_EQ(data.size(), buffer->data_size());
+  EXPECT_EQ(0, memcmp(data.data(), buffer->data(), data.size()));
+  EXPECT_EQ(1u, pool->allocation_count());
+  EXPECT_EQ(0u, pool->cached_bytes());
+
+  const uint8_t* buffer_data = buffer->data();
+  buffer.reset();
+  const size_t capacity = DecoderBufferPool::GetSizeClassCapacity(
+      DecoderBufferPool::GetSizeClass(data.size()));
+  EXPECT_EQ(capacity, pool->cached_bytes());
+
+  // A buffer of another size in the same size class reuses the memory.
+  const std::vector<uint8_t> other_data = CreateData(capacity, 2);
+  buffer = pool->CopyFrom(other_data.data(), other_data.size());
+  EXPECT_EQ(buffer_data, buffer->data());
+  ASSERT_EQ(other_data.size(), buffer->data_size());
+  EXPECT_EQ(0, memcmp(other_data.data(), buffer->data(), other_data.size()));
+  EXPECT_EQ(1u, pool->allocation_count());
+  EXPECT_EQ(1u, pool->reuse_count());
+  EXPECT_EQ(0u, pool->cached_bytes());
+
+  // A buffer of a different size class does not.
+  buffer = pool->CopyFrom(data.data(), 100);
+  EXPECT_EQ(2u, pool->allocation_count());
+  EXPECT_EQ(1u, pool->reuse_count());
+}
+
+TEST(DecoderBufferPoolTest, MaxCachedBytes) {
+  const std::vector<uint8_t> data = CreateData(1000, 3);
+  const size_t capacity = DecoderBufferPool::GetSizeClassCapacity(
+      DecoderBufferPool::GetSizeClass(data.size()));
+  auto pool = base::MakeRefCounted<DecoderBufferPool>(capacity);
+
+  scoped_refptr<DecoderBuffer> first_buffer =
+      pool->CopyFrom(data.data(), data.size());
+  scoped_refptr<DecoderBuffer> second_buffer =
+      pool->CopyFrom(data.data(), data.size());
+  first_buffer.reset();
+  second_buffer.reset();
+  EXPECT_EQ(capacity, pool->cached_bytes());
+}
+
+TEST(DecoderBufferPoolTest, LargeBuffersAreNotCached) {
+  auto pool = base::MakeRefCounted<DecoderBufferPool>(
+      4 * DecoderBufferPool::kMaxPooledSize);
+  const std::vector<uint8_t> data =
+      CreateData(DecoderBufferPool::kMaxPooledSize + 1, 4);
+  scoped_refptr<DecoderBuffer> buffer =
+      pool->CopyFrom(data.data(), data.size());
+  EXPECT_EQ(0, memcmp(data.data(), buffer->data(), data.size()));
+  buffer.reset();
+  EXPECT_EQ(0u, pool->cached_bytes());
+}
+
+TEST(DecoderBufferPoolTest, SideData) {
+  auto pool = base::MakeRefCounted<DecoderBufferPool>(1024 * 1024);
+  const std::vector<uint8_t> data = CreateData(500, 5);
+  const std::vector<uint8_t> side_data = CreateData(10, 6);
+  scoped_refptr<DecoderBuffer> buffer = pool->CopyFrom(
+      data.data(), data.size(), side_data.data(), side_data.size());
+  EXPECT_TRUE(buffer->MatchesForTesting(*DecoderBuffer::CopyFrom(
+      data.data(), data.size(), side_data.data(), side_data.size())));
+}
+
+TEST(DecoderBufferPoolTest, StreamParserBuffer) {
+  auto pool = base::MakeRefCounted<DecoderBufferPool>(1024 * 1024);
+  const std::vector<uint8_t> data = CreateData(2000, 7);
+  scoped_refptr<StreamParserBuffer> buffer = StreamParserBuffer::CopyFrom(
+      pool.get(), data.data(), data.size(), true, DemuxerStream::VIDEO, 1);
+  EXPECT_EQ(0, memcmp(data.data(), buffer->data(), data.size()));
+  EXPECT_TRUE(buffer->is_key_frame());
+  buffer.reset();
+  EXPECT_GT(pool->cached_bytes(), 0u);
+
+  // A null pool allocates from the heap.
+  buffer = StreamParserBuffer::CopyFrom(nullptr, data.data(), data.size(),
+                                        false, DemuxerStream::VIDEO, 1);
+  EXPECT_EQ(0, memcmp(data.data(), buffer->data(), data.size()));
+}
+
+}  // namespace media
@@ -249,6 +249,11 @@ namespace media {
 const base::Feature kFFmpegDecodeOpaqueVP8{"FFmpegDecodeOpaqueVP8",
                                            base::FEATURE_ENABLED_BY_DEFAULT};
 
+// Size FFmpegVideoDecoder's thread count to the available cores and content
+// resolution, and decode into pooled, zero-copy frame buffers.
+const base::Feature kFFmpegVideoDecoderThreading{
+    "FFmpegVideoDecoderThreading", base::FEATURE_DISABLED_BY_DEFAULT};
+
 // Only used for disabling overlay fullscreen (aka SurfaceView) in Clank.
 const base::Feature kOverlayFullscreenVideo{"overlay-fullscreen-video",
                                             base::FEATURE_ENABLED_BY_DEFAULT};
@@ -909,6 +914,12 @@ const base::Feature kUseFakeDeviceForMediaStream{
 const base::Feature kBresenhamCadence{"BresenhamCadence",
                                       base::FEATURE_DISABLED_BY_DEFAULT};
 
+// Makes VideoRendererAlgorithm select frames for the vsync times predicted
+// from the measured render interval jitter, and VideoCadenceEstimator reuse
+// the cadences it found before for a render interval and frame duration.
+const base::Feature kJitterAwareVideoRendering{
+    "JitterAwareVideoRendering", base::FEATURE_DISABLED_BY_DEFAULT};
+
 // Display the playback speed button on the media controls.
 const base::Feature kPlaybackSpeedButton{"PlaybackSpeedButton",
                                          base::FEATURE_ENABLED_BY_DEFAULT};
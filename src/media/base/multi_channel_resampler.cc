@@ -10,17 +10,41 @@
 #include "base/bind.h"
 #include "base/callback_helpers.h"
 #include "base/check_op.h"
+#include "base/cpu.h"
+#include "build/build_config.h"
 #include "media/base/audio_bus.h"
 
 namespace media {
 
+// static
+int MultiChannelResampler::GetMinInterleavedChannels() {
+#if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  return kMinInterleavedChannelsAVX2OrNEON;
+#elif defined(ARCH_CPU_X86_FAMILY)
+  return base::CPU().has_avx2() ? kMinInterleavedChannelsAVX2OrNEON
+                                : kMinInterleavedChannelsSSE;
+#else
+  return kMinInterleavedChannelsSSE;
+#endif
+}
+
 MultiChannelResampler::MultiChannelResampler(int channels,
                                              double io_sample_rate_ratio,
                                              size_t request_size,
                                              const ReadCB read_cb)
     : read_cb_(std::move(read_cb)),
-      wrapped_resampler_audio_bus_(AudioBus::CreateWrapper(channels)),
+      interleaved_(channels >= GetMinInterleavedChannels()),
       output_frames_ready_(0) {
+  if (interleaved_) {
+    resamplers_.push_back(std::make_unique<SincResampler>(
+        channels, io_sample_rate_ratio, request_size,
+        base::BindRepeating(&MultiChannelResampler::ProvideInterleavedInput,
+                            base::Unretained(this))));
+    resampler_audio_bus_ = AudioBus::Create(channels, request_size);
+    channel_destinations_.resize(channels);
+    return;
+  }
+
   // Allocate each channel's resampler.
   resamplers_.reserve(channels);
   for (int i = 0; i < channels; ++i) {
@@ -31,6 +55,7 @@ MultiChannelResampler::MultiChannelResampler(int channels,
   }
 
   // Setup the wrapped AudioBus for channel data.
+  wrapped_resampler_audio_bus_ = AudioBus::CreateWrapper(channels);
   wrapped_resampler_audio_bus_->set_frames(request_size);
 
   // Allocate storage for all channels except the first, which will use the
@@ -47,7 +72,8 @@ MultiChannelResampler::MultiChannelResampler(int channels,
 MultiChannelResampler::~MultiChannelResampler() = default;
 
 void MultiChannelResampler::Resample(int frames, AudioBus* audio_bus) {
-  DCHECK_EQ(static_cast<size_t>(audio_bus->channels()), resamplers_.size());
+  DCHECK_EQ(static_cast<size_t>(audio_bus->channels()),
+            interleaved_ ? channel_destinations_.size() : resamplers_.size());
 
   // Optimize the single channel case to avoid the chunking process below.
   if (audio_bus->channels() == 1) {
@@ -64,6 +90,15 @@ void MultiChannelResampler::Resample(int frames, AudioBus* audio_bus) {
     int chunk_size = resamplers_[0]->ChunkSize();
     int frames_this_time = std::min(frames - output_frames_ready_, chunk_size);
 
+    if (interleaved_) {
+      for (size_t i = 0; i < channel_destinations_.size(); ++i)
+        channel_destinations_[i] = audio_bus->channel(i) + output_frames_ready_;
+      resamplers_[0]->ResampleMultiChannel(frames_this_time,
+                                           channel_destinations_.data());
+      output_frames_ready_ += frames_this_time;
+      continue;
+    }
+
     // Resample each channel.
     for (size_t i = 0; i < resamplers_.size(); ++i) {
       DCHECK_EQ(chunk_size, resamplers_[i]->ChunkSize());
@@ -102,6 +137,23 @@ void MultiChannelResampler::ProvideInput(int channel,
   }
 }
 
+void MultiChannelResampler::ProvideInterleavedInput(int frames,
+                                                    float* destination) {
+  DCHECK_EQ(frames, resampler_audio_bus_->frames());
+  read_cb_.Run(output_frames_ready_, resampler_audio_bus_.get());
+
+  // Interleave the planar data into the layout SincResampler expects; the
+  // padding samples at the end of each frame are left untouched.
+  const int channels = resampler_audio_bus_->channels();
+  const int channel_stride = resamplers_[0]->ChannelStride();
+  for (int ch = 0; ch < channels; ++ch) {
+    const float* source = resampler_audio_bus_->channel(ch);
+    float* dest = destination + ch;
+    for (int i = 0; i < frames; ++i, dest += channel_stride)
+      *dest = source[i];
+  }
+}
+
 void MultiChannelResampler::Flush() {
   for (size_t i = 0; i < resamplers_.size(); ++i)
     resamplers_[i]->Flush();
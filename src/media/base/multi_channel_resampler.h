@@ -18,9 +18,24 @@ namespace media {
 class AudioBus;
 
 // MultiChannelResampler is a multi channel wrapper for SincResampler; allowing
-// high quality sample rate conversion of multiple channels at once.
+// high quality sample rate conversion of multiple channels at once.  Layouts of
+// GetMinInterleavedChannels() or more channels are interleaved into a single
+// SincResampler, so the kernel for each output frame is chosen and evaluated
+// once for every channel.  Fewer channels would leave most of each SIMD vector
+// as padding, so each of them has its own SincResampler instead.
 class MEDIA_EXPORT MultiChannelResampler {
  public:
+  // The minimum number of channels resampled by a single interleaved
+  // SincResampler when it uses its AVX2 or NEON kernels, and when it uses its
+  // SSE or C kernels.  The interleaved SSE kernel is slower than per channel
+  // resampling for 5.1 layouts.
+  static constexpr int kMinInterleavedChannelsAVX2OrNEON = 4;
+  static constexpr int kMinInterleavedChannelsSSE = 8;
+
+  // Returns the minimum number of channels resampled by a single interleaved
+  // SincResampler on this CPU, picked like SincResampler picks its kernels.
+  static int GetMinInterleavedChannels();
+
   // Callback type for providing more data into the resampler.  Expects AudioBus
   // to be completely filled with data upon return; zero padded if not enough
   // frames are available to satisfy the request.  |frame_delay| is the number
@@ -63,24 +78,42 @@ class MEDIA_EXPORT MultiChannelResampler {
   // See SincResampler::PrimeWithSilence.
   void PrimeWithSilence();
 
+  bool is_interleaved_for_testing() const { return interleaved_; }
+
  private:
-  // SincResampler::ReadCB implementation.  ProvideInput() will be called for
-  // each channel (in channel order) as SincResampler needs more data.
+  // SincResampler::ReadCB implementation of the per channel resamplers.
+  // ProvideInput() will be called for each channel (in channel order) as
+  // SincResampler needs more data.
   void ProvideInput(int channel, int frames, float* destination);
 
+  // SincResampler::ReadCB implementation of the interleaved resampler.  Fills
+  // |destination| with |frames| of input, interleaved as SincResampler
+  // expects.
+  void ProvideInterleavedInput(int frames, float* destination);
+
   // Source of data for resampling.
   ReadCB read_cb_;
 
-  // Each channel has its own high quality resampler.
+  // Whether all channels are resampled by a single interleaved SincResampler.
+  const bool interleaved_;
+
+  // Either a high quality resampler for each channel, or a single one which
+  // resamples all channels at once if |interleaved_|.
   std::vector<std::unique_ptr<SincResampler>> resamplers_;
 
-  // Buffers for audio data going into SincResampler from ReadCB.
+  // Buffers for audio data going into SincResampler from ReadCB.  These are
+  // all channels except the first if each channel has its own resampler, or
+  // all the planar channels which are then interleaved if |interleaved_|.
   std::unique_ptr<AudioBus> resampler_audio_bus_;
 
   // To avoid a memcpy() on the first channel we create a wrapped AudioBus where
   // the first channel points to the |destination| provided to ProvideInput().
+  // Unused if |interleaved_|.
   std::unique_ptr<AudioBus> wrapped_resampler_audio_bus_;
 
+  // Per channel output pointers for SincResampler::ResampleMultiChannel().
+  std::vector<float*> channel_destinations_;
+
   // The number of output frames that have successfully been processed during
   // the current Resample() call.
   int output_frames_ready_;
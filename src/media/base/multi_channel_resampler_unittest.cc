@@ -9,7 +9,9 @@
 
 #include "base/bind.h"
 #include "base/callback_helpers.h"
+#include "base/cpu.h"
 #include "base/macros.h"
+#include "build/build_config.h"
 #include "media/base/audio_bus.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -133,9 +135,47 @@ TEST_P(MultiChannelResamplerTest, LowLatency) {
   LowLatencyTest(GetParam());
 }
 
-// Test common channel layouts: mono, stereo, 5.1, 7.1.
+// Test common channel layouts: mono, stereo, quad, 5.1, 7.1.  Quad and larger
+// layouts are resampled interleaved with the AVX2 and NEON kernels, and only
+// 7.1 with the SSE kernel.
 INSTANTIATE_TEST_SUITE_P(MultiChannelResamplerTest,
                          MultiChannelResamplerTest,
-                         testing::Values(1, 2, 6, 8));
+                         testing::Values(1, 2, 4, 6, 8));
+
+static bool HasAVX2OrNEON() {
+#if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  return true;
+#elif defined(ARCH_CPU_X86_FAMILY)
+  return base::CPU().has_avx2();
+#else
+  return false;
+#endif
+}
+
+static void ExpectInterleavedFrom(int min_interleaved_channels) {
+  EXPECT_EQ(min_interleaved_channels,
+            MultiChannelResampler::GetMinInterleavedChannels());
+  for (int channels = 1; channels <= 8; ++channels) {
+    MultiChannelResampler resampler(
+        channels, kScaleFactor, SincResampler::kDefaultRequestSize,
+        base::BindRepeating([](int frame_delay, AudioBus* audio_bus) {}));
+    EXPECT_EQ(channels >= min_interleaved_channels,
+              resampler.is_interleaved_for_testing())
+        << channels;
+  }
+}
+
+TEST(MultiChannelResamplerInterleavingTest, AVX2OrNEON) {
+  if (!HasAVX2OrNEON())
+    GTEST_SKIP();
+  ExpectInterleavedFrom(
+      MultiChannelResampler::kMinInterleavedChannelsAVX2OrNEON);
+}
+
+TEST(MultiChannelResamplerInterleavingTest, SSE) {
+  if (HasAVX2OrNEON())
+    GTEST_SKIP();
+  ExpectInterleavedFrom(MultiChannelResampler::kMinInterleavedChannelsSSE);
+}
 
 }  // namespace media
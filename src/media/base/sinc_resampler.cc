@@ -72,11 +72,16 @@
 //
 // Note: we're glossing over how the sub-sample handling works with
 // |virtual_source_idx_|, etc.
+//
+// Multi-channel resamplers use the same layout, but every frame in the input
+// buffer holds |channel_stride_| interleaved samples.  A single kernel choice
+// and a single pass over the kernel then produce an output for every channel.
 
 #include "media/base/sinc_resampler.h"
 
 #include <limits>
 
+#include "base/bits.h"
 #include "base/check_op.h"
 #include "base/cpu.h"
 #include "base/numerics/math_constants.h"
@@ -118,18 +123,24 @@ static double SincScaleFactor(double io_ratio) {
 void SincResampler::InitializeCPUSpecificFeatures() {
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
   convolve_proc_ = Convolve_NEON;
+  convolve_multi_channel_proc_ = ConvolveMultiChannel_NEON;
 #elif defined(ARCH_CPU_X86_FAMILY)
   base::CPU cpu;
   // Using AVX2 instead of SSE2 when AVX2 supported.
-  if (cpu.has_avx2())
+  if (cpu.has_avx2()) {
     convolve_proc_ = Convolve_AVX2;
-  else if (cpu.has_sse2())
+    convolve_multi_channel_proc_ = ConvolveMultiChannel_AVX2;
+  } else if (cpu.has_sse2()) {
     convolve_proc_ = Convolve_SSE;
-  else
+    convolve_multi_channel_proc_ = ConvolveMultiChannel_SSE;
+  } else {
     convolve_proc_ = Convolve_C;
+    convolve_multi_channel_proc_ = ConvolveMultiChannel_C;
+  }
 #else
   // Unknown architecture.
   convolve_proc_ = Convolve_C;
+  convolve_multi_channel_proc_ = ConvolveMultiChannel_C;
 #endif
 }
 
@@ -137,12 +148,26 @@ static int CalculateChunkSize(int block_size_, double io_ratio) {
   return block_size_ / io_ratio;
 }
 
+// Multi-channel frames are padded to a multiple of the SSE / NEON width so that
+// every frame in the input buffer is 16-byte aligned.
+static int CalculateChannelStride(int channels) {
+  return channels == 1 ? 1 : base::bits::AlignUp(channels, 4);
+}
+
 SincResampler::SincResampler(double io_sample_rate_ratio,
                              int request_frames,
                              const ReadCB read_cb)
+    : SincResampler(1, io_sample_rate_ratio, request_frames, read_cb) {}
+
+SincResampler::SincResampler(int channels,
+                             double io_sample_rate_ratio,
+                             int request_frames,
+                             const ReadCB read_cb)
     : io_sample_rate_ratio_(io_sample_rate_ratio),
       read_cb_(std::move(read_cb)),
       request_frames_(request_frames),
+      channels_(channels),
+      channel_stride_(CalculateChannelStride(channels)),
       input_buffer_size_(request_frames_ + kKernelSize),
       // Create input buffers with a 32-byte alignment for SIMD optimizations.
       kernel_storage_(static_cast<float*>(
@@ -151,10 +176,14 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
           base::AlignedAlloc(sizeof(float) * kKernelStorageSize, 32))),
       kernel_window_storage_(static_cast<float*>(
           base::AlignedAlloc(sizeof(float) * kKernelStorageSize, 32))),
-      input_buffer_(static_cast<float*>(
-          base::AlignedAlloc(sizeof(float) * input_buffer_size_, 32))),
+      input_buffer_(static_cast<float*>(base::AlignedAlloc(
+          sizeof(float) * input_buffer_size_ * channel_stride_,
+          32))),
+      convolve_output_(static_cast<float*>(
+          base::AlignedAlloc(sizeof(float) * channel_stride_, 32))),
       r1_(input_buffer_.get()),
-      r2_(input_buffer_.get() + kKernelSize / 2) {
+      r2_(input_buffer_.get() + kKernelSize / 2 * channel_stride_) {
+  CHECK_GT(channels, 0);
   CHECK_GT(request_frames, kKernelSize * 3 / 2)
       << "request_frames must be greater than 1.5 kernels to allow sufficient "
          "data for resampling";
@@ -181,10 +210,11 @@ SincResampler::~SincResampler() = default;
 void SincResampler::UpdateRegions(bool second_load) {
   // Setup various region pointers in the buffer (see diagram above).  If we're
   // on the second load we need to slide r0_ to the right by kKernelSize / 2.
-  r0_ = input_buffer_.get() + (second_load ? kKernelSize : kKernelSize / 2);
-  r3_ = r0_ + request_frames_ - kKernelSize;
-  r4_ = r0_ + request_frames_ - kKernelSize / 2;
-  block_size_ = r4_ - r2_;
+  r0_ = input_buffer_.get() +
+        (second_load ? kKernelSize : kKernelSize / 2) * channel_stride_;
+  r3_ = r0_ + (request_frames_ - kKernelSize) * channel_stride_;
+  r4_ = r0_ + (request_frames_ - kKernelSize / 2) * channel_stride_;
+  block_size_ = (r4_ - r2_) / channel_stride_;
   chunk_size_ = CalculateChunkSize(block_size_, io_sample_rate_ratio_);
 
   // r1_ at the beginning of the buffer.
@@ -256,9 +286,8 @@ void SincResampler::SetRatio(double io_sample_rate_ratio) {
   }
 }
 
-void SincResampler::Resample(int frames, float* destination) {
-  TRACE_EVENT1(TRACE_DISABLED_BY_DEFAULT("audio"), "SincResampler::Resample",
-               "io sample rate ratio", io_sample_rate_ratio_);
+template <typename ConvolveFn>
+void SincResampler::ResampleInternal(int frames, ConvolveFn convolve) {
   int remaining_frames = frames;
 
   // Step (1) -- Prime the input buffer at the start of the input stream.
@@ -268,6 +297,7 @@ void SincResampler::Resample(int frames, float* destination) {
   }
 
   // Step (2) -- Resample!
+  int frame = 0;
   while (remaining_frames) {
     // Silent audio can contain non-zero samples small enough to result in
     // subnormals internally. Disabling subnormals can be significantly faster.
@@ -293,13 +323,12 @@ void SincResampler::Resample(int frames, float* destination) {
         DCHECK_EQ(0u, reinterpret_cast<uintptr_t>(k2) & 0x1F);
 
         // Initialize input pointer based on quantized |virtual_source_idx_|.
-        const float* input_ptr = r1_ + source_idx;
+        const float* input_ptr = r1_ + source_idx * channel_stride_;
 
         // Figure out how much to weight each kernel's "convolution".
         const double kernel_interpolation_factor =
             virtual_offset_idx - offset_idx;
-        *destination++ =
-            convolve_proc_(input_ptr, k1, k2, kernel_interpolation_factor);
+        convolve(frame++, input_ptr, k1, k2, kernel_interpolation_factor);
 
         // Advance the virtual index.
         virtual_source_idx_ += io_sample_rate_ratio_;
@@ -314,7 +343,8 @@ void SincResampler::Resample(int frames, float* destination) {
 
     // Step (3) -- Copy r3_, r4_ to r1_, r2_.
     // This wraps the last input frames back to the start of the buffer.
-    memcpy(r1_, r3_, sizeof(*input_buffer_.get()) * kKernelSize);
+    memcpy(r1_, r3_,
+           sizeof(*input_buffer_.get()) * kKernelSize * channel_stride_);
 
     // Step (4) -- Reinitialize regions if necessary.
     if (r0_ == r2_)
@@ -325,6 +355,41 @@ void SincResampler::Resample(int frames, float* destination) {
   }
 }
 
+void SincResampler::Resample(int frames, float* destination) {
+  TRACE_EVENT1(TRACE_DISABLED_BY_DEFAULT("audio"), "SincResampler::Resample",
+               "io sample rate ratio", io_sample_rate_ratio_);
+  DCHECK_EQ(channels_, 1);
+  ResampleInternal(frames, [this, destination](int frame,
+                                               const float* input_ptr,
+                                               const float* k1, const float* k2,
+                                               double interpolation_factor) {
+    destination[frame] =
+        convolve_proc_(input_ptr, k1, k2, interpolation_factor);
+  });
+}
+
+void SincResampler::ResampleMultiChannel(int frames,
+                                         float* const* destinations) {
+  TRACE_EVENT2(TRACE_DISABLED_BY_DEFAULT("audio"),
+               "SincResampler::ResampleMultiChannel", "io sample rate ratio",
+               io_sample_rate_ratio_, "channels", channels_);
+  if (channels_ == 1) {
+    Resample(frames, destinations[0]);
+    return;
+  }
+
+  float* const output = convolve_output_.get();
+  ResampleInternal(frames, [this, destinations, output](
+                               int frame, const float* input_ptr,
+                               const float* k1, const float* k2,
+                               double interpolation_factor) {
+    convolve_multi_channel_proc_(channel_stride_, input_ptr, k1, k2,
+                                 interpolation_factor, output);
+    for (int ch = 0; ch < channels_; ++ch)
+      destinations[ch][frame] = output[ch];
+  });
+}
+
 void SincResampler::PrimeWithSilence() {
   // By enforcing the buffer hasn't been primed, we ensure the input buffer has
   // already been zeroed during construction or by a previous Flush() call.
@@ -337,7 +402,7 @@ void SincResampler::Flush() {
   virtual_source_idx_ = 0;
   buffer_primed_ = false;
   memset(input_buffer_.get(), 0,
-         sizeof(*input_buffer_.get()) * input_buffer_size_);
+         sizeof(*input_buffer_.get()) * input_buffer_size_ * channel_stride_);
   UpdateRegions(false);
 }
 
@@ -372,6 +437,28 @@ float SincResampler::Convolve_C(const float* input_ptr, const float* k1,
       kernel_interpolation_factor * sum2);
 }
 
+void SincResampler::ConvolveMultiChannel_C(int channel_stride,
+                                           const float* input_ptr,
+                                           const float* k1,
+                                           const float* k2,
+                                           double kernel_interpolation_factor,
+                                           float* output) {
+  for (int ch = 0; ch < channel_stride; ++ch) {
+    float sum1 = 0;
+    float sum2 = 0;
+    const float* channel_input_ptr = input_ptr + ch;
+    for (int i = 0; i < kKernelSize; ++i) {
+      sum1 += *channel_input_ptr * k1[i];
+      sum2 += *channel_input_ptr * k2[i];
+      channel_input_ptr += channel_stride;
+    }
+
+    // Linearly interpolate the two "convolutions".
+    output[ch] = static_cast<float>((1.0 - kernel_interpolation_factor) * sum1 +
+                                    kernel_interpolation_factor * sum2);
+  }
+}
+
 #if defined(ARCH_CPU_X86_FAMILY)
 float SincResampler::Convolve_SSE(const float* input_ptr, const float* k1,
                                   const float* k2,
@@ -458,6 +545,86 @@ __attribute__((target("avx2,fma"))) float SincResampler::Convolve_AVX2(
 
   return result;
 }
+
+void SincResampler::ConvolveMultiChannel_SSE(int channel_stride,
+                                             const float* input_ptr,
+                                             const float* k1,
+                                             const float* k2,
+                                             double kernel_interpolation_factor,
+                                             float* output) {
+  const __m128 m_factor1 =
+      _mm_set_ps1(static_cast<float>(1.0 - kernel_interpolation_factor));
+  const __m128 m_factor2 =
+      _mm_set_ps1(static_cast<float>(kernel_interpolation_factor));
+
+  // Every frame is 16-byte aligned since |channel_stride| is a multiple of 4,
+  // so each group of four channels is processed with aligned loads while the
+  // kernel taps are broadcast across channels.
+  for (int ch = 0; ch < channel_stride; ch += 4) {
+    __m128 m_sums1 = _mm_setzero_ps();
+    __m128 m_sums2 = _mm_setzero_ps();
+    const float* channel_input_ptr = input_ptr + ch;
+    for (int i = 0; i < kKernelSize; ++i) {
+      const __m128 m_input = _mm_load_ps(channel_input_ptr);
+      m_sums1 = _mm_add_ps(m_sums1, _mm_mul_ps(m_input, _mm_set_ps1(k1[i])));
+      m_sums2 = _mm_add_ps(m_sums2, _mm_mul_ps(m_input, _mm_set_ps1(k2[i])));
+      channel_input_ptr += channel_stride;
+    }
+
+    // Linearly interpolate the two "convolutions".
+    _mm_store_ps(output + ch, _mm_add_ps(_mm_mul_ps(m_sums1, m_factor1),
+                                         _mm_mul_ps(m_sums2, m_factor2)));
+  }
+}
+
+__attribute__((target("avx2,fma"))) void
+SincResampler::ConvolveMultiChannel_AVX2(int channel_stride,
+                                         const float* input_ptr,
+                                         const float* k1,
+                                         const float* k2,
+                                         double kernel_interpolation_factor,
+                                         float* output) {
+  const float factor1 = static_cast<float>(1.0 - kernel_interpolation_factor);
+  const float factor2 = static_cast<float>(kernel_interpolation_factor);
+
+  // Process eight channels at a time.  Frames are only guaranteed to be 16-byte
+  // aligned, so use unaligned loads.
+  int ch = 0;
+  for (; ch + 8 <= channel_stride; ch += 8) {
+    __m256 m_sums1 = _mm256_setzero_ps();
+    __m256 m_sums2 = _mm256_setzero_ps();
+    const float* channel_input_ptr = input_ptr + ch;
+    for (int i = 0; i < kKernelSize; ++i) {
+      const __m256 m_input = _mm256_loadu_ps(channel_input_ptr);
+      m_sums1 = _mm256_fmadd_ps(m_input, _mm256_set1_ps(k1[i]), m_sums1);
+      m_sums2 = _mm256_fmadd_ps(m_input, _mm256_set1_ps(k2[i]), m_sums2);
+      channel_input_ptr += channel_stride;
+    }
+
+    // Linearly interpolate the two "convolutions".
+    _mm256_storeu_ps(
+        output + ch,
+        _mm256_fmadd_ps(m_sums2, _mm256_set1_ps(factor2),
+                        _mm256_mul_ps(m_sums1, _mm256_set1_ps(factor1))));
+  }
+
+  // Handle a remaining group of four channels.
+  if (ch < channel_stride) {
+    DCHECK_EQ(ch + 4, channel_stride);
+    __m128 m_sums1 = _mm_setzero_ps();
+    __m128 m_sums2 = _mm_setzero_ps();
+    const float* channel_input_ptr = input_ptr + ch;
+    for (int i = 0; i < kKernelSize; ++i) {
+      const __m128 m_input = _mm_load_ps(channel_input_ptr);
+      m_sums1 = _mm_fmadd_ps(m_input, _mm_set1_ps(k1[i]), m_sums1);
+      m_sums2 = _mm_fmadd_ps(m_input, _mm_set1_ps(k2[i]), m_sums2);
+      channel_input_ptr += channel_stride;
+    }
+    _mm_store_ps(output + ch,
+                 _mm_fmadd_ps(m_sums2, _mm_set1_ps(factor2),
+                              _mm_mul_ps(m_sums1, _mm_set1_ps(factor1))));
+  }
+}
 #elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
 float SincResampler::Convolve_NEON(const float* input_ptr, const float* k1,
                                    const float* k2,
@@ -485,6 +652,34 @@ float SincResampler::Convolve_NEON(const float* input_ptr, const float* k1,
   float32x2_t m_half = vadd_f32(vget_high_f32(m_sums1), vget_low_f32(m_sums1));
   return vget_lane_f32(vpadd_f32(m_half, m_half), 0);
 }
+
+void SincResampler::ConvolveMultiChannel_NEON(
+    int channel_stride,
+    const float* input_ptr,
+    const float* k1,
+    const float* k2,
+    double kernel_interpolation_factor,
+    float* output) {
+  const float factor1 = 1.0 - kernel_interpolation_factor;
+  const float factor2 = kernel_interpolation_factor;
+
+  // Process four channels at a time, broadcasting each kernel tap.
+  for (int ch = 0; ch < channel_stride; ch += 4) {
+    float32x4_t m_sums1 = vmovq_n_f32(0);
+    float32x4_t m_sums2 = vmovq_n_f32(0);
+    const float* channel_input_ptr = input_ptr + ch;
+    for (int i = 0; i < kKernelSize; ++i) {
+      const float32x4_t m_input = vld1q_f32(channel_input_ptr);
+      m_sums1 = vmlaq_n_f32(m_sums1, m_input, k1[i]);
+      m_sums2 = vmlaq_n_f32(m_sums2, m_input, k2[i]);
+      channel_input_ptr += channel_stride;
+    }
+
+    // Linearly interpolate the two "convolutions".
+    vst1q_f32(output + ch,
+              vmlaq_n_f32(vmulq_n_f32(m_sums1, factor1), m_sums2, factor2));
+  }
+}
 #endif
 
 }  // namespace media
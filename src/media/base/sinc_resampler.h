@@ -16,7 +16,9 @@
 
 namespace media {
 
-// SincResampler is a high-quality single-channel sample-rate converter.
+// SincResampler is a high-quality sample-rate converter. It resamples a single
+// channel, or several channels at once from interleaved input; the latter
+// shares kernel selection and evaluation across all channels.
 class MEDIA_EXPORT SincResampler {
  public:
   enum {
@@ -50,11 +52,30 @@ class MEDIA_EXPORT SincResampler {
   SincResampler(double io_sample_rate_ratio,
                 int request_frames,
                 const ReadCB read_cb);
+
+  // Constructs a SincResampler which resamples |channels| channels at once.
+  // |read_cb| must render |frames| interleaved frames into |destination|, each
+  // frame being ChannelStride() floats wide; the samples past |channels| in
+  // each frame are padding and must be left untouched.
+  SincResampler(int channels,
+                double io_sample_rate_ratio,
+                int request_frames,
+                const ReadCB read_cb);
   ~SincResampler();
 
-  // Resample |frames| of data from |read_cb_| into |destination|.
+  // Resample |frames| of data from |read_cb_| into |destination|. Only valid
+  // for single channel resamplers.
   void Resample(int frames, float* destination);
 
+  // Resample |frames| of data from |read_cb_| into the planar |destinations|,
+  // which must hold one pointer per channel.
+  void ResampleMultiChannel(int frames, float* const* destinations);
+
+  // The number of floats per interleaved frame provided to |read_cb_|; this is
+  // the channel count rounded up to the SIMD width, or one for single channel
+  // resamplers.
+  int ChannelStride() const { return channel_stride_; }
+
   // The maximum size in frames that guarantees Resample() will only make a
   // single call to |read_cb_| for more data.  Note: If PrimeWithSilence() is
   // not called, chunk size will grow after the first two Resample() calls by
@@ -92,10 +113,18 @@ class MEDIA_EXPORT SincResampler {
   FRIEND_TEST_ALL_PREFIXES(SincResamplerPerfTest, Convolve_unoptimized_aligned);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerPerfTest, Convolve_optimized_aligned);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerPerfTest, Convolve_optimized_unaligned);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveMultiChannel);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerPerfTest, ConvolveMultiChannel);
 
   void InitializeKernel();
   void UpdateRegions(bool second_load);
 
+  // Shared implementation of Resample() and ResampleMultiChannel(). Calls
+  // |convolve|(output_frame_index, input_ptr, k1, k2, interpolation_factor)
+  // for each output frame.
+  template <typename ConvolveFn>
+  void ResampleInternal(int frames, ConvolveFn convolve);
+
   // Compute convolution of |k1| and |k2| over |input_ptr|, resultant sums are
   // linearly interpolated using |kernel_interpolation_factor|.  On x86, the
   // underlying implementation is chosen at run time based on SSE support.  On
@@ -116,6 +145,37 @@ class MEDIA_EXPORT SincResampler {
                              double kernel_interpolation_factor);
 #endif
 
+  // Multi-channel versions of the above. |input_ptr| points to interleaved
+  // frames of |channel_stride| floats each, where |channel_stride| is a
+  // multiple of 4.  Writes |channel_stride| interpolated sums to |output|.
+  static void ConvolveMultiChannel_C(int channel_stride,
+                                     const float* input_ptr,
+                                     const float* k1,
+                                     const float* k2,
+                                     double kernel_interpolation_factor,
+                                     float* output);
+#if defined(ARCH_CPU_X86_FAMILY)
+  static void ConvolveMultiChannel_SSE(int channel_stride,
+                                       const float* input_ptr,
+                                       const float* k1,
+                                       const float* k2,
+                                       double kernel_interpolation_factor,
+                                       float* output);
+  static void ConvolveMultiChannel_AVX2(int channel_stride,
+                                        const float* input_ptr,
+                                        const float* k1,
+                                        const float* k2,
+                                        double kernel_interpolation_factor,
+                                        float* output);
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  static void ConvolveMultiChannel_NEON(int channel_stride,
+                                        const float* input_ptr,
+                                        const float* k1,
+                                        const float* k2,
+                                        double kernel_interpolation_factor,
+                                        float* output);
+#endif
+
   // Selects runtime specific CPU features like SSE.  Must be called before
   // using SincResampler.
   void InitializeCPUSpecificFeatures();
@@ -143,7 +203,12 @@ class MEDIA_EXPORT SincResampler {
   // guarantees Resample() will only ask for input at most once.
   int chunk_size_;
 
-  // The size (in samples) of the internal buffer used by the resampler.
+  // The number of channels resampled, and the number of floats used to store
+  // each interleaved input frame.
+  const int channels_;
+  const int channel_stride_;
+
+  // The size (in frames) of the internal buffer used by the resampler.
   const int input_buffer_size_;
 
   // Contains kKernelOffsetCount kernels back-to-back, each of size kKernelSize.
@@ -156,15 +221,23 @@ class MEDIA_EXPORT SincResampler {
   // Data from the source is copied into this buffer for each processing pass.
   std::unique_ptr<float[], base::AlignedFreeDeleter> input_buffer_;
 
+  // Scratch space for the |channel_stride_| outputs of a multi-channel
+  // convolution.
+  std::unique_ptr<float[], base::AlignedFreeDeleter> convolve_output_;
+
   // Stores the runtime selection of which Convolve function to use.
   using ConvolveProc = float (*)(const float*,
                                  const float*,
                                  const float*,
                                  double);
   ConvolveProc convolve_proc_;
+  using ConvolveMultiChannelProc =
+      void (*)(int, const float*, const float*, const float*, double, float*);
+  ConvolveMultiChannelProc convolve_multi_channel_proc_;
 
   // Pointers to the various regions inside |input_buffer_|.  See the diagram at
-  // the top of the .cc file for more information.
+  // the top of the .cc file for more information.  Regions are measured in
+  // frames, so each spans |channel_stride_| times as many floats.
   float* r0_;
   float* const r1_;
   float* const r2_;
@@ -2,9 +2,15 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "base/bind.h"
 #include "base/callback_helpers.h"
 #include "base/cpu.h"
+#include "base/memory/aligned_memory.h"
+#include "base/strings/stringprintf.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
 #include "media/base/sinc_resampler.h"
@@ -76,4 +82,108 @@ TEST(SincResamplerPerfTest, Convolve_optimized_unaligned) {
 #endif
 }
 
+static void RunConvolveMultiChannelBenchmark(int channels) {
+  SincResampler resampler(channels, kSampleRateRatio,
+                          SincResampler::kDefaultRequestSize,
+                          base::DoNothing());
+  const int channel_stride = resampler.ChannelStride();
+  std::unique_ptr<float[], base::AlignedFreeDeleter> input(
+      static_cast<float*>(base::AlignedAlloc(
+          sizeof(float) * SincResampler::kKernelSize * channel_stride, 32)));
+  std::fill(input.get(),
+            input.get() + SincResampler::kKernelSize * channel_stride, 0.5f);
+  std::unique_ptr<float[], base::AlignedFreeDeleter> output(
+      static_cast<float*>(
+          base::AlignedAlloc(sizeof(float) * channel_stride, 32)));
+
+  // Each iteration produces one output frame for every channel, so compare
+  // against |channels| iterations of the single channel benchmarks.
+  const int iterations = kBenchmarkIterations / channels;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < iterations; ++i) {
+    resampler.convolve_multi_channel_proc_(
+        channel_stride, input.get(), resampler.get_kernel_for_testing(),
+        resampler.get_kernel_for_testing(), kKernelInterpolationFactor,
+        output.get());
+  }
+  double total_time_seconds = (base::TimeTicks::Now() - start).InSecondsF();
+
+  perf_test::PerfResultReporter reporter(
+      "sinc_resampler", base::StringPrintf("multi_channel_%d", channels));
+  reporter.RegisterImportantMetric("_convolve", "runs/s");
+  reporter.AddResult("_convolve", iterations * channels / total_time_seconds);
+}
+
+// Benchmark for the multi-channel Convolve() methods; results are reported in
+// single channel convolutions per second.
+TEST(SincResamplerPerfTest, ConvolveMultiChannel) {
+  RunConvolveMultiChannelBenchmark(6);
+  RunConvolveMultiChannelBenchmark(8);
+}
+
+static const int kResampleIterations = 20000;
+static const int kResampleFrames = 480;
+static const double kResampleSampleRateRatio = 44100.0 / 48000.0;
+
+// Resamples |channels| channels either with one SincResampler per channel or
+// with a single interleaved SincResampler, the two ways MultiChannelResampler
+// can be set up, and reports the output frames resampled per second.
+static void RunResampleMultiChannelBenchmark(int channels, bool interleaved) {
+  std::vector<std::unique_ptr<SincResampler>> resamplers;
+  if (interleaved) {
+    resamplers.push_back(std::make_unique<SincResampler>(
+        channels, kResampleSampleRateRatio, SincResampler::kDefaultRequestSize,
+        base::DoNothing()));
+  } else {
+    for (int ch = 0; ch < channels; ++ch) {
+      resamplers.push_back(std::make_unique<SincResampler>(
+          kResampleSampleRateRatio, SincResampler::kDefaultRequestSize,
+          base::DoNothing()));
+    }
+  }
+  std::vector<std::vector<float>> output(
+      channels, std::vector<float>(kResampleFrames));
+  std::vector<float*> destinations(channels);
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kResampleIterations; ++i) {
+    // Chunk the frames as MultiChannelResampler does.
+    for (int frames_done = 0; frames_done < kResampleFrames;) {
+      const int frames_this_time = std::min(kResampleFrames - frames_done,
+                                            resamplers[0]->ChunkSize());
+      if (interleaved) {
+        for (int ch = 0; ch < channels; ++ch)
+          destinations[ch] = output[ch].data() + frames_done;
+        resamplers[0]->ResampleMultiChannel(frames_this_time,
+                                            destinations.data());
+      } else {
+        for (int ch = 0; ch < channels; ++ch) {
+          resamplers[ch]->Resample(frames_this_time,
+                                   output[ch].data() + frames_done);
+        }
+      }
+      frames_done += frames_this_time;
+    }
+  }
+  double total_time_seconds = (base::TimeTicks::Now() - start).InSecondsF();
+
+  perf_test::PerfResultReporter reporter(
+      "sinc_resampler",
+      base::StringPrintf("%s_%d", interleaved ? "interleaved" : "per_channel",
+                         channels));
+  reporter.RegisterImportantMetric("_resample", "frames/s");
+  reporter.AddResult("_resample",
+                     kResampleIterations * kResampleFrames /
+                         total_time_seconds);
+}
+
+// Compares resampling each channel separately and all of them interleaved,
+// which determines MultiChannelResampler::GetMinInterleavedChannels().
+TEST(SincResamplerPerfTest, ResampleMultiChannel) {
+  for (int channels : {2, 4, 6, 8}) {
+    RunResampleMultiChannelBenchmark(channels, /*interleaved=*/false);
+    RunResampleMultiChannelBenchmark(channels, /*interleaved=*/true);
+  }
+}
+
 } // namespace media
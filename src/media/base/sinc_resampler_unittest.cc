@@ -3,12 +3,15 @@
 // found in the LICENSE file.
 
 #include <memory>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback_helpers.h"
 #include "base/macros.h"
+#include "base/memory/aligned_memory.h"
 #include "base/numerics/math_constants.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/test/bind.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
 #include "media/base/sinc_resampler.h"
@@ -184,6 +187,101 @@ TEST(SincResamplerTest, Convolve) {
   EXPECT_NEAR(result2, result, kEpsilon);
 }
 
+// Ensure the multi-channel Convolve methods match Convolve_C() on each channel.
+TEST(SincResamplerTest, ConvolveMultiChannel) {
+  // Six channels are padded to a stride of eight, exercising both the full
+  // width and the remainder paths of the SIMD implementations.
+  static const int kChannels = 6;
+  SincResampler resampler(kChannels, kSampleRateRatio,
+                          SincResampler::kDefaultRequestSize,
+                          SincResampler::ReadCB());
+  const int channel_stride = resampler.ChannelStride();
+  ASSERT_EQ(8, channel_stride);
+
+  static const double kEpsilon = 0.00000005;
+
+  // Interleave shifted copies of a kernel to use as per-channel input.
+  const float* kernel = resampler.kernel_storage_.get();
+  std::unique_ptr<float[], base::AlignedFreeDeleter> input(
+      static_cast<float*>(base::AlignedAlloc(
+          sizeof(float) * SincResampler::kKernelSize * channel_stride, 32)));
+  for (int i = 0; i < SincResampler::kKernelSize; ++i) {
+    for (int ch = 0; ch < channel_stride; ++ch)
+      input[i * channel_stride + ch] = kernel[i + ch];
+  }
+
+  float expected[8];
+  SincResampler::ConvolveMultiChannel_C(channel_stride, input.get(), kernel,
+                                        kernel, kKernelInterpolationFactor,
+                                        expected);
+  std::unique_ptr<float[], base::AlignedFreeDeleter> output(
+      static_cast<float*>(
+          base::AlignedAlloc(sizeof(float) * channel_stride, 32)));
+  resampler.convolve_multi_channel_proc_(channel_stride, input.get(), kernel,
+                                         kernel, kKernelInterpolationFactor,
+                                         output.get());
+
+  for (int ch = 0; ch < channel_stride; ++ch) {
+    const double single_channel_result = SincResampler::Convolve_C(
+        kernel + ch, kernel, kernel, kKernelInterpolationFactor);
+    EXPECT_NEAR(single_channel_result, expected[ch], kEpsilon);
+    EXPECT_NEAR(single_channel_result, output[ch], kEpsilon);
+  }
+}
+
+// Ensure multi-channel resampling produces the same output as resampling each
+// channel independently.
+TEST(SincResamplerTest, ResampleMultiChannel) {
+  static const int kChannels = 3;
+  static const int kFrames = 1000;
+  auto fill_channel = [](int channel, int offset, int frames, float* dest) {
+    for (int i = 0; i < frames; ++i)
+      dest[i] = sin((offset + i) * 0.01 * (channel + 1));
+  };
+
+  // Resample each channel on its own.
+  std::vector<std::vector<float>> expected(kChannels,
+                                           std::vector<float>(kFrames));
+  for (int ch = 0; ch < kChannels; ++ch) {
+    int offset = 0;
+    SincResampler resampler(
+        kSampleRateRatio, SincResampler::kDefaultRequestSize,
+        base::BindLambdaForTesting([&](int frames, float* destination) {
+          fill_channel(ch, offset, frames, destination);
+          offset += frames;
+        }));
+    resampler.Resample(kFrames, expected[ch].data());
+  }
+
+  // Resample all channels together from interleaved input.
+  int offset = 0;
+  std::unique_ptr<SincResampler> resampler;
+  resampler = std::make_unique<SincResampler>(
+      kChannels, kSampleRateRatio, SincResampler::kDefaultRequestSize,
+      base::BindLambdaForTesting([&](int frames, float* destination) {
+        const int channel_stride = resampler->ChannelStride();
+        std::vector<float> channel_data(frames);
+        for (int ch = 0; ch < kChannels; ++ch) {
+          fill_channel(ch, offset, frames, channel_data.data());
+          for (int i = 0; i < frames; ++i)
+            destination[i * channel_stride + ch] = channel_data[i];
+        }
+        offset += frames;
+      }));
+  std::vector<std::vector<float>> actual(kChannels,
+                                         std::vector<float>(kFrames));
+  float* destinations[kChannels];
+  for (int ch = 0; ch < kChannels; ++ch)
+    destinations[ch] = actual[ch].data();
+  resampler->ResampleMultiChannel(kFrames, destinations);
+
+  static const double kEpsilon = 0.000001;
+  for (int ch = 0; ch < kChannels; ++ch) {
+    for (int i = 0; i < kFrames; ++i)
+      ASSERT_NEAR(expected[ch][i], actual[ch][i], kEpsilon) << ch << ", " << i;
+  }
+}
+
 // Fake audio source for testing the resampler.  Generates a sinusoidal linear
 // chirp (http://en.wikipedia.org/wiki/Chirp) which can be tuned to stress the
 // resampler for the specific sample rate conversion being used.
@@ -4,6 +4,9 @@
 
 #include "media/base/stream_parser.h"
 
+#include <utility>
+
+#include "media/base/decoder_buffer_pool.h"
 #include "media/base/stream_parser_buffer.h"
 
 namespace media {
@@ -19,6 +22,11 @@ StreamParser::StreamParser() = default;
 
 StreamParser::~StreamParser() = default;
 
+void StreamParser::set_buffer_pool(
+    scoped_refptr<DecoderBufferPool> buffer_pool) {
+  buffer_pool_ = std::move(buffer_pool);
+}
+
 // Default implementation of ProcessChunks() is not fully implemented.
 bool StreamParser::ProcessChunks(std::unique_ptr<BufferQueue> buffer_queue) {
   NOTIMPLEMENTED();  // Likely the wrong type of parser is being used.
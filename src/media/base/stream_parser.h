@@ -23,6 +23,7 @@
 
 namespace media {
 
+class DecoderBufferPool;
 class MediaLog;
 class MediaTracks;
 class StreamParserBuffer;
@@ -146,7 +147,18 @@ class MEDIA_EXPORT StreamParser {
   virtual bool Parse(const uint8_t* buf, int size) = 0;
   virtual bool ProcessChunks(std::unique_ptr<BufferQueue> buffer_queue);
 
+  // Sets the pool which parsers supporting it allocate the data of the buffers
+  // they emit from, typically shared by all the parsers of a demuxer. Must be
+  // called before Init().
+  void set_buffer_pool(scoped_refptr<DecoderBufferPool> buffer_pool);
+
+ protected:
+  // Returns the pool set by set_buffer_pool(), or null.
+  DecoderBufferPool* buffer_pool() const { return buffer_pool_.get(); }
+
  private:
+  scoped_refptr<DecoderBufferPool> buffer_pool_;
+
   DISALLOW_COPY_AND_ASSIGN(StreamParser);
 };
 
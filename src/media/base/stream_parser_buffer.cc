@@ -8,13 +8,14 @@
 
 #include "base/check_op.h"
 #include "base/memory/ptr_util.h"
+#include "media/base/decoder_buffer_pool.h"
 #include "media/base/timestamp_constants.h"
 
 namespace media {
 
 scoped_refptr<StreamParserBuffer> StreamParserBuffer::CreateEOSBuffer() {
   return base::WrapRefCounted(new StreamParserBuffer(
-      NULL, 0, NULL, 0, false, DemuxerStream::UNKNOWN, 0));
+      nullptr, NULL, 0, NULL, 0, false, DemuxerStream::UNKNOWN, 0));
 }
 
 scoped_refptr<StreamParserBuffer> StreamParserBuffer::CopyFrom(
@@ -24,7 +25,7 @@ scoped_refptr<StreamParserBuffer> StreamParserBuffer::CopyFrom(
     Type type,
     TrackId track_id) {
   return base::WrapRefCounted(new StreamParserBuffer(
-      data, data_size, NULL, 0, is_key_frame, type, track_id));
+      nullptr, data, data_size, NULL, 0, is_key_frame, type, track_id));
 }
 
 scoped_refptr<StreamParserBuffer> StreamParserBuffer::CopyFrom(
@@ -36,8 +37,19 @@ scoped_refptr<StreamParserBuffer> StreamParserBuffer::CopyFrom(
     Type type,
     TrackId track_id) {
   return base::WrapRefCounted(
-      new StreamParserBuffer(data, data_size, side_data, side_data_size,
-                             is_key_frame, type, track_id));
+      new StreamParserBuffer(nullptr, data, data_size, side_data,
+                             side_data_size, is_key_frame, type, track_id));
+}
+
+scoped_refptr<StreamParserBuffer> StreamParserBuffer::CopyFrom(
+    DecoderBufferPool* pool,
+    const uint8_t* data,
+    int data_size,
+    bool is_key_frame,
+    Type type,
+    TrackId track_id) {
+  return base::WrapRefCounted(new StreamParserBuffer(
+      pool, data, data_size, NULL, 0, is_key_frame, type, track_id));
 }
 
 DecodeTimestamp StreamParserBuffer::GetDecodeTimestamp() const {
@@ -52,14 +64,15 @@ void StreamParserBuffer::SetDecodeTimestamp(DecodeTimestamp timestamp) {
     preroll_buffer_->SetDecodeTimestamp(timestamp);
 }
 
-StreamParserBuffer::StreamParserBuffer(const uint8_t* data,
+StreamParserBuffer::StreamParserBuffer(DecoderBufferPool* pool,
+                                       const uint8_t* data,
                                        int data_size,
                                        const uint8_t* side_data,
                                        int side_data_size,
                                        bool is_key_frame,
                                        Type type,
                                        TrackId track_id)
-    : DecoderBuffer(data, data_size, side_data, side_data_size),
+    : DecoderBuffer(pool, data, data_size, side_data, side_data_size),
       decode_timestamp_(kNoDecodeTimestamp()),
       config_id_(kInvalidConfigId),
       type_(type),
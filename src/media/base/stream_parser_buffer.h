@@ -124,6 +124,15 @@ class MEDIA_EXPORT StreamParserBuffer : public DecoderBuffer {
                                                     Type type,
                                                     TrackId track_id);
 
+  // Same as above, but the data is allocated from |pool|, and returned to it
+  // when the buffer is destroyed. |pool| may be null.
+  static scoped_refptr<StreamParserBuffer> CopyFrom(DecoderBufferPool* pool,
+                                                    const uint8_t* data,
+                                                    int data_size,
+                                                    bool is_key_frame,
+                                                    Type type,
+                                                    TrackId track_id);
+
   // Decode timestamp. If not explicitly set, or set to kNoTimestamp, the
   // value will be taken from the normal timestamp.
   DecodeTimestamp GetDecodeTimestamp() const;
@@ -164,7 +173,8 @@ class MEDIA_EXPORT StreamParserBuffer : public DecoderBuffer {
   }
 
  private:
-  StreamParserBuffer(const uint8_t* data,
+  StreamParserBuffer(DecoderBufferPool* pool,
+                     const uint8_t* data,
                      int data_size,
                      const uint8_t* side_data,
                      int side_data_size,
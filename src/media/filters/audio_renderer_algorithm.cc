@@ -557,9 +557,23 @@ void AudioRendererAlgorithm::GetOptimalBlock() {
 
     // |optimal_index| is in frames and it is relative to the beginning of the
     // |search_block_|.
-    optimal_index =
-        internal::OptimalIndex(search_block_wrapper_.get(),
-                               target_block_wrapper_.get(), exclude_interval);
+    switch (wsola_search_quality_) {
+      case WsolaSearchQuality::kHigh:
+        optimal_index = internal::OptimalIndex(search_block_wrapper_.get(),
+                                               target_block_wrapper_.get(),
+                                               exclude_interval);
+        break;
+      case WsolaSearchQuality::kMedium:
+        optimal_index = internal::CoarseToFineOptimalIndex(
+            search_block_wrapper_.get(), target_block_wrapper_.get(),
+            exclude_interval, 2);
+        break;
+      case WsolaSearchQuality::kLow:
+        optimal_index = internal::CoarseToFineOptimalIndex(
+            search_block_wrapper_.get(), target_block_wrapper_.get(),
+            exclude_interval, 4);
+        break;
+    }
 
     // Translate |index| w.r.t. the beginning of |audio_buffer_| and extract the
     // optimal block.
@@ -630,4 +644,9 @@ void AudioRendererAlgorithm::SetPreservesPitch(bool preserves_pitch) {
   preserves_pitch_ = preserves_pitch;
 }
 
+void AudioRendererAlgorithm::SetWsolaSearchQuality(
+    WsolaSearchQuality quality) {
+  wsola_search_quality_ = quality;
+}
+
 }  // namespace media
@@ -41,6 +41,20 @@ class AudioBus;
 
 class MEDIA_EXPORT AudioRendererAlgorithm {
  public:
+  // Trade-off between the accuracy of the WSOLA search for the block most
+  // similar to the natural continuation of the output, and its CPU cost.
+  enum class WsolaSearchQuality {
+    // Search the input at full resolution. This is the default.
+    kHigh,
+    // Search the input decimated by 2, then refine the best match at full
+    // resolution. Nearly as accurate as kHigh at a lower cost.
+    kMedium,
+    // Same as kMedium with the input decimated by 4. Several times cheaper than
+    // kHigh, but more likely to pick a block which does not match the output
+    // continuation in high frequencies.
+    kLow,
+  };
+
   AudioRendererAlgorithm(MediaLog* media_log);
   AudioRendererAlgorithm(MediaLog* media_log,
                          AudioRendererAlgorithmParameters params);
@@ -91,6 +105,10 @@ class MEDIA_EXPORT AudioRendererAlgorithm {
   // resampling when this is false.
   void SetPreservesPitch(bool preserves_pitch);
 
+  // Sets the quality of the WSOLA similarity search. May be called at any
+  // time; takes effect from the next WSOLA iteration.
+  void SetWsolaSearchQuality(WsolaSearchQuality quality);
+
   // Returns true if the |audio_buffer_| is >= |playback_threshold_|.
   bool IsQueueAdequateForPlayback();
 
@@ -225,6 +243,8 @@ class MEDIA_EXPORT AudioRendererAlgorithm {
   // and resampling when this
   bool preserves_pitch_ = true;
 
+  WsolaSearchQuality wsola_search_quality_ = WsolaSearchQuality::kHigh;
+
   // How many frames to have in queue before beginning playback.
   int64_t playback_threshold_;
 
@@ -0,0 +1,125 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <tuple>
+
+#include "base/numerics/math_constants.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "media/base/audio_buffer.h"
+#include "media/base/audio_bus.h"
+#include "media/base/audio_parameters.h"
+#include "media/base/channel_layout.h"
+#include "media/base/media_util.h"
+#include "media/filters/audio_renderer_algorithm.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace media {
+
+static const int kSampleRate = 48000;
+
+// Frames requested by each FillBuffer() call, 10ms like an audio sink.
+static const int kFramesPerBuffer = kSampleRate / 100;
+
+// Duration of the output rendered by each benchmark.
+static const int kOutputDurationInSeconds = 60;
+
+using WsolaSearchQuality = AudioRendererAlgorithm::WsolaSearchQuality;
+
+// Channel layout, playback rate and search quality.
+using AudioRendererAlgorithmPerfTestParam =
+    std::tuple<ChannelLayout, double, WsolaSearchQuality>;
+
+static const char* WsolaSearchQualityToString(WsolaSearchQuality quality) {
+  switch (quality) {
+    case WsolaSearchQuality::kHigh:
+      return "high";
+    case WsolaSearchQuality::kMedium:
+      return "medium";
+    case WsolaSearchQuality::kLow:
+      return "low";
+  }
+}
+
+// Creates a buffer of 100ms of audio with a different mix of tones on each
+// channel, so that the WSOLA search has some structure to match.
+static scoped_refptr<AudioBuffer> CreateInputBuffer(
+    ChannelLayout channel_layout) {
+  const int channels = ChannelLayoutToChannelCount(channel_layout);
+  const int frames = kSampleRate / 10;
+  scoped_refptr<AudioBuffer> buffer = AudioBuffer::CreateBuffer(
+      kSampleFormatPlanarF32, channel_layout, channels, kSampleRate, frames);
+  for (int ch = 0; ch < channels; ++ch) {
+    float* data = reinterpret_cast<float*>(buffer->channel_data()[ch]);
+    const float frequency = 200.0f * (ch + 1);
+    for (int i = 0; i < frames; ++i) {
+      const float t = static_cast<float>(i) / kSampleRate;
+      data[i] = 0.5f * std::sin(2 * base::kPiFloat * frequency * t) +
+                0.25f * std::sin(2 * base::kPiFloat * 3.1f * frequency * t);
+    }
+  }
+  return buffer;
+}
+
+static void RunFillBufferBenchmark(ChannelLayout channel_layout,
+                                   double playback_rate,
+                                   WsolaSearchQuality quality,
+                                   const std::string& story) {
+  NullMediaLog media_log;
+  AudioRendererAlgorithm algorithm(&media_log);
+  algorithm.SetWsolaSearchQuality(quality);
+  AudioParameters params(AudioParameters::AUDIO_PCM_LINEAR, channel_layout,
+                         kSampleRate, kFramesPerBuffer);
+  algorithm.Initialize(params, false);
+
+  scoped_refptr<AudioBuffer> input = CreateInputBuffer(channel_layout);
+  std::unique_ptr<AudioBus> output =
+      AudioBus::Create(params.channels(), kFramesPerBuffer);
+
+  const int buffers = kOutputDurationInSeconds * kSampleRate / kFramesPerBuffer;
+  base::TimeDelta total_time;
+  for (int i = 0; i < buffers; ++i) {
+    while (!algorithm.IsQueueFull())
+      algorithm.EnqueueBuffer(input);
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    ASSERT_EQ(kFramesPerBuffer, algorithm.FillBuffer(output.get(), 0,
+                                                     kFramesPerBuffer,
+                                                     playback_rate));
+    total_time += base::TimeTicks::Now() - start;
+  }
+
+  perf_test::PerfResultReporter reporter("audio_renderer_algorithm", story);
+  reporter.RegisterImportantMetric("_fill_buffer", "us");
+  reporter.AddResult("_fill_buffer", total_time.InMicrosecondsF() / buffers);
+}
+
+class AudioRendererAlgorithmPerfTest
+    : public testing::TestWithParam<AudioRendererAlgorithmPerfTestParam> {};
+
+TEST_P(AudioRendererAlgorithmPerfTest, FillBuffer) {
+  const ChannelLayout channel_layout = std::get<0>(GetParam());
+  const double playback_rate = std::get<1>(GetParam());
+  const WsolaSearchQuality quality = std::get<2>(GetParam());
+  RunFillBufferBenchmark(
+      channel_layout, playback_rate, quality,
+      base::StringPrintf("%s_%.2fx_%s", ChannelLayoutToString(channel_layout),
+                         playback_rate, WsolaSearchQualityToString(quality)));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    All,
+    AudioRendererAlgorithmPerfTest,
+    testing::Combine(testing::Values(CHANNEL_LAYOUT_STEREO,
+                                     CHANNEL_LAYOUT_5_1),
+                     testing::Values(0.5, 0.75, 1.25, 1.5, 2.0),
+                     testing::Values(WsolaSearchQuality::kHigh,
+                                     WsolaSearchQuality::kMedium,
+                                     WsolaSearchQuality::kLow)));
+
+}  // namespace media
@@ -761,6 +761,68 @@ TEST_F(AudioRendererAlgorithmTest, FullAndDecimatedSearch) {
                                       exclude_interval));
 }
 
+TEST_F(AudioRendererAlgorithmTest, DecimateAudioBus) {
+  const int kChannels = 2;
+  const int kFrames = 9;
+  const int kFactor = 2;
+  float ch_0[] = {1.0f, 3.0f, 0.0f, 0.0f, -1.0f, 1.0f, 2.0f, 2.0f, 5.0f};
+  float ch_1[] = {0.5f, 0.5f, 1.0f, 0.0f, -2.0f, -4.0f, 0.0f, 1.0f, 5.0f};
+  std::unique_ptr<AudioBus> input = AudioBus::Create(kChannels, kFrames);
+  memcpy(input->channel(0), ch_0, sizeof(ch_0));
+  memcpy(input->channel(1), ch_1, sizeof(ch_1));
+
+  // The last input frame has no pair, and is dropped.
+  std::unique_ptr<AudioBus> output =
+      AudioBus::Create(kChannels, kFrames / kFactor);
+  internal::DecimateAudioBus(input.get(), kFactor, output.get());
+
+  EXPECT_FLOAT_EQ(2.0f, output->channel(0)[0]);
+  EXPECT_FLOAT_EQ(0.0f, output->channel(0)[1]);
+  EXPECT_FLOAT_EQ(0.0f, output->channel(0)[2]);
+  EXPECT_FLOAT_EQ(2.0f, output->channel(0)[3]);
+  EXPECT_FLOAT_EQ(0.5f, output->channel(1)[0]);
+  EXPECT_FLOAT_EQ(0.5f, output->channel(1)[1]);
+  EXPECT_FLOAT_EQ(-3.0f, output->channel(1)[2]);
+  EXPECT_FLOAT_EQ(0.5f, output->channel(1)[3]);
+}
+
+TEST_F(AudioRendererAlgorithmTest, CoarseToFineSearch) {
+  const int kChannels = 2;
+  const int kHalfPulseWidth = 24;
+  const int kFramesPerBlock = 240;
+  const int kNumCandidateBlocks = 360;
+  const int kTargetIndex = 101;
+  std::unique_ptr<AudioBus> search_region = AudioBus::Create(
+      kChannels, kNumCandidateBlocks + (kFramesPerBlock - 1));
+  FillWithSquarePulseTrain(kHalfPulseWidth, 0, 0, search_region.get());
+  FillWithSquarePulseTrain(kHalfPulseWidth, kHalfPulseWidth / 2, 1,
+                           search_region.get());
+  std::unique_ptr<AudioBus> target =
+      AudioBus::Create(kChannels, kFramesPerBlock);
+  search_region->CopyPartialFramesTo(kTargetIndex, kFramesPerBlock, 0,
+                                     target.get());
+
+  // The pulse train is periodic, so the target matches every pulse width from
+  // |kTargetIndex|. The coarse search must be refined to one of these exact
+  // matches, even though the target is not aligned on the decimated frames.
+  for (int decimation : {2, 4}) {
+    SCOPED_TRACE(decimation);
+    internal::Interval exclude_interval = std::make_pair(-100, -10);
+    int optimal_index = internal::CoarseToFineOptimalIndex(
+        search_region.get(), target.get(), exclude_interval, decimation);
+    EXPECT_EQ(0, (optimal_index - kTargetIndex) % (2 * kHalfPulseWidth));
+
+    // Exclude the period holding the target; another one must be found.
+    exclude_interval = std::make_pair(kTargetIndex - kHalfPulseWidth,
+                                      kTargetIndex + kHalfPulseWidth);
+    optimal_index = internal::CoarseToFineOptimalIndex(
+        search_region.get(), target.get(), exclude_interval, decimation);
+    EXPECT_FALSE(optimal_index >= exclude_interval.first &&
+                 optimal_index <= exclude_interval.second);
+    EXPECT_EQ(0, (optimal_index - kTargetIndex) % (2 * kHalfPulseWidth));
+  }
+}
+
 TEST_F(AudioRendererAlgorithmTest, QuadraticInterpolation) {
   // Arbitrary coefficients.
   const float kA = 0.7f;
@@ -807,6 +869,18 @@ TEST_F(AudioRendererAlgorithmTest, WsolaSpeedup) {
   WsolaTest(1.6);
 }
 
+TEST_F(AudioRendererAlgorithmTest, WsolaSlowdown_MediumSearchQuality) {
+  algorithm_.SetWsolaSearchQuality(
+      AudioRendererAlgorithm::WsolaSearchQuality::kMedium);
+  WsolaTest(0.6);
+}
+
+TEST_F(AudioRendererAlgorithmTest, WsolaSpeedup_MediumSearchQuality) {
+  algorithm_.SetWsolaSearchQuality(
+      AudioRendererAlgorithm::WsolaSearchQuality::kMedium);
+  WsolaTest(1.6);
+}
+
 TEST_F(AudioRendererAlgorithmTest, FillBufferOffset) {
   Initialize();
   // Pad the queue capacity so fill requests for all rates bellow can be fully
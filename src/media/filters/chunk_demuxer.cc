@@ -451,6 +451,8 @@ ChunkDemuxer::ChunkDemuxer(
       progress_cb_(std::move(progress_cb)),
       encrypted_media_init_data_cb_(std::move(encrypted_media_init_data_cb)),
       media_log_(media_log),
+      buffer_pool_(DecoderBufferPool::CreateForDemuxer(
+          DemuxerTypes::kChunkDemuxer)),
       duration_(kNoTimestamp),
       user_specified_duration_(-1),
       liveness_(DemuxerStream::LIVENESS_UNKNOWN) {
@@ -716,6 +718,8 @@ ChunkDemuxer::Status ChunkDemuxer::AddIdInternal(
            << " expected_codecs=" << expected_codecs;
   lock_.AssertAcquired();
 
+  stream_parser->set_buffer_pool(buffer_pool_);
+
   std::unique_ptr<FrameProcessor> frame_processor =
       std::make_unique<FrameProcessor>(
           base::BindRepeating(&ChunkDemuxer::IncreaseDurationIfNecessary,
@@ -1110,6 +1114,7 @@ void ChunkDemuxer::ChangeType(const std::string& id,
       CreateParserForTypeAndCodecs(content_type, codecs, media_log_));
   // Caller should query CanChangeType() first to protect from failing this.
   DCHECK(stream_parser);
+  stream_parser->set_buffer_pool(buffer_pool_);
   source_state_map_[id]->ChangeType(std::move(stream_parser),
                                     ExpectedCodecs(content_type, codecs));
 }
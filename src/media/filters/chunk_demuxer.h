@@ -21,6 +21,7 @@
 #include "base/synchronization/lock.h"
 #include "base/thread_annotations.h"
 #include "media/base/byte_queue.h"
+#include "media/base/decoder_buffer_pool.h"
 #include "media/base/demuxer.h"
 #include "media/base/demuxer_stream.h"
 #include "media/base/media_tracks.h"
@@ -513,6 +514,9 @@ class MEDIA_EXPORT ChunkDemuxer : public Demuxer {
   // MediaLog for reporting messages and properties to debug content and engine.
   MediaLog* media_log_;
 
+  // Pool the stream parsers of all the SourceBuffers allocate buffers from.
+  const scoped_refptr<DecoderBufferPool> buffer_pool_;
+
   PipelineStatusCallback init_cb_;
   // Callback to execute upon seek completion.
   // TODO(wolenetz/acolwell): Protect against possible double-locking by first
@@ -418,8 +418,8 @@ void FFmpegDemuxerStream::EnqueuePacket(ScopedAVPacket packet) {
                  settings_data, settings_data + settings_size,
                  &side_data);
 
-    buffer = DecoderBuffer::CopyFrom(packet->data, packet->size,
-                                     side_data.data(), side_data.size());
+    buffer = demuxer_->buffer_pool()->CopyFrom(
+        packet->data, packet->size, side_data.data(), side_data.size());
   } else {
     size_t side_data_size = 0;
     uint8_t* side_data = av_packet_get_side_data(
@@ -474,12 +474,12 @@ void FFmpegDemuxerStream::EnqueuePacket(ScopedAVPacket packet) {
     // reference inner memory of FFmpeg.  As such we should transfer the packet
     // into memory we control.
     if (side_data_size > 0) {
-      buffer = DecoderBuffer::CopyFrom(packet->data + data_offset,
-                                       packet->size - data_offset, side_data,
-                                       side_data_size);
+      buffer = demuxer_->buffer_pool()->CopyFrom(
+          packet->data + data_offset, packet->size - data_offset, side_data,
+          side_data_size);
     } else {
-      buffer = DecoderBuffer::CopyFrom(packet->data + data_offset,
-                                       packet->size - data_offset);
+      buffer = demuxer_->buffer_pool()->CopyFrom(packet->data + data_offset,
+                                                 packet->size - data_offset);
     }
 
     size_t skip_samples_size = 0;
@@ -926,6 +926,8 @@ FFmpegDemuxer::FFmpegDemuxer(
           {base::MayBlock(), base::TaskPriority::USER_BLOCKING})),
       data_source_(data_source),
       media_log_(media_log),
+      buffer_pool_(DecoderBufferPool::CreateForDemuxer(
+          DemuxerTypes::kFFmpegDemuxer)),
       encrypted_media_init_data_cb_(encrypted_media_init_data_cb),
       media_tracks_updated_cb_(std::move(media_tracks_updated_cb)),
       is_local_file_(is_local_file) {
@@ -36,6 +36,7 @@
 #include "base/sequenced_task_runner.h"
 #include "media/base/audio_decoder_config.h"
 #include "media/base/decoder_buffer.h"
+#include "media/base/decoder_buffer_pool.h"
 #include "media/base/decoder_buffer_queue.h"
 #include "media/base/demuxer.h"
 #include "media/base/media_log.h"
@@ -271,6 +272,9 @@ class MEDIA_EXPORT FFmpegDemuxer : public Demuxer {
     return glue_ ? glue_->container() : container_names::CONTAINER_UNKNOWN;
   }
 
+  // Pool the streams allocate the buffers they demux from.
+  DecoderBufferPool* buffer_pool() const { return buffer_pool_.get(); }
+
  private:
   // To allow tests access to privates.
   friend class FFmpegDemuxerTest;
@@ -384,6 +388,8 @@ class MEDIA_EXPORT FFmpegDemuxer : public Demuxer {
 
   MediaLog* media_log_;
 
+  const scoped_refptr<DecoderBufferPool> buffer_pool_;
+
   // Derived bitrate after initialization has completed.
   int bitrate_ = 0;
 
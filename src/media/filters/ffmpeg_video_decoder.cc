@@ -11,26 +11,33 @@
 #include <memory>
 
 #include "base/bind.h"
+#include "base/bits.h"
 #include "base/callback_helpers.h"
+#include "base/feature_list.h"
 #include "base/location.h"
 #include "base/sequenced_task_runner.h"
+#include "base/system/sys_info.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 #include "media/base/bind_to_current_loop.h"
 #include "media/base/decoder_buffer.h"
 #include "media/base/limits.h"
 #include "media/base/media_log.h"
+#include "media/base/media_switches.h"
 #include "media/base/timestamp_constants.h"
 #include "media/base/video_aspect_ratio.h"
 #include "media/base/video_frame.h"
 #include "media/base/video_util.h"
 #include "media/ffmpeg/ffmpeg_common.h"
 #include "media/ffmpeg/ffmpeg_decoding_loop.h"
+#include "media/filters/frame_buffer_pool.h"
 
 namespace media {
 
-// Returns the number of threads given the FFmpeg CodecID. Also inspects the
-// command line for a valid --video-threads flag.
-static int GetFFmpegVideoDecoderThreadCount(const VideoDecoderConfig& config) {
+// Returns the number of threads given the FFmpeg CodecID and |threading_mode|.
+// Also inspects the command line for a valid --video-threads flag.
+static int GetFFmpegVideoDecoderThreadCount(
+    const VideoDecoderConfig& config,
+    FFmpegVideoDecoder::ThreadingMode threading_mode) {
   // Most codecs are so old that more threads aren't really needed.
   int desired_threads = limits::kMinVideoDecodeThreads;
 
@@ -54,15 +61,41 @@ static int GetFFmpegVideoDecoderThreadCount(const VideoDecoderConfig& config) {
 
     case kCodecH264:
     case kCodecVP8:
-      // Normalize to three threads for 1080p content, then scale linearly
-      // with number of pixels.
-      // Examples:
-      // 4k: 12 threads
-      // 1440p: 5 threads
-      // 1080p: 3 threads
-      // anything lower than 1080p: 2 threads
-      desired_threads = config.coded_size().width() *
-                        config.coded_size().height() * 3 / 1920 / 1080;
+      switch (threading_mode) {
+        case FFmpegVideoDecoder::ThreadingMode::kDefault:
+          // Normalize to three threads for 1080p content, then scale linearly
+          // with number of pixels.
+          // Examples:
+          // 4k: 12 threads
+          // 1440p: 5 threads
+          // 1080p: 3 threads
+          // anything lower than 1080p: 2 threads
+          desired_threads = config.coded_size().width() *
+                            config.coded_size().height() * 3 / 1920 / 1080;
+          break;
+
+        case FFmpegVideoDecoder::ThreadingMode::kFrameThreaded:
+          // Each frame thread adds a frame of latency and holds a frame buffer,
+          // so scale with resolution: one thread per ~0.5 megapixels, leaving
+          // one core for the rest of the pipeline.
+          // Examples:
+          // 4k: 16 threads
+          // 1440p: 7 threads
+          // 1080p: 4 threads
+          // anything lower than 1080p: 2 threads
+          desired_threads = std::min(
+              config.coded_size().width() * config.coded_size().height() * 4 /
+                  1920 / 1080,
+              base::SysInfo::NumberOfProcessors() - 1);
+          break;
+
+        case FFmpegVideoDecoder::ThreadingMode::kSliceThreaded:
+          // Slice threads add no latency and FFmpeg caps them to the number of
+          // slices in the stream, so use every core.
+          desired_threads = base::SysInfo::NumberOfProcessors();
+          break;
+      }
+      break;
   }
 
   return VideoDecoder::GetRecommendedThreadCount(desired_threads);
@@ -80,6 +113,19 @@ static void ReleaseVideoBufferImpl(void* opaque, uint8_t* data) {
     static_cast<VideoFrame*>(opaque)->Release();
 }
 
+// Owned by the AVBufferRef of a frame allocated from a FrameBufferPool.
+struct PooledFrameBuffer {
+  scoped_refptr<FrameBufferPool> pool;
+  void* fb_priv;
+  scoped_refptr<VideoFrame> video_frame;
+};
+
+static void ReleasePooledFrameBufferImpl(void* opaque, uint8_t* data) {
+  std::unique_ptr<PooledFrameBuffer> buffer(
+      static_cast<PooledFrameBuffer*>(opaque));
+  buffer->pool->ReleaseFrameBuffer(buffer->fb_priv);
+}
+
 // static
 bool FFmpegVideoDecoder::IsCodecSupported(VideoCodec codec) {
   return avcodec_find_decoder(VideoCodecToCodecID(codec)) != nullptr;
@@ -110,7 +156,11 @@ SupportedVideoDecoderConfigs FFmpegVideoDecoder::SupportedConfigsForWebRTC() {
 }
 
 FFmpegVideoDecoder::FFmpegVideoDecoder(MediaLog* media_log)
-    : media_log_(media_log) {
+    : media_log_(media_log),
+      threading_mode_(
+          base::FeatureList::IsEnabled(kFFmpegVideoDecoderThreading)
+              ? ThreadingMode::kFrameThreaded
+              : ThreadingMode::kDefault) {
   DVLOG(1) << __func__;
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
@@ -163,8 +213,12 @@ int FFmpegVideoDecoder::GetVideoBuffer(struct AVCodecContext* codec_context,
 
   // FFmpeg expects the initial allocation to be zero-initialized.  Failure to
   // do so can lead to uninitialized value usage.  See http://crbug.com/390941
-  scoped_refptr<VideoFrame> video_frame = frame_pool_.CreateFrame(
-      format, coded_size, gfx::Rect(size), natural_size, kNoTimestamp);
+  scoped_refptr<VideoFrame> video_frame =
+      frame_buffer_pool_
+          ? CreatePooledFrame(format, coded_size, gfx::Rect(size),
+                              natural_size, frame)
+          : frame_pool_.CreateFrame(format, coded_size, gfx::Rect(size),
+                                    natural_size, kNoTimestamp);
 
   if (!video_frame)
     return AVERROR(EINVAL);
@@ -217,6 +271,10 @@ int FFmpegVideoDecoder::GetVideoBuffer(struct AVCodecContext* codec_context,
   frame->format = codec_context->pix_fmt;
   frame->reordered_opaque = codec_context->reordered_opaque;
 
+  // CreatePooledFrame() has already attached an AVBufferRef to |frame|.
+  if (frame_buffer_pool_)
+    return 0;
+
   // Now create an AVBufferRef for the data just allocated. It will own the
   // reference to the VideoFrame object.
   VideoFrame* opaque = video_frame.get();
@@ -230,6 +288,63 @@ int FFmpegVideoDecoder::GetVideoBuffer(struct AVCodecContext* codec_context,
   return 0;
 }
 
+scoped_refptr<VideoFrame> FFmpegVideoDecoder::CreatePooledFrame(
+    VideoPixelFormat format,
+    const gfx::Size& coded_size,
+    const gfx::Rect& visible_rect,
+    const gfx::Size& natural_size,
+    AVFrame* frame) {
+  // All formats accepted by GetVideoBuffer() are three plane YUV formats. The
+  // plane layout mirrors VideoFrame::AllocateMemory(), which in turn mirrors
+  // FFmpeg's own allocation and overread requirements.
+  DCHECK_EQ(VideoFrame::NumPlanes(format), 3u);
+  const std::vector<int32_t> strides =
+      VideoFrame::ComputeStrides(format, coded_size);
+  size_t offsets[3];
+  size_t buffer_size = 0;
+  for (size_t plane = 0; plane < 3; ++plane) {
+    offsets[plane] = buffer_size;
+    buffer_size +=
+        strides[plane] *
+        base::bits::AlignUp(
+            VideoFrame::Rows(plane, format, coded_size.height()),
+            static_cast<size_t>(VideoFrame::kFrameAddressAlignment));
+  }
+  // H.264 chroma motion compensation may overread by one line.
+  buffer_size += strides[VideoFrame::kUPlane] + VideoFrame::kFrameSizePadding;
+
+  void* fb_priv = nullptr;
+  uint8_t* data = frame_buffer_pool_->GetFrameBuffer(
+      buffer_size + VideoFrame::kFrameAddressAlignment - 1, &fb_priv);
+  if (!data)
+    return nullptr;
+  data = base::bits::AlignUp(data, VideoFrame::kFrameAddressAlignment);
+
+  scoped_refptr<VideoFrame> video_frame = VideoFrame::WrapExternalYuvData(
+      format, coded_size, visible_rect, natural_size,
+      strides[VideoFrame::kYPlane], strides[VideoFrame::kUPlane],
+      strides[VideoFrame::kVPlane], data + offsets[VideoFrame::kYPlane],
+      data + offsets[VideoFrame::kUPlane], data + offsets[VideoFrame::kVPlane],
+      kNoTimestamp);
+  if (!video_frame) {
+    frame_buffer_pool_->ReleaseFrameBuffer(fb_priv);
+    return nullptr;
+  }
+
+  // The AVBufferRef keeps the pool memory alive for as long as FFmpeg
+  // references it; OnNewFrame() extends that to the lifetime of any VideoFrame
+  // handed out to the client.
+  auto* opaque =
+      new PooledFrameBuffer{frame_buffer_pool_, fb_priv, video_frame};
+  frame->buf[0] = av_buffer_create(data, buffer_size,
+                                   ReleasePooledFrameBufferImpl, opaque, 0);
+  if (!frame->buf[0]) {
+    ReleasePooledFrameBufferImpl(opaque, data);
+    return nullptr;
+  }
+  return video_frame;
+}
+
 VideoDecoderType FFmpegVideoDecoder::GetDecoderType() const {
   return VideoDecoderType::kFFmpeg;
 }
@@ -391,8 +506,17 @@ bool FFmpegVideoDecoder::OnNewFrame(AVFrame* frame) {
     return false;
   }
 
-  scoped_refptr<VideoFrame> video_frame =
-      reinterpret_cast<VideoFrame*>(av_buffer_get_opaque(frame->buf[0]));
+  scoped_refptr<VideoFrame> video_frame;
+  if (frame_buffer_pool_) {
+    auto* buffer =
+        static_cast<PooledFrameBuffer*>(av_buffer_get_opaque(frame->buf[0]));
+    video_frame = buffer->video_frame;
+    video_frame->AddDestructionObserver(
+        frame_buffer_pool_->CreateFrameCallback(buffer->fb_priv));
+  } else {
+    video_frame =
+        reinterpret_cast<VideoFrame*>(av_buffer_get_opaque(frame->buf[0]));
+  }
   video_frame->set_timestamp(
       base::TimeDelta::FromMicroseconds(frame->reordered_opaque));
   video_frame->metadata().power_efficient = false;
@@ -403,6 +527,13 @@ bool FFmpegVideoDecoder::OnNewFrame(AVFrame* frame) {
 void FFmpegVideoDecoder::ReleaseFFmpegResources() {
   decoding_loop_.reset();
   codec_context_.reset();
+
+  // FFmpeg has released all of its buffers at this point, so any remaining
+  // pool memory is held by outstanding VideoFrames.
+  if (frame_buffer_pool_) {
+    frame_buffer_pool_->Shutdown();
+    frame_buffer_pool_ = nullptr;
+  }
 }
 
 bool FFmpegVideoDecoder::ConfigureDecoder(const VideoDecoderConfig& config,
@@ -417,15 +548,24 @@ bool FFmpegVideoDecoder::ConfigureDecoder(const VideoDecoderConfig& config,
   codec_context_.reset(avcodec_alloc_context3(NULL));
   VideoDecoderConfigToAVCodecContext(config, codec_context_.get());
 
-  codec_context_->thread_count = GetFFmpegVideoDecoderThreadCount(config);
+  codec_context_->thread_count =
+      GetFFmpegVideoDecoderThreadCount(config, threading_mode_);
   codec_context_->thread_type =
-      FF_THREAD_SLICE | (low_delay ? 0 : FF_THREAD_FRAME);
+      FF_THREAD_SLICE |
+      (low_delay || threading_mode_ == ThreadingMode::kSliceThreaded
+           ? 0
+           : FF_THREAD_FRAME);
   codec_context_->opaque = this;
   codec_context_->get_buffer2 = GetVideoBufferImpl;
 
   if (decode_nalus_)
     codec_context_->flags2 |= AV_CODEC_FLAG2_CHUNKS;
 
+  if (threading_mode_ != ThreadingMode::kDefault) {
+    frame_buffer_pool_ =
+        base::MakeRefCounted<FrameBufferPool>(/*zero_initialize_memory=*/true);
+  }
+
   const AVCodec* codec = avcodec_find_decoder(codec_context_->codec_id);
   if (!codec || avcodec_open2(codec_context_.get(), codec, NULL) < 0) {
     ReleaseFFmpegResources();
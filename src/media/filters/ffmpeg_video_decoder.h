@@ -25,10 +25,27 @@ namespace media {
 
 class DecoderBuffer;
 class FFmpegDecodingLoop;
+class FrameBufferPool;
 class MediaLog;
 
 class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
  public:
+  // Controls how FFmpeg's internal threads are used.
+  enum class ThreadingMode {
+    // Thread count is a fixed function of the codec and resolution; frame
+    // threading is used unless low delay decoding was requested. Output frames
+    // are allocated from a VideoFramePool.
+    kDefault,
+    // Thread count is sized to the available cores and the content resolution.
+    // Frame and slice threading are both enabled, unless low delay decoding was
+    // requested, in which case only slice threading is used. Output frames are
+    // allocated from a FrameBufferPool and wrapped without copies.
+    kFrameThreaded,
+    // As kFrameThreaded, but only slice threading is used. This adds no
+    // decoding latency, but only benefits streams with multiple slices.
+    kSliceThreaded,
+  };
+
   static bool IsCodecSupported(VideoCodec codec);
   static SupportedVideoDecoderConfigs SupportedConfigsForWebRTC();
 
@@ -39,6 +56,12 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
   // Disables low-latency mode. Must be called before Initialize().
   void set_decode_nalus(bool decode_nalus) { decode_nalus_ = decode_nalus; }
 
+  // Overrides the threading mode selected by the kFFmpegVideoDecoderThreading
+  // feature. Takes effect on the next call to Initialize().
+  void set_threading_mode(ThreadingMode threading_mode) {
+    threading_mode_ = threading_mode;
+  }
+
   // VideoDecoder implementation.
   VideoDecoderType GetDecoderType() const override;
   void Initialize(const VideoDecoderConfig& config,
@@ -72,6 +95,14 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
   bool FFmpegDecode(const DecoderBuffer& buffer);
   bool OnNewFrame(AVFrame* frame);
 
+  // Allocates the buffer for |frame| from |frame_buffer_pool_| and wraps it in
+  // a VideoFrame. May be called on any thread. Returns null on failure.
+  scoped_refptr<VideoFrame> CreatePooledFrame(VideoPixelFormat format,
+                                              const gfx::Size& coded_size,
+                                              const gfx::Rect& visible_rect,
+                                              const gfx::Size& natural_size,
+                                              AVFrame* frame);
+
   // Handles (re-)initializing the decoder with a (new) config.
   // Returns true if initialization was successful.
   bool ConfigureDecoder(const VideoDecoderConfig& config, bool low_delay);
@@ -94,8 +125,13 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
 
   VideoFramePool frame_pool_;
 
+  // Used instead of |frame_pool_| for threading modes other than kDefault.
+  scoped_refptr<FrameBufferPool> frame_buffer_pool_;
+
   bool decode_nalus_ = false;
 
+  ThreadingMode threading_mode_;
+
   bool force_allocation_error_ = false;
 
   std::unique_ptr<FFmpegDecodingLoop> decoding_loop_;
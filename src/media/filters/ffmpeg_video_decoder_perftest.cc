@@ -0,0 +1,155 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
+#include "media/base/decoder_buffer.h"
+#include "media/base/media_util.h"
+#include "media/base/test_data_util.h"
+#include "media/base/video_frame.h"
+#include "media/ffmpeg/ffmpeg_common.h"
+#include "media/filters/ffmpeg_glue.h"
+#include "media/filters/ffmpeg_video_decoder.h"
+#include "media/filters/in_memory_url_protocol.h"
+#include "media/media_buildflags.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace media {
+
+static const int kBenchmarkIterations = 5;
+
+struct DecoderPerfTestParam {
+  const char* filename;
+  FFmpegVideoDecoder::ThreadingMode threading_mode;
+  const char* story;
+};
+
+// Demuxes every packet of the first video stream in |filename|.
+static void ReadVideoPackets(const std::string& filename,
+                             VideoDecoderConfig* config,
+                             std::vector<scoped_refptr<DecoderBuffer>>* out) {
+  scoped_refptr<DecoderBuffer> data = ReadTestDataFile(filename);
+  InMemoryUrlProtocol protocol(data->data(), data->data_size(), false);
+  FFmpegGlue glue(&protocol);
+  ASSERT_TRUE(glue.OpenContext());
+
+  AVFormatContext* format_context = glue.format_context();
+  int video_stream_index = -1;
+  for (unsigned int i = 0; i < format_context->nb_streams; ++i) {
+    if (format_context->streams[i]->codecpar->codec_type ==
+        AVMEDIA_TYPE_VIDEO) {
+      video_stream_index = i;
+      break;
+    }
+  }
+  ASSERT_GE(video_stream_index, 0);
+  const AVStream* stream = format_context->streams[video_stream_index];
+  ASSERT_TRUE(AVStreamToVideoDecoderConfig(stream, config));
+
+  AVPacket packet = {};
+  while (av_read_frame(format_context, &packet) >= 0) {
+    if (packet.stream_index == video_stream_index) {
+      scoped_refptr<DecoderBuffer> buffer =
+          DecoderBuffer::CopyFrom(packet.data, packet.size);
+      buffer->set_timestamp(
+          ConvertFromTimeBase(stream->time_base, packet.pts));
+      out->push_back(std::move(buffer));
+    }
+    av_packet_unref(&packet);
+  }
+  out->push_back(DecoderBuffer::CreateEOSBuffer());
+}
+
+static void RunDecoderBenchmark(const DecoderPerfTestParam& param) {
+  base::test::SingleThreadTaskEnvironment task_environment;
+  VideoDecoderConfig config;
+  std::vector<scoped_refptr<DecoderBuffer>> buffers;
+  ReadVideoPackets(param.filename, &config, &buffers);
+  ASSERT_TRUE(config.IsValidConfig());
+
+  NullMediaLog media_log;
+  int frames_decoded = 0;
+  base::TimeDelta total_time;
+  for (int i = 0; i < kBenchmarkIterations; ++i) {
+    FFmpegVideoDecoder decoder(&media_log);
+    decoder.set_threading_mode(param.threading_mode);
+    {
+      base::RunLoop run_loop;
+      decoder.Initialize(
+          config, false, nullptr,
+          base::BindOnce(
+              [](base::OnceClosure quit_cb, Status status) {
+                CHECK(status.is_ok());
+                std::move(quit_cb).Run();
+              },
+              run_loop.QuitClosure()),
+          base::BindRepeating(
+              [](int* frames_decoded, scoped_refptr<VideoFrame> frame) {
+                ++(*frames_decoded);
+              },
+              &frames_decoded),
+          base::NullCallback());
+      run_loop.Run();
+    }
+
+    // Benchmark. Output frames are dropped immediately, as a renderer keeping
+    // up with the decoder would.
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (const auto& buffer : buffers) {
+      base::RunLoop run_loop;
+      decoder.Decode(buffer,
+                     base::BindOnce(
+                         [](base::OnceClosure quit_cb, Status status) {
+                           CHECK(status.is_ok());
+                           std::move(quit_cb).Run();
+                         },
+                         run_loop.QuitClosure()));
+      run_loop.Run();
+    }
+    total_time += base::TimeTicks::Now() - start;
+  }
+
+  perf_test::PerfResultReporter reporter("ffmpeg_video_decoder_bench",
+                                         param.story);
+  reporter.RegisterImportantMetric("_throughput", "frames/s");
+  reporter.AddResult("_throughput", frames_decoded / total_time.InSecondsF());
+}
+
+class FFmpegVideoDecoderPerfTest
+    : public testing::TestWithParam<DecoderPerfTestParam> {};
+
+TEST_P(FFmpegVideoDecoderPerfTest, Decode) {
+  RunDecoderBenchmark(GetParam());
+}
+
+static const DecoderPerfTestParam kDecoderPerfTestParams[] = {
+    {"bear-640x360.webm", FFmpegVideoDecoder::ThreadingMode::kDefault,
+     "vp8_360p_default"},
+    {"bear-640x360.webm", FFmpegVideoDecoder::ThreadingMode::kFrameThreaded,
+     "vp8_360p_frame_threaded"},
+    {"bear-640x360.webm", FFmpegVideoDecoder::ThreadingMode::kSliceThreaded,
+     "vp8_360p_slice_threaded"},
+#if BUILDFLAG(USE_PROPRIETARY_CODECS)
+    {"bear-1280x720.mp4", FFmpegVideoDecoder::ThreadingMode::kDefault,
+     "h264_720p_default"},
+    {"bear-1280x720.mp4", FFmpegVideoDecoder::ThreadingMode::kFrameThreaded,
+     "h264_720p_frame_threaded"},
+    {"bear-1280x720.mp4", FFmpegVideoDecoder::ThreadingMode::kSliceThreaded,
+     "h264_720p_slice_threaded"},
+#endif
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         FFmpegVideoDecoderPerfTest,
+                         testing::ValuesIn(kDecoderPerfTestParams));
+
+}  // namespace media
@@ -260,6 +260,39 @@ TEST_F(FFmpegVideoDecoderTest, DecodeFrame_Normal) {
   ASSERT_EQ(1U, output_frames_.size());
 }
 
+TEST_F(FFmpegVideoDecoderTest, DecodeFrame_FrameThreaded) {
+  decoder_->set_threading_mode(
+      FFmpegVideoDecoder::ThreadingMode::kFrameThreaded);
+  Initialize();
+
+  InputBuffers input_buffers;
+  input_buffers.push_back(i_frame_buffer_);
+  input_buffers.push_back(i_frame_buffer_);
+  input_buffers.push_back(end_of_stream_buffer_);
+  EXPECT_TRUE(DecodeMultipleFrames(input_buffers).is_ok());
+  ASSERT_EQ(2U, output_frames_.size());
+  EXPECT_NE(output_frames_[0]->data(VideoFrame::kYPlane),
+            output_frames_[1]->data(VideoFrame::kYPlane));
+
+  // Pooled frames must remain valid after the decoder is destroyed.
+  Destroy();
+  for (const auto& frame : output_frames_) {
+    EXPECT_EQ(kVisibleRect, frame->visible_rect());
+    EXPECT_EQ(VideoFrame::STORAGE_UNOWNED_MEMORY, frame->storage_type());
+  }
+  output_frames_.clear();
+  base::RunLoop().RunUntilIdle();
+}
+
+TEST_F(FFmpegVideoDecoderTest, DecodeFrame_SliceThreaded) {
+  decoder_->set_threading_mode(
+      FFmpegVideoDecoder::ThreadingMode::kSliceThreaded);
+  Initialize();
+
+  EXPECT_TRUE(DecodeSingleFrame(i_frame_buffer_).is_ok());
+  ASSERT_EQ(1U, output_frames_.size());
+}
+
 TEST_F(FFmpegVideoDecoderTest, DecodeFrame_OOM) {
   Initialize();
   decoder_->force_allocation_error_for_testing();
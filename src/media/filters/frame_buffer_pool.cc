@@ -4,6 +4,8 @@
 
 #include "media/filters/frame_buffer_pool.h"
 
+#include <stdlib.h>
+
 #include "base/bind.h"
 #include "base/callback_helpers.h"
 #include "base/check_op.h"
@@ -33,8 +35,9 @@ struct FrameBufferPool::FrameBuffer {
   base::TimeTicks last_use_time;
 };
 
-FrameBufferPool::FrameBufferPool()
-    : tick_clock_(base::DefaultTickClock::GetInstance()) {
+FrameBufferPool::FrameBufferPool(bool zero_initialize_memory)
+    : zero_initialize_memory_(zero_initialize_memory),
+      tick_clock_(base::DefaultTickClock::GetInstance()) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
@@ -45,16 +48,10 @@ FrameBufferPool::~FrameBufferPool() {
 }
 
 uint8_t* FrameBufferPool::GetFrameBuffer(size_t min_size, void** fb_priv) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  DCHECK(!in_shutdown_);
+  MaybeRegisterDumpProvider();
 
-  if (!registered_dump_provider_) {
-    base::trace_event::MemoryDumpManager::GetInstance()
-        ->RegisterDumpProviderWithSequencedTaskRunner(
-            this, "FrameBufferPool", base::SequencedTaskRunnerHandle::Get(),
-            MemoryDumpProvider::Options());
-    registered_dump_provider_ = true;
-  }
+  base::AutoLock auto_lock(lock_);
+  DCHECK(!in_shutdown_);
 
   // Check if a free frame buffer exists.
   auto it = std::find_if(
@@ -71,13 +68,18 @@ uint8_t* FrameBufferPool::GetFrameBuffer(size_t min_size, void** fb_priv) {
   frame_buffer->held_by_library = true;
   if (frame_buffer->data_size < min_size) {
     // Free the existing |data| first so that the memory can be reused,
-    // if possible. Note that the new array is purposely not initialized.
+    // if possible. Note that the new array is purposely not initialized unless
+    // the client asked for zeroed memory.
     frame_buffer->data.reset();
 
     uint8_t* data = nullptr;
-    if (force_allocation_error_ ||
-        !base::UncheckedMalloc(min_size, reinterpret_cast<void**>(&data)) ||
-        !data) {
+    const bool allocated =
+        zero_initialize_memory_
+            ? base::UncheckedCalloc(1, min_size,
+                                    reinterpret_cast<void**>(&data))
+            : base::UncheckedMalloc(min_size, reinterpret_cast<void**>(&data));
+    if (force_allocation_error_ || !allocated || !data) {
+      free(data);
       frame_buffers_.erase(it);
       return nullptr;
     }
@@ -93,6 +95,7 @@ uint8_t* FrameBufferPool::GetFrameBuffer(size_t min_size, void** fb_priv) {
 
 void FrameBufferPool::ReleaseFrameBuffer(void* fb_priv) {
   DCHECK(fb_priv);
+  base::AutoLock auto_lock(lock_);
 
   // Note: The library may invoke this method multiple times for the same frame,
   // so we can't DCHECK that |held_by_library| is true.
@@ -106,6 +109,7 @@ void FrameBufferPool::ReleaseFrameBuffer(void* fb_priv) {
 uint8_t* FrameBufferPool::AllocateAlphaPlaneForFrameBuffer(size_t min_size,
                                                            void* fb_priv) {
   DCHECK(fb_priv);
+  base::AutoLock auto_lock(lock_);
 
   auto* frame_buffer = static_cast<FrameBuffer*>(fb_priv);
   DCHECK(IsUsed(frame_buffer));
@@ -127,7 +131,9 @@ uint8_t* FrameBufferPool::AllocateAlphaPlaneForFrameBuffer(size_t min_size,
 
 base::OnceClosure FrameBufferPool::CreateFrameCallback(void* fb_priv) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  MaybeRegisterDumpProvider();
 
+  base::AutoLock auto_lock(lock_);
   auto* frame_buffer = static_cast<FrameBuffer*>(fb_priv);
   ++frame_buffer->held_by_frame;
 
@@ -135,6 +141,11 @@ base::OnceClosure FrameBufferPool::CreateFrameCallback(void* fb_priv) {
                         base::SequencedTaskRunnerHandle::Get(), frame_buffer);
 }
 
+size_t FrameBufferPool::get_pool_size_for_testing() const {
+  base::AutoLock auto_lock(lock_);
+  return frame_buffers_.size();
+}
+
 bool FrameBufferPool::OnMemoryDump(
     const base::trace_event::MemoryDumpArgs& args,
     base::trace_event::ProcessMemoryDump* pmd) {
@@ -150,6 +161,7 @@ bool FrameBufferPool::OnMemoryDump(
                             ->system_allocator_pool_name());
   size_t bytes_used = 0;
   size_t bytes_reserved = 0;
+  base::AutoLock auto_lock(lock_);
   for (const auto& frame_buffer : frame_buffers_) {
     if (IsUsed(frame_buffer.get()))
       bytes_used += frame_buffer->data_size + frame_buffer->alpha_data_size;
@@ -168,13 +180,20 @@ bool FrameBufferPool::OnMemoryDump(
 
 void FrameBufferPool::Shutdown() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  in_shutdown_ = true;
+  bool registered_dump_provider;
+  {
+    base::AutoLock auto_lock(lock_);
+    in_shutdown_ = true;
+    registered_dump_provider = registered_dump_provider_;
+  }
 
-  if (registered_dump_provider_) {
+  if (registered_dump_provider) {
     base::trace_event::MemoryDumpManager::GetInstance()->UnregisterDumpProvider(
         this);
   }
 
+  base::AutoLock auto_lock(lock_);
+
   // Clear any refs held by the library which isn't good about cleaning up after
   // itself. This is safe since the library has already been shutdown by this
   // point.
@@ -191,6 +210,7 @@ bool FrameBufferPool::IsUsed(const FrameBuffer* buf) {
 
 void FrameBufferPool::EraseUnusedResources() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  lock_.AssertAcquired();
   base::EraseIf(frame_buffers_, [](const std::unique_ptr<FrameBuffer>& buf) {
     return !IsUsed(buf.get());
   });
@@ -207,6 +227,7 @@ void FrameBufferPool::OnVideoFrameDestroyed(
   }
 
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  base::AutoLock auto_lock(lock_);
   DCHECK_GT(frame_buffer->held_by_frame, 0);
   --frame_buffer->held_by_frame;
 
@@ -227,4 +248,23 @@ void FrameBufferPool::OnVideoFrameDestroyed(
   });
 }
 
+void FrameBufferPool::MaybeRegisterDumpProvider() {
+  // Decoder worker threads have no task runner; registration will instead
+  // happen on the next call from the owning sequence.
+  if (!base::SequencedTaskRunnerHandle::IsSet())
+    return;
+
+  {
+    base::AutoLock auto_lock(lock_);
+    if (registered_dump_provider_ || in_shutdown_)
+      return;
+    registered_dump_provider_ = true;
+  }
+
+  base::trace_event::MemoryDumpManager::GetInstance()
+      ->RegisterDumpProviderWithSequencedTaskRunner(
+          this, "FrameBufferPool", base::SequencedTaskRunnerHandle::Get(),
+          MemoryDumpProvider::Options());
+}
+
 }  // namespace media
@@ -13,6 +13,8 @@
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/sequence_checker.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
 #include "base/time/default_tick_clock.h"
 #include "base/trace_event/memory_dump_provider.h"
 #include "media/base/media_export.h"
@@ -26,11 +28,17 @@ namespace media {
 // FrameBufferPool is a pool of simple CPU memory. This class needs to be ref-
 // counted since frames created using this memory may live beyond the lifetime
 // of the caller to this class.
+//
+// GetFrameBuffer(), ReleaseFrameBuffer() and AllocateAlphaPlaneForFrameBuffer()
+// may be called from any thread, e.g. from a decoder library's worker threads;
+// all other methods must be called on the sequence which owns the pool.
 class MEDIA_EXPORT FrameBufferPool
     : public base::RefCountedThreadSafe<FrameBufferPool>,
       public base::trace_event::MemoryDumpProvider {
  public:
-  FrameBufferPool();
+  // If |zero_initialize_memory| is true, newly allocated buffers are zeroed;
+  // some decoders (e.g., FFmpeg) require this of their initial allocations.
+  explicit FrameBufferPool(bool zero_initialize_memory = false);
 
   // Called when a frame buffer allocation is needed. Upon return |fb_priv| will
   // be set to a private value used to identify the buffer in future calls and a
@@ -48,7 +56,7 @@ class MEDIA_EXPORT FrameBufferPool
   // |fb_priv| must be a value previously returned by GetFrameBuffer().
   base::OnceClosure CreateFrameCallback(void* fb_priv);
 
-  size_t get_pool_size_for_testing() const { return frame_buffers_.size(); }
+  size_t get_pool_size_for_testing() const;
 
   void set_tick_clock_for_testing(const base::TickClock* tick_clock) {
     tick_clock_ = tick_clock;
@@ -78,7 +86,11 @@ class MEDIA_EXPORT FrameBufferPool
   static bool IsUsed(const FrameBuffer* buf);
 
   // Drop all entries in |frame_buffers_| that report !IsUsed().
-  void EraseUnusedResources();
+  void EraseUnusedResources() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Registers |this| as a MemoryDumpProvider on the current sequence, if one
+  // exists and registration hasn't already happened.
+  void MaybeRegisterDumpProvider();
 
   // Method that gets called when a VideoFrame that references this pool gets
   // destroyed.
@@ -86,12 +98,18 @@ class MEDIA_EXPORT FrameBufferPool
       scoped_refptr<base::SequencedTaskRunner> task_runner,
       FrameBuffer* frame_buffer);
 
+  const bool zero_initialize_memory_;
+
+  // Protects all state touched by the methods which may be called from any
+  // thread.
+  mutable base::Lock lock_;
+
   // Allocated frame buffers.
-  std::vector<std::unique_ptr<FrameBuffer>> frame_buffers_;
+  std::vector<std::unique_ptr<FrameBuffer>> frame_buffers_ GUARDED_BY(lock_);
 
-  bool in_shutdown_ = false;
+  bool in_shutdown_ GUARDED_BY(lock_) = false;
 
-  bool registered_dump_provider_ = false;
+  bool registered_dump_provider_ GUARDED_BY(lock_) = false;
 
   bool force_allocation_error_ = false;
 
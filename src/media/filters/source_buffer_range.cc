@@ -23,7 +23,8 @@ SourceBufferRange::SourceBufferRange(
       interbuffer_distance_cb_(std::move(interbuffer_distance_cb)),
       size_in_bytes_(0),
       range_start_pts_(range_start_pts),
-      keyframe_map_index_base_(0) {
+      keyframe_map_index_base_(0),
+      keyframe_map_byte_base_(0) {
   DVLOG(3) << __func__;
   DCHECK(interbuffer_distance_cb_);
   CHECK(!new_buffers.empty());
@@ -119,14 +120,27 @@ void SourceBufferRange::AppendBuffersToEnd(
     DCHECK((*itr)->timestamp() != kNoTimestamp);
     DCHECK((*itr)->GetDecodeTimestamp() != kNoDecodeTimestamp());
 
+    if ((*itr)->is_key_frame()) {
+      const base::TimeDelta timestamp = (*itr)->timestamp();
+      const KeyframeEntry entry = {
+          timestamp,
+          static_cast<int>(buffers_.size()) + keyframe_map_index_base_,
+          size_in_bytes_ + keyframe_map_byte_base_};
+      if (keyframe_map_.empty() || keyframe_map_.back().timestamp < timestamp) {
+        keyframe_map_.push_back(entry);
+      } else {
+        // Keyframes normally arrive in increasing timestamp order. Otherwise
+        // keep the index sorted, and keep the earlier GOP for a duplicate
+        // timestamp.
+        auto pos = GetFirstKeyframeAt(timestamp, false);
+        if (pos == keyframe_map_.end() || pos->timestamp != timestamp)
+          keyframe_map_.insert(pos, entry);
+      }
+    }
+
     buffers_.push_back(*itr);
     UpdateEndTime(*itr);
     size_in_bytes_ += (*itr)->data_size();
-
-    if ((*itr)->is_key_frame()) {
-      keyframe_map_.insert(std::make_pair(
-          (*itr)->timestamp(), buffers_.size() - 1 + keyframe_map_index_base_));
-    }
   }
 
   DVLOG(4) << __func__ << " Result: " << ToStringForDebugging();
@@ -177,7 +191,7 @@ void SourceBufferRange::Seek(base::TimeDelta timestamp) {
   DCHECK(!keyframe_map_.empty());
 
   auto result = GetFirstKeyframeAtOrBefore(timestamp);
-  next_buffer_index_ = result->second - keyframe_map_index_base_;
+  next_buffer_index_ = result->index - keyframe_map_index_base_;
   CHECK_LT(next_buffer_index_, static_cast<int>(buffers_.size()))
       << next_buffer_index_ << ", size = " << buffers_.size();
 }
@@ -201,7 +215,7 @@ int SourceBufferRange::GetConfigIdAtTime(base::TimeDelta timestamp) const {
 
   auto result = GetFirstKeyframeAtOrBefore(timestamp);
   CHECK(result != keyframe_map_.end());
-  size_t buffer_index = result->second - keyframe_map_index_base_;
+  size_t buffer_index = result->index - keyframe_map_index_base_;
   CHECK_LT(buffer_index, buffers_.size())
       << buffer_index << ", size = " << buffers_.size();
 
@@ -223,7 +237,7 @@ bool SourceBufferRange::SameConfigThruRange(base::TimeDelta start,
 
   auto result = GetFirstKeyframeAtOrBefore(start);
   CHECK(result != keyframe_map_.end());
-  size_t buffer_index = result->second - keyframe_map_index_base_;
+  size_t buffer_index = result->index - keyframe_map_index_base_;
   CHECK_LT(buffer_index, buffers_.size())
       << buffer_index << ", size = " << buffers_.size();
 
@@ -256,7 +270,7 @@ std::unique_ptr<SourceBufferRange> SourceBufferRange::SplitRange(
   // Remove the data beginning at |keyframe_index| from |buffers_| and save it
   // into |removed_buffers|.
   int keyframe_index =
-      new_beginning_keyframe->second - keyframe_map_index_base_;
+      new_beginning_keyframe->index - keyframe_map_index_base_;
   CHECK_LT(keyframe_index, static_cast<int>(buffers_.size()));
   BufferQueue::iterator starting_point = buffers_.begin() + keyframe_index;
   BufferQueue removed_buffers(starting_point, buffers_.end());
@@ -315,16 +329,15 @@ size_t SourceBufferRange::DeleteGOPFromFront(BufferQueue* deleted_buffers) {
   int buffers_deleted = 0;
   size_t total_bytes_deleted = 0;
 
-  KeyframeMap::const_iterator front = keyframe_map_.begin();
-  DCHECK(front != keyframe_map_.end());
+  DCHECK(!keyframe_map_.empty());
 
   // Delete the keyframe at the start of |keyframe_map_|.
-  keyframe_map_.erase(front);
+  keyframe_map_.pop_front();
 
   // Now we need to delete all the buffers that depend on the keyframe we've
   // just deleted.
   int end_index = keyframe_map_.size() > 0
-                      ? keyframe_map_.begin()->second - keyframe_map_index_base_
+                      ? keyframe_map_.begin()->index - keyframe_map_index_base_
                       : buffers_.size();
 
   // Delete buffers from the beginning of the buffered range up until (but not
@@ -339,8 +352,10 @@ size_t SourceBufferRange::DeleteGOPFromFront(BufferQueue* deleted_buffers) {
     ++buffers_deleted;
   }
 
-  // Update |keyframe_map_index_base_| to account for the deleted buffers.
+  // Update |keyframe_map_index_base_| and |keyframe_map_byte_base_| to account
+  // for the deleted buffers.
   keyframe_map_index_base_ += buffers_deleted;
+  keyframe_map_byte_base_ += total_bytes_deleted;
 
   if (next_buffer_index_ > -1) {
     next_buffer_index_ -= buffers_deleted;
@@ -369,14 +384,12 @@ size_t SourceBufferRange::DeleteGOPFromBack(BufferQueue* deleted_buffers) {
   DCHECK(deleted_buffers);
 
   // Remove the last GOP's keyframe from the |keyframe_map_|.
-  KeyframeMap::const_iterator back = keyframe_map_.end();
   DCHECK_GT(keyframe_map_.size(), 0u);
-  --back;
 
   // The index of the first buffer in the last GOP is equal to the new size of
   // |buffers_| after that GOP is deleted.
-  size_t goal_size = back->second - keyframe_map_index_base_;
-  keyframe_map_.erase(back);
+  size_t goal_size = keyframe_map_.back().index - keyframe_map_index_base_;
+  keyframe_map_.pop_back();
 
   size_t total_bytes_deleted = 0;
   while (buffers_.size() != goal_size) {
@@ -409,8 +422,6 @@ size_t SourceBufferRange::GetRemovalGOP(
   auto gop_itr = GetFirstKeyframeAt(start_timestamp, false);
   if (gop_itr == keyframe_map_.end())
     return 0;
-  int keyframe_index = gop_itr->second - keyframe_map_index_base_;
-  BufferQueue::const_iterator buffer_itr = buffers_.begin() + keyframe_index;
   auto gop_end = keyframe_map_.end();
   if (end_timestamp < GetBufferedEndTimestamp())
     gop_end = GetFirstKeyframeAtOrBefore(end_timestamp);
@@ -422,24 +433,13 @@ size_t SourceBufferRange::GetRemovalGOP(
     gop_end = gop_itr;
 
   while (gop_itr != gop_end && bytes_removed < total_bytes_to_free) {
+    bytes_removed += GetGOPSize(gop_itr);
     ++gop_itr;
-
-    size_t gop_size = 0;
-    int next_gop_index = gop_itr == keyframe_map_.end()
-                             ? buffers_.size()
-                             : gop_itr->second - keyframe_map_index_base_;
-    BufferQueue::const_iterator next_gop_start =
-        buffers_.begin() + next_gop_index;
-    for (; buffer_itr != next_gop_start; ++buffer_itr) {
-      gop_size += (*buffer_itr)->data_size();
-    }
-
-    bytes_removed += gop_size;
   }
   if (bytes_removed > 0) {
     *removal_end_timestamp = gop_itr == keyframe_map_.end()
                                  ? GetBufferedEndTimestamp()
-                                 : gop_itr->first;
+                                 : gop_itr->timestamp;
   }
   return bytes_removed;
 }
@@ -454,7 +454,7 @@ bool SourceBufferRange::FirstGOPEarlierThanMediaTime(
 
   auto second_gop = keyframe_map_.begin();
   ++second_gop;
-  return second_gop->first <= media_time;
+  return second_gop->timestamp <= media_time;
 }
 
 bool SourceBufferRange::FirstGOPContainsNextBufferPosition() const {
@@ -470,7 +470,7 @@ bool SourceBufferRange::FirstGOPContainsNextBufferPosition() const {
 
   auto second_gop = keyframe_map_.begin();
   ++second_gop;
-  return next_buffer_index_ < second_gop->second - keyframe_map_index_base_;
+  return next_buffer_index_ < second_gop->index - keyframe_map_index_base_;
 }
 
 bool SourceBufferRange::LastGOPContainsNextBufferPosition() const {
@@ -486,7 +486,7 @@ bool SourceBufferRange::LastGOPContainsNextBufferPosition() const {
 
   auto last_gop = keyframe_map_.end();
   --last_gop;
-  return last_gop->second - keyframe_map_index_base_ <= next_buffer_index_;
+  return last_gop->index - keyframe_map_index_base_ <= next_buffer_index_;
 }
 
 base::TimeDelta SourceBufferRange::GetNextTimestamp() const {
@@ -560,7 +560,7 @@ base::TimeDelta SourceBufferRange::FindHighestBufferedTimestampAtOrBefore(
   DCHECK(!buffers_.empty());
   DCHECK(BelongsToRange(timestamp));
 
-  if (keyframe_map_.begin()->first > timestamp) {
+  if (keyframe_map_.begin()->timestamp > timestamp) {
     // If the first keyframe in the range starts after |timestamp|, then
     // return the range start time (which could be earlier due to coded frame
     // group signalling.)
@@ -569,18 +569,18 @@ base::TimeDelta SourceBufferRange::FindHighestBufferedTimestampAtOrBefore(
     return range_start;
   }
 
-  if (keyframe_map_.begin()->first == timestamp) {
+  if (keyframe_map_.begin()->timestamp == timestamp) {
     return timestamp;
   }
 
   auto key_iter = GetFirstKeyframeAtOrBefore(timestamp);
   DCHECK(key_iter != keyframe_map_.end())
       << "BelongsToRange() semantics failed.";
-  DCHECK(key_iter->first <= timestamp);
+  DCHECK(key_iter->timestamp <= timestamp);
 
   // Scan forward in |buffers_| to find the highest frame with timestamp <=
   // |timestamp|. Stop once a frame with timestamp > |timestamp| is encountered.
-  size_t key_index = key_iter->second - keyframe_map_index_base_;
+  size_t key_index = key_iter->index - keyframe_map_index_base_;
   SourceBufferRange::BufferQueue::const_iterator search_iter =
       buffers_.begin() + key_index;
   CHECK(search_iter != buffers_.end());
@@ -618,11 +618,11 @@ base::TimeDelta SourceBufferRange::NextKeyframeTimestamp(
   // group and the first buffer, then just pretend there is a keyframe at the
   // specified timestamp.
   if (itr == keyframe_map_.begin() && timestamp > range_start_pts_ &&
-      timestamp < itr->first) {
+      timestamp < itr->timestamp) {
     return timestamp;
   }
 
-  return itr->first;
+  return itr->timestamp;
 }
 
 base::TimeDelta SourceBufferRange::KeyframeBeforeTimestamp(
@@ -635,7 +635,7 @@ base::TimeDelta SourceBufferRange::KeyframeBeforeTimestamp(
   if (timestamp < GetStartTimestamp() || timestamp >= GetBufferedEndTimestamp())
     return kNoTimestamp;
 
-  return GetFirstKeyframeAtOrBefore(timestamp)->first;
+  return GetFirstKeyframeAtOrBefore(timestamp)->timestamp;
 }
 
 bool SourceBufferRange::GetBuffersInRange(base::TimeDelta start,
@@ -700,6 +700,16 @@ void SourceBufferRange::AdjustEstimatedDurationForNewAppend(
   }
 }
 
+size_t SourceBufferRange::GetGOPSize(KeyframeMap::const_iterator gop) const {
+  DCHECK(gop != keyframe_map_.end());
+  auto next_gop = gop + 1;
+  size_t gop_end = next_gop == keyframe_map_.end()
+                       ? size_in_bytes_ + keyframe_map_byte_base_
+                       : next_gop->byte_offset;
+  DCHECK_GE(gop_end, gop->byte_offset);
+  return gop_end - gop->byte_offset;
+}
+
 void SourceBufferRange::FreeBufferRange(
     const BufferQueue::const_iterator& starting_point,
     const BufferQueue::const_iterator& ending_point) {
@@ -817,7 +827,7 @@ size_t SourceBufferRange::GetBufferIndexAt(base::TimeDelta timestamp,
   // don't know the DTS for the searched-for frame, and the PTS sequence within
   // a GOP may not match the DTS-sorted sequence of frames within the GOP.
   DCHECK_GT(buffers_.size(), 0u);
-  size_t search_index = gop_iter->second - keyframe_map_index_base_;
+  size_t search_index = gop_iter->index - keyframe_map_index_base_;
   SourceBufferRange::BufferQueue::const_iterator search_iter =
       buffers_.begin() + search_index;
   gop_iter++;
@@ -825,7 +835,7 @@ size_t SourceBufferRange::GetBufferIndexAt(base::TimeDelta timestamp,
   SourceBufferRange::BufferQueue::const_iterator next_gop_start =
       gop_iter == keyframe_map_.end()
           ? buffers_.end()
-          : buffers_.begin() + (gop_iter->second - keyframe_map_index_base_);
+          : buffers_.begin() + (gop_iter->index - keyframe_map_index_base_);
 
   while (search_iter != next_gop_start) {
     if (((*search_iter)->timestamp() > timestamp) ||
@@ -854,8 +864,18 @@ SourceBufferRange::GetFirstKeyframeAt(base::TimeDelta timestamp,
   DVLOG(1) << __func__;
   DVLOG(4) << ToStringForDebugging();
 
-  return skip_given_timestamp ? keyframe_map_.upper_bound(timestamp)
-                              : keyframe_map_.lower_bound(timestamp);
+  if (skip_given_timestamp) {
+    return std::upper_bound(
+        keyframe_map_.begin(), keyframe_map_.end(), timestamp,
+        [](base::TimeDelta time, const KeyframeEntry& entry) {
+          return time < entry.timestamp;
+        });
+  }
+  return std::lower_bound(
+      keyframe_map_.begin(), keyframe_map_.end(), timestamp,
+      [](const KeyframeEntry& entry, base::TimeDelta time) {
+        return entry.timestamp < time;
+      });
 }
 
 SourceBufferRange::KeyframeMap::const_iterator
@@ -863,12 +883,12 @@ SourceBufferRange::GetFirstKeyframeAtOrBefore(base::TimeDelta timestamp) const {
   DVLOG(1) << __func__;
   DVLOG(4) << ToStringForDebugging();
 
-  auto result = keyframe_map_.lower_bound(timestamp);
-  // lower_bound() returns the first element >= |timestamp|, so we want the
-  // previous element if it did not return the element exactly equal to
+  auto result = GetFirstKeyframeAt(timestamp, false);
+  // GetFirstKeyframeAt() returns the first element >= |timestamp|, so we want
+  // the previous element if it did not return the element exactly equal to
   // |timestamp|.
   if (result != keyframe_map_.begin() &&
-      (result == keyframe_map_.end() || result->first != timestamp)) {
+      (result == keyframe_map_.end() || result->timestamp != timestamp)) {
     --result;
   }
   return result;
@@ -904,7 +924,7 @@ bool SourceBufferRange::TruncateAt(const size_t starting_point,
 
   // Remove keyframes from |starting_point| onward.
   KeyframeMap::const_iterator starting_point_keyframe =
-      keyframe_map_.lower_bound((*starting_point_iter)->timestamp());
+      GetFirstKeyframeAt((*starting_point_iter)->timestamp(), false);
   keyframe_map_.erase(starting_point_keyframe, keyframe_map_.end());
 
   // Remove everything from |starting_point| onward.
@@ -933,7 +953,7 @@ void SourceBufferRange::UpdateEndTimeUsingLastGOP() {
   // Iterate through the frames of the last GOP in this range, finding the
   // frame with the highest PTS.
   for (BufferQueue::const_iterator buffer_itr =
-           buffers_.begin() + (last_gop->second - keyframe_map_index_base_);
+           buffers_.begin() + (last_gop->index - keyframe_map_index_base_);
        buffer_itr != buffers_.end(); ++buffer_itr) {
     UpdateEndTime(*buffer_itr);
   }
@@ -948,12 +968,14 @@ std::string SourceBufferRange::ToStringForDebugging() const {
 
 #if !defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)
   result << "keyframe_map_index_base_=" << keyframe_map_index_base_
+         << ", keyframe_map_byte_base_=" << keyframe_map_byte_base_
          << ", buffers.size()=" << buffers_.size()
          << ", keyframe_map_.size()=" << keyframe_map_.size()
          << ", keyframe_map_:\n";
   for (const auto& entry : keyframe_map_) {
-    result << "\t pts " << entry.first.InMicroseconds()
-           << ", unadjusted idx = " << entry.second << "\n";
+    result << "\t pts " << entry.timestamp.InMicroseconds()
+           << ", unadjusted idx = " << entry.index
+           << ", unadjusted byte offset = " << entry.byte_offset << "\n";
   }
 #endif  // !defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)
 
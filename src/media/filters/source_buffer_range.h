@@ -6,10 +6,11 @@
 #define MEDIA_FILTERS_SOURCE_BUFFER_RANGE_H_
 
 #include <stddef.h>
-#include <map>
 #include <memory>
+#include <string>
 
 #include "base/callback.h"
+#include "base/containers/circular_deque.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "media/base/media_export.h"
@@ -250,7 +251,20 @@ class MEDIA_EXPORT SourceBufferRange {
   // Friend of private is only for IsNextInPresentationSequence testing.
   friend class SourceBufferStreamTest;
 
-  using KeyframeMap = std::map<base::TimeDelta, int>;
+  // A GOP in this range: the presentation timestamp of its keyframe, the
+  // position of that keyframe in |buffers_| (adjusted by
+  // |keyframe_map_index_base_|) and the number of bytes buffered in this range
+  // before that keyframe (adjusted by |keyframe_map_byte_base_|).
+  struct KeyframeEntry {
+    base::TimeDelta timestamp;
+    int index;
+    size_t byte_offset;
+  };
+
+  // Sorted by keyframe timestamp. GOPs are appended at the back and evicted
+  // from either end, so a deque gives O(1) updates while lookups by timestamp
+  // are binary searches.
+  using KeyframeMap = base::circular_deque<KeyframeEntry>;
 
   // Called during AppendBuffersToEnd to adjust estimated duration at the
   // end of the last append to match the delta in timestamps between
@@ -259,6 +273,10 @@ class MEDIA_EXPORT SourceBufferRange {
   // care of updating |highest_frame_|.
   void AdjustEstimatedDurationForNewAppend(const BufferQueue& new_buffers);
 
+  // Returns the size in bytes of the buffers in the GOP starting at |gop|,
+  // which must not be |keyframe_map_.end()|.
+  size_t GetGOPSize(KeyframeMap::const_iterator gop) const;
+
   // Frees the buffers in |buffers_| from [|start_point|,|ending_point|) and
   // updates the |size_in_bytes_| accordingly. Note, this does not update
   // |keyframe_map_|.
@@ -389,8 +407,14 @@ class MEDIA_EXPORT SourceBufferRange {
   //   keyframe_map_[k] - keyframe_map_index_base_
   int keyframe_map_index_base_;
 
-  // Maps keyframe presentation timestamps to GOP start index of |buffers_|
-  // (with index adjusted by |keyframe_map_index_base_|);
+  // Byte offset base of all entries in |keyframe_map_|. The number of bytes
+  // buffered in this range before the keyframe of entry |k| is:
+  //   keyframe_map_[k].byte_offset - keyframe_map_byte_base_
+  // This lets the size of any GOP be computed without visiting its buffers.
+  size_t keyframe_map_byte_base_;
+
+  // Index of the GOPs in |buffers_|, ordered by keyframe presentation
+  // timestamp.
   KeyframeMap keyframe_map_;
 
   DISALLOW_COPY_AND_ASSIGN(SourceBufferRange);
@@ -0,0 +1,133 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "base/time/time.h"
+#include "media/base/demuxer_stream.h"
+#include "media/base/media_util.h"
+#include "media/base/stream_parser_buffer.h"
+#include "media/base/test_helpers.h"
+#include "media/filters/source_buffer_stream.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace media {
+
+// Amount of synthetic media appended by each benchmark.
+static const int kMediaDurationInHours = 4;
+
+// Playback trails the append position by this much, so that garbage collection
+// always has buffers behind the playback position to evict.
+static const int kPlaybackLagInSeconds = 30;
+
+// Memory limit of the stream, small enough that every append past the first
+// few minutes requires eviction.
+static const size_t kMemoryLimit = 8 * 1024 * 1024;
+
+struct SourceBufferStreamPerfTestParam {
+  const char* story;
+  DemuxerStream::Type type;
+  int frames_per_second;
+  int frames_per_keyframe;
+  int frame_size;
+  // Number of frames in each call to Append(), like a parsed media segment.
+  int frames_per_append;
+};
+
+static void RunAppendAndEvictBenchmark(
+    const SourceBufferStreamPerfTestParam& param) {
+  NullMediaLog media_log;
+  std::unique_ptr<SourceBufferStream> stream =
+      param.type == DemuxerStream::AUDIO
+          ? std::make_unique<SourceBufferStream>(TestAudioConfig::Normal(),
+                                                 &media_log)
+          : std::make_unique<SourceBufferStream>(TestVideoConfig::Normal(),
+                                                 &media_log);
+  stream->set_memory_limit(kMemoryLimit);
+
+  const std::vector<uint8_t> data(param.frame_size);
+  const base::TimeDelta frame_duration =
+      base::TimeDelta::FromSeconds(1) / param.frames_per_second;
+  const int total_frames =
+      kMediaDurationInHours * 3600 * param.frames_per_second;
+  const int lag_frames = kPlaybackLagInSeconds * param.frames_per_second;
+
+  stream->Seek(base::TimeDelta());
+  stream->OnStartOfCodedFrameGroup(base::TimeDelta());
+
+  base::TimeDelta append_time;
+  base::TimeDelta gc_time;
+  int frames_read = 0;
+  for (int frame = 0; frame < total_frames;
+       frame += param.frames_per_append) {
+    // Buffers are created outside of the timed region; only the stream's own
+    // bookkeeping is measured.
+    SourceBufferStream::BufferQueue buffers;
+    for (int i = frame; i < frame + param.frames_per_append; ++i) {
+      scoped_refptr<StreamParserBuffer> buffer = StreamParserBuffer::CopyFrom(
+          data.data(), data.size(), i % param.frames_per_keyframe == 0,
+          param.type, 0);
+      buffer->set_timestamp(i * frame_duration);
+      buffer->SetDecodeTimestamp(
+          DecodeTimestamp::FromPresentationTime(i * frame_duration));
+      buffer->set_duration(frame_duration);
+      buffers.push_back(std::move(buffer));
+    }
+
+    const base::TimeDelta media_time =
+        std::max(0, frame - lag_frames) * frame_duration;
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    ASSERT_TRUE(stream->GarbageCollectIfNeeded(
+        media_time, param.frames_per_append * param.frame_size));
+    base::TimeTicks gc_end = base::TimeTicks::Now();
+    stream->Append(buffers);
+    append_time += base::TimeTicks::Now() - gc_end;
+    gc_time += gc_end - start;
+
+    // Read up to the playback position, as the renderer would.
+    scoped_refptr<StreamParserBuffer> buffer;
+    while (frames_read * frame_duration < media_time) {
+      ASSERT_EQ(SourceBufferStreamStatus::kSuccess,
+                stream->GetNextBuffer(&buffer));
+      ++frames_read;
+    }
+  }
+  EXPECT_LE(stream->GetBufferedSize(), kMemoryLimit);
+
+  const int appends = total_frames / param.frames_per_append;
+  perf_test::PerfResultReporter reporter("source_buffer_stream", param.story);
+  reporter.RegisterImportantMetric("_append", "us");
+  reporter.RegisterImportantMetric("_garbage_collect", "us");
+  reporter.AddResult("_append", append_time.InMicrosecondsF() / appends);
+  reporter.AddResult("_garbage_collect", gc_time.InMicrosecondsF() / appends);
+}
+
+class SourceBufferStreamPerfTest
+    : public testing::TestWithParam<SourceBufferStreamPerfTestParam> {};
+
+TEST_P(SourceBufferStreamPerfTest, AppendAndEvict) {
+  RunAppendAndEvictBenchmark(GetParam());
+}
+
+static const SourceBufferStreamPerfTestParam kPerfTestParams[] = {
+    // 30fps video with one second GOPs, appended in one second segments.
+    {"video_30fps", DemuxerStream::VIDEO, 30, 30, 4096, 30},
+    // 60fps video with two second GOPs, appended in two second segments.
+    {"video_60fps", DemuxerStream::VIDEO, 60, 120, 2048, 120},
+    // 20ms audio frames, each a keyframe, appended in one second segments.
+    {"audio_50fps", DemuxerStream::AUDIO, 50, 1, 256, 50},
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         SourceBufferStreamPerfTest,
+                         testing::ValuesIn(kPerfTestParams));
+
+}  // namespace media
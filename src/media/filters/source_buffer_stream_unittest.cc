@@ -3368,6 +3368,31 @@ TEST_F(SourceBufferStreamTest, GetRemovalRange_Range) {
   EXPECT_EQ(18, bytes_removed);
 }
 
+TEST_F(SourceBufferStreamTest, GetRemovalRange_AfterGOPsRemovedFromEnds) {
+  // Append 4 GOPs starting at 0ms, 30ms apart.
+  NewCodedFrameGroupAppend("0K 30 60 90K 120 150 180K 210 240 270K 300 330");
+  CheckExpectedRangesByTimestamp("{ [0,360) }");
+
+  // Garbage collect the 2 GOPs before the playback position.
+  SeekToTimestampMs(180);
+  SetMemoryLimit(6);
+  EXPECT_TRUE(GarbageCollect(base::TimeDelta::FromMilliseconds(180), 0));
+  CheckExpectedRangesByTimestamp("{ [180,360) }");
+
+  // GOP sizes must not include the buffers removed from the front.
+  int remove_range_end = -1;
+  EXPECT_EQ(3, GetRemovalRangeInMs(180, 360, 1, &remove_range_end));
+  EXPECT_EQ(270, remove_range_end);
+  EXPECT_EQ(6, GetRemovalRangeInMs(180, 360, 20, &remove_range_end));
+  EXPECT_EQ(360, remove_range_end);
+
+  // Truncate the last GOP. Its size must only include the remaining buffer.
+  RemoveInMs(300, 360, 360);
+  CheckExpectedRangesByTimestamp("{ [180,300) }");
+  EXPECT_EQ(4, GetRemovalRangeInMs(180, 300, 20, &remove_range_end));
+  EXPECT_EQ(300, remove_range_end);
+}
+
 TEST_F(SourceBufferStreamTest, ConfigChange_Basic) {
   VideoDecoderConfig new_config = TestVideoConfig::Large();
   ASSERT_FALSE(new_config.Matches(video_config_));
@@ -0,0 +1,137 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/callback_helpers.h"
+#include "base/strings/string_split.h"
+#include "base/time/time.h"
+#include "media/base/decoder_buffer.h"
+#include "media/base/media_tracks.h"
+#include "media/base/media_util.h"
+#include "media/base/stream_parser.h"
+#include "media/base/test_data_util.h"
+#include "media/filters/stream_parser_factory.h"
+#include "media/formats/mp4/mp4_stream_parser.h"
+#include "media/media_buildflags.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace media {
+
+static const int kBenchmarkIterations = 100;
+
+struct StreamParserPerfTestParam {
+  const char* filename;
+  const char* mime_type;
+  // Comma separated codecs parameter of |mime_type|.
+  const char* codecs;
+  const char* story;
+  // If non-zero, overrides the amount of queued MP4 sample data which is
+  // emitted without waiting for the end of the Parse() call.
+  size_t max_queued_sample_bytes;
+};
+
+// Parse state for a single iteration of the benchmark.
+struct ParseStats {
+  base::TimeTicks first_buffers_time;
+  int buffer_count = 0;
+};
+
+static bool OnNewConfig(std::unique_ptr<MediaTracks> tracks,
+                        const StreamParser::TextTrackConfigMap& text_configs) {
+  return true;
+}
+
+static bool OnNewBuffers(ParseStats* stats,
+                         const StreamParser::BufferQueueMap& buffer_queue_map) {
+  if (stats->first_buffers_time.is_null())
+    stats->first_buffers_time = base::TimeTicks::Now();
+  for (const auto& it : buffer_queue_map)
+    stats->buffer_count += it.second.size();
+  return true;
+}
+
+// Appends all of |param.filename| to a new parser with a single Parse() call,
+// as a media segment appended to a SourceBuffer would be, and reports the
+// parse throughput and how long it took for the first samples to be emitted.
+static void RunStreamParserBenchmark(const StreamParserPerfTestParam& param) {
+  scoped_refptr<DecoderBuffer> data = ReadTestDataFile(param.filename);
+  const std::vector<std::string> codecs =
+      base::SplitString(param.codecs, ",", base::TRIM_WHITESPACE,
+                        base::SPLIT_WANT_NONEMPTY);
+
+  NullMediaLog media_log;
+  base::TimeDelta total_time;
+  base::TimeDelta first_buffers_time;
+  for (int i = 0; i < kBenchmarkIterations; ++i) {
+    std::unique_ptr<StreamParser> parser =
+        StreamParserFactory::Create(param.mime_type, codecs, &media_log);
+    ASSERT_TRUE(parser);
+    if (param.max_queued_sample_bytes) {
+      static_cast<mp4::MP4StreamParser*>(parser.get())
+          ->set_max_queued_sample_bytes_for_testing(
+              param.max_queued_sample_bytes);
+    }
+
+    ParseStats stats;
+    parser->Init(base::DoNothing(), base::BindRepeating(&OnNewConfig),
+                 base::BindRepeating(&OnNewBuffers, &stats), true,
+                 base::DoNothing(), base::DoNothing(), base::DoNothing(),
+                 &media_log);
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    ASSERT_TRUE(parser->Parse(data->data(), data->data_size()));
+    total_time += base::TimeTicks::Now() - start;
+
+    ASSERT_GT(stats.buffer_count, 0);
+    first_buffers_time += stats.first_buffers_time - start;
+  }
+
+  perf_test::PerfResultReporter reporter("stream_parser_bench", param.story);
+  reporter.RegisterImportantMetric("_throughput", "MB/s");
+  reporter.RegisterImportantMetric("_first_buffers", "us");
+  reporter.AddResult("_throughput", kBenchmarkIterations * data->data_size() /
+                                        total_time.InSecondsF() / 1e6);
+  reporter.AddResult("_first_buffers",
+                     first_buffers_time.InMicrosecondsF() /
+                         kBenchmarkIterations);
+}
+
+class StreamParserPerfTest
+    : public testing::TestWithParam<StreamParserPerfTestParam> {};
+
+TEST_P(StreamParserPerfTest, Parse) {
+  RunStreamParserBenchmark(GetParam());
+}
+
+static const StreamParserPerfTestParam kStreamParserPerfTestParams[] = {
+    {"bear-320x240-v_frag-vp9.mp4", "video/mp4", "vp09.00.10.08",
+     "mp4_vp9_frag", 0},
+#if BUILDFLAG(USE_PROPRIETARY_CODECS)
+    {"bear-1280x720-av_frag.mp4", "video/mp4", "avc1.64001F,mp4a.40.2",
+     "mp4_h264_aac_frag", 0},
+    // None of the test files has a fragment with more than 512 KiB of samples,
+    // so lower the limit below the size of this file's fragments instead, to
+    // measure their incremental emission. Compare with mp4_h264_aac_frag.
+    {"bear-1280x720-av_frag.mp4", "video/mp4", "avc1.64001F,mp4a.40.2",
+     "mp4_h264_aac_frag_large_fragments", 16 * 1024},
+#if BUILDFLAG(ENABLE_MSE_MPEG2TS_STREAM_PARSER)
+    {"bear-1280x720.ts", "video/mp2t", "avc1.64001F,mp4a.40.2",
+     "mp2t_h264_aac", 0},
+#endif
+#endif
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         StreamParserPerfTest,
+                         testing::ValuesIn(kStreamParserPerfTestParams));
+
+}  // namespace media
@@ -30,6 +30,14 @@ const int kMinimumCadenceDurationMs = 100;
 const double kVariableFPSFactor = 0.55;
 const double kConstantFPSFactor = 0.45;
 
+// Size of the buckets of render intervals and frame durations which share a
+// cadence in the cadence profile; small enough to tell 59.94Hz from 60Hz.
+const int64_t kCadenceProfileGranularityUs = 10;
+
+// Maximum number of cadences in the cadence profile; a playback only ever sees
+// a few displays and playback rates.
+const size_t kMaxCadenceProfileSize = 16;
+
 // Records the number of cadence changes to UMA.
 static void HistogramCadenceChangeCount(int cadence_changes) {
   const int kCadenceChangeMax = 10;
@@ -79,7 +87,9 @@ VideoCadenceEstimator::VideoCadenceEstimator(
     : cadence_hysteresis_threshold_(
           base::TimeDelta::FromMilliseconds(kMinimumCadenceDurationMs)),
       minimum_time_until_max_drift_(minimum_time_until_max_drift),
-      is_variable_frame_rate_(false) {
+      is_variable_frame_rate_(false),
+      use_cadence_profile_(
+          base::FeatureList::IsEnabled(media::kJitterAwareVideoRendering)) {
   Reset();
 }
 
@@ -147,18 +157,38 @@ bool VideoCadenceEstimator::UpdateCadenceEstimate(
     return false;
   }
 
+  // A cadence which was accepted before for the same render interval and
+  // frame duration does not need to wait for the hysteresis again.
+  const auto profile_key =
+      GetCadenceProfileKey(render_interval, frame_duration);
+  bool in_cadence_profile = false;
+  if (use_cadence_profile_ && !new_cadence.empty()) {
+    auto it = cadence_profile_.find(profile_key);
+    in_cadence_profile =
+        it != cadence_profile_.end() && it->second == new_cadence;
+  }
+
   // Wait until enough render intervals have elapsed before accepting the
   // cadence change.  Prevents oscillation of the cadence selection.
   bool update_pending_cadence = true;
-  if (new_cadence == pending_cadence_ ||
+  if (in_cadence_profile || new_cadence == pending_cadence_ ||
       cadence_hysteresis_threshold_ <= render_interval) {
-    if (++render_intervals_cadence_held_ * render_interval >=
-        cadence_hysteresis_threshold_) {
+    if (in_cadence_profile ||
+        ++render_intervals_cadence_held_ * render_interval >=
+            cadence_hysteresis_threshold_) {
       DVLOG(1) << "Cadence switch: " << CadenceToString(cadence_) << " -> "
                << CadenceToString(new_cadence)
                << " :: Time until drift exceeded: " << time_until_max_drift;
       cadence_.swap(new_cadence);
 
+      if (use_cadence_profile_ && !cadence_.empty()) {
+        if (cadence_profile_.size() >= kMaxCadenceProfileSize &&
+            !cadence_profile_.contains(profile_key)) {
+          cadence_profile_.clear();
+        }
+        cadence_profile_[profile_key] = cadence_;
+      }
+
       // Note: Because this class is transitively owned by a garbage collected
       // object, WebMediaPlayer, we log cadence changes as they are encountered.
       HistogramCadenceChangeCount(++cadence_changes_);
@@ -180,6 +210,15 @@ bool VideoCadenceEstimator::UpdateCadenceEstimate(
   return false;
 }
 
+// static
+std::pair<int64_t, int64_t> VideoCadenceEstimator::GetCadenceProfileKey(
+    base::TimeDelta render_interval,
+    base::TimeDelta frame_duration) {
+  return std::make_pair(
+      render_interval.InMicroseconds() / kCadenceProfileGranularityUs,
+      frame_duration.InMicroseconds() / kCadenceProfileGranularityUs);
+}
+
 int VideoCadenceEstimator::GetCadenceForFrame(uint64_t frame_number) const {
   DCHECK(has_cadence());
   if (bm_.use_bresenham_cadence_) {
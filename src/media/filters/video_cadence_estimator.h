@@ -8,8 +8,10 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <utility>
 #include <vector>
 
+#include "base/containers/flat_map.h"
 #include "base/macros.h"
 #include "base/time/time.h"
 #include "media/base/media_export.h"
@@ -77,7 +79,8 @@ class MEDIA_EXPORT VideoCadenceEstimator {
   explicit VideoCadenceEstimator(base::TimeDelta minimum_time_until_max_drift);
   ~VideoCadenceEstimator();
 
-  // Clears stored cadence information.
+  // Clears stored cadence information.  The cadence profile, see
+  // |cadence_profile_|, is kept.
   void Reset();
 
   // Updates the estimates for |cadence_| based on the given values as described
@@ -139,6 +142,11 @@ class MEDIA_EXPORT VideoCadenceEstimator {
   bool UpdateBresenhamCadenceEstimate(base::TimeDelta render_interval,
                                       base::TimeDelta frame_duration);
 
+  // Returns the key of |cadence_profile_| for the given values.
+  static std::pair<int64_t, int64_t> GetCadenceProfileKey(
+      base::TimeDelta render_interval,
+      base::TimeDelta frame_duration);
+
   // The approximate best N-frame cadence for all frames seen thus far; updated
   // by UpdateCadenceEstimate().  Empty when no cadence has been detected.
   Cadence cadence_;
@@ -168,6 +176,15 @@ class MEDIA_EXPORT VideoCadenceEstimator {
 
   bool is_variable_frame_rate_;
 
+  // Cadences which were accepted for a render interval and frame duration, in
+  // buckets of kCadenceProfileGranularityUs.  Unlike the rest of the state it
+  // is kept across Reset(), so that after a seek, a playback rate change or a
+  // move back to a display the cadence found there before is used again right
+  // away, instead of after |cadence_hysteresis_threshold_|.  Only used when
+  // kJitterAwareVideoRendering is enabled.
+  bool use_cadence_profile_;
+  base::flat_map<std::pair<int64_t, int64_t>, Cadence> cadence_profile_;
+
   // Data members related to Bresenham cadence algorithm.
   // No technical reason to have this struct except for grouping related fields.
   struct {
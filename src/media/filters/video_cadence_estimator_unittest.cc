@@ -407,4 +407,40 @@ TEST(VideoCadenceEstimatorTest, BresenhamCadenceChange) {
       Interval(59), frame_duration, base::TimeDelta(), base::TimeDelta()));
 }
 
+TEST(VideoCadenceEstimatorTest, CadenceProfile) {
+  base::test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitAndEnableFeature(media::kJitterAwareVideoRendering);
+  VideoCadenceEstimator estimator(kMinimumAcceptableTimeBetweenGlitches);
+  const base::TimeDelta render_interval = Interval(60);
+  const base::TimeDelta frame_duration = Interval(30);
+  const base::TimeDelta acceptable_drift = frame_duration / 2;
+
+  // The first time, the cadence is only accepted after the hysteresis.
+  EXPECT_FALSE(estimator.UpdateCadenceEstimate(
+      render_interval, frame_duration, base::TimeDelta(), acceptable_drift));
+  EXPECT_FALSE(estimator.has_cadence());
+  int updates = 1;
+  while (!estimator.UpdateCadenceEstimate(render_interval, frame_duration,
+                                          base::TimeDelta(),
+                                          acceptable_drift)) {
+    ++updates;
+  }
+  EXPECT_GT(updates, 1);
+  EXPECT_EQ("[2]", estimator.GetCadenceForTesting());
+
+  // After a reset, the cadence found before for the same render interval and
+  // frame duration is accepted right away.
+  estimator.Reset();
+  EXPECT_FALSE(estimator.has_cadence());
+  EXPECT_TRUE(estimator.UpdateCadenceEstimate(
+      render_interval, frame_duration, base::TimeDelta(), acceptable_drift));
+  EXPECT_EQ("[2]", estimator.GetCadenceForTesting());
+
+  // But not for another render interval.
+  estimator.Reset();
+  EXPECT_FALSE(estimator.UpdateCadenceEstimate(
+      Interval(120), frame_duration, base::TimeDelta(), acceptable_drift));
+  EXPECT_FALSE(estimator.has_cadence());
+}
+
 }  // namespace media
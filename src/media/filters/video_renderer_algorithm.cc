@@ -8,11 +8,22 @@
 #include <limits>
 
 #include "media/base/media_log.h"
+#include "media/base/media_switches.h"
 
 namespace media {
 
 const int kMaxOutOfOrderFrameLogs = 10;
 
+// Bound of the deviation of |deadline_min| from its predicted value within
+// which the prediction is used, as a multiple of the measured jitter.  Below
+// kMinDeadlineJitterBoundUs of deviation, the prediction is always used.
+const double kDeadlineJitterBoundFactor = 3;
+const int kMinDeadlineJitterBoundUs = 1000;
+
+// The predicted vsync phase follows the measured deadlines by this fraction of
+// their deviation, to correct the slow drift between the two.
+const int kDeadlinePhaseCorrectionDivisor = 8;
+
 VideoRendererAlgorithm::ReadyFrame::ReadyFrame(
     scoped_refptr<VideoFrame> ready_frame)
     : frame(std::move(ready_frame)),
@@ -39,7 +50,10 @@ VideoRendererAlgorithm::VideoRendererAlgorithm(
           kMinimumAcceptableTimeBetweenGlitchesSecs)),
       wall_clock_time_cb_(wall_clock_time_cb),
       frame_duration_calculator_(kMovingAverageSamples),
-      frame_dropping_disabled_(false) {
+      frame_dropping_disabled_(false),
+      jitter_aware_rendering_(
+          base::FeatureList::IsEnabled(kJitterAwareVideoRendering)),
+      deadline_error_calculator_(kMovingAverageSamples) {
   DCHECK(wall_clock_time_cb_);
   Reset();
 }
@@ -87,7 +101,12 @@ scoped_refptr<VideoFrame> VideoRendererAlgorithm::Render(
   last_deadline_max_ = deadline_max;
   base::TimeDelta selected_frame_drift, cadence_frame_drift;
 
-  // Step 4: Attempt to find the best frame by cadence.
+  // Step 4: Select frames for the predicted vsync rather than the given
+  // deadlines, if they only deviate from it by jitter.
+  if (jitter_aware_rendering_)
+    PredictDeadlines(&deadline_min, &deadline_max);
+
+  // Step 5: Attempt to find the best frame by cadence.
   const int cadence_frame = FindBestFrameByCadence();
   int frame_to_render = cadence_frame;
   if (frame_to_render >= 0) {
@@ -95,7 +114,7 @@ scoped_refptr<VideoFrame> VideoRendererAlgorithm::Render(
         CalculateAbsoluteDriftForFrame(deadline_min, frame_to_render);
   }
 
-  // Step 5: If no frame could be found by cadence or the selected frame exceeds
+  // Step 6: If no frame could be found by cadence or the selected frame exceeds
   // acceptable drift, try to find the best frame by coverage of the deadline.
   if (frame_to_render < 0 || selected_frame_drift > max_acceptable_drift_) {
     int second_best_by_coverage = -1;
@@ -119,7 +138,7 @@ scoped_refptr<VideoFrame> VideoRendererAlgorithm::Render(
     }
   }
 
-  // Step 6: If _still_ no frame could be found by coverage, try to choose the
+  // Step 7: If _still_ no frame could be found by coverage, try to choose the
   // least crappy option based on the drift from the deadline. If we're here the
   // selection is going to be bad because it means no suitable frame has any
   // coverage of the deadline interval.
@@ -163,7 +182,7 @@ scoped_refptr<VideoFrame> VideoRendererAlgorithm::Render(
     }
   }
 
-  // Step 7: Drop frames which occur prior to the frame to be rendered. If any
+  // Step 8: Drop frames which occur prior to the frame to be rendered. If any
   // frame unexpectedly has a zero render count it should be reported as
   // dropped. When using cadence some frames may be expected to be skipped and
   // should not be counted as dropped.
@@ -212,7 +231,7 @@ scoped_refptr<VideoFrame> VideoRendererAlgorithm::Render(
              << ", Duration: " << average_frame_duration_.InMicroseconds();
   }
 
-  // Step 8: Congratulations, the frame selection gauntlet has been passed!
+  // Step 9: Congratulations, the frame selection gauntlet has been passed!
   if (first_frame_ && frame_to_render > 0)
     first_frame_ = false;
 
@@ -311,6 +330,9 @@ void VideoRendererAlgorithm::Reset(ResetFlag reset_flag) {
   effective_frames_queued_ = cadence_frame_counter_ = 0;
   was_time_moving_ = false;
 
+  predicted_deadline_min_ = base::TimeTicks();
+  deadline_error_calculator_.Reset();
+
   // Default to ATSC IS/191 recommendations for maximum acceptable drift before
   // we have enough frames to base the maximum on frame duration.
   max_acceptable_drift_ = base::TimeDelta::FromMilliseconds(15);
@@ -754,6 +776,51 @@ void VideoRendererAlgorithm::UpdateEffectiveFramesQueued() {
       std::max(min_frames_queued, CountEffectiveFramesQueued());
 }
 
+void VideoRendererAlgorithm::PredictDeadlines(base::TimeTicks* deadline_min,
+                                              base::TimeTicks* deadline_max) {
+  DCHECK_GT(render_interval_, base::TimeDelta());
+  if (predicted_deadline_min_.is_null()) {
+    predicted_deadline_min_ = *deadline_min + render_interval_;
+    return;
+  }
+
+  // Render() may not be called for every vsync, so compare |deadline_min| with
+  // the predicted vsync closest to it.
+  base::TimeDelta error = *deadline_min - predicted_deadline_min_;
+  const int64_t skipped_intervals =
+      (error + render_interval_ / 2).IntDiv(render_interval_);
+  if (skipped_intervals < 0) {
+    // Render() was called more than once for a vsync, start over.
+    predicted_deadline_min_ = *deadline_min + render_interval_;
+    return;
+  }
+  predicted_deadline_min_ += render_interval_ * skipped_intervals;
+  error -= render_interval_ * skipped_intervals;
+
+  base::TimeDelta bound =
+      base::TimeDelta::FromMicroseconds(kMinDeadlineJitterBoundUs);
+  if (deadline_error_calculator_.count()) {
+    bound = std::max(bound, deadline_error_calculator_.Deviation() *
+                                kDeadlineJitterBoundFactor);
+  }
+  bound = std::min(bound, render_interval_ / 2);
+  deadline_error_calculator_.AddSample(error);
+
+  if (error.magnitude() > bound) {
+    // The vsync phase changed, follow it.
+    DVLOG(2) << "Deadline is " << error.InMillisecondsF()
+             << "ms away from its prediction, resynchronizing.";
+    predicted_deadline_min_ = *deadline_min + render_interval_;
+    return;
+  }
+
+  const base::TimeTicks predicted_deadline_min =
+      predicted_deadline_min_ + error / kDeadlinePhaseCorrectionDivisor;
+  *deadline_min = predicted_deadline_min;
+  *deadline_max = predicted_deadline_min + render_interval_;
+  predicted_deadline_min_ = predicted_deadline_min + render_interval_;
+}
+
 int VideoRendererAlgorithm::FindFirstGoodFrame() const {
   const auto minimum_start_time =
       cadence_estimator_.has_cadence()
@@ -47,6 +47,13 @@ class MediaLog;
 // the start of the interval.
 //
 // Combined these three approaches enforce optimal smoothness in many cases.
+//
+// When kJitterAwareVideoRendering is enabled, frames are selected for the
+// vsync times predicted from previous Render() calls instead of the given
+// deadlines, as long as the deadlines stay within the jitter measured around
+// the predictions.  Otherwise a deadline which is late or early by a fraction
+// of a millisecond can flip the selection between two frames with similar
+// coverage, and repeat a frame or drop one.
 class MEDIA_EXPORT VideoRendererAlgorithm {
  public:
   VideoRendererAlgorithm(const TimeSource::WallClockTimeCB& wall_clock_time_cb,
@@ -267,6 +274,13 @@ class MEDIA_EXPORT VideoRendererAlgorithm {
   base::TimeDelta CalculateAbsoluteDriftForFrame(base::TimeTicks deadline_min,
                                                  int frame_index) const;
 
+  // Replaces [|deadline_min|, |deadline_max|] by the interval of the vsync
+  // predicted from previous calls, if |deadline_min| is close enough to it
+  // given the jitter measured so far.  Updates the predictions and the jitter
+  // measurements.  Only used when |jitter_aware_rendering_| is true.
+  void PredictDeadlines(base::TimeTicks* deadline_min,
+                        base::TimeTicks* deadline_max);
+
   // Returns the index of the first usable frame or -1 if no usable frames.
   int FindFirstGoodFrame() const;
 
@@ -346,6 +360,15 @@ class MEDIA_EXPORT VideoRendererAlgorithm {
   // to UpdateEffectiveFramesQueued() whenever the |frame_queue_| is changed.
   size_t effective_frames_queued_;
 
+  // Whether kJitterAwareVideoRendering is enabled; see PredictDeadlines().
+  const bool jitter_aware_rendering_;
+
+  // The |deadline_min| predicted for the next Render() call, and the errors of
+  // the previous predictions, from which the jitter of the deadlines around
+  // the vsync times is measured.
+  base::TimeTicks predicted_deadline_min_;
+  MovingAverage deadline_error_calculator_;
+
   DISALLOW_COPY_AND_ASSIGN(VideoRendererAlgorithm);
 };
 
@@ -0,0 +1,204 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/time/time.h"
+#include "media/base/media_switches.h"
+#include "media/base/media_util.h"
+#include "media/base/video_frame.h"
+#include "media/filters/video_renderer_algorithm.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "ui/gfx/geometry/rect.h"
+
+namespace media {
+
+// Duration of each replayed vsync timeline. The first and last second are
+// not counted, while the algorithm locks on to the display.
+static const int kTimelineDurationInSeconds = 60;
+
+struct VsyncTimeline {
+  const char* story;
+  double frame_rate;
+  double refresh_rate;
+  // Maximum deviation of the vsync times from their ideal values.
+  double jitter_ms;
+  // Fraction of vsyncs missed by the compositor, during which the previous
+  // frame stays on screen.
+  double missed_vsync_fraction;
+};
+
+// Frame rate, refresh rate and jitter of a timeline, and whether jitter aware
+// rendering is enabled.
+using VideoRendererAlgorithmPerfTestParam = std::tuple<VsyncTimeline, bool>;
+
+struct RenderResult {
+  int frames = 0;
+  // Frames which were never displayed.
+  int frames_dropped = 0;
+  // Frames displayed for more vsyncs than their duration covers.
+  int frames_repeated = 0;
+  // Frames displayed for a number of vsyncs other than the ideal cadence.
+  int glitches = 0;
+};
+
+class VideoRendererAlgorithmPerfTest
+    : public testing::TestWithParam<VideoRendererAlgorithmPerfTestParam> {
+ public:
+  VideoRendererAlgorithmPerfTest() {
+    if (std::get<1>(GetParam()))
+      feature_list_.InitAndEnableFeature(kJitterAwareVideoRendering);
+    else
+      feature_list_.InitAndDisableFeature(kJitterAwareVideoRendering);
+  }
+
+ protected:
+  // Maps the media timestamps to wall clock times as if playback started at
+  // |start_time_|.
+  bool GetWallClockTimes(const std::vector<base::TimeDelta>& media_timestamps,
+                         std::vector<base::TimeTicks>* wall_clock_times) {
+    for (const auto& media_timestamp : media_timestamps)
+      wall_clock_times->push_back(start_time_ + media_timestamp);
+    return true;
+  }
+
+  // Returns a pseudo random value in [-1, 1], denser around zero. The
+  // timelines are generated from a fixed seed so that every run replays the
+  // same vsync times.
+  double NextJitter() {
+    const double a = NextUniform();
+    const double b = NextUniform();
+    return a + b - 1;
+  }
+
+  double NextUniform() {
+    seed_ = seed_ * 1103515245 + 12345;
+    return (seed_ >> 8) / static_cast<double>(1 << 24);
+  }
+
+  // Replays |timeline| through a VideoRendererAlgorithm.
+  RenderResult ReplayTimeline(const VsyncTimeline& timeline) {
+    VideoRendererAlgorithm algorithm(
+        base::BindRepeating(&VideoRendererAlgorithmPerfTest::GetWallClockTimes,
+                            base::Unretained(this)),
+        &media_log_);
+    const gfx::Size natural_size(8, 8);
+    const double frame_duration_us =
+        base::Time::kMicrosecondsPerSecond / timeline.frame_rate;
+    const double render_interval_us =
+        base::Time::kMicrosecondsPerSecond / timeline.refresh_rate;
+    const int vsyncs = kTimelineDurationInSeconds * timeline.refresh_rate;
+    const int frames = kTimelineDurationInSeconds * timeline.frame_rate;
+
+    // Number of vsyncs each frame was displayed for.
+    std::vector<int> display_counts(frames + 1);
+    int next_frame = 0;
+    int displayed_frame = -1;
+    for (int i = 0; i < vsyncs; ++i) {
+      const double ideal_deadline_us = i * render_interval_us;
+
+      // Keep a few frames ahead of the display, like VideoRendererImpl.
+      while (next_frame < frames &&
+             next_frame * frame_duration_us <
+                 ideal_deadline_us + 4 * (frame_duration_us +
+                                          render_interval_us)) {
+        algorithm.EnqueueFrame(VideoFrame::CreateFrame(
+            PIXEL_FORMAT_I420, natural_size, gfx::Rect(natural_size),
+            natural_size,
+            base::TimeDelta::FromMicroseconds(next_frame * frame_duration_us)));
+        ++next_frame;
+      }
+
+      if (i > 0 && NextUniform() < timeline.missed_vsync_fraction) {
+        if (displayed_frame >= 0)
+          ++display_counts[displayed_frame];
+        continue;
+      }
+
+      // Jitter is at most a third of the render interval, beyond which the
+      // compositor would rather miss the vsync.
+      const double jitter_us =
+          std::min(timeline.jitter_ms * 1000, render_interval_us / 3) *
+          NextJitter();
+      const base::TimeTicks deadline_min =
+          start_time_ +
+          base::TimeDelta::FromMicroseconds(ideal_deadline_us + jitter_us);
+      size_t frames_dropped = 0;
+      scoped_refptr<VideoFrame> frame = algorithm.Render(
+          deadline_min,
+          deadline_min + base::TimeDelta::FromMicroseconds(render_interval_us),
+          &frames_dropped);
+      displayed_frame = std::lround(frame->timestamp().InMicroseconds() /
+                                    frame_duration_us);
+      ++display_counts[displayed_frame];
+    }
+
+    const double ideal_cadence = frame_duration_us / render_interval_us;
+    const int min_cadence = std::floor(ideal_cadence + 1e-6);
+    const int max_cadence = std::ceil(ideal_cadence - 1e-6);
+    RenderResult result;
+    for (int i = timeline.frame_rate;
+         i < (kTimelineDurationInSeconds - 1) * timeline.frame_rate; ++i) {
+      ++result.frames;
+      if (!display_counts[i])
+        ++result.frames_dropped;
+      if (display_counts[i] > max_cadence)
+        ++result.frames_repeated;
+      if (display_counts[i] != min_cadence && display_counts[i] != max_cadence)
+        ++result.glitches;
+    }
+    return result;
+  }
+
+  base::test::ScopedFeatureList feature_list_;
+  NullMediaLog media_log_;
+  const base::TimeTicks start_time_ =
+      base::TimeTicks() + base::TimeDelta::FromSeconds(1);
+  uint32_t seed_ = 1;
+};
+
+TEST_P(VideoRendererAlgorithmPerfTest, ReplayVsyncTimeline) {
+  const VsyncTimeline& timeline = std::get<0>(GetParam());
+  const RenderResult result = ReplayTimeline(timeline);
+
+  perf_test::PerfResultReporter reporter(
+      "video_renderer_algorithm",
+      base::StringPrintf("%s_%s", timeline.story,
+                         std::get<1>(GetParam()) ? "jitter_aware" : "default"));
+  reporter.RegisterImportantMetric("_frames_dropped", "count");
+  reporter.RegisterImportantMetric("_frames_repeated", "count");
+  reporter.RegisterImportantMetric("_glitches", "count");
+  reporter.AddResult("_frames_dropped", result.frames_dropped);
+  reporter.AddResult("_frames_repeated", result.frames_repeated);
+  reporter.AddResult("_glitches", result.glitches);
+}
+
+static const VsyncTimeline kVsyncTimelines[] = {
+    {"24fps_60hz", 24, 60, 0, 0},
+    {"24fps_60hz_jitter_2ms", 24, 60, 2, 0},
+    {"23_976fps_59_94hz_jitter_2ms", 23.976, 59.94, 2, 0},
+    {"24fps_50hz_jitter_3ms", 24, 50, 3, 0},
+    {"25fps_50hz_jitter_3ms", 25, 50, 3, 0},
+    {"30fps_60hz_jitter_2ms_missed_vsyncs", 30, 60, 2, 0.005},
+    {"60fps_60hz_jitter_1ms", 60, 60, 1, 0},
+    {"24fps_144hz_jitter_1ms", 24, 144, 1, 0},
+    {"60fps_144hz_jitter_1ms_missed_vsyncs", 60, 144, 1, 0.005},
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         VideoRendererAlgorithmPerfTest,
+                         testing::Combine(testing::ValuesIn(kVsyncTimelines),
+                                          testing::Bool()));
+
+}  // namespace media
@@ -13,8 +13,10 @@
 #include "base/cxx17_backports.h"
 #include "base/memory/ref_counted.h"
 #include "base/strings/stringprintf.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/simple_test_tick_clock.h"
 #include "build/build_config.h"
+#include "media/base/media_switches.h"
 #include "media/base/media_util.h"
 #include "media/base/timestamp_constants.h"
 #include "media/base/video_frame_pool.h"
@@ -1685,4 +1687,52 @@ TEST_F(VideoRendererAlgorithmTest, WallClockDurationMetadataSet) {
   }
 }
 
+// Renders 24fps in 50Hz with deadlines which are up to 2ms early or late, and
+// verifies that the jitter does not make any frame display for fewer or more
+// intervals than the [2:2:...:3] cadence allows.
+TEST_F(VideoRendererAlgorithmTest, JitterAwareRendering) {
+  base::test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitAndEnableFeature(kJitterAwareVideoRendering);
+  VideoRendererAlgorithm algorithm(
+      base::BindRepeating(&WallClockTimeSource::GetWallClockTimes,
+                          base::Unretained(&time_source_)),
+      &media_log_);
+  TickGenerator frame_tg(base::TimeTicks(), 24);
+  const base::TimeTicks start_time = tick_clock_->NowTicks();
+  const base::TimeDelta render_interval = base::TimeDelta::FromMilliseconds(20);
+  time_source_.StartTicking();
+
+  std::vector<std::pair<base::TimeDelta, int>> display_counts;
+  for (int i = 0; i < 500; ++i) {
+    while (algorithm.frames_queued() < 4) {
+      algorithm.EnqueueFrame(
+          CreateFrame(frame_tg.current() - base::TimeTicks()));
+      frame_tg.step();
+    }
+
+    const base::TimeTicks deadline_min =
+        start_time + render_interval * i +
+        base::TimeDelta::FromMilliseconds((i * 7) % 5 - 2);
+    tick_clock_->Advance(deadline_min - tick_clock_->NowTicks());
+    size_t frames_dropped = 0;
+    scoped_refptr<VideoFrame> frame = algorithm.Render(
+        deadline_min, deadline_min + render_interval, &frames_dropped);
+    ASSERT_TRUE(frame);
+    EXPECT_EQ(0u, frames_dropped);
+    if (display_counts.empty() ||
+        display_counts.back().first != frame->timestamp()) {
+      display_counts.emplace_back(frame->timestamp(), 0);
+    }
+    ++display_counts.back().second;
+  }
+
+  // Skip the first frames, rendered before the cadence is found, and the last
+  // one, which is still on screen.
+  for (size_t i = 2; i + 1 < display_counts.size(); ++i) {
+    SCOPED_TRACE(display_counts[i].first);
+    EXPECT_GE(display_counts[i].second, 2);
+    EXPECT_LE(display_counts[i].second, 3);
+  }
+}
+
 }  // namespace media
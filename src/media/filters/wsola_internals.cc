@@ -27,6 +27,14 @@ namespace media {
 
 namespace internal {
 
+// This is a compromise between complexity reduction and search accuracy. I
+// don't have a proof that down sample of order 5 is optimal. One can compute
+// a decimation factor that minimizes complexity given the size of
+// |search_block| and |target_block|. However, my experiments show the rate of
+// missing the optimal index is significant. This value is chosen
+// heuristically based on experiments.
+const int kSearchDecimation = 5;
+
 bool InInterval(int n, Interval q) {
   return n >= q.first && n <= q.second;
 }
@@ -108,6 +116,107 @@ void MultiChannelDotProduct(const AudioBus* a,
   }
 }
 
+// Dot-products of |num_frames| frames of |a| with |num_frames| frames of |b|
+// starting at |b|, |b| + 1, |b| + 2 and |b| + 3, i.e. at four consecutive
+// candidate offsets. The sums are done in the same order as in
+// MultiChannelDotProduct(), so the results are bit-identical to four calls of
+// it, but the four independent accumulators hide the latency of the additions
+// and |a| is loaded once for all offsets.
+static void DotProductAtFourOffsets(const float* a,
+                                    const float* b,
+                                    int num_frames,
+                                    float* dot_product) {
+  int first_scalar_frame = 0;
+#if defined(USE_SIMD)
+  const int rem = num_frames % 4;
+  const int last_index = num_frames - rem;
+  first_scalar_frame = last_index;
+
+#if defined(ARCH_CPU_X86_FAMILY)
+  __m128 m_sum0 = _mm_setzero_ps();
+  __m128 m_sum1 = _mm_setzero_ps();
+  __m128 m_sum2 = _mm_setzero_ps();
+  __m128 m_sum3 = _mm_setzero_ps();
+  for (int s = 0; s < last_index; s += 4) {
+    const __m128 m_a = _mm_loadu_ps(a + s);
+    m_sum0 = _mm_add_ps(m_sum0, _mm_mul_ps(m_a, _mm_loadu_ps(b + s)));
+    m_sum1 = _mm_add_ps(m_sum1, _mm_mul_ps(m_a, _mm_loadu_ps(b + s + 1)));
+    m_sum2 = _mm_add_ps(m_sum2, _mm_mul_ps(m_a, _mm_loadu_ps(b + s + 2)));
+    m_sum3 = _mm_add_ps(m_sum3, _mm_mul_ps(m_a, _mm_loadu_ps(b + s + 3)));
+  }
+
+  // Reduce all four accumulators at once. After the transpose, |m_sumK| holds
+  // lane K of every offset, and the lanes are summed as (0 + 2) + (1 + 3) like
+  // MultiChannelDotProduct() does.
+  _MM_TRANSPOSE4_PS(m_sum0, m_sum1, m_sum2, m_sum3);
+  _mm_storeu_ps(dot_product, _mm_add_ps(_mm_add_ps(m_sum0, m_sum2),
+                                        _mm_add_ps(m_sum1, m_sum3)));
+#elif defined(ARCH_CPU_ARM_FAMILY)
+  float32x4_t m_sum[4] = {vmovq_n_f32(0), vmovq_n_f32(0), vmovq_n_f32(0),
+                          vmovq_n_f32(0)};
+  for (int s = 0; s < last_index; s += 4) {
+    const float32x4_t m_a = vld1q_f32(a + s);
+    m_sum[0] = vmlaq_f32(m_sum[0], m_a, vld1q_f32(b + s));
+    m_sum[1] = vmlaq_f32(m_sum[1], m_a, vld1q_f32(b + s + 1));
+    m_sum[2] = vmlaq_f32(m_sum[2], m_a, vld1q_f32(b + s + 2));
+    m_sum[3] = vmlaq_f32(m_sum[3], m_a, vld1q_f32(b + s + 3));
+  }
+  for (int k = 0; k < 4; ++k) {
+    float32x2_t m_half =
+        vadd_f32(vget_high_f32(m_sum[k]), vget_low_f32(m_sum[k]));
+    dot_product[k] = vget_lane_f32(vpadd_f32(m_half, m_half), 0);
+  }
+#endif
+#else
+  memset(dot_product, 0, sizeof(*dot_product) * 4);
+#endif  // defined(USE_SIMD)
+
+  for (int k = 0; k < 4; ++k) {
+    for (int n = first_scalar_frame; n < num_frames; ++n)
+      dot_product[k] += a[n] * b[n + k];
+  }
+}
+
+// Same as MultiChannelDotProduct() for the frame offsets |frame_offset_b| to
+// |frame_offset_b| + 3 of |b|. The dot-product of channel |k| at offset
+// |frame_offset_b| + |i| is written to |dot_product[i * channels + k]|.
+static void MultiChannelDotProductAtFourOffsets(const AudioBus* a,
+                                                const AudioBus* b,
+                                                int frame_offset_b,
+                                                int num_frames,
+                                                float* dot_product) {
+  DCHECK_EQ(a->channels(), b->channels());
+  DCHECK_LE(num_frames, a->frames());
+  DCHECK_LE(frame_offset_b + 3 + num_frames, b->frames());
+
+  const int channels = a->channels();
+  for (int k = 0; k < channels; ++k) {
+    float offset_dot_product[4];
+    DotProductAtFourOffsets(a->channel(k), b->channel(k) + frame_offset_b,
+                            num_frames, offset_dot_product);
+    for (int i = 0; i < 4; ++i)
+      dot_product[i * channels + k] = offset_dot_product[i];
+  }
+}
+
+void DecimateAudioBus(const AudioBus* input, int factor, AudioBus* output) {
+  DCHECK_GT(factor, 0);
+  DCHECK_EQ(input->channels(), output->channels());
+  DCHECK_LE(output->frames() * factor, input->frames());
+
+  const float scale = 1.0f / factor;
+  for (int k = 0; k < input->channels(); ++k) {
+    const float* input_channel = input->channel(k);
+    float* output_channel = output->channel(k);
+    for (int n = 0; n < output->frames(); ++n, input_channel += factor) {
+      float sum = 0.0f;
+      for (int m = 0; m < factor; ++m)
+        sum += input_channel[m];
+      output_channel[n] = sum * scale;
+    }
+  }
+}
+
 void MultiChannelMovingBlockEnergies(const AudioBus* input,
                                      int frames_per_block,
                                      float* energy) {
@@ -242,26 +351,40 @@ int FullSearch(int low_limit,
                const float* energy_candidate_blocks) {
   int channels = search_block->channels();
   int block_size = target_block->frames();
-  std::unique_ptr<float[]> dot_prod(new float[channels]);
+  std::unique_ptr<float[]> dot_prod(new float[4 * channels]);
 
   float best_similarity = std::numeric_limits<float>::min();
   int optimal_index = 0;
 
-  for (int n = low_limit; n <= high_limit; ++n) {
-    if (InInterval(n, exclude_interval)) {
-      continue;
-    }
-    MultiChannelDotProduct(target_block, 0, search_block, n, block_size,
-                           dot_prod.get());
-
+  // Candidates are compared in increasing order, as are the ones computed four
+  // at a time below, so ties are resolved the same way whatever the grouping.
+  auto update_optimal_index = [&](int n, const float* dot_prod_n) {
+    if (InInterval(n, exclude_interval))
+      return;
     float similarity = MultiChannelSimilarityMeasure(
-        dot_prod.get(), energy_target_block,
+        dot_prod_n, energy_target_block,
         &energy_candidate_blocks[n * channels], channels);
-
     if (similarity > best_similarity) {
       best_similarity = similarity;
       optimal_index = n;
     }
+  };
+
+  int n = low_limit;
+  for (; n + 3 <= high_limit; n += 4) {
+    MultiChannelDotProductAtFourOffsets(target_block, search_block, n,
+                                        block_size, dot_prod.get());
+    for (int i = 0; i < 4; ++i)
+      update_optimal_index(n + i, &dot_prod[i * channels]);
+  }
+
+  for (; n <= high_limit; ++n) {
+    if (InInterval(n, exclude_interval)) {
+      continue;
+    }
+    MultiChannelDotProduct(target_block, 0, search_block, n, block_size,
+                           dot_prod.get());
+    update_optimal_index(n, dot_prod.get());
   }
 
   return optimal_index;
@@ -275,14 +398,6 @@ int OptimalIndex(const AudioBus* search_block,
   int target_size = target_block->frames();
   int num_candidate_blocks = search_block->frames() - (target_size - 1);
 
-  // This is a compromise between complexity reduction and search accuracy. I
-  // don't have a proof that down sample of order 5 is optimal. One can compute
-  // a decimation factor that minimizes complexity given the size of
-  // |search_block| and |target_block|. However, my experiments show the rate of
-  // missing the optimal index is significant. This value is chosen
-  // heuristically based on experiments.
-  const int kSearchDecimation = 5;
-
   std::unique_ptr<float[]> energy_target_block(new float[channels]);
   std::unique_ptr<float[]> energy_candidate_blocks(
       new float[channels * num_candidate_blocks]);
@@ -308,6 +423,77 @@ int OptimalIndex(const AudioBus* search_block,
                     energy_candidate_blocks.get());
 }
 
+int CoarseToFineOptimalIndex(const AudioBus* search_block,
+                             const AudioBus* target_block,
+                             Interval exclude_interval,
+                             int decimation) {
+  DCHECK_GT(decimation, 1);
+  int channels = search_block->channels();
+  DCHECK_EQ(channels, target_block->channels());
+  int target_size = target_block->frames();
+  int num_candidate_blocks = search_block->frames() - (target_size - 1);
+
+  // Coarse search on decimated copies of the blocks. Each coarse candidate
+  // stands for |decimation| full resolution candidates, so only those whose
+  // full resolution candidates are all excluded are excluded.
+  std::unique_ptr<AudioBus> coarse_target =
+      AudioBus::Create(channels, target_size / decimation);
+  std::unique_ptr<AudioBus> coarse_search =
+      AudioBus::Create(channels, search_block->frames() / decimation);
+  DecimateAudioBus(target_block, decimation, coarse_target.get());
+  DecimateAudioBus(search_block, decimation, coarse_search.get());
+  Interval coarse_exclude_interval(
+      (exclude_interval.first + decimation - 1) / decimation,
+      (exclude_interval.second + 1) / decimation - 1);
+  int coarse_target_size = coarse_target->frames();
+  int num_coarse_candidate_blocks =
+      coarse_search->frames() - (coarse_target_size - 1);
+
+  std::unique_ptr<float[]> energy_target_block(new float[channels]);
+  std::unique_ptr<float[]> energy_candidate_blocks(
+      new float[channels * num_candidate_blocks]);
+  MultiChannelMovingBlockEnergies(coarse_search.get(), coarse_target_size,
+                                  energy_candidate_blocks.get());
+  MultiChannelDotProduct(coarse_target.get(), 0, coarse_target.get(), 0,
+                         coarse_target_size, energy_target_block.get());
+
+  // The decimated search of OptimalIndex() skips kSearchDecimation full
+  // resolution candidates at a time; keep the same spacing between coarse
+  // candidates, so that the coarse search does not get less accurate.
+  int search_decimation = kSearchDecimation / decimation;
+  int coarse_index;
+  if (search_decimation > 1) {
+    coarse_index = DecimatedSearch(
+        search_decimation, coarse_exclude_interval, coarse_target.get(),
+        coarse_search.get(), energy_target_block.get(),
+        energy_candidate_blocks.get());
+    coarse_index = FullSearch(
+        std::max(0, coarse_index - search_decimation),
+        std::min(num_coarse_candidate_blocks - 1,
+                 coarse_index + search_decimation),
+        coarse_exclude_interval, coarse_target.get(), coarse_search.get(),
+        energy_target_block.get(), energy_candidate_blocks.get());
+  } else {
+    coarse_index = FullSearch(0, num_coarse_candidate_blocks - 1,
+                              coarse_exclude_interval, coarse_target.get(),
+                              coarse_search.get(), energy_target_block.get(),
+                              energy_candidate_blocks.get());
+  }
+
+  // Refine at full resolution around the candidates of |coarse_index|.
+  MultiChannelMovingBlockEnergies(search_block, target_size,
+                                  energy_candidate_blocks.get());
+  MultiChannelDotProduct(target_block, 0, target_block, 0, target_size,
+                         energy_target_block.get());
+
+  int lim_low = std::max(0, (coarse_index - 1) * decimation);
+  int lim_high = std::min(num_candidate_blocks - 1,
+                          (coarse_index + 2) * decimation - 1);
+  return FullSearch(lim_low, lim_high, exclude_interval, target_block,
+                    search_block, energy_target_block.get(),
+                    energy_candidate_blocks.get());
+}
+
 void GetPeriodicHanningWindow(int window_length, float* window) {
   const float scale = 2.0f * base::kPiFloat / window_length;
   for (int n = 0; n < window_length; ++n)
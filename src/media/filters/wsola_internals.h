@@ -29,6 +29,14 @@ MEDIA_EXPORT void MultiChannelDotProduct(const AudioBus* a,
                                          int num_frames,
                                          float* dot_product);
 
+// Decimates each channel of |input| by |factor|, averaging every |factor|
+// frames into one. The average is a crude low-pass filter which limits the
+// aliasing of the decimated signal. |output| must have the channels of |input|
+// and at most |input->frames()| / |factor| frames.
+MEDIA_EXPORT void DecimateAudioBus(const AudioBus* input,
+                                   int factor,
+                                   AudioBus* output);
+
 // Energies of sliding windows of channels are interleaved.
 // The number windows is |input->frames()| - (|frames_per_window| - 1), hence,
 // the method assumes |energy| must be, at least, of size
@@ -76,6 +84,17 @@ MEDIA_EXPORT int OptimalIndex(const AudioBus* search_block,
                               const AudioBus* target_block,
                               Interval exclude_interval);
 
+// Same as OptimalIndex(), but the search runs on copies of |search_block| and
+// |target_block| decimated by |decimation|, and is then refined at full
+// resolution around the best coarse match only. Each similarity computation of
+// the coarse search costs 1 / |decimation| of a full resolution one, and there
+// are 1 / |decimation| as many candidates, at the risk of missing the optimal
+// block when it differs from its neighbors in high frequencies only.
+MEDIA_EXPORT int CoarseToFineOptimalIndex(const AudioBus* search_block,
+                                          const AudioBus* target_block,
+                                          Interval exclude_interval,
+                                          int decimation);
+
 // Return a "periodic" Hann window. This is the first L samples of an L+1
 // Hann window. It is perfect reconstruction for overlap-and-add.
 MEDIA_EXPORT void GetPeriodicHanningWindow(int window_length, float* window);
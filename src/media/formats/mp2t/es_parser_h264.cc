@@ -344,8 +344,10 @@ bool EsParserH264::ParseFromEsQueue() {
       case H264NALU::kNonIDRSlice: {
         is_key_frame = (nalu.nal_unit_type == H264NALU::kIDRSlice);
         DVLOG(LOG_LEVEL_ES) << "NALU: slice IDR=" << is_key_frame;
+        // Only the PPS id of the slice is needed here.
         H264SliceHeader shdr;
-        if (h264_parser_->ParseSliceHeader(nalu, &shdr) != H264Parser::kOk) {
+        if (h264_parser_->ParsePartialSliceHeader(nalu, &shdr) !=
+            H264Parser::kOk) {
           // Only accept an invalid SPS/PPS at the beginning when the stream
           // does not necessarily start with an SPS/PPS/IDR.
           // TODO(damienv): Should be able to differentiate a missing SPS/PPS
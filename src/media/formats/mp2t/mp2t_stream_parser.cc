@@ -326,70 +326,79 @@ bool Mp2tStreamParser::Parse(const uint8_t* buf, int size) {
   // Add the data to the parser state.
   ts_byte_queue_.Push(buf, size);
 
-  while (true) {
-    const uint8_t* ts_buffer;
-    int ts_buffer_size;
-    ts_byte_queue_.Peek(&ts_buffer, &ts_buffer_size);
-    if (ts_buffer_size < TsPacket::kPacketSize)
-      break;
+  // Demux all the complete TS packets in the queue in a single pass, reusing
+  // one TsPacket, and only pop them from |ts_byte_queue_| at the end.
+  const uint8_t* ts_buffer;
+  int ts_buffer_size;
+  ts_byte_queue_.Peek(&ts_buffer, &ts_buffer_size);
+
+  TsPacket ts_packet;
+  int offset = 0;
+  bool status = true;
+  while (ts_buffer_size - offset >= TsPacket::kPacketSize) {
+    const uint8_t* packet_buffer = ts_buffer + offset;
+    const int packet_buffer_size = ts_buffer_size - offset;
 
     // Synchronization.
-    int skipped_bytes = TsPacket::Sync(ts_buffer, ts_buffer_size);
+    int skipped_bytes = TsPacket::Sync(packet_buffer, packet_buffer_size);
     if (skipped_bytes > 0) {
       DVLOG(1) << "Packet not aligned on a TS syncword:"
                << " skipped_bytes=" << skipped_bytes;
-      ts_byte_queue_.Pop(skipped_bytes);
+      offset += skipped_bytes;
       continue;
     }
 
     // Parse the TS header, skipping 1 byte if the header is invalid.
-    std::unique_ptr<TsPacket> ts_packet(
-        TsPacket::Parse(ts_buffer, ts_buffer_size));
-    if (!ts_packet) {
+    if (!TsPacket::Parse(packet_buffer, packet_buffer_size, &ts_packet)) {
       DVLOG(1) << "Error: invalid TS packet";
-      ts_byte_queue_.Pop(1);
+      offset += 1;
       continue;
     }
     DVLOG(LOG_LEVEL_TS)
-        << "Processing PID=" << ts_packet->pid()
-        << " start_unit=" << ts_packet->payload_unit_start_indicator();
+        << "Processing PID=" << ts_packet.pid()
+        << " start_unit=" << ts_packet.payload_unit_start_indicator();
 
     // Parse the section.
-    auto it = pids_.find(ts_packet->pid());
+    auto it = pids_.find(ts_packet.pid());
     if (it == pids_.end() &&
-        ts_packet->pid() == TsSection::kPidPat) {
+        ts_packet.pid() == TsSection::kPidPat) {
       // Create the PAT state here if needed.
       auto pat_section_parser =
           std::make_unique<TsSectionPat>(base::BindRepeating(
               &Mp2tStreamParser::RegisterPmt, base::Unretained(this)));
       auto pat_pid_state = std::make_unique<PidState>(
-          ts_packet->pid(), PidState::kPidPat, std::move(pat_section_parser));
+          ts_packet.pid(), PidState::kPidPat, std::move(pat_section_parser));
       pat_pid_state->Enable();
       it = pids_
                .insert(
-                   std::make_pair(ts_packet->pid(), std::move(pat_pid_state)))
+                   std::make_pair(ts_packet.pid(), std::move(pat_pid_state)))
                .first;
     }
 #if BUILDFLAG(ENABLE_HLS_SAMPLE_AES)
     // We allow a CAT to appear as the first packet in the TS. This allows us to
     // specify encryption metadata for HLS by injecting it as an extra TS packet
     // at the front of the stream.
-    else if (it == pids_.end() && ts_packet->pid() == TsSection::kPidCat) {
+    else if (it == pids_.end() && ts_packet.pid() == TsSection::kPidCat) {
       it = pids_.insert(std::make_pair(TsSection::kPidCat, MakeCatPidState()))
                .first;
     }
 #endif
 
     if (it != pids_.end()) {
-      if (!it->second->PushTsPacket(*ts_packet))
-        return false;
+      if (!it->second->PushTsPacket(ts_packet)) {
+        status = false;
+        break;
+      }
     } else {
-      DVLOG(LOG_LEVEL_TS) << "Ignoring TS packet for pid: " << ts_packet->pid();
+      DVLOG(LOG_LEVEL_TS) << "Ignoring TS packet for pid: " << ts_packet.pid();
     }
 
     // Go to the next packet.
-    ts_byte_queue_.Pop(TsPacket::kPacketSize);
+    offset += TsPacket::kPacketSize;
   }
+  ts_byte_queue_.Pop(offset);
+  if (!status)
+    return false;
 
   RCHECK(FinishInitializationIfNeeded());
 
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback_helpers.h"
@@ -408,6 +409,37 @@ TEST_F(Mp2tStreamParserTest, UnalignedAppend512) {
   EXPECT_EQ(segment_count_, 1);
 }
 
+TEST_F(Mp2tStreamParserTest, SingleAppend) {
+  // Test demuxing all the TS packets of the stream from a single append.
+  InitializeParser();
+  scoped_refptr<DecoderBuffer> buffer = ReadTestDataFile("bear-1280x720.ts");
+  EXPECT_TRUE(AppendData(buffer->data(), buffer->data_size()));
+  parser_->Flush();
+  EXPECT_EQ(audio_frame_count_, 119);
+  EXPECT_EQ(video_frame_count_, 82);
+  EXPECT_EQ(config_count_, 1);
+  EXPECT_EQ(segment_count_, 1);
+}
+
+TEST_F(Mp2tStreamParserTest, ResyncAfterLeadingGarbage) {
+  // Leading bytes, including stray syncwords which are not followed by other
+  // syncwords at the TS packet interval, must be skipped.
+  InitializeParser();
+  scoped_refptr<DecoderBuffer> buffer = ReadTestDataFile("bear-1280x720.ts");
+  std::vector<uint8_t> data(1000, 0);
+  data[10] = 0x47;
+  data[500] = 0x47;
+  data[999] = 0x47;
+  data.insert(data.end(), buffer->data(),
+              buffer->data() + buffer->data_size());
+  EXPECT_TRUE(AppendDataInPieces(data.data(), data.size(), 512));
+  parser_->Flush();
+  EXPECT_EQ(audio_frame_count_, 119);
+  EXPECT_EQ(video_frame_count_, 82);
+  EXPECT_EQ(config_count_, 1);
+  EXPECT_EQ(segment_count_, 1);
+}
+
 TEST_F(Mp2tStreamParserTest, AppendAfterFlush512) {
   InitializeParser();
   ParseMpeg2TsFile("bear-1280x720.ts", 512);
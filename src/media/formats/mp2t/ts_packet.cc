@@ -4,7 +4,7 @@
 
 #include "media/formats/mp2t/ts_packet.h"
 
-#include <memory>
+#include <string.h>
 
 #include "base/logging.h"
 #include "media/base/bit_reader.h"
@@ -18,13 +18,24 @@ static const uint8_t kTsHeaderSyncword = 0x47;
 // static
 int TsPacket::Sync(const uint8_t* buf, int size) {
   int k = 0;
-  for (; k < size; k++) {
+  while (k < size) {
+    // Jump to the next candidate syncword. memchr() is vectorized by the C
+    // library, which makes resynchronizing over garbage much cheaper than
+    // testing each byte in turn.
+    const uint8_t* candidate = static_cast<const uint8_t*>(
+        memchr(buf + k, kTsHeaderSyncword, size - k));
+    if (!candidate) {
+      k = size;
+      break;
+    }
+    k = candidate - buf;
+
     // Verify that we have 4 syncwords in a row when possible,
     // this should improve synchronization robustness.
     // TODO(damienv): Consider the case where there is garbage
     // between TS packets.
     bool is_header = true;
-    for (int i = 0; i < 4; i++) {
+    for (int i = 1; i < 4; i++) {
       int idx = k + i * kPacketSize;
       if (idx >= size)
         break;
@@ -38,6 +49,7 @@ int TsPacket::Sync(const uint8_t* buf, int size) {
     }
     if (is_header)
       break;
+    k++;
   }
 
   DVLOG_IF(1, k != 0) << "SYNC: nbytes_skipped=" << k;
@@ -45,11 +57,12 @@ int TsPacket::Sync(const uint8_t* buf, int size) {
 }
 
 // static
-TsPacket* TsPacket::Parse(const uint8_t* buf, int size) {
+bool TsPacket::Parse(const uint8_t* buf, int size, TsPacket* ts_packet) {
+  DCHECK(ts_packet);
   if (size < kPacketSize) {
     DVLOG(1) << "Buffer does not hold one full TS packet:"
              << " buffer_size=" << size;
-    return NULL;
+    return false;
   }
 
   DCHECK_EQ(buf[0], kTsHeaderSyncword);
@@ -57,16 +70,15 @@ TsPacket* TsPacket::Parse(const uint8_t* buf, int size) {
     DVLOG(1) << "Not on a TS syncword:"
              << " buf[0]="
              << std::hex << static_cast<int>(buf[0]) << std::dec;
-    return NULL;
+    return false;
   }
 
-  std::unique_ptr<TsPacket> ts_packet(new TsPacket());
   bool status = ts_packet->ParseHeader(buf);
   if (!status) {
     DVLOG(1) << "Parsing header failed";
-    return NULL;
+    return false;
   }
-  return ts_packet.release();
+  return true;
 }
 
 TsPacket::TsPacket() {
@@ -76,26 +88,23 @@ TsPacket::~TsPacket() {
 }
 
 bool TsPacket::ParseHeader(const uint8_t* buf) {
-  BitReader bit_reader(buf, kPacketSize);
   payload_ = buf;
   payload_size_ = kPacketSize;
 
-  // Read the TS header: 4 bytes.
-  int syncword;
-  int transport_error_indicator;
-  int payload_unit_start_indicator;
-  int transport_priority;
-  int transport_scrambling_control;
-  int adaptation_field_control;
-  RCHECK(bit_reader.ReadBits(8, &syncword));
-  RCHECK(bit_reader.ReadBits(1, &transport_error_indicator));
-  RCHECK(bit_reader.ReadBits(1, &payload_unit_start_indicator));
-  RCHECK(bit_reader.ReadBits(1, &transport_priority));
-  RCHECK(bit_reader.ReadBits(13, &pid_));
-  RCHECK(bit_reader.ReadBits(2, &transport_scrambling_control));
-  RCHECK(bit_reader.ReadBits(2, &adaptation_field_control));
-  RCHECK(bit_reader.ReadBits(4, &continuity_counter_));
-  payload_unit_start_indicator_ = (payload_unit_start_indicator != 0);
+  // Read the TS header: 4 bytes. This runs for every packet, so the fields
+  // are extracted directly rather than through a BitReader:
+  //   syncword                      8 bits
+  //   transport_error_indicator     1 bit
+  //   payload_unit_start_indicator  1 bit
+  //   transport_priority            1 bit
+  //   pid                          13 bits
+  //   transport_scrambling_control  2 bits
+  //   adaptation_field_control      2 bits
+  //   continuity_counter            4 bits
+  payload_unit_start_indicator_ = (buf[1] & 0x40) != 0;
+  pid_ = ((buf[1] & 0x1f) << 8) | buf[2];
+  int adaptation_field_control = (buf[3] >> 4) & 0x3;
+  continuity_counter_ = buf[3] & 0xf;
   payload_ += 4;
   payload_size_ -= 4;
 
@@ -108,6 +117,7 @@ bool TsPacket::ParseHeader(const uint8_t* buf) {
     return true;
 
   // Read the adaptation field if needed.
+  BitReader bit_reader(payload_, payload_size_);
   int adaptation_field_length;
   RCHECK(bit_reader.ReadBits(8, &adaptation_field_length));
   DVLOG(LOG_LEVEL_TS) << "adaptation_field_length=" << adaptation_field_length;
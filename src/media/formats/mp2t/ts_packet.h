@@ -23,11 +23,12 @@ class TsPacket {
   // to be synchronized on a TS syncword.
   static int Sync(const uint8_t* buf, int size);
 
-  // Parse a TS packet.
-  // Return a TsPacket only when parsing was successful.
-  // Return NULL otherwise.
-  static TsPacket* Parse(const uint8_t* buf, int size);
+  // Parse a TS packet into |ts_packet|. The same TsPacket can be used to
+  // parse every packet of a stream.
+  // Return true only when parsing was successful.
+  static bool Parse(const uint8_t* buf, int size, TsPacket* ts_packet);
 
+  TsPacket();
   ~TsPacket();
 
   // TS header accessors.
@@ -44,8 +45,6 @@ class TsPacket {
   int payload_size() const { return payload_size_; }
 
  private:
-  TsPacket();
-
   // Parse an Mpeg2 TS header.
   // The buffer size should be at least |kPacketSize|
   bool ParseHeader(const uint8_t* buf);
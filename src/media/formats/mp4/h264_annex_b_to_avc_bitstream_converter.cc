@@ -105,8 +105,9 @@ Status H264AnnexBToAvcBitstreamConverter::ConvertChunk(
       case H264NALU::kSliceDataC:
       case H264NALU::kNonIDRSlice:
       case H264NALU::kIDRSlice: {
+        // Only the PPS id of the slice is needed here.
         H264SliceHeader slice_hdr;
-        result = parser_.ParseSliceHeader(nalu, &slice_hdr);
+        result = parser_.ParsePartialSliceHeader(nalu, &slice_hdr);
         if (result != H264Parser::kOk) {
           return Status(StatusCode::kH264ParsingError,
                         "Could not parse slice header");
@@ -14,6 +14,7 @@
 #include "base/callback_helpers.h"
 #include "base/logging.h"
 #include "base/numerics/math_constants.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
@@ -42,6 +43,12 @@ const int kMaxEmptySampleLogs = 20;
 const int kMaxInvalidConversionLogs = 20;
 const int kMaxVideoKeyframeMismatchLogs = 10;
 
+// Queued samples are handed to |new_buffers_cb_| once they reach this size,
+// instead of only when Parse() runs out of data. Large appends then make their
+// first frames available for reading while the rest is still being parsed, and
+// the parser never holds more than this much unsent sample data.
+const size_t kMaxQueuedSampleBytes = 512 * 1024;
+
 // Caller should be prepared to handle return of EncryptionScheme::kUnencrypted
 // in case of unsupported scheme.
 EncryptionScheme GetEncryptionScheme(const ProtectionSchemeInfo& sinf) {
@@ -95,7 +102,9 @@ MP4StreamParser::MP4StreamParser(const std::set<int>& audio_object_types,
       has_flac_(has_flac),
       num_empty_samples_skipped_(0),
       num_invalid_conversions_(0),
-      num_video_keyframe_mismatches_(0) {}
+      num_video_keyframe_mismatches_(0),
+      queued_sample_bytes_(0),
+      max_queued_sample_bytes_(kMaxQueuedSampleBytes) {}
 
 MP4StreamParser::~MP4StreamParser() = default;
 
@@ -187,6 +196,8 @@ bool MP4StreamParser::Parse(const uint8_t* buf, int size) {
           int64_t max_clear = runs_->GetMaxClearOffset() + moof_head_;
           err = !ReadAndDiscardMDATsUntil(max_clear);
         }
+        if (result && !err && queued_sample_bytes_ >= max_queued_sample_bytes_)
+          err = !SendAndFlushSamples(&buffers);
         break;
       }
     }
@@ -197,6 +208,7 @@ bool MP4StreamParser::Parse(const uint8_t* buf, int size) {
 
   if (err) {
     DLOG(ERROR) << "Error while parsing MP4";
+    queued_sample_bytes_ = 0;
     moov_.reset();
     Reset();
     ChangeState(kError);
@@ -809,20 +821,27 @@ ParseResult MP4StreamParser::EnqueueSample(BufferQueueMap* buffers) {
   // opposite of what the coded frame contains.
   bool is_keyframe = runs_->is_keyframe();
 
-  std::vector<uint8_t> frame_buf(buf, buf + sample_size);
+  // Samples are copied from |queue_| straight into their StreamParserBuffer.
+  // Only samples that must be rewritten for the decoder take an extra copy,
+  // into |frame_buf_|, which is reused across samples.
+  const uint8_t* frame_data = buf;
+  int frame_size = sample_size;
   if (video) {
     if (runs_->video_description().video_codec == kCodecH264 ||
         runs_->video_description().video_codec == kCodecHEVC ||
         runs_->video_description().video_codec == kCodecDolbyVision) {
       DCHECK(runs_->video_description().frame_bitstream_converter);
+      frame_buf_.assign(buf, buf + sample_size);
       BitstreamConverter::AnalysisResult analysis;
       if (!runs_->video_description()
                .frame_bitstream_converter->ConvertAndAnalyzeFrame(
-                   &frame_buf, is_keyframe, &subsamples, &analysis)) {
+                   &frame_buf_, is_keyframe, &subsamples, &analysis)) {
         MEDIA_LOG(ERROR, media_log_)
             << "Failed to prepare video sample for decode";
         return ParseResult::kError;
       }
+      frame_data = frame_buf_.data();
+      frame_size = base::checked_cast<int>(frame_buf_.size());
 
       // If conformance analysis was not actually performed, assume the frame is
       // conformant.  If it was performed and found to be non-conformant, log
@@ -863,12 +882,15 @@ ParseResult MP4StreamParser::EnqueueSample(BufferQueueMap* buffers) {
   if (audio) {
     if (ESDescriptor::IsAAC(runs_->audio_description().esds.object_type)) {
 #if BUILDFLAG(USE_PROPRIETARY_CODECS)
-      if (!PrepareAACBuffer(runs_->audio_description().esds.aac, &frame_buf,
+      frame_buf_.assign(buf, buf + sample_size);
+      if (!PrepareAACBuffer(runs_->audio_description().esds.aac, &frame_buf_,
                             &subsamples)) {
         MEDIA_LOG(ERROR, media_log_)
             << "Failed to prepare AAC sample for decode";
         return ParseResult::kError;
       }
+      frame_data = frame_buf_.data();
+      frame_size = base::checked_cast<int>(frame_buf_.size());
 #else
       return ParseResult::kError;
 #endif  // BUILDFLAG(USE_PROPRIETARY_CODECS)
@@ -890,8 +912,9 @@ ParseResult MP4StreamParser::EnqueueSample(BufferQueueMap* buffers) {
       DemuxerStream::VIDEO;
 
   scoped_refptr<StreamParserBuffer> stream_buf =
-      StreamParserBuffer::CopyFrom(&frame_buf[0], frame_buf.size(), is_keyframe,
-                                   buffer_type, runs_->track_id());
+      StreamParserBuffer::CopyFrom(buffer_pool(), frame_data, frame_size,
+                                   is_keyframe, buffer_type,
+                                   runs_->track_id());
 
   if (decrypt_config)
     stream_buf->set_decrypt_config(std::move(decrypt_config));
@@ -925,7 +948,8 @@ ParseResult MP4StreamParser::EnqueueSample(BufferQueueMap* buffers) {
            << ", cts=" << runs_->cts().InMilliseconds()
            << ", size=" << sample_size;
 
-  (*buffers)[runs_->track_id()].push_back(stream_buf);
+  queued_sample_bytes_ += stream_buf->data_size();
+  (*buffers)[runs_->track_id()].push_back(std::move(stream_buf));
   if (!runs_->AdvanceSample())
     return ParseResult::kError;
   return ParseResult::kOk;
@@ -936,6 +960,7 @@ bool MP4StreamParser::SendAndFlushSamples(BufferQueueMap* buffers) {
     return true;
   bool success = new_buffers_cb_.Run(*buffers);
   buffers->clear();
+  queued_sample_bytes_ = 0;
   return success;
 }
 
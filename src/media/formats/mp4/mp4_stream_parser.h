@@ -5,6 +5,7 @@
 #ifndef MEDIA_FORMATS_MP4_MP4_STREAM_PARSER_H_
 #define MEDIA_FORMATS_MP4_MP4_STREAM_PARSER_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <memory>
@@ -55,6 +56,12 @@ class MEDIA_EXPORT MP4StreamParser : public StreamParser {
   VideoTransformation CalculateRotation(const TrackHeader& track,
                                         const MovieHeader& movie);
 
+  // Overrides the size at which queued samples are sent to |new_buffers_cb_|
+  // without waiting for the end of the Parse() call.
+  void set_max_queued_sample_bytes_for_testing(size_t bytes) {
+    max_queued_sample_bytes_ = bytes;
+  }
+
  private:
   enum State {
     kWaitingForInit,
@@ -151,6 +158,17 @@ class MEDIA_EXPORT MP4StreamParser : public StreamParser {
   // Tracks the number of MEDIA_LOGS for video keyframe MP4<->frame mismatch.
   int num_video_keyframe_mismatches_;
 
+  // Scratch space for samples that are rewritten before being emitted, e.g.
+  // AVC to Annex B conversion or ADTS header insertion. Kept across samples to
+  // avoid reallocating it for each one.
+  std::vector<uint8_t> frame_buf_;
+
+  // Total size of the samples enqueued by EnqueueSample() but not yet sent to
+  // |new_buffers_cb_|, and the size at which they are sent from within
+  // Parse().
+  size_t queued_sample_bytes_;
+  size_t max_queued_sample_bytes_;
+
   DISALLOW_COPY_AND_ASSIGN(MP4StreamParser);
 };
 
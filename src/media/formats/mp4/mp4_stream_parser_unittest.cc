@@ -8,7 +8,9 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <tuple>
 
@@ -97,6 +99,9 @@ class MP4StreamParserTest : public testing::Test {
   StreamParser::TrackId video_track_id_;
   bool verifying_keyframeness_sequence_;
   StrictMock<base::MockRepeatingCallback<void(Keyframeness)>> keyframeness_cb_;
+  int new_buffers_cb_count_ = 0;
+  // All buffers emitted so far, in emission order for each track.
+  StreamParser::BufferQueueMap emitted_buffers_;
 
   bool AppendData(const uint8_t* data, size_t length) {
     return parser_->Parse(data, length);
@@ -159,10 +164,13 @@ class MP4StreamParserTest : public testing::Test {
   }
 
   bool NewBuffersF(const StreamParser::BufferQueueMap& buffer_queue_map) {
+    ++new_buffers_cb_count_;
     DecodeTimestamp lowest_end_dts = kNoDecodeTimestamp();
     for (const auto& it : buffer_queue_map) {
       DVLOG(3) << "Buffers for track_id=" << it.first;
       DCHECK(!it.second.empty());
+      StreamParser::BufferQueue& emitted = emitted_buffers_[it.first];
+      emitted.insert(emitted.end(), it.second.begin(), it.second.end());
 
       if (lowest_end_dts == kNoDecodeTimestamp() ||
           lowest_end_dts > it.second.back()->GetDecodeTimestamp())
@@ -311,6 +319,53 @@ TEST_F(MP4StreamParserTest, MultiFragmentAppend) {
   ParseMP4File("bear-1280x720-av_frag.mp4", 768432);
 }
 
+TEST_F(MP4StreamParserTest, FlushesQueuedSamplesWithinParse) {
+  // The test files have no media segment with more sample data than the
+  // default limit, so parse one with the limit lowered below the size of its
+  // fragments, and compare with the buffers emitted at the default limit.
+  scoped_refptr<DecoderBuffer> buffer =
+      ReadTestDataFile("bear-1280x720-av_frag.mp4");
+
+  InitializeParser();
+  EXPECT_TRUE(AppendData(buffer->data(), buffer->data_size()));
+  const int expected_new_buffers_cb_count = new_buffers_cb_count_;
+  const StreamParser::BufferQueueMap expected_buffers =
+      std::move(emitted_buffers_);
+  ASSERT_EQ(2u, expected_buffers.size());
+
+  std::set<int> audio_object_types;
+  audio_object_types.insert(kISO_14496_3);
+  parser_.reset(new MP4StreamParser(audio_object_types, false, false));
+  parser_->set_max_queued_sample_bytes_for_testing(16 * 1024);
+  InitializeParser();
+  new_buffers_cb_count_ = 0;
+  emitted_buffers_.clear();
+
+  // A single append, so every extra |new_buffers_cb| call comes from within
+  // Parse().
+  EXPECT_TRUE(AppendData(buffer->data(), buffer->data_size()));
+  EXPECT_GT(new_buffers_cb_count_, expected_new_buffers_cb_count);
+
+  // Every sample is still emitted exactly once, in decode order.
+  ASSERT_EQ(expected_buffers.size(), emitted_buffers_.size());
+  for (const auto& it : expected_buffers) {
+    SCOPED_TRACE(it.first);
+    const StreamParser::BufferQueue& expected = it.second;
+    const StreamParser::BufferQueue& emitted = emitted_buffers_[it.first];
+    ASSERT_EQ(expected.size(), emitted.size());
+    for (size_t i = 0; i < emitted.size(); ++i) {
+      SCOPED_TRACE(i);
+      if (i > 0) {
+        EXPECT_LT(emitted[i - 1]->GetDecodeTimestamp(),
+                  emitted[i]->GetDecodeTimestamp());
+      }
+      EXPECT_EQ(expected[i]->GetDecodeTimestamp(),
+                emitted[i]->GetDecodeTimestamp());
+      EXPECT_TRUE(expected[i]->MatchesForTesting(*emitted[i]));
+    }
+  }
+}
+
 TEST_F(MP4StreamParserTest, Flush) {
   // Flush while reading sample data, then start a new stream.
   InitializeParser();
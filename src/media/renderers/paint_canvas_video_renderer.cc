@@ -5,7 +5,9 @@
 #include "media/renderers/paint_canvas_video_renderer.h"
 
 #include <GLES3/gl3.h>
+#include <cmath>
 #include <limits>
+#include <utility>
 
 #include "base/barrier_closure.h"
 #include "base/bind.h"
@@ -43,6 +45,7 @@
 #include "third_party/skia/include/gpu/GrDirectContext.h"
 #include "third_party/skia/include/gpu/gl/GrGLTypes.h"
 #include "ui/gfx/geometry/rect_f.h"
+#include "ui/gfx/geometry/size_conversions.h"
 #include "ui/gfx/skia_util.h"
 
 // Skia internal format depends on a platform. On Android it is ABGR, on others
@@ -79,6 +82,11 @@ namespace {
 // We delete the temporary resource if it is not used for 3 seconds.
 const int kTemporaryResourceDeletionDelay = 3;  // Seconds;
 
+// Maximum number of pixel buffers kept for the RGB images of software frames.
+// More than one buffer is needed when the canvas records the image instead of
+// drawing it right away, e.g. into a display list.
+const size_t kMaxSoftwareImagePixels = 3;
+
 // Helper class that begins/ends access to a mailbox within a scope. The mailbox
 // must have been imported into |texture|.
 class ScopedSharedImageAccess {
@@ -931,6 +939,37 @@ void PaintCanvasVideoRenderer::Paint(
                           cc::PaintFlags::FilterQualityToSkSamplingOptions(
                               flags.getFilterQuality()),
                           &video_flags, SkCanvas::kStrict_SrcRectConstraint);
+  } else if (!raster_context_provider && video_frame->IsMappable()) {
+    // Without a raster context the image is converted to RGB on the CPU
+    // anyway, so convert it here into a recycled bitmap. When the frame is
+    // drawn smaller than its visible size, it is scaled before the conversion
+    // so that only the drawn pixels are converted.
+    gfx::Size image_size = video_frame->visible_rect().size();
+    const SkMatrix total_matrix = canvas->getTotalMatrix();
+    if ((video_transformation.rotation == VIDEO_ROTATION_0 ||
+         video_transformation.rotation == VIDEO_ROTATION_180) &&
+        total_matrix.isScaleTranslate() &&
+        CanScaleAndConvertVideoFrame(video_frame.get())) {
+      // The total matrix already includes the scaling from the visible size
+      // to |dest_rect|, so it maps the visible size to the drawn pixels.
+      const gfx::Size drawn_size = gfx::ToRoundedSize(gfx::ScaleSize(
+          gfx::SizeF(video_frame->visible_rect().size()),
+          std::abs(total_matrix.getScaleX()),
+          std::abs(total_matrix.getScaleY())));
+      if (!drawn_size.IsEmpty() && drawn_size.width() < image_size.width() &&
+          drawn_size.height() < image_size.height()) {
+        image_size = drawn_size;
+      }
+    }
+    cc::PaintImage software_image =
+        GetSoftwareImage(video_frame.get(), image_size);
+    canvas->drawImageRect(
+        software_image, SkRect::MakeWH(image_size.width(), image_size.height()),
+        SkRect::MakeWH(video_frame->visible_rect().width(),
+                       video_frame->visible_rect().height()),
+        cc::PaintFlags::FilterQualityToSkSamplingOptions(
+            flags.getFilterQuality()),
+        &video_flags, SkCanvas::kStrict_SrcRectConstraint);
   } else {
     DCHECK_EQ(video_frame->visible_rect().size(),
               gfx::Size(image.width(), image.height()));
@@ -1233,6 +1272,60 @@ void PaintCanvasVideoRenderer::ConvertVideoFrameToRGBPixels(
   }
 }
 
+// static
+bool PaintCanvasVideoRenderer::CanScaleAndConvertVideoFrame(
+    const VideoFrame* video_frame) {
+  return video_frame->IsMappable() &&
+         (video_frame->format() == PIXEL_FORMAT_I420 ||
+          video_frame->format() == PIXEL_FORMAT_YV12) &&
+         video_frame->data(VideoFrame::kUPlane) &&
+         video_frame->data(VideoFrame::kVPlane) &&
+         video_frame->ColorSpace().GetMatrixID() !=
+             gfx::ColorSpace::MatrixID::GBR;
+}
+
+void PaintCanvasVideoRenderer::ScaleAndConvertVideoFrameToRGBPixels(
+    const VideoFrame* video_frame,
+    const gfx::Size& dest_size,
+    void* rgb_pixels,
+    size_t row_bytes) {
+  DCHECK(CanScaleAndConvertVideoFrame(video_frame));
+  DCHECK(!dest_size.IsEmpty());
+  if (dest_size == video_frame->visible_rect().size()) {
+    ConvertVideoFrameToRGBPixels(video_frame, rgb_pixels, row_bytes);
+    return;
+  }
+
+  scoped_refptr<VideoFrame> scaled_frame = scaled_frame_pool_.CreateFrame(
+      PIXEL_FORMAT_I420, dest_size, gfx::Rect(dest_size), dest_size,
+      video_frame->timestamp());
+  if (!scaled_frame) {
+    DLOG(ERROR) << "Failed to allocate a scaled frame.";
+    return;
+  }
+  scaled_frame->set_color_space(video_frame->ColorSpace());
+
+  // The box filter averages all the source pixels of a destination pixel,
+  // which is cheap and does not alias when downscaling.
+  libyuv::I420Scale(video_frame->visible_data(VideoFrame::kYPlane),
+                    video_frame->stride(VideoFrame::kYPlane),
+                    video_frame->visible_data(VideoFrame::kUPlane),
+                    video_frame->stride(VideoFrame::kUPlane),
+                    video_frame->visible_data(VideoFrame::kVPlane),
+                    video_frame->stride(VideoFrame::kVPlane),
+                    video_frame->visible_rect().width(),
+                    video_frame->visible_rect().height(),
+                    scaled_frame->visible_data(VideoFrame::kYPlane),
+                    scaled_frame->stride(VideoFrame::kYPlane),
+                    scaled_frame->visible_data(VideoFrame::kUPlane),
+                    scaled_frame->stride(VideoFrame::kUPlane),
+                    scaled_frame->visible_data(VideoFrame::kVPlane),
+                    scaled_frame->stride(VideoFrame::kVPlane),
+                    dest_size.width(), dest_size.height(),
+                    libyuv::kFilterBox);
+  ConvertVideoFrameToRGBPixels(scaled_frame.get(), rgb_pixels, row_bytes);
+}
+
 bool PaintCanvasVideoRenderer::CopyVideoFrameTexturesToGLTexture(
     viz::RasterContextProvider* raster_context_provider,
     gpu::gles2::GLES2Interface* destination_gl,
@@ -1657,6 +1750,7 @@ void PaintCanvasVideoRenderer::ResetCache() {
   DCHECK(thread_checker_.CalledOnValidThread());
   cache_.reset();
   yuv_cache_.Reset();
+  software_image_pixels_.clear();
 }
 
 PaintCanvasVideoRenderer::Cache::Cache(int frame_id) : frame_id(frame_id) {}
@@ -1833,6 +1927,61 @@ bool PaintCanvasVideoRenderer::UpdateLastImage(
   return true;
 }
 
+cc::PaintImage PaintCanvasVideoRenderer::GetSoftwareImage(
+    const VideoFrame* video_frame,
+    const gfx::Size& size) {
+  DCHECK(cache_);
+  DCHECK_EQ(cache_->frame_id, video_frame->unique_id());
+  if (cache_->software_image &&
+      cache_->software_image.width() == size.width() &&
+      cache_->software_image.height() == size.height()) {
+    return cache_->software_image;
+  }
+  // Release the image of another size first, so that its pixels can be reused.
+  cache_->software_image = cc::PaintImage();
+
+  const SkImageInfo info = SkImageInfo::MakeN32Premul(size.width(),
+                                                      size.height());
+  const size_t row_bytes = info.minRowBytes();
+  const size_t byte_size = info.computeByteSize(row_bytes);
+
+  // Pixels which only |software_image_pixels_| refers to are not used by any
+  // image anymore.
+  sk_sp<SkData> pixels;
+  for (auto it = software_image_pixels_.begin();
+       it != software_image_pixels_.end(); ++it) {
+    if ((*it)->unique() && (*it)->size() == byte_size) {
+      pixels = std::move(*it);
+      software_image_pixels_.erase(it);
+      break;
+    }
+  }
+  if (!pixels)
+    pixels = SkData::MakeUninitialized(byte_size);
+
+  if (size == video_frame->visible_rect().size()) {
+    ConvertVideoFrameToRGBPixels(video_frame, pixels->writable_data(),
+                                 row_bytes);
+  } else {
+    ScaleAndConvertVideoFrameToRGBPixels(video_frame, size,
+                                         pixels->writable_data(), row_bytes);
+  }
+
+  cache_->software_image =
+      cc::PaintImageBuilder::WithDefault()
+          .set_id(renderer_stable_id_)
+          .set_animation_type(cc::PaintImage::AnimationType::VIDEO)
+          .set_completion_state(cc::PaintImage::CompletionState::DONE)
+          .set_image(SkImage::MakeRasterData(info, pixels, row_bytes),
+                     cc::PaintImage::GetNextContentId())
+          .TakePaintImage();
+
+  software_image_pixels_.push_back(std::move(pixels));
+  if (software_image_pixels_.size() > kMaxSoftwareImagePixels)
+    software_image_pixels_.erase(software_image_pixels_.begin());
+  return cache_->software_image;
+}
+
 bool PaintCanvasVideoRenderer::PrepareVideoFrame(
     scoped_refptr<VideoFrame> video_frame,
     viz::RasterContextProvider* raster_context_provider,
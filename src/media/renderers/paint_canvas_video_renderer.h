@@ -8,6 +8,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <vector>
+
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/threading/thread_checker.h"
@@ -19,9 +21,12 @@
 #include "media/base/media_export.h"
 #include "media/base/timestamp_constants.h"
 #include "media/base/video_frame.h"
+#include "media/base/video_frame_pool.h"
 #include "media/base/video_transformation.h"
 #include "media/renderers/video_frame_yuv_converter.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
 
 namespace gfx {
 class RectF;
@@ -87,6 +92,19 @@ class MEDIA_EXPORT PaintCanvasVideoRenderer {
                                            size_t row_bytes,
                                            bool premultiply_alpha = true);
 
+  // Returns true if ScaleAndConvertVideoFrameToRGBPixels() supports
+  // |video_frame|, which is the case of mappable 8-bit 4:2:0 frames.
+  static bool CanScaleAndConvertVideoFrame(const VideoFrame* video_frame);
+
+  // Same as ConvertVideoFrameToRGBPixels(), but the visible area of
+  // |video_frame| is scaled to |dest_size| RGB pixels. The frame is scaled
+  // before it is converted, so that only |dest_size| pixels are converted,
+  // using a scratch frame that is reused from one call to the next.
+  void ScaleAndConvertVideoFrameToRGBPixels(const VideoFrame* video_frame,
+                                            const gfx::Size& dest_size,
+                                            void* rgb_pixels,
+                                            size_t row_bytes);
+
   // Copy the contents of |video_frame| to |texture| of |destination_gl|.
   //
   // The format of |video_frame| must be VideoFrame::NATIVE_TEXTURE.
@@ -215,6 +233,10 @@ class MEDIA_EXPORT PaintCanvasVideoRenderer {
     // True if the underlying resource was created with a top left origin.
     bool texture_origin_is_top_left = true;
 
+    // The RGB image drawn on canvases without a raster context, at the size
+    // it was last drawn at. This is only set if the VideoFrame was software.
+    cc::PaintImage software_image;
+
     // Used to allow recycling of the previous shared image. This requires that
     // no external users have access to this resource via SkImage. Returns true
     // if the existing resource can be recycled.
@@ -244,8 +266,23 @@ class MEDIA_EXPORT PaintCanvasVideoRenderer {
 
   bool CacheBackingWrapsTexture() const;
 
+  // Returns |cache_->software_image|, updated to |video_frame| converted to
+  // RGB at |size|, which is either the visible size of the frame or a smaller
+  // size if CanScaleAndConvertVideoFrame(). |video_frame| must be the frame
+  // of |cache_|.
+  cc::PaintImage GetSoftwareImage(const VideoFrame* video_frame,
+                                  const gfx::Size& size);
+
   absl::optional<Cache> cache_;
 
+  // Pixels of the last images returned by GetSoftwareImage(), least recently
+  // used first. Once no image refers to them anymore, they are reused for the
+  // next image of the same size instead of allocating a new bitmap per frame.
+  std::vector<sk_sp<SkData>> software_image_pixels_;
+
+  // Scratch frames of ScaleAndConvertVideoFrameToRGBPixels().
+  VideoFramePool scaled_frame_pool_;
+
   // If |cache_| is not used for a while, it's deleted to save memory.
   base::DelayTimer cache_deleting_timer_;
   // Stable paint image id to provide to draw image calls.
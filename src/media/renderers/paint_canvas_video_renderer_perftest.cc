@@ -0,0 +1,117 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "cc/paint/paint_flags.h"
+#include "cc/paint/skia_paint_canvas.h"
+#include "media/base/video_frame.h"
+#include "media/base/video_util.h"
+#include "media/renderers/paint_canvas_video_renderer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/rect_f.h"
+
+namespace media {
+
+// Number of frames converted by each benchmark.
+static const int kFrames = 100;
+
+struct PaintCanvasVideoRendererPerfTestParam {
+  const char* story;
+  gfx::Size frame_size;
+};
+
+class PaintCanvasVideoRendererPerfTest
+    : public testing::TestWithParam<PaintCanvasVideoRendererPerfTestParam> {
+ protected:
+  // Returns |kFrames| distinct I420 frames, so that nothing is cached from a
+  // frame to the next.
+  std::vector<scoped_refptr<VideoFrame>> CreateFrames() {
+    const gfx::Size& size = GetParam().frame_size;
+    std::vector<scoped_refptr<VideoFrame>> frames;
+    for (int i = 0; i < kFrames; ++i) {
+      frames.push_back(VideoFrame::CreateFrame(
+          PIXEL_FORMAT_I420, size, gfx::Rect(size), size,
+          base::TimeDelta::FromMilliseconds(i)));
+      FillYUV(frames.back().get(), i, 128 + i, 128 - i);
+    }
+    return frames;
+  }
+
+  void ReportResult(const char* metric, base::TimeDelta total_time) {
+    perf_test::PerfResultReporter reporter("paint_canvas_video_renderer",
+                                           GetParam().story);
+    reporter.RegisterImportantMetric(metric, "ms");
+    reporter.AddResult(metric, total_time.InMillisecondsF() / kFrames);
+  }
+
+  // Needed by the conversion, which is split across the thread pool.
+  base::test::TaskEnvironment task_environment_;
+  PaintCanvasVideoRenderer renderer_;
+};
+
+TEST_P(PaintCanvasVideoRendererPerfTest, ConvertToRGB) {
+  const gfx::Size& size = GetParam().frame_size;
+  std::vector<scoped_refptr<VideoFrame>> frames = CreateFrames();
+  std::vector<uint32_t> rgb_pixels(size.GetArea());
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (const auto& frame : frames) {
+    PaintCanvasVideoRenderer::ConvertVideoFrameToRGBPixels(
+        frame.get(), rgb_pixels.data(), size.width() * sizeof(uint32_t));
+  }
+  ReportResult("_convert", base::TimeTicks::Now() - start);
+}
+
+TEST_P(PaintCanvasVideoRendererPerfTest, ScaleAndConvertToRGB) {
+  const gfx::Size dest_size =
+      gfx::ScaleToFlooredSize(GetParam().frame_size, 0.5f);
+  std::vector<scoped_refptr<VideoFrame>> frames = CreateFrames();
+  std::vector<uint32_t> rgb_pixels(dest_size.GetArea());
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (const auto& frame : frames) {
+    renderer_.ScaleAndConvertVideoFrameToRGBPixels(
+        frame.get(), dest_size, rgb_pixels.data(),
+        dest_size.width() * sizeof(uint32_t));
+  }
+  ReportResult("_scale_and_convert_half", base::TimeTicks::Now() - start);
+}
+
+// Paints frames at half their size on a software canvas, like a drawImage()
+// call of a 2D canvas.
+TEST_P(PaintCanvasVideoRendererPerfTest, PaintScaled) {
+  const gfx::Size dest_size =
+      gfx::ScaleToFlooredSize(GetParam().frame_size, 0.5f);
+  std::vector<scoped_refptr<VideoFrame>> frames = CreateFrames();
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(dest_size.width(), dest_size.height());
+  cc::SkiaPaintCanvas canvas(bitmap);
+  cc::PaintFlags flags;
+  flags.setFilterQuality(cc::PaintFlags::FilterQuality::kLow);
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (const auto& frame : frames) {
+    renderer_.Paint(frame, &canvas, gfx::RectF(gfx::SizeF(dest_size)), flags,
+                    kNoTransformation, nullptr);
+  }
+  ReportResult("_paint_half", base::TimeTicks::Now() - start);
+}
+
+static const PaintCanvasVideoRendererPerfTestParam kPerfTestParams[] = {
+    {"1080p_i420", gfx::Size(1920, 1080)},
+    {"2160p_i420", gfx::Size(3840, 2160)},
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         PaintCanvasVideoRendererPerfTest,
+                         testing::ValuesIn(kPerfTestParams));
+
+}  // namespace media
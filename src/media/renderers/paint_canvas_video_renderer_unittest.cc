@@ -5,6 +5,8 @@
 #include <GLES3/gl3.h>
 #include <stdint.h>
 
+#include <vector>
+
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/macros.h"
@@ -13,6 +15,7 @@
 #include "base/test/task_environment.h"
 #include "build/build_config.h"
 #include "cc/paint/paint_flags.h"
+#include "cc/paint/paint_recorder.h"
 #include "cc/paint/skia_paint_canvas.h"
 #include "components/viz/common/gpu/context_provider.h"
 #include "components/viz/test/test_context_provider.h"
@@ -481,6 +484,109 @@ TEST_F(PaintCanvasVideoRendererTest, CroppedFrame_NoScaling) {
                                           offset_y + crop_rect.height() - 1));
 }
 
+// Returns a 4K frame with the same contents as the whole cropped frame.
+static scoped_refptr<VideoFrame> CreateUHDQuadrantsFrame(
+    scoped_refptr<VideoFrame> cropped_frame) {
+  const gfx::Size size(3840, 2160);
+  auto frame = VideoFrame::CreateFrame(PIXEL_FORMAT_I420, size,
+                                       gfx::Rect(size), size,
+                                       base::TimeDelta());
+  libyuv::I420Scale(cropped_frame->data(0), cropped_frame->stride(0),
+                    cropped_frame->data(1), cropped_frame->stride(1),
+                    cropped_frame->data(2), cropped_frame->stride(2),
+                    cropped_frame->coded_size().width(),
+                    cropped_frame->coded_size().height(), frame->data(0),
+                    frame->stride(0), frame->data(1), frame->stride(1),
+                    frame->data(2), frame->stride(2), size.width(),
+                    size.height(), libyuv::kFilterNone);
+  return frame;
+}
+
+TEST_F(PaintCanvasVideoRendererTest, ScaleAndConvertVideoFrameToRGBPixels) {
+  auto test_frame = CreateUHDQuadrantsFrame(cropped_frame());
+  ASSERT_TRUE(
+      PaintCanvasVideoRenderer::CanScaleAndConvertVideoFrame(test_frame.get()));
+
+  const gfx::Size dest_size(960, 540);
+  std::vector<uint32_t> rgb_pixels(dest_size.GetArea());
+  renderer_.ScaleAndConvertVideoFrameToRGBPixels(
+      test_frame.get(), dest_size, rgb_pixels.data(),
+      dest_size.width() * sizeof(uint32_t));
+
+  // Check the corners.
+  EXPECT_EQ(SK_ColorBLACK, rgb_pixels[0]);
+  EXPECT_EQ(MaybeConvertABGRToARGB(SK_ColorRED),
+            rgb_pixels[dest_size.width() - 1]);
+  EXPECT_EQ(SK_ColorGREEN,
+            rgb_pixels[dest_size.width() * (dest_size.height() - 1)]);
+  EXPECT_EQ(MaybeConvertABGRToARGB(SK_ColorBLUE), rgb_pixels.back());
+}
+
+// Returns a 4K frame of vertical black and white stripes, which are
+// |stripe_width| pixels wide.
+static scoped_refptr<VideoFrame> CreateUHDStripesFrame(int stripe_width) {
+  const gfx::Size size(3840, 2160);
+  auto frame = VideoFrame::CreateFrame(PIXEL_FORMAT_I420, size,
+                                       gfx::Rect(size), size,
+                                       base::TimeDelta());
+  for (int y = 0; y < size.height(); ++y) {
+    uint8_t* row = frame->visible_data(VideoFrame::kYPlane) +
+                   y * frame->stride(VideoFrame::kYPlane);
+    for (int x = 0; x < size.width(); ++x)
+      row[x] = (x / stripe_width) % 2 ? 235 : 16;
+  }
+  for (size_t plane : {VideoFrame::kUPlane, VideoFrame::kVPlane}) {
+    for (int y = 0; y < size.height() / 2; ++y) {
+      memset(frame->visible_data(plane) + y * frame->stride(plane), 128,
+             size.width() / 2);
+    }
+  }
+  return frame;
+}
+
+TEST_F(PaintCanvasVideoRendererTest, DownscaledFrame) {
+  // The frame is scaled to the size of the canvas before it is converted.
+  Paint(CreateUHDQuadrantsFrame(cropped_frame()), target_canvas(), kNone);
+
+  // Check the corners.
+  EXPECT_EQ(SK_ColorBLACK, bitmap()->getColor(0, 0));
+  EXPECT_EQ(SK_ColorRED, bitmap()->getColor(kWidth - 1, 0));
+  EXPECT_EQ(SK_ColorGREEN, bitmap()->getColor(0, kHeight - 1));
+  EXPECT_EQ(SK_ColorBLUE, bitmap()->getColor(kWidth - 1, kHeight - 1));
+}
+
+TEST_F(PaintCanvasVideoRendererTest, DownscaledFrameKeepsDetail) {
+  // The stripes are 2 pixels wide once the frame is drawn on the canvas, so
+  // they only survive if the frame is converted at the size of the canvas.
+  const int kScale = 3840 / kWidth;
+  Paint(CreateUHDStripesFrame(2 * kScale), target_canvas(), kNone);
+
+  for (int x = 0; x < kWidth; ++x) {
+    const SkColor color = bitmap()->getColor(x, kHeight / 2);
+    if ((x / 2) % 2)
+      EXPECT_GT(SkColorGetG(color), 0xF0u) << "x = " << x;
+    else
+      EXPECT_LT(SkColorGetG(color), 0x10u) << "x = " << x;
+  }
+}
+
+TEST_F(PaintCanvasVideoRendererTest, RecordedFrameKeepsItsPixels) {
+  // Record the painting of a red frame, which keeps its image alive.
+  cc::PaintRecorder recorder;
+  Paint(natural_frame(), recorder.beginRecording(kWidth, kHeight), kRed);
+  sk_sp<cc::PaintRecord> record = recorder.finishRecordingAsPicture();
+
+  // Frames of the same size painted next must not reuse its pixels.
+  for (int i = 0; i < 5; ++i) {
+    Paint(VideoFrame::CreateBlackFrame(gfx::Size(kWidth, kHeight)),
+          target_canvas(), kBlue);
+    EXPECT_EQ(SK_ColorBLUE, bitmap()->getColor(0, 0));
+  }
+
+  target_canvas()->drawPicture(record);
+  EXPECT_EQ(SK_ColorRED, bitmap()->getColor(0, 0));
+}
+
 TEST_F(PaintCanvasVideoRendererTest, Video_Rotation_90) {
   SkBitmap bitmap = AllocBitmap(kWidth, kHeight);
   cc::SkiaPaintCanvas canvas(bitmap);
@@ -3,16 +3,55 @@
 // found in the LICENSE file.
 
 #include "media/video/h264_bit_reader.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/bits.h"
 #include "base/check.h"
 
 namespace media {
 
+namespace {
+
+// Returns the first emulation prevention byte in [begin, end), i.e. the first
+// 0x03 byte preceded by two zero bytes, or nullptr. |zero_bytes_before| zero
+// bytes right before |begin| may be part of the sequence.
+const uint8_t* FindEmulationPreventionByte(const uint8_t* begin,
+                                           const uint8_t* end,
+                                           int zero_bytes_before) {
+  const uint8_t* p = begin;
+  while (p < end) {
+    p = static_cast<const uint8_t*>(memchr(p, 0x03, end - p));
+    if (!p)
+      return nullptr;
+    const bool zero_before = p - 1 >= begin ? p[-1] == 0x00
+                                            : zero_bytes_before >= 1;
+    const bool zero_two_before =
+        p - 2 >= begin ? p[-2] == 0x00 : zero_bytes_before >= begin - p + 2;
+    if (zero_before && zero_two_before)
+      return p;
+    ++p;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+// static
+constexpr off_t H264BitReader::kRBSPChunkSize;
+
 H264BitReader::H264BitReader()
     : data_(nullptr),
       bytes_left_(0),
+      plain_data_end_(nullptr),
+      stream_(nullptr),
+      stream_bytes_left_(0),
+      stream_zero_bytes_(0),
+      num_emulation_prevention_bytes_read_in_chunk_(0),
       curr_byte_(0),
       num_remaining_bits_in_curr_byte_(0),
-      prev_two_bytes_(0),
       emulation_prevention_bytes_(0) {}
 
 H264BitReader::~H264BitReader() = default;
@@ -24,40 +63,97 @@ bool H264BitReader::Initialize(const uint8_t* data, off_t size) {
     return false;
 
   data_ = data;
-  bytes_left_ = size;
+  bytes_left_ = 0;
+  plain_data_end_ = data_;
+  stream_ = data;
+  stream_bytes_left_ = size;
+  // The first two bytes cannot complete an emulation prevention sequence.
+  stream_zero_bytes_ = 0;
+  emulation_prevention_byte_positions_.clear();
+  num_emulation_prevention_bytes_read_in_chunk_ = 0;
   num_remaining_bits_in_curr_byte_ = 0;
-  // Initially set to 0xffff to accept all initial two-byte sequences.
-  prev_two_bytes_ = 0xffff;
   emulation_prevention_bytes_ = 0;
 
   return true;
 }
 
-bool H264BitReader::UpdateCurrByte() {
-  if (bytes_left_ < 1)
+bool H264BitReader::LoadNextChunk() {
+  // Emulation prevention bytes left at the end of the previous chunk are
+  // skipped now, before the next byte is loaded.
+  emulation_prevention_bytes_ += NumEmulationPreventionBytesLeftInChunk();
+  emulation_prevention_byte_positions_.clear();
+  num_emulation_prevention_bytes_read_in_chunk_ = 0;
+
+  if (stream_bytes_left_ < 1)
     return false;
 
-  // Emulation prevention three-byte detection.
-  // If a sequence of 0x000003 is found, skip (ignore) the last byte (0x03).
-  if (*data_ == 0x03 && (prev_two_bytes_ & 0xffff) == 0) {
-    // Detected 0x000003, skip last byte.
-    ++data_;
-    --bytes_left_;
-    ++emulation_prevention_bytes_;
-    // Need another full three bytes before we can detect the sequence again.
-    prev_two_bytes_ = 0xffff;
+  const off_t chunk_size = std::min(stream_bytes_left_, kRBSPChunkSize);
+  const uint8_t* const chunk_end = stream_ + chunk_size;
+  const uint8_t* epb =
+      FindEmulationPreventionByte(stream_, chunk_end, stream_zero_bytes_);
 
-    if (bytes_left_ < 1)
-      return false;
+  // Bytes after the last emulation prevention byte of the chunk.
+  const uint8_t* tail = stream_;
+  int zero_bytes_before_tail = stream_zero_bytes_;
+
+  if (!epb) {
+    // Most chunks have no emulation prevention byte, read them in place.
+    data_ = stream_;
+    bytes_left_ = chunk_size;
+  } else {
+    uint8_t* out = rbsp_chunk_;
+    do {
+      memcpy(out, tail, epb - tail);
+      out += epb - tail;
+      emulation_prevention_byte_positions_.push_back(out);
+      // Need another full three bytes before we can detect the sequence
+      // again.
+      tail = epb + 1;
+      zero_bytes_before_tail = 0;
+      epb = FindEmulationPreventionByte(tail, chunk_end, 0);
+    } while (epb);
+    memcpy(out, tail, chunk_end - tail);
+    out += chunk_end - tail;
+    data_ = rbsp_chunk_;
+    bytes_left_ = out - rbsp_chunk_;
+  }
+
+  // Count the zero bytes the next chunk may complete a sequence with.
+  int zero_bytes = 0;
+  const uint8_t* p = chunk_end;
+  while (zero_bytes < 2 && p > tail && p[-1] == 0x00) {
+    --p;
+    ++zero_bytes;
   }
+  if (p == tail)
+    zero_bytes = std::min(2, zero_bytes + zero_bytes_before_tail);
+  stream_zero_bytes_ = zero_bytes;
+
+  stream_ = chunk_end;
+  stream_bytes_left_ -= chunk_size;
+  return true;
+}
 
-  // Load a new byte and advance pointers.
-  curr_byte_ = *data_++ & 0xff;
-  --bytes_left_;
-  num_remaining_bits_in_curr_byte_ = 8;
+bool H264BitReader::UpdatePlainData() {
+  while (bytes_left_ < 1) {
+    if (!LoadNextChunk()) {
+      plain_data_end_ = data_;
+      return false;
+    }
+  }
 
-  prev_two_bytes_ = ((prev_two_bytes_ & 0xff) << 8) | curr_byte_;
+  // Skip the emulation prevention bytes which preceded the byte to load.
+  while (NumEmulationPreventionBytesLeftInChunk() > 0 &&
+         emulation_prevention_byte_positions_
+                 [num_emulation_prevention_bytes_read_in_chunk_] <= data_) {
+    ++num_emulation_prevention_bytes_read_in_chunk_;
+    ++emulation_prevention_bytes_;
+  }
 
+  plain_data_end_ = NumEmulationPreventionBytesLeftInChunk() > 0
+                        ? emulation_prevention_byte_positions_
+                              [num_emulation_prevention_bytes_read_in_chunk_]
+                        : data_ + bytes_left_;
   return true;
 }
 
@@ -66,27 +162,75 @@ bool H264BitReader::UpdateCurrByte() {
 // (|num_bits| - 1).
 bool H264BitReader::ReadBits(int num_bits, int* out) {
   int bits_left = num_bits;
-  *out = 0;
+  int value = 0;
   DCHECK(num_bits <= 31);
 
   while (num_remaining_bits_in_curr_byte_ < bits_left) {
     // Take all that's left in current byte, shift to make space for the rest.
-    *out |= (curr_byte_ << (bits_left - num_remaining_bits_in_curr_byte_));
+    value |= (curr_byte_ << (bits_left - num_remaining_bits_in_curr_byte_));
     bits_left -= num_remaining_bits_in_curr_byte_;
 
-    if (!UpdateCurrByte())
+    // Take the whole bytes needed before the last one at once, when there is
+    // no emulation prevention byte to skip among them.
+    if (bits_left > 8) {
+      const uint8_t* const data = data_;
+      const off_t plain_bytes =
+          std::min<off_t>((bits_left - 1) / 8, plain_data_end_ - data);
+      if (plain_bytes > 0) {
+        int bytes_value = 0;
+        for (off_t i = 0; i < plain_bytes; ++i)
+          bytes_value = (bytes_value << 8) | data[i];
+        bits_left -= plain_bytes * 8;
+        value |= bytes_value << bits_left;
+        data_ = data + plain_bytes;
+        bytes_left_ -= plain_bytes;
+        // As if the last byte was loaded into |curr_byte_| and all taken.
+        curr_byte_ = data[plain_bytes - 1];
+        num_remaining_bits_in_curr_byte_ = 8;
+      }
+    }
+
+    if (!UpdateCurrByte()) {
+      *out = value;
       return false;
+    }
   }
 
-  *out |= (curr_byte_ >> (num_remaining_bits_in_curr_byte_ - bits_left));
-  *out &= ((1u << num_bits) - 1u);
+  value |= (curr_byte_ >> (num_remaining_bits_in_curr_byte_ - bits_left));
+  *out = value & ((1u << num_bits) - 1u);
   num_remaining_bits_in_curr_byte_ -= bits_left;
 
   return true;
 }
 
+bool H264BitReader::ReadLeadingZeroBits(int* num_zero_bits) {
+  *num_zero_bits = 0;
+  while (true) {
+    if (num_remaining_bits_in_curr_byte_ == 0 && !UpdateCurrByte())
+      return false;
+
+    const int bits =
+        curr_byte_ & ((1 << num_remaining_bits_in_curr_byte_) - 1);
+    if (bits != 0) {
+      // Take the zero bits before the most significant one bit, and that bit.
+      const int one_bit_position = base::bits::Log2Floor(bits);
+      *num_zero_bits += num_remaining_bits_in_curr_byte_ - 1 - one_bit_position;
+      num_remaining_bits_in_curr_byte_ = one_bit_position;
+      return true;
+    }
+
+    *num_zero_bits += num_remaining_bits_in_curr_byte_;
+    num_remaining_bits_in_curr_byte_ = 0;
+  }
+}
+
 off_t H264BitReader::NumBitsLeft() {
-  return (num_remaining_bits_in_curr_byte_ + bytes_left_ * 8);
+  // Emulation prevention bytes which were not skipped yet are counted, like
+  // the bytes of the stream which are not in a chunk yet.
+  const off_t bytes_left = bytes_left_ +
+                           NumEmulationPreventionBytesLeftInChunk() +
+                           stream_bytes_left_;
+  return (num_remaining_bits_in_curr_byte_ + bytes_left * 8);
 }
 
 bool H264BitReader::HasMoreRBSPData() {
@@ -105,13 +249,22 @@ bool H264BitReader::HasMoreRBSPData() {
   // While the spec disallows it (7.4.1: "The last byte of the NAL unit shall
   // not be equal to 0x00"), some streams have trailing null bytes anyway. We
   // don't handle emulation prevention sequences because HasMoreRBSPData() is
-  // not used when parsing slices (where cabac_zero_word elements are legal).
+  // not used when parsing slices (where cabac_zero_word elements are legal),
+  // so an emulation prevention byte left in the chunk is other data.
+  if (NumEmulationPreventionBytesLeftInChunk() > 0)
+    return true;
   for (off_t i = 0; i < bytes_left_; i++) {
     if (data_[i] != 0)
       return true;
   }
+  for (off_t i = 0; i < stream_bytes_left_; i++) {
+    if (stream_[i] != 0)
+      return true;
+  }
 
   bytes_left_ = 0;
+  plain_data_end_ = data_;
+  stream_bytes_left_ = 0;
   return false;
 }
 
@@ -11,6 +11,8 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <vector>
+
 #include "base/macros.h"
 #include "media/base/media_export.h"
 
@@ -39,6 +41,12 @@ class MEDIA_EXPORT H264BitReader {
   // bits in the stream), true otherwise.
   bool ReadBits(int num_bits, int* out);
 
+  // Read the zero bits up to the next one bit, and that one bit, from the
+  // stream, and return the number of zero bits in |*num_zero_bits|. This is
+  // the prefix of an exp-Golomb code, see 9.1 in spec.
+  // Return false if there is no one bit left in the stream.
+  bool ReadLeadingZeroBits(int* num_zero_bits);
+
   // Return the number of bits left in the stream.
   off_t NumBitsLeft();
 
@@ -49,16 +57,68 @@ class MEDIA_EXPORT H264BitReader {
   size_t NumEmulationPreventionBytesRead();
 
  private:
+  // Size of the chunks of the stream which are stripped of their emulation
+  // prevention bytes at once.
+  static constexpr off_t kRBSPChunkSize = 64;
+
   // Advance to the next byte, loading it into curr_byte_.
   // Return false on end of stream.
-  bool UpdateCurrByte();
+  bool UpdateCurrByte() {
+    if (data_ == plain_data_end_ && !UpdatePlainData())
+      return false;
+    curr_byte_ = *data_++;
+    --bytes_left_;
+    num_remaining_bits_in_curr_byte_ = 8;
+    return true;
+  }
+
+  // Skip the emulation prevention bytes in front of data_, loading the next
+  // chunk if needed, and update plain_data_end_.
+  // Return false on end of stream.
+  bool UpdatePlainData();
 
-  // Pointer to the next unread (not in curr_byte_) byte in the stream.
+  // Strip the emulation prevention bytes of the next chunk of the stream, and
+  // make it the chunk that data_ points into.
+  // Return false on end of stream.
+  bool LoadNextChunk();
+
+  // Number of emulation prevention bytes in the current chunk which were not
+  // read yet.
+  size_t NumEmulationPreventionBytesLeftInChunk() const {
+    return emulation_prevention_byte_positions_.size() -
+           num_emulation_prevention_bytes_read_in_chunk_;
+  }
+
+  // Pointer to the next unread (not in curr_byte_) byte in the current chunk.
+  // The chunk is read in place from the stream when it has no emulation
+  // prevention bytes, and from rbsp_chunk_ otherwise.
   const uint8_t* data_;
 
-  // Bytes left in the stream (without the curr_byte_).
+  // Bytes left in the current chunk (without the curr_byte_).
   off_t bytes_left_;
 
+  // End of the bytes from data_ which can be loaded without skipping an
+  // emulation prevention byte or loading the next chunk.
+  const uint8_t* plain_data_end_;
+
+  // Pointer to the first byte of the stream that is not in a chunk yet, and
+  // number of bytes left from it.
+  const uint8_t* stream_;
+  off_t stream_bytes_left_;
+
+  // Number of zero bytes, up to two, right before stream_ and after the last
+  // emulation prevention byte, which may start an emulation prevention
+  // sequence ending in the next chunk.
+  int stream_zero_bytes_;
+
+  // Contents of the current chunk without its emulation prevention bytes.
+  uint8_t rbsp_chunk_[kRBSPChunkSize];
+
+  // Positions in the current chunk of the bytes which followed an emulation
+  // prevention byte in the stream, and number of them which were read.
+  std::vector<const uint8_t*> emulation_prevention_byte_positions_;
+  size_t num_emulation_prevention_bytes_read_in_chunk_;
+
   // Contents of the current byte; first unread bit starting at position
   // 8 - num_remaining_bits_in_curr_byte_ from MSB.
   int curr_byte_;
@@ -66,10 +126,6 @@ class MEDIA_EXPORT H264BitReader {
   // Number of bits remaining in curr_byte_
   int num_remaining_bits_in_curr_byte_;
 
-  // Used in emulation prevention three byte detection (see spec).
-  // Initially set to 0xffff to accept all initial two-byte sequences.
-  int prev_two_bytes_;
-
   // Number of emulation preventation bytes (0x000003) we met.
   size_t emulation_prevention_bytes_;
 
@@ -3,10 +3,77 @@
 // found in the LICENSE file.
 
 #include "media/video/h264_bit_reader.h"
+
+#include <stdint.h>
+
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace media {
 
+namespace {
+
+// Reads the bits of a stream after removing all of its emulation prevention
+// bytes up front, as a reference for H264BitReader.
+class ReferenceBitReader {
+ public:
+  ReferenceBitReader(const uint8_t* data, size_t size) {
+    int zero_bytes = 0;
+    for (size_t i = 0; i < size; ++i) {
+      if (data[i] == 0x03 && zero_bytes >= 2) {
+        ++emulation_prevention_bytes_;
+        zero_bytes = 0;
+        continue;
+      }
+      zero_bytes = data[i] == 0x00 ? zero_bytes + 1 : 0;
+      rbsp_.push_back(data[i]);
+    }
+  }
+
+  bool ReadBit(int* out) {
+    if (bit_position_ >= rbsp_.size() * 8)
+      return false;
+    *out = (rbsp_[bit_position_ / 8] >> (7 - bit_position_ % 8)) & 1;
+    ++bit_position_;
+    return true;
+  }
+
+  bool ReadBits(int num_bits, int* out) {
+    *out = 0;
+    for (int i = 0; i < num_bits; ++i) {
+      int bit;
+      if (!ReadBit(&bit))
+        return false;
+      *out = (*out << 1) | bit;
+    }
+    return true;
+  }
+
+  size_t emulation_prevention_bytes() const {
+    return emulation_prevention_bytes_;
+  }
+
+ private:
+  std::vector<uint8_t> rbsp_;
+  size_t bit_position_ = 0;
+  size_t emulation_prevention_bytes_ = 0;
+};
+
+// Returns |size| pseudo-random bytes with many zero bytes and emulation
+// prevention bytes.
+std::vector<uint8_t> CreateStream(uint32_t* seed, size_t size) {
+  std::vector<uint8_t> data(size);
+  for (uint8_t& byte : data) {
+    *seed = *seed * 1103515245 + 12345;
+    const uint32_t r = *seed >> 16;
+    byte = r % 8 < 3 ? 0x00 : (r % 8 == 7 ? 0x03 : r >> 8);
+  }
+  return data;
+}
+
+}  // namespace
+
 TEST(H264BitReaderTest, ReadStreamWithoutEscapeAndTrailingZeroBytes) {
   H264BitReader reader;
   const unsigned char rbsp[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xa0};
@@ -70,4 +137,85 @@ TEST(H264BitReaderTest, StopBitOccupyFullByte) {
   EXPECT_FALSE(reader.HasMoreRBSPData());
 }
 
+TEST(H264BitReaderTest, ReadLeadingZeroBits) {
+  H264BitReader reader;
+  // 1, 0001, twelve zero bits and 1, then six zero bits.
+  const unsigned char rbsp[] = {0x88, 0x00, 0x40};
+  int num_zero_bits = -1;
+
+  EXPECT_TRUE(reader.Initialize(rbsp, sizeof(rbsp)));
+  EXPECT_TRUE(reader.ReadLeadingZeroBits(&num_zero_bits));
+  EXPECT_EQ(num_zero_bits, 0);
+  EXPECT_EQ(reader.NumBitsLeft(), 23);
+  EXPECT_TRUE(reader.ReadLeadingZeroBits(&num_zero_bits));
+  EXPECT_EQ(num_zero_bits, 3);
+  EXPECT_EQ(reader.NumBitsLeft(), 19);
+  EXPECT_TRUE(reader.ReadLeadingZeroBits(&num_zero_bits));
+  EXPECT_EQ(num_zero_bits, 12);
+  EXPECT_EQ(reader.NumBitsLeft(), 6);
+  EXPECT_FALSE(reader.ReadLeadingZeroBits(&num_zero_bits));
+}
+
+TEST(H264BitReaderTest, EmulationPreventionBytesAcrossChunks) {
+  // Emulation prevention bytes at and around every position of a few chunks
+  // of the reader, including the last byte of the stream.
+  for (size_t position = 2; position < 200; ++position) {
+    SCOPED_TRACE(position);
+    std::vector<uint8_t> data(position + 1 + position % 3, 0x55);
+    data[position - 2] = 0x00;
+    data[position - 1] = 0x00;
+    data[position] = 0x03;
+
+    ReferenceBitReader reference(data.data(), data.size());
+    H264BitReader reader;
+    ASSERT_TRUE(reader.Initialize(data.data(), data.size()));
+    int value;
+    int expected_value;
+    while (reference.ReadBits(8, &expected_value)) {
+      ASSERT_TRUE(reader.ReadBits(8, &value));
+      EXPECT_EQ(value, expected_value);
+    }
+    EXPECT_FALSE(reader.ReadBits(8, &value));
+    EXPECT_EQ(reader.NumEmulationPreventionBytesRead(), 1u);
+  }
+}
+
+// Reads random streams with reads of random sizes, and checks that they read
+// the same bits as the reference reader.
+TEST(H264BitReaderTest, MatchesReferenceReader) {
+  uint32_t seed = 1;
+  for (int i = 0; i < 2000; ++i) {
+    const std::vector<uint8_t> data = CreateStream(&seed, 1 + i % 300);
+    ReferenceBitReader reference(data.data(), data.size());
+    H264BitReader reader;
+    ASSERT_TRUE(reader.Initialize(data.data(), data.size()));
+
+    while (true) {
+      seed = seed * 1103515245 + 12345;
+      const uint32_t r = seed >> 16;
+      bool result;
+      int value;
+      int expected_value;
+      if (r % 4 == 0) {
+        result = reader.ReadLeadingZeroBits(&value);
+        int bit = 0;
+        bool expected_result;
+        expected_value = 0;
+        while ((expected_result = reference.ReadBit(&bit)) && bit == 0)
+          ++expected_value;
+        ASSERT_EQ(result, expected_result);
+      } else {
+        const int num_bits = 1 + (r >> 2) % 31;
+        result = reader.ReadBits(num_bits, &value);
+        ASSERT_EQ(result, reference.ReadBits(num_bits, &expected_value));
+      }
+      if (!result)
+        break;
+      ASSERT_EQ(value, expected_value);
+    }
+    EXPECT_EQ(reader.NumEmulationPreventionBytesRead(),
+              reference.emulation_prevention_bytes());
+  }
+}
+
 }  // namespace media
@@ -12,10 +12,15 @@
 #include "base/logging.h"
 #include "base/notreached.h"
 #include "base/numerics/safe_math.h"
+#include "build/build_config.h"
 #include "media/base/subsample_entry.h"
 #include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/geometry/size.h"
 
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
 namespace media {
 
 namespace {
@@ -366,6 +371,32 @@ static inline bool IsStartCode(const uint8_t* data) {
   return data[0] == 0x00 && data[1] == 0x00 && data[2] == 0x01;
 }
 
+#if defined(ARCH_CPU_X86_FAMILY)
+// Returns the number of bytes at the beginning of |data| where no start code
+// can begin, skipping them 32 at a time as long as there are no two zero bytes
+// in a row. The last two bytes of |data| are never skipped, so that the end of
+// the search is the same as without skipping.
+static off_t SkipBytesWithoutStartCode(const uint8_t* data, off_t data_size) {
+  const __m128i zero = _mm_setzero_si128();
+  off_t skipped = 0;
+  for (; skipped + 34 <= data_size; skipped += 32) {
+    const __m128i low =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + skipped));
+    const __m128i high =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + skipped + 16));
+    // Bit i is set when byte i of the block is zero.
+    const uint32_t zeros =
+        static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(low, zero))) |
+        (static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(high, zero)))
+         << 16);
+    // A zero last byte may be followed by a zero in the next block.
+    if (zeros & ((zeros >> 1) | 0x80000000u))
+      break;
+  }
+  return skipped;
+}
+#endif
+
 // static
 bool H264Parser::FindStartCode(const uint8_t* data,
                                off_t data_size,
@@ -375,6 +406,14 @@ bool H264Parser::FindStartCode(const uint8_t* data,
   off_t bytes_left = data_size;
 
   while (bytes_left >= 3) {
+#if defined(ARCH_CPU_X86_FAMILY)
+    // Most of the data is slice data, where two zero bytes in a row are rare
+    // thanks to emulation prevention.
+    const off_t skipped = SkipBytesWithoutStartCode(data, bytes_left);
+    data += skipped;
+    bytes_left -= skipped;
+#endif
+
     // The start code is "\0\0\1", ones are more unusual than zeroes, so let's
     // search for it first.
     const uint8_t* tmp =
@@ -548,15 +587,15 @@ bool H264Parser::ParseNALUs(const uint8_t* stream,
 }
 
 H264Parser::Result H264Parser::ReadUE(int* val) {
-  int num_bits = -1;
-  int bit;
+  int num_bits;
   int rest;
 
   // Count the number of contiguous zero bits.
-  do {
-    READ_BITS_OR_RETURN(1, &bit);
-    num_bits++;
-  } while (bit == 0);
+  if (!br_.ReadLeadingZeroBits(&num_bits)) {
+    DVLOG(1) << "Error in stream: unexpected EOS while trying to read "
+                "exp-Golomb code";
+    return kInvalidStream;
+  }
 
   if (num_bits > 31)
     return kInvalidStream;
@@ -1424,12 +1463,11 @@ H264Parser::Result H264Parser::ParseDecRefPicMarking(H264SliceHeader* shdr) {
   return kOk;
 }
 
-H264Parser::Result H264Parser::ParseSliceHeader(const H264NALU& nalu,
-                                                H264SliceHeader* shdr) {
+H264Parser::Result H264Parser::ParsePartialSliceHeader(const H264NALU& nalu,
+                                                       H264SliceHeader* shdr) {
   // See 7.4.3.
   const H264SPS* sps;
   const H264PPS* pps;
-  Result res;
 
   memset(shdr, 0, sizeof(*shdr));
 
@@ -1455,6 +1493,18 @@ H264Parser::Result H264Parser::ParseSliceHeader(const H264NALU& nalu,
     return kUnsupportedStream;
   }
 
+  return kOk;
+}
+
+H264Parser::Result H264Parser::ParseSliceHeader(const H264NALU& nalu,
+                                                H264SliceHeader* shdr) {
+  Result res = ParsePartialSliceHeader(nalu, shdr);
+  if (res != kOk)
+    return res;
+
+  const H264PPS* pps = GetPPS(shdr->pic_parameter_set_id);
+  const H264SPS* sps = GetSPS(pps->seq_parameter_set_id);
+
   READ_BITS_OR_RETURN(sps->log2_max_frame_num_minus4 + 4, &shdr->frame_num);
   if (!sps->frame_mbs_only_flag) {
     READ_BOOL_OR_RETURN(&shdr->field_pic_flag);
@@ -491,6 +491,13 @@ class MEDIA_EXPORT H264Parser {
   // the NALU returned from AdvanceToNextNALU() and corresponding to |*shdr|.
   Result ParseSliceHeader(const H264NALU& nalu, H264SliceHeader* shdr);
 
+  // Parse only the first fields of a slice header, up to and including
+  // |pic_parameter_set_id|, and check that the PPS and SPS it refers to are
+  // present and supported. The other fields of |*shdr| are zeroed. This is
+  // much cheaper than ParseSliceHeader() for callers which only need the NALU
+  // type, keyframe-ness and parameter sets of slices, such as stream parsers.
+  Result ParsePartialSliceHeader(const H264NALU& nalu, H264SliceHeader* shdr);
+
   // Parse a SEI message, returning it in |*sei_msg|, provided and managed
   // by the caller.
   Result ParseSEI(H264SEIMessage* sei_msg);
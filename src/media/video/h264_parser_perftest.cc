@@ -0,0 +1,140 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/files/memory_mapped_file.h"
+#include "base/time/time.h"
+#include "media/base/test_data_util.h"
+#include "media/video/h264_parser.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace media {
+
+// Number of times the test stream is parsed by each benchmark.
+static const int kIterations = 200;
+
+enum class SliceParsing {
+  kNone,
+  kPartial,
+  kFull,
+};
+
+struct H264ParserPerfTestParam {
+  const char* story;
+  SliceParsing slice_parsing;
+};
+
+class H264ParserPerfTest
+    : public testing::TestWithParam<H264ParserPerfTestParam> {};
+
+// Parses the NALUs of a stream like a stream parser or a decoder would, with
+// the slice headers parsed as requested by the test parameter.
+TEST_P(H264ParserPerfTest, ParseStream) {
+  base::MemoryMappedFile stream;
+  ASSERT_TRUE(stream.Initialize(GetTestDataFilePath("test-25fps.h264")));
+
+  int num_slices = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    H264Parser parser;
+    parser.SetStream(stream.data(), stream.length());
+    while (true) {
+      H264NALU nalu;
+      H264Parser::Result res = parser.AdvanceToNextNALU(&nalu);
+      if (res == H264Parser::kEOStream)
+        break;
+      ASSERT_EQ(res, H264Parser::kOk);
+
+      int id;
+      H264SliceHeader shdr;
+      switch (nalu.nal_unit_type) {
+        case H264NALU::kIDRSlice:
+        case H264NALU::kNonIDRSlice:
+          if (GetParam().slice_parsing == SliceParsing::kPartial) {
+            ASSERT_EQ(parser.ParsePartialSliceHeader(nalu, &shdr),
+                      H264Parser::kOk);
+          } else if (GetParam().slice_parsing == SliceParsing::kFull) {
+            ASSERT_EQ(parser.ParseSliceHeader(nalu, &shdr), H264Parser::kOk);
+          }
+          ++num_slices;
+          break;
+        case H264NALU::kSPS:
+          ASSERT_EQ(parser.ParseSPS(&id), H264Parser::kOk);
+          break;
+        case H264NALU::kPPS:
+          ASSERT_EQ(parser.ParsePPS(&id), H264Parser::kOk);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  base::TimeDelta total_time = base::TimeTicks::Now() - start;
+  EXPECT_GT(num_slices, 0);
+
+  perf_test::PerfResultReporter reporter("h264_parser", GetParam().story);
+  reporter.RegisterImportantMetric("_throughput", "MB/s");
+  reporter.RegisterImportantMetric("_slice_time", "us");
+  reporter.AddResult("_throughput", stream.length() * kIterations /
+                                        total_time.InSecondsF() / 1e6);
+  reporter.AddResult("_slice_time",
+                     total_time.InMicrosecondsF() / num_slices);
+}
+
+static const H264ParserPerfTestParam kPerfTestParams[] = {
+    {"nalus", SliceParsing::kNone},
+    {"partial_slice_headers", SliceParsing::kPartial},
+    {"slice_headers", SliceParsing::kFull},
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         H264ParserPerfTest,
+                         testing::ValuesIn(kPerfTestParams));
+
+// Searches for the start codes of a large stream of slice data, where they
+// are far apart.
+TEST(H264StartCodePerfTest, FindStartCodeInSliceData) {
+  // 4 MB of slice data, with a start code every 64 KB and a few zero bytes
+  // which do not start a start code.
+  std::vector<uint8_t> data(4 * 1024 * 1024);
+  uint32_t seed = 1;
+  for (size_t i = 0; i < data.size(); ++i) {
+    seed = seed * 1103515245 + 12345;
+    data[i] = i % 997 == 0 ? 0 : (seed >> 16) | 4;
+  }
+  for (size_t i = 0; i + 3 < data.size(); i += 64 * 1024) {
+    data[i] = 0;
+    data[i + 1] = 0;
+    data[i + 2] = 1;
+  }
+
+  int num_start_codes = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations / 10; ++i) {
+    const uint8_t* ptr = data.data();
+    off_t bytes_left = data.size();
+    off_t offset;
+    off_t start_code_size;
+    while (H264Parser::FindStartCode(ptr, bytes_left, &offset,
+                                     &start_code_size)) {
+      ptr += offset + start_code_size;
+      bytes_left -= offset + start_code_size;
+      ++num_start_codes;
+    }
+  }
+  base::TimeDelta total_time = base::TimeTicks::Now() - start;
+  EXPECT_GT(num_start_codes, 0);
+
+  perf_test::PerfResultReporter reporter("h264_parser", "slice_data");
+  reporter.RegisterImportantMetric("_find_start_code_throughput", "MB/s");
+  reporter.AddResult(
+      "_find_start_code_throughput",
+      data.size() * (kIterations / 10) / total_time.InSecondsF() / 1e6);
+}
+
+}  // namespace media
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <vector>
@@ -169,6 +170,116 @@ TEST(H264ParserTest, ParseNALUsFromStreamFile) {
   ASSERT_EQ(num_nalus, nalus.size());
 }
 
+// Parses the slice headers of the test stream both partially and fully, and
+// checks that they agree on the fields of the partial header.
+TEST(H264ParserTest, ParsePartialSliceHeader) {
+  base::FilePath file_path = GetTestDataFilePath("test-25fps.h264");
+
+  base::MemoryMappedFile stream;
+  ASSERT_TRUE(stream.Initialize(file_path))
+      << "Couldn't open stream file: " << file_path.MaybeAsASCII();
+
+  H264Parser parser;
+  parser.SetStream(stream.data(), stream.length());
+  H264Parser partial_parser;
+  partial_parser.SetStream(stream.data(), stream.length());
+
+  int num_slices = 0;
+  while (true) {
+    H264NALU nalu;
+    H264NALU partial_nalu;
+    H264Parser::Result res = parser.AdvanceToNextNALU(&nalu);
+    ASSERT_EQ(res, partial_parser.AdvanceToNextNALU(&partial_nalu));
+    if (res == H264Parser::kEOStream)
+      break;
+    ASSERT_EQ(res, H264Parser::kOk);
+    ASSERT_EQ(nalu.nal_unit_type, partial_nalu.nal_unit_type);
+
+    int id;
+    switch (nalu.nal_unit_type) {
+      case H264NALU::kIDRSlice:
+      case H264NALU::kNonIDRSlice: {
+        H264SliceHeader shdr;
+        H264SliceHeader partial_shdr;
+        ASSERT_EQ(parser.ParseSliceHeader(nalu, &shdr), H264Parser::kOk);
+        ASSERT_EQ(partial_parser.ParsePartialSliceHeader(partial_nalu,
+                                                         &partial_shdr),
+                  H264Parser::kOk);
+        EXPECT_EQ(shdr.idr_pic_flag, partial_shdr.idr_pic_flag);
+        EXPECT_EQ(shdr.nal_ref_idc, partial_shdr.nal_ref_idc);
+        EXPECT_EQ(shdr.first_mb_in_slice, partial_shdr.first_mb_in_slice);
+        EXPECT_EQ(shdr.slice_type, partial_shdr.slice_type);
+        EXPECT_EQ(shdr.pic_parameter_set_id,
+                  partial_shdr.pic_parameter_set_id);
+        EXPECT_EQ(0, partial_shdr.frame_num);
+        ++num_slices;
+        break;
+      }
+
+      case H264NALU::kSPS:
+        ASSERT_EQ(parser.ParseSPS(&id), H264Parser::kOk);
+        ASSERT_EQ(partial_parser.ParseSPS(&id), H264Parser::kOk);
+        break;
+
+      case H264NALU::kPPS:
+        ASSERT_EQ(parser.ParsePPS(&id), H264Parser::kOk);
+        ASSERT_EQ(partial_parser.ParsePPS(&id), H264Parser::kOk);
+        break;
+
+      default:
+        break;
+    }
+  }
+  EXPECT_GT(num_slices, 0);
+}
+
+// Returns the result of H264Parser::FindStartCode(), computed byte by byte.
+static bool FindStartCodeReference(const uint8_t* data,
+                                   off_t data_size,
+                                   off_t* offset,
+                                   off_t* start_code_size) {
+  for (off_t i = 0; i + 3 <= data_size; ++i) {
+    if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1) {
+      const bool four_bytes = i > 0 && data[i - 1] == 0;
+      *offset = four_bytes ? i - 1 : i;
+      *start_code_size = four_bytes ? 4 : 3;
+      return true;
+    }
+  }
+  *offset = std::max<off_t>(data_size - 2, 0);
+  *start_code_size = 0;
+  return false;
+}
+
+// Checks FindStartCode() on random data, with zero bytes and start codes at
+// every alignment.
+TEST(H264ParserTest, FindStartCodeMatchesReference) {
+  uint32_t seed = 1;
+  for (int i = 0; i < 20000; ++i) {
+    const size_t size = i % 200;
+    std::vector<uint8_t> data(size);
+    // Only a few zero bytes, like slice data, or many of them.
+    const uint32_t zero_byte_odds = i % 2 ? 64 : 4;
+    for (uint8_t& byte : data) {
+      seed = seed * 1103515245 + 12345;
+      const uint32_t r = seed >> 16;
+      byte = r % zero_byte_odds == 0 ? 0 : (r % 61 == 1 ? 1 : r >> 8);
+    }
+
+    off_t offset = -1;
+    off_t start_code_size = -1;
+    off_t expected_offset = -1;
+    off_t expected_start_code_size = -1;
+    const bool found = H264Parser::FindStartCode(data.data(), data.size(),
+                                                 &offset, &start_code_size);
+    ASSERT_EQ(found, FindStartCodeReference(data.data(), data.size(),
+                                            &expected_offset,
+                                            &expected_start_code_size));
+    ASSERT_EQ(offset, expected_offset);
+    ASSERT_EQ(start_code_size, expected_start_code_size);
+  }
+}
+
 // Verify that GetCurrentSubsamples works.
 TEST(H264ParserTest, GetCurrentSubsamplesNormal) {
   const uint8_t kStream[] = {
@@ -271,12 +271,12 @@ bool H265SliceHeader::IsBSlice() const {
 
 H265Parser::Result H265Parser::ReadUE(int* val) {
   // Count the number of contiguous zero bits.
-  int bit;
-  int num_bits = -1;
-  do {
-    READ_BITS_OR_RETURN(1, &bit);
-    num_bits++;
-  } while (bit == 0);
+  int num_bits;
+  if (!br_.ReadLeadingZeroBits(&num_bits)) {
+    DVLOG(1) << "Error in stream: unexpected EOS while trying to read "
+                "exp-Golomb code";
+    return kInvalidStream;
+  }
 
   if (num_bits > 31)
     return kInvalidStream;
@@ -194,6 +194,68 @@ EmptyFilesResult CreateEmptyFiles(
   return EmptyFilesResult(std::move(result), File::FILE_OK, free_disk_space);
 }
 
+// Writes the items evicted to a page file. Items are usually much smaller than
+// the page file, so they are coalesced into writes of |write_size| bytes
+// instead of costing a system call each. Data large enough to fill whole
+// writes on its own is written straight from the item, so that every write
+// but the last one starts at a multiple of |write_size|.
+class PageFileWriter {
+ public:
+  PageFileWriter(File* file, size_t write_size, size_t total_size)
+      : file_(file), write_size_(write_size) {
+    DCHECK_NE(0u, write_size_);
+    buffer_.reserve(std::min(write_size_, total_size));
+  }
+
+  // Returns false if writing to the file failed.
+  bool Append(base::span<const uint8_t> data) {
+    while (!data.empty()) {
+      if (buffer_.empty() && data.size() >= write_size_) {
+        const size_t aligned_size = data.size() - data.size() % write_size_;
+        if (!Write(data.first(aligned_size)))
+          return false;
+        data = data.subspan(aligned_size);
+        continue;
+      }
+      const size_t length = std::min(write_size_ - buffer_.size(), data.size());
+      buffer_.insert(buffer_.end(), data.begin(), data.begin() + length);
+      data = data.subspan(length);
+      if (buffer_.size() == write_size_ && !Flush())
+        return false;
+    }
+    return true;
+  }
+
+  // Writes the data buffered by Append().
+  bool Flush() {
+    if (buffer_.empty())
+      return true;
+    const bool result = Write(buffer_);
+    buffer_.clear();
+    return result;
+  }
+
+ private:
+  bool Write(base::span<const uint8_t> data) {
+    while (!data.empty()) {
+      const int bytes_written =
+          file_->WriteAtCurrentPos(reinterpret_cast<const char*>(data.data()),
+                                   base::saturated_cast<int>(data.size()));
+      if (bytes_written < 0)
+        return false;
+      DCHECK_LE(static_cast<size_t>(bytes_written), data.size());
+      data = data.subspan(bytes_written);
+    }
+    return true;
+  }
+
+  File* const file_;
+  const size_t write_size_;
+  std::vector<uint8_t> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(PageFileWriter);
+};
+
 // Used to evict multiple memory items out to a single file. Caller must
 // populate file reference in returned FileCreationInfo. Also returns the free
 // disk space AFTER creating this file.
@@ -203,7 +265,8 @@ std::pair<FileCreationInfo, int64_t> CreateFileAndWriteItems(
     const FilePath& file_path,
     scoped_refptr<base::TaskRunner> file_task_runner,
     std::vector<base::span<const uint8_t>> data,
-    size_t total_size_bytes) {
+    size_t total_size_bytes,
+    size_t page_file_write_size) {
   DCHECK_NE(0u, total_size_bytes);
   UMA_HISTOGRAM_MEMORY_KB("Storage.Blob.PageFileSize", total_size_bytes / 1024);
   base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
@@ -237,22 +300,15 @@ std::pair<FileCreationInfo, int64_t> CreateFileAndWriteItems(
 
   // Write data.
   file.SetLength(total_size_bytes);
-  int bytes_written = 0;
+  PageFileWriter writer(&file, page_file_write_size, total_size_bytes);
+  bool write_succeeded = true;
   for (const auto& item : data) {
-    size_t length = item.size();
-    size_t bytes_left = length;
-    while (bytes_left > 0) {
-      bytes_written = file.WriteAtCurrentPos(
-          reinterpret_cast<const char*>(item.data() + (length - bytes_left)),
-          base::saturated_cast<int>(bytes_left));
-      if (bytes_written < 0)
-        break;
-      DCHECK_LE(static_cast<size_t>(bytes_written), bytes_left);
-      bytes_left -= bytes_written;
-    }
-    if (bytes_written < 0)
+    write_succeeded = writer.Append(item);
+    if (!write_succeeded)
       break;
   }
+  if (write_succeeded)
+    write_succeeded = writer.Flush();
   if (!file.Flush()) {
     file.Close();
     base::DeleteFile(file_path);
@@ -263,7 +319,7 @@ std::pair<FileCreationInfo, int64_t> CreateFileAndWriteItems(
   File::Info info;
   bool success = file.GetInfo(&info);
   creation_info.error =
-      bytes_written < 0 || !success ? File::FILE_ERROR_FAILED : File::FILE_OK;
+      !write_succeeded || !success ? File::FILE_ERROR_FAILED : File::FILE_OK;
   creation_info.last_modified = info.last_modified;
   return std::make_pair(std::move(creation_info), disk_availability);
 }
@@ -977,7 +1033,7 @@ void BlobMemoryController::MaybeScheduleEvictionUntilSystemHealthy(
         base::BindOnce(&CreateFileAndWriteItems, blob_storage_dir_,
                        disk_space_function_, std::move(page_file_path),
                        file_runner_, std::move(data_for_paging),
-                       total_items_size),
+                       total_items_size, limits_.page_file_write_size),
         base::BindOnce(&BlobMemoryController::OnEvictionComplete,
                        weak_factory_.GetWeakPtr(), std::move(file_reference),
                        std::move(items_to_swap), total_items_size, reason,
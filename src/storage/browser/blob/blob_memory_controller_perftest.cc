@@ -0,0 +1,133 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback_helpers.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/task/thread_pool.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "storage/browser/blob/blob_data_builder.h"
+#include "storage/browser/blob/blob_data_item.h"
+#include "storage/browser/blob/blob_memory_controller.h"
+#include "storage/browser/blob/shareable_blob_data_item.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace storage {
+namespace {
+
+// Amount of blob data in memory when the memory pressure signal arrives.
+constexpr size_t kBlobMemorySize = 128 * 1024 * 1024;
+
+struct BlobMemoryControllerPerfTestParam {
+  const char* story;
+  // Size of the items of the blobs, which are all paged to disk.
+  size_t item_size;
+  // Size of the writes the items are coalesced into.
+  size_t page_file_write_size;
+};
+
+class BlobMemoryControllerPerfTest
+    : public testing::TestWithParam<BlobMemoryControllerPerfTestParam> {
+ public:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+ protected:
+  BlobStorageLimits GetLimits() const {
+    BlobStorageLimits limits;
+    // Leave room for all the blobs, so that they are only paged out on memory
+    // pressure.
+    limits.max_blob_in_memory_space = 2 * kBlobMemorySize;
+    limits.desired_max_disk_space = 2 * kBlobMemorySize;
+    limits.effective_max_disk_space = 2 * kBlobMemorySize;
+    limits.page_file_write_size = GetParam().page_file_write_size;
+    return limits;
+  }
+
+  // Creates blobs of a single item until they fill |kBlobMemorySize|, like
+  // many small fetch() or Blob() calls do.
+  std::vector<scoped_refptr<ShareableBlobDataItem>> CreatePopulatedItems(
+      BlobMemoryController* controller) {
+    const std::string data(GetParam().item_size, 'x');
+    std::vector<scoped_refptr<ShareableBlobDataItem>> items;
+    for (size_t size = 0; size + data.size() <= kBlobMemorySize;
+         size += data.size()) {
+      BlobDataBuilder builder("blob");
+      builder.AppendData(data);
+      std::vector<scoped_refptr<ShareableBlobDataItem>> blob_items = {
+          base::MakeRefCounted<ShareableBlobDataItem>(
+              builder.items()[0]->item(), ShareableBlobDataItem::QUOTA_NEEDED)};
+      controller->ReserveMemoryQuota(blob_items, base::DoNothing());
+      blob_items[0]->set_state(ShareableBlobDataItem::POPULATED_WITH_QUOTA);
+      items.push_back(std::move(blob_items[0]));
+    }
+    controller->NotifyMemoryItemsUsed(items);
+    return items;
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+};
+
+// Pages all the blobs out on a memory pressure signal, on the thread pool like
+// the browser does.
+TEST_P(BlobMemoryControllerPerfTest, PageOutUnderMemoryPressure) {
+  BlobMemoryController controller(
+      temp_dir_.GetPath(),
+      base::ThreadPool::CreateTaskRunner(
+          {base::MayBlock(), base::TaskPriority::USER_VISIBLE}));
+  controller.set_limits_for_testing(GetLimits());
+  std::vector<scoped_refptr<ShareableBlobDataItem>> items =
+      CreatePopulatedItems(&controller);
+  const size_t memory_usage = controller.memory_usage();
+  ASSERT_EQ(0u, controller.disk_usage());
+
+  const base::TimeTicks start = base::TimeTicks::Now();
+  controller.OnMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  task_environment_.RunUntilIdle();
+  const base::TimeDelta total_time = base::TimeTicks::Now() - start;
+
+  const uint64_t bytes_paged = controller.disk_usage();
+  EXPECT_GT(bytes_paged, memory_usage / 2);
+  size_t items_paged = 0;
+  for (const auto& item : items) {
+    if (item->item()->type() == BlobDataItem::Type::kFile)
+      ++items_paged;
+  }
+
+  perf_test::PerfResultReporter reporter("blob_memory_controller",
+                                         GetParam().story);
+  reporter.RegisterImportantMetric("_paging_throughput", "MB/s");
+  reporter.RegisterImportantMetric("_time_per_item", "us");
+  reporter.AddResult("_paging_throughput",
+                     bytes_paged / total_time.InSecondsF() / (1024 * 1024));
+  reporter.AddResult("_time_per_item",
+                     total_time.InMicrosecondsF() / items_paged);
+}
+
+const BlobMemoryControllerPerfTestParam kPerfTestParams[] = {
+    // A write per item, like before items were coalesced.
+    {"1kb_items_unbatched", 1024, 1024},
+    {"1kb_items", 1024, kDefaultPageFileWriteSize},
+    {"16kb_items_unbatched", 16 * 1024, 16 * 1024},
+    {"16kb_items", 16 * 1024, kDefaultPageFileWriteSize},
+    {"1mb_items", 1024 * 1024, kDefaultPageFileWriteSize},
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         BlobMemoryControllerPerfTest,
+                         testing::ValuesIn(kPerfTestParams));
+
+}  // namespace
+}  // namespace storage
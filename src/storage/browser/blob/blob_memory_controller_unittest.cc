@@ -353,6 +353,70 @@ TEST_P(BlobMemoryControllerTest, PageToDisk) {
   EXPECT_EQ(0u, controller.disk_usage());
 }
 
+// Items which are smaller and larger than the page file writes are coalesced
+// and split, and still end up at their offsets in the page files.
+TEST_P(BlobMemoryControllerTest, PageToDiskCoalescesWrites) {
+  const std::string kId = "id";
+  const std::string kId2 = "id2";
+  const size_t kSmallItemSize = 3;
+  const size_t kLargeItemSize = 47;
+  BlobMemoryController controller(temp_dir_.GetPath(), file_runner_);
+  SetTestMemoryLimits(&controller);
+  BlobStorageLimits limits = controller.limits();
+  limits.page_file_write_size = 8;
+  controller.set_limits_for_testing(limits);
+  AssertEnoughDiskSpace();
+
+  // Alternate small and large items until they fill the memory quota.
+  BlobDataBuilder builder(kId);
+  std::vector<std::string> item_data;
+  size_t total_size = 0;
+  for (char c = 'a'; total_size < kTestBlobStorageMaxBlobMemorySize; ++c) {
+    const size_t size = item_data.size() % 2 ? kLargeItemSize : kSmallItemSize;
+    item_data.push_back(std::string(size, c));
+    builder.AppendFutureData(size).Populate(base::as_bytes(
+        base::make_span(item_data.back().data(), item_data.back().size())));
+    total_size += size;
+  }
+  ASSERT_EQ(kTestBlobStorageMaxBlobMemorySize, total_size);
+
+  std::vector<scoped_refptr<ShareableBlobDataItem>> items =
+      CreateSharedDataItems(builder);
+  controller.ReserveMemoryQuota(items, GetMemoryRequestCallback());
+  EXPECT_TRUE(memory_quota_result_);
+  memory_quota_result_ = false;
+
+  // Request more memory, which pages out the populated items.
+  BlobDataBuilder builder2(kId2);
+  builder2.AppendFutureData(kTestBlobStorageMinFileSizeBytes + 1);
+  std::vector<scoped_refptr<ShareableBlobDataItem>> items2 =
+      CreateSharedDataItems(builder2);
+  controller.ReserveMemoryQuota(items2, GetMemoryRequestCallback());
+  for (const auto& item : items)
+    item->set_state(ItemState::POPULATED_WITH_QUOTA);
+  controller.NotifyMemoryItemsUsed(items);
+
+  EXPECT_TRUE(file_runner_->HasPendingTask());
+  RunFileThreadTasks();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(memory_quota_result_);
+
+  size_t paged_items = 0;
+  base::ScopedAllowBlockingForTesting allow_blocking;
+  for (size_t i = 0; i < items.size(); ++i) {
+    const BlobDataItem& item = *items[i]->item();
+    if (item.type() != BlobDataItem::Type::kFile)
+      continue;
+    ++paged_items;
+    std::string file_contents;
+    ASSERT_TRUE(base::ReadFileToString(item.path(), &file_contents));
+    ASSERT_LE(item.offset() + item.length(), file_contents.size());
+    EXPECT_EQ(item_data[i],
+              file_contents.substr(item.offset(), item.length()));
+  }
+  EXPECT_GT(paged_items, 0u);
+}
+
 TEST_P(BlobMemoryControllerTest, NoDiskTooLarge) {
   BlobMemoryController controller(temp_dir_.GetPath(), nullptr);
   SetTestMemoryLimits(&controller);
@@ -11,14 +11,23 @@
 #include <limits>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback_helpers.h"
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
 #include "base/memory/ptr_util.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/task/post_task.h"
 #include "base/task/thread_pool.h"
 #include "base/time/time.h"
 #include "base/trace_event/trace_event.h"
+#include "build/build_config.h"
+#include "mojo/public/cpp/system/data_pipe_producer.h"
+#include "mojo/public/cpp/system/file_data_source.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 #include "storage/browser/blob/blob_data_handle.h"
@@ -28,9 +37,22 @@
 #include "storage/browser/file_system/file_system_url.h"
 #include "third_party/blink/public/common/blob/blob_utils.h"
 
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#endif
+
 namespace storage {
 namespace {
 
+// Maximum number of bytes of file items read ahead when a reader starts
+// streaming, so that prefetching a large blob doesn't evict the page cache.
+constexpr uint64_t kMaxPrefetchBytes = 16 * 1024 * 1024;
+
+// Maximum number of bytes of a local file item written to the data pipe of
+// BlobReader::ReadLocalFileItems at once, so that its progress is reported
+// while a large file is read.
+constexpr uint64_t kMaxLocalFileWriteBytes = 1024 * 1024;
+
 bool IsFileType(BlobDataItem::Type type) {
   switch (type) {
     case BlobDataItem::Type::kFile:
@@ -67,6 +89,107 @@ int ConvertBlobErrorToNetError(BlobStatus reason) {
   NOTREACHED();
   return net::ERR_FAILED;
 }
+
+// Reads [offset, offset + length) of a local file item for
+// BlobReader::ReadLocalFileItems, directly into the data pipe buffer handed out
+// by the DataPipeProducer. The file is opened on the first read, so that it is
+// only ever opened, read and closed on the blocking sequence of the producer.
+class LocalFileItemDataSource : public mojo::DataPipeProducer::DataSource {
+ public:
+  LocalFileItemDataSource(const base::FilePath& path,
+                          const base::Time& expected_modification_time,
+                          uint64_t offset,
+                          uint64_t length)
+      : path_(path),
+        expected_modification_time_(expected_modification_time),
+        offset_(offset),
+        length_(length) {}
+  ~LocalFileItemDataSource() override = default;
+
+ private:
+  // mojo::DataPipeProducer::DataSource:
+  uint64_t GetLength() const override { return length_; }
+
+  ReadResult Read(uint64_t offset, base::span<char> buffer) override {
+    ReadResult result;
+    if (!file_.IsValid()) {
+      result.result = OpenFile();
+      if (result.result != MOJO_RESULT_OK) {
+        file_.Close();
+        return result;
+      }
+    }
+    if (offset >= length_)
+      return result;
+
+    const int bytes_to_read = static_cast<int>(std::min<uint64_t>(
+        {buffer.size(), length_ - offset, std::numeric_limits<int>::max()}));
+    const int bytes_read =
+        file_.Read(offset_ + offset, buffer.data(), bytes_to_read);
+    if (bytes_read < 0) {
+      result.result = mojo::FileDataSource::ConvertFileErrorToMojoResult(
+          base::File::GetLastFileError());
+      return result;
+    }
+    result.bytes_read = bytes_read;
+    // The file ends before the item does, so it was truncated after it was
+    // opened.
+    if (bytes_read < bytes_to_read)
+      result.result = MOJO_RESULT_DATA_LOSS;
+    return result;
+  }
+
+  // A file modified since it was added to the blob is reported as data loss,
+  // which ConvertMojoResultToNetError() maps to ERR_UPLOAD_FILE_CHANGED, like
+  // FileStreamReader does.
+  MojoResult OpenFile() {
+    file_.Initialize(path_, base::File::FLAG_OPEN | base::File::FLAG_READ |
+                                base::File::FLAG_SEQUENTIAL_SCAN);
+    if (!file_.IsValid()) {
+      return mojo::FileDataSource::ConvertFileErrorToMojoResult(
+          file_.error_details());
+    }
+    base::File::Info file_info;
+    if (!file_.GetInfo(&file_info))
+      return MOJO_RESULT_UNKNOWN;
+    if (!FileStreamReader::VerifySnapshotTime(expected_modification_time_,
+                                              file_info)) {
+      return MOJO_RESULT_DATA_LOSS;
+    }
+    return MOJO_RESULT_OK;
+  }
+
+  const base::FilePath path_;
+  const base::Time expected_modification_time_;
+  const uint64_t offset_;
+  const uint64_t length_;
+  base::File file_;
+
+  DISALLOW_COPY_AND_ASSIGN(LocalFileItemDataSource);
+};
+
+int ConvertMojoResultToNetError(MojoResult result) {
+  switch (result) {
+    case MOJO_RESULT_OK:
+      return net::OK;
+    case MOJO_RESULT_NOT_FOUND:
+      return net::ERR_FILE_NOT_FOUND;
+    case MOJO_RESULT_PERMISSION_DENIED:
+      return net::ERR_ACCESS_DENIED;
+    case MOJO_RESULT_RESOURCE_EXHAUSTED:
+      return net::ERR_INSUFFICIENT_RESOURCES;
+    case MOJO_RESULT_DATA_LOSS:
+      return net::ERR_UPLOAD_FILE_CHANGED;
+    case MOJO_RESULT_FAILED_PRECONDITION:
+    case MOJO_RESULT_CANCELLED:
+    case MOJO_RESULT_ABORTED:
+      // The consumer closed the data pipe.
+      return net::ERR_ABORTED;
+    default:
+      return net::ERR_FAILED;
+  }
+}
+
 }  // namespace
 
 BlobReader::FileStreamReaderProvider::~FileStreamReaderProvider() = default;
@@ -228,6 +351,8 @@ BlobReader::Status BlobReader::Read(net::IOBuffer* buffer,
     return Status::DONE;
   }
 
+  PrefetchFileItems();
+
   // Keep track of the buffer.
   DCHECK(!read_buf_.get());
   read_buf_ = base::MakeRefCounted<net::DrainableIOBuffer>(buffer, dest_size);
@@ -263,9 +388,41 @@ void BlobReader::ReadSingleMojoDataItem(
                             remaining_bytes_, std::move(done));
 }
 
+bool BlobReader::IsLocalFileItemsOnly() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(total_size_calculated_);
+  // The files are read without the FileStreamReaders provided for testing.
+  if (!blob_data_.get() || file_stream_provider_for_testing_)
+    return false;
+  const auto& items = blob_data_->items();
+  for (size_t i = current_item_index_; i < items.size(); ++i) {
+    if (items[i]->type() != BlobDataItem::Type::kFile)
+      return false;
+  }
+  return true;
+}
+
+void BlobReader::ReadLocalFileItems(mojo::ScopedDataPipeProducerHandle producer,
+                                    ProgressCallback progress,
+                                    net::CompletionOnceCallback done) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(IsLocalFileItemsOnly());
+  DCHECK(read_callback_.is_null());
+  DCHECK(!local_file_producer_);
+
+  PrefetchFileItems();
+  local_file_producer_ =
+      std::make_unique<mojo::DataPipeProducer>(std::move(producer));
+  local_file_progress_callback_ = std::move(progress);
+  read_callback_ = std::move(done);
+  ReadNextLocalFileItem();
+}
+
 void BlobReader::Kill() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
+  // Destroying the producer cancels the pending write, if any.
+  local_file_producer_.reset();
   DeleteItemReaders();
   weak_factory_.InvalidateWeakPtrs();
 }
@@ -579,6 +736,7 @@ BlobReader::Status BlobReader::ReadFileItem(FileStreamReader* reader,
     TRACE_EVENT_NESTABLE_ASYNC_BEGIN1("Blob", "BlobReader::ReadFileItem",
                                       TRACE_ID_LOCAL(this), "uuid",
                                       blob_data_->uuid());
+    file_read_start_time_ = base::TimeTicks::Now();
     io_pending_ = true;
     return Status::IO_PENDING;
   }
@@ -590,9 +748,148 @@ void BlobReader::DidReadFile(int result) {
   TRACE_EVENT_NESTABLE_ASYNC_END1("Blob", "BlobReader::ReadFileItem",
                                   TRACE_ID_LOCAL(this), "uuid",
                                   blob_data_->uuid());
+  // This is the latency of the async reads of all file items, local and file
+  // system ones alike. Blobs paged to disk by BlobMemoryController are only
+  // some of them.
+  UMA_HISTOGRAM_TIMES("Storage.Blob.AsyncFileItemReadTime",
+                      base::TimeTicks::Now() - file_read_start_time_);
   DidReadItem(result);
 }
 
+void BlobReader::PrefetchFileItems() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (file_items_prefetched_ || file_stream_provider_for_testing_)
+    return;
+  file_items_prefetched_ = true;
+
+  std::vector<FileItemRange> ranges = GetFileItemPrefetchRanges();
+  if (ranges.empty())
+    return;
+  file_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(&BlobReader::PrefetchFileItemRanges, std::move(ranges)));
+}
+
+std::vector<BlobReader::FileItemRange> BlobReader::GetFileItemPrefetchRanges()
+    const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(total_size_calculated_);
+
+  std::vector<FileItemRange> ranges;
+  uint64_t prefetch_bytes = 0;
+  uint64_t remaining_bytes = remaining_bytes_;
+  const auto& items = blob_data_->items();
+  for (size_t i = current_item_index_;
+       i < items.size() && remaining_bytes > 0; ++i) {
+    // |item_length_list_| has the resolved length of items of unknown length,
+    // and the first item may have been partly read already.
+    const uint64_t consumed =
+        i == current_item_index_ ? current_item_offset_ : 0;
+    const uint64_t length =
+        std::min(item_length_list_[i] - consumed, remaining_bytes);
+    remaining_bytes -= length;
+
+    const BlobDataItem& item = *items[i];
+    if (item.type() != BlobDataItem::Type::kFile || item.IsFutureFileItem() ||
+        length == 0) {
+      continue;
+    }
+    if (length > kMaxPrefetchBytes - prefetch_bytes)
+      continue;
+    ranges.push_back({item.path(), item.offset() + consumed, length});
+    prefetch_bytes += length;
+  }
+  return ranges;
+}
+
+// static
+void BlobReader::PrefetchFileItemRanges(std::vector<FileItemRange> ranges) {
+  for (const FileItemRange& range : ranges) {
+    base::File file(range.path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+    if (!file.IsValid())
+      continue;
+    // posix_fadvise() is only available in the Android NDK in API 21+, see
+    // base::PreReadFile().
+#if defined(OS_LINUX) || defined(OS_CHROMEOS) || \
+    (defined(OS_ANDROID) && __ANDROID_API__ >= 21)
+    posix_fadvise(file.GetPlatformFile(),
+                  base::saturated_cast<off_t>(range.offset),
+                  base::saturated_cast<off_t>(range.length),
+                  POSIX_FADV_WILLNEED);
+#else
+    // The OS can't be asked to read ahead, so the range is read instead.
+    constexpr size_t kPrefetchReadSize = 64 * 1024;
+    std::vector<char> buffer(kPrefetchReadSize);
+    const uint64_t end = range.offset + range.length;
+    for (uint64_t offset = range.offset; offset < end;) {
+      const int bytes_read = file.Read(
+          base::checked_cast<int64_t>(offset), buffer.data(),
+          static_cast<int>(std::min<uint64_t>(buffer.size(), end - offset)));
+      if (bytes_read <= 0)
+        break;
+      offset += bytes_read;
+    }
+#endif
+  }
+}
+
+void BlobReader::ReadNextLocalFileItem() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(local_file_producer_);
+
+  const auto& items = blob_data_->items();
+  while (remaining_bytes_ > 0 && current_item_index_ < items.size()) {
+    const uint64_t length = std::min(
+        {item_length_list_[current_item_index_] - current_item_offset_,
+         remaining_bytes_, kMaxLocalFileWriteBytes});
+    if (length == 0) {
+      AdvanceItem();
+      continue;
+    }
+
+    const BlobDataItem& item = *items.at(current_item_index_);
+    TRACE_EVENT_NESTABLE_ASYNC_BEGIN1("Blob", "BlobReader::ReadLocalFileItem",
+                                      TRACE_ID_LOCAL(this), "uuid",
+                                      blob_data_->uuid());
+    local_file_producer_->Write(
+        std::make_unique<LocalFileItemDataSource>(
+            item.path(), item.expected_modification_time(),
+            item.offset() + current_item_offset_, length),
+        base::BindOnce(&BlobReader::DidWriteLocalFileItem,
+                       weak_factory_.GetWeakPtr(), length));
+    return;
+  }
+
+  local_file_producer_.reset();  // This closes the data pipe.
+  local_file_progress_callback_.Reset();
+  if (remaining_bytes_ > 0) {
+    InvalidateCallbacksAndDone(net::ERR_UNEXPECTED, std::move(read_callback_));
+    return;
+  }
+  std::move(read_callback_).Run(net::OK);
+}
+
+void BlobReader::DidWriteLocalFileItem(uint64_t length, MojoResult result) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  TRACE_EVENT_NESTABLE_ASYNC_END1("Blob", "BlobReader::ReadLocalFileItem",
+                                  TRACE_ID_LOCAL(this), "uuid",
+                                  blob_data_->uuid());
+  if (result != MOJO_RESULT_OK) {
+    local_file_producer_.reset();
+    local_file_progress_callback_.Reset();
+    InvalidateCallbacksAndDone(ConvertMojoResultToNetError(result),
+                               std::move(read_callback_));
+    return;
+  }
+
+  current_item_offset_ += length;
+  remaining_bytes_ -= length;
+  if (current_item_offset_ == item_length_list_[current_item_index_])
+    AdvanceItem();
+  local_file_progress_callback_.Run(static_cast<int>(length));
+  ReadNextLocalFileItem();
+}
+
 void BlobReader::ContinueAsyncReadLoop() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
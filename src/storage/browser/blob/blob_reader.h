@@ -13,10 +13,12 @@
 #include <vector>
 
 #include "base/component_export.h"
+#include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
+#include "base/time/time.h"
 #include "mojo/public/cpp/base/big_buffer.h"
 #include "mojo/public/cpp/system/data_pipe.h"
 #include "net/base/completion_once_callback.h"
@@ -29,7 +31,10 @@ class GURL;
 namespace base {
 class FilePath;
 class TaskRunner;
-class Time;
+}
+
+namespace mojo {
+class DataPipeProducer;
 }
 
 namespace net {
@@ -72,6 +77,7 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobReader {
   };
   enum class Status { NET_ERROR, IO_PENDING, DONE };
   using StatusCallback = base::OnceCallback<void(Status)>;
+  using ProgressCallback = base::RepeatingCallback<void(int num_bytes)>;
   virtual ~BlobReader();
 
   // This calculates the total size of the blob, and initializes the reading
@@ -130,6 +136,24 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobReader {
   void ReadSingleMojoDataItem(mojo::ScopedDataPipeProducerHandle producer,
                               net::CompletionOnceCallback done);
 
+  // Returns if all of the items left to read are local files, which includes
+  // the items BlobMemoryController paged to disk. If so, ReadLocalFileItems
+  // can be called instead of multiple Reads as an optimized path: the files
+  // are read directly into the data pipe on a blocking sequence, without an
+  // intermediate IOBuffer or a round trip to this sequence per chunk, and each
+  // read is as large as the space the consumer freed in the pipe. This can
+  // only be called after CalculateSize (and optionally SetReadRange). Readers
+  // with a FileStreamReaderProvider set for testing never take this path.
+  // * The progress callback is called with the number of bytes written to
+  //   |producer| after each chunk of at most 1MB.
+  // * The done callback is called with net::OK once remaining_bytes() have
+  //   been written to |producer|, or with the error code, which net_error()
+  //   also returns.
+  bool IsLocalFileItemsOnly() const;
+  void ReadLocalFileItems(mojo::ScopedDataPipeProducerHandle producer,
+                          ProgressCallback progress,
+                          net::CompletionOnceCallback done);
+
   // Kills reading and invalidates all callbacks. The reader cannot be used
   // after this call.
   void Kill();
@@ -164,6 +188,7 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobReader {
   friend class BlobReaderTest;
   FRIEND_TEST_ALL_PREFIXES(BlobReaderTest, HandleBeforeAsyncCancel);
   FRIEND_TEST_ALL_PREFIXES(BlobReaderTest, ReadFromIncompleteBlob);
+  FRIEND_TEST_ALL_PREFIXES(BlobReaderTest, FileItemPrefetchRanges);
 
   BlobReader(const BlobDataHandle* blob_handle);
 
@@ -179,6 +204,13 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobReader {
   }
 
  private:
+  // The range of a file item left to read.
+  struct FileItemRange {
+    base::FilePath path;
+    uint64_t offset;
+    uint64_t length;
+  };
+
   Status ReportError(int net_error);
   void InvalidateCallbacksAndDone(int net_error,
                                   net::CompletionOnceCallback done);
@@ -207,10 +239,24 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobReader {
   void ReadBytesItem(const BlobDataItem& item, int bytes_to_read);
   BlobReader::Status ReadFileItem(FileStreamReader* reader, int bytes_to_read);
   void DidReadFile(int result);
+  // Asks the OS to read ahead the ranges of the file items left to read, so
+  // that blobs paged to disk are read back from the page cache. Only done once,
+  // when the reader starts streaming.
+  void PrefetchFileItems();
+  // Returns the ranges of the local file items left to read, up to
+  // |kMaxPrefetchBytes| in total. Items larger than what is left of that budget
+  // are skipped.
+  std::vector<FileItemRange> GetFileItemPrefetchRanges() const;
+  // Runs on the file task runner.
+  static void PrefetchFileItemRanges(std::vector<FileItemRange> ranges);
   void DeleteItemReaders();
   Status ReadReadableDataHandle(const BlobDataItem& item, int bytes_to_read);
   void DidReadReadableDataHandle(int result);
   void DidReadItem(int result);
+  // Writes the next chunk of the current local file item to the data pipe of
+  // ReadLocalFileItems, or completes the read if there is nothing left to read.
+  void ReadNextLocalFileItem();
+  void DidWriteLocalFileItem(uint64_t length, MojoResult result);
   void DidReadSideData(StatusCallback done,
                        int expected_size,
                        int result,
@@ -260,10 +306,15 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobReader {
   std::map<size_t, std::unique_ptr<FileStreamReader>> index_to_reader_;
   std::map<size_t, std::unique_ptr<network::DataPipeToSourceStream>>
       index_to_pipe_;
+  // Writes the local file items to the data pipe of ReadLocalFileItems.
+  std::unique_ptr<mojo::DataPipeProducer> local_file_producer_;
+  ProgressCallback local_file_progress_callback_;
   size_t current_item_index_ = 0;
   uint64_t current_item_offset_ = 0;
 
   bool io_pending_ = false;
+  bool file_items_prefetched_ = false;
+  base::TimeTicks file_read_start_time_;
 
   net::CompletionOnceCallback size_callback_;
   net::CompletionOnceCallback read_callback_;
@@ -0,0 +1,187 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/barrier_closure.h"
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/process/process_metrics.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "mojo/public/cpp/system/data_pipe.h"
+#include "mojo/public/cpp/system/data_pipe_drainer.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_byte_range.h"
+#include "storage/browser/blob/blob_data_builder.h"
+#include "storage/browser/blob/blob_data_handle.h"
+#include "storage/browser/blob/blob_storage_context.h"
+#include "storage/browser/blob/mojo_blob_reader.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/blink/public/common/blob/blob_utils.h"
+
+namespace storage {
+namespace {
+
+// Size of the file the blobs are made of. Blobs larger than it reference the
+// file several times, like a blob paged to disk references its page files.
+constexpr size_t kFileSize = 256 * 1024 * 1024;
+
+struct BlobReaderPerfTestParam {
+  const char* story;
+  // Number of items referencing the whole file.
+  int file_items;
+  // Whether a small bytes item precedes the files, which makes MojoBlobReader
+  // read the blob through BlobReader::Read() rather than ReadLocalFileItems().
+  bool bytes_item;
+};
+
+// Drains the data pipe as fast as possible, like a consumer which hands the
+// data to the network.
+class CountingDrainerClient : public mojo::DataPipeDrainer::Client {
+ public:
+  explicit CountingDrainerClient(base::OnceClosure done)
+      : done_(std::move(done)) {}
+
+  uint64_t bytes_drained() const { return bytes_drained_; }
+
+  // mojo::DataPipeDrainer::Client:
+  void OnDataAvailable(const void* data, size_t num_bytes) override {
+    bytes_drained_ += num_bytes;
+  }
+  void OnDataComplete() override { std::move(done_).Run(); }
+
+ private:
+  base::OnceClosure done_;
+  uint64_t bytes_drained_ = 0;
+};
+
+class CompletionDelegate : public MojoBlobReader::Delegate {
+ public:
+  CompletionDelegate(net::Error* result, base::OnceClosure done)
+      : result_(result), done_(std::move(done)) {}
+
+  // MojoBlobReader::Delegate:
+  RequestSideData DidCalculateSize(uint64_t total_size,
+                                   uint64_t content_size) override {
+    return DONT_REQUEST_SIDE_DATA;
+  }
+  void OnComplete(net::Error result, uint64_t total_written_bytes) override {
+    *result_ = result;
+    std::move(done_).Run();
+  }
+
+ private:
+  net::Error* const result_;
+  base::OnceClosure done_;
+};
+
+class BlobReaderPerfTest
+    : public testing::TestWithParam<BlobReaderPerfTestParam> {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    file_path_ = temp_dir_.GetPath().AppendASCII("blob_file");
+    const std::string chunk(1024 * 1024, 'x');
+    base::File file(file_path_,
+                    base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+    ASSERT_TRUE(file.IsValid());
+    for (size_t written = 0; written < kFileSize; written += chunk.size()) {
+      ASSERT_EQ(static_cast<int>(chunk.size()),
+                file.WriteAtCurrentPos(chunk.data(), chunk.size()));
+    }
+    base::File::Info info;
+    ASSERT_TRUE(file.GetInfo(&info));
+    file_modification_time_ = info.last_modified;
+  }
+
+ protected:
+  std::unique_ptr<BlobDataHandle> CreateBlob() {
+    auto builder = std::make_unique<BlobDataBuilder>("uuid");
+    if (GetParam().bytes_item)
+      builder->AppendData("header");
+    for (int i = 0; i < GetParam().file_items; ++i) {
+      builder->AppendFile(file_path_, 0, kFileSize, file_modification_time_);
+    }
+    return context_.AddFinishedBlob(std::move(builder));
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  base::FilePath file_path_;
+  base::Time file_modification_time_;
+  BlobStorageContext context_;
+};
+
+TEST_P(BlobReaderPerfTest, ReadToDataPipe) {
+  std::unique_ptr<BlobDataHandle> blob = CreateBlob();
+  const uint64_t blob_size = blob->size();
+
+  mojo::ScopedDataPipeProducerHandle producer;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  MojoCreateDataPipeOptions options;
+  options.struct_size = sizeof(MojoCreateDataPipeOptions);
+  options.flags = MOJO_CREATE_DATA_PIPE_FLAG_NONE;
+  options.element_num_bytes = 1;
+  options.capacity_num_bytes =
+      blink::BlobUtils::GetDataPipeCapacity(blob_size);
+  ASSERT_EQ(MOJO_RESULT_OK, mojo::CreateDataPipe(&options, producer, consumer));
+
+  base::RunLoop run_loop;
+  base::RepeatingClosure done =
+      base::BarrierClosure(2, run_loop.QuitClosure());
+  CountingDrainerClient drainer_client(done);
+  mojo::DataPipeDrainer drainer(&drainer_client, std::move(consumer));
+  net::Error result = net::ERR_IO_PENDING;
+
+  std::unique_ptr<base::ProcessMetrics> process_metrics =
+      base::ProcessMetrics::CreateCurrentProcessMetrics();
+  const base::TimeDelta start_cpu_time =
+      process_metrics->GetCumulativeCPUUsage();
+  const base::TimeTicks start = base::TimeTicks::Now();
+  MojoBlobReader::Create(blob.get(), net::HttpByteRange(),
+                         std::make_unique<CompletionDelegate>(&result, done),
+                         std::move(producer));
+  run_loop.Run();
+  const base::TimeDelta total_time = base::TimeTicks::Now() - start;
+  const base::TimeDelta cpu_time =
+      process_metrics->GetCumulativeCPUUsage() - start_cpu_time;
+
+  EXPECT_EQ(net::OK, result);
+  EXPECT_EQ(blob_size, drainer_client.bytes_drained());
+
+  perf_test::PerfResultReporter reporter("blob_reader", GetParam().story);
+  reporter.RegisterImportantMetric("_throughput", "MB/s");
+  reporter.RegisterImportantMetric("_cpu_time_per_gb", "ms");
+  const double gigabytes = blob_size / (1024.0 * 1024.0 * 1024.0);
+  reporter.AddResult("_throughput",
+                     blob_size / total_time.InSecondsF() / (1024 * 1024));
+  reporter.AddResult("_cpu_time_per_gb",
+                     cpu_time.InMillisecondsF() / gigabytes);
+}
+
+const BlobReaderPerfTestParam kPerfTestParams[] = {
+    {"256mb_file", 1, false},
+    {"2gb_files", 8, false},
+    {"4gb_files", 16, false},
+    {"2gb_bytes_and_files", 8, true},
+    {"4gb_bytes_and_files", 16, true},
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         BlobReaderPerfTest,
+                         testing::ValuesIn(kPerfTestParams));
+
+}  // namespace
+}  // namespace storage
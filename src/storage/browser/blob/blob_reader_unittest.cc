@@ -7,6 +7,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -15,7 +16,10 @@
 #include "base/bind.h"
 #include "base/callback.h"
 #include "base/callback_helpers.h"
+#include "base/files/file.h"
 #include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/location.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
@@ -228,6 +232,43 @@ class BlobReaderTest : public ::testing::Test {
     reader_->SetFileStreamProviderForTesting(base::WrapUnique(provider_));
   }
 
+  // For the tests of ReadLocalFileItems, which reads the files itself.
+  void InitializeReaderWithoutFileStreamProvider(
+      std::unique_ptr<BlobDataBuilder> builder) {
+    blob_handle_ = context_.AddFinishedBlob(std::move(builder));
+    reader_.reset(new BlobReader(blob_handle_.get()));
+  }
+
+  // Reads the local file items of |reader_| into a data pipe of |capacity|
+  // bytes, and returns the result of the read, the chunks of progress
+  // reported and the data read.
+  int ReadLocalFileItems(uint32_t capacity,
+                         std::vector<int>* progress,
+                         std::string* data) {
+    mojo::ScopedDataPipeProducerHandle producer;
+    mojo::ScopedDataPipeConsumerHandle consumer;
+    EXPECT_EQ(MOJO_RESULT_OK,
+              mojo::CreateDataPipe(capacity, producer, consumer));
+
+    int result = net::ERR_IO_PENDING;
+    reader_->ReadLocalFileItems(
+        std::move(producer),
+        base::BindLambdaForTesting(
+            [progress](int num_bytes) { progress->push_back(num_bytes); }),
+        base::BindLambdaForTesting([&](int net_error) { result = net_error; }));
+    task_environment_.RunUntilIdle();
+
+    uint32_t num_bytes = 0;
+    if (consumer->ReadData(nullptr, &num_bytes, MOJO_READ_DATA_FLAG_QUERY) ==
+        MOJO_RESULT_OK) {
+      data->resize(num_bytes);
+      EXPECT_EQ(MOJO_RESULT_OK,
+                consumer->ReadData(&(*data)[0], &num_bytes,
+                                   MOJO_READ_DATA_FLAG_ALL_OR_NONE));
+    }
+    return result;
+  }
+
   // Takes ownership of the file reader (the blob reader takes ownership).
   void ExpectLocalFileCall(const FilePath& file_path,
                            base::Time modification_time,
@@ -656,6 +697,177 @@ TEST_F(BlobReaderTest, FileSystemAsync) {
   EXPECT_EQ(0, memcmp(buffer->data(), "FileData!!!", kData.size()));
 }
 
+TEST_F(BlobReaderTest, LocalFileItems) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const FilePath kPath1 = temp_dir.GetPath().AppendASCII("file1");
+  const FilePath kPath2 = temp_dir.GetPath().AppendASCII("file2");
+  const std::string kData1 = "Local file data";
+  const std::string kData2 = "More local file data";
+  ASSERT_TRUE(base::WriteFile(kPath1, kData1));
+  ASSERT_TRUE(base::WriteFile(kPath2, kData2));
+  base::File::Info info1;
+  base::File::Info info2;
+  ASSERT_TRUE(base::GetFileInfo(kPath1, &info1));
+  ASSERT_TRUE(base::GetFileInfo(kPath2, &info2));
+
+  auto b = std::make_unique<BlobDataBuilder>("uuid");
+  b->AppendFile(kPath1, 6, 9, info1.last_modified);
+  b->AppendFile(kPath2, 0, kData2.size(), info2.last_modified);
+  this->InitializeReaderWithoutFileStreamProvider(std::move(b));
+
+  int size_result = -1;
+  EXPECT_EQ(
+      BlobReader::Status::IO_PENDING,
+      reader_->CalculateSize(base::BindOnce(&SetValue<int>, &size_result)));
+  task_environment_.RunUntilIdle();
+  CheckSizeCalculatedAsynchronously(9 + kData2.size(), size_result);
+  EXPECT_TRUE(reader_->IsLocalFileItemsOnly());
+
+  // Read a range spanning both items.
+  const std::string kData = kData1.substr(6, 9) + kData2;
+  const uint64_t kRangeStart = 3;
+  const uint64_t kRangeLength = 12;
+  EXPECT_EQ(BlobReader::Status::DONE,
+            reader_->SetReadRange(kRangeStart, kRangeLength));
+
+  std::vector<int> progress;
+  std::string data;
+  EXPECT_EQ(net::OK, ReadLocalFileItems(64 * 1024, &progress, &data));
+  EXPECT_EQ(0u, reader_->remaining_bytes());
+  EXPECT_EQ(kData.substr(kRangeStart, kRangeLength), data);
+  // Progress is reported for the part of each item in the range.
+  EXPECT_EQ(std::vector<int>({6, 6}), progress);
+}
+
+TEST_F(BlobReaderTest, LocalFileItemsProgress) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const FilePath kPath = temp_dir.GetPath().AppendASCII("file");
+  const int kMB = 1024 * 1024;
+  const std::string kData(2 * kMB + 10, 'a');
+  ASSERT_TRUE(base::WriteFile(kPath, kData));
+  base::File::Info info;
+  ASSERT_TRUE(base::GetFileInfo(kPath, &info));
+
+  auto b = std::make_unique<BlobDataBuilder>("uuid");
+  b->AppendFile(kPath, 0, kData.size(), info.last_modified);
+  this->InitializeReaderWithoutFileStreamProvider(std::move(b));
+
+  int size_result = -1;
+  EXPECT_EQ(
+      BlobReader::Status::IO_PENDING,
+      reader_->CalculateSize(base::BindOnce(&SetValue<int>, &size_result)));
+  task_environment_.RunUntilIdle();
+  CheckSizeCalculatedAsynchronously(kData.size(), size_result);
+  EXPECT_TRUE(reader_->IsLocalFileItemsOnly());
+
+  // Progress is reported after each 1MB chunk of the file.
+  std::vector<int> progress;
+  std::string data;
+  EXPECT_EQ(net::OK, ReadLocalFileItems(kData.size(), &progress, &data));
+  EXPECT_EQ(kData, data);
+  EXPECT_EQ(std::vector<int>({kMB, kMB, 10}), progress);
+}
+
+TEST_F(BlobReaderTest, LocalFileItemsModified) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const FilePath kPath = temp_dir.GetPath().AppendASCII("file");
+  const std::string kData = "Local file data";
+  ASSERT_TRUE(base::WriteFile(kPath, kData));
+  base::File::Info info;
+  ASSERT_TRUE(base::GetFileInfo(kPath, &info));
+
+  auto b = std::make_unique<BlobDataBuilder>("uuid");
+  b->AppendFile(kPath, 0, kData.size(), info.last_modified);
+  this->InitializeReaderWithoutFileStreamProvider(std::move(b));
+
+  int size_result = -1;
+  EXPECT_EQ(
+      BlobReader::Status::IO_PENDING,
+      reader_->CalculateSize(base::BindOnce(&SetValue<int>, &size_result)));
+  task_environment_.RunUntilIdle();
+  CheckSizeCalculatedAsynchronously(kData.size(), size_result);
+  EXPECT_TRUE(reader_->IsLocalFileItemsOnly());
+
+  // Modify the file after its size was calculated.
+  ASSERT_TRUE(base::TouchFile(
+      kPath, info.last_accessed,
+      info.last_modified + base::TimeDelta::FromHours(1)));
+
+  std::vector<int> progress;
+  std::string data;
+  EXPECT_EQ(net::ERR_UPLOAD_FILE_CHANGED,
+            ReadLocalFileItems(64 * 1024, &progress, &data));
+  EXPECT_EQ(net::ERR_UPLOAD_FILE_CHANGED, reader_->net_error());
+  EXPECT_TRUE(progress.empty());
+}
+
+TEST_F(BlobReaderTest, LocalFileItemsWithFileStreamProvider) {
+  const FilePath kPath = FilePath::FromUTF8Unsafe("/fake/file.txt");
+  const std::string kData = "FileData!!!";
+  const base::Time kTime = base::Time::Now();
+
+  auto b = std::make_unique<BlobDataBuilder>("uuid");
+  b->AppendFile(kPath, 0, kData.size(), kTime);
+  this->InitializeReader(std::move(b));
+  ExpectLocalFileCall(kPath, kTime, 0, new FakeFileStreamReader(kData));
+
+  int size_result = -1;
+  EXPECT_EQ(BlobReader::Status::DONE, reader_->CalculateSize(base::BindOnce(
+                                          &SetValue<int>, &size_result)));
+  CheckSizeCalculatedSynchronously(kData.size(), size_result);
+
+  // The files must be read through the provided FileStreamReaders.
+  EXPECT_FALSE(reader_->IsLocalFileItemsOnly());
+}
+
+TEST_F(BlobReaderTest, FileItemPrefetchRanges) {
+  const FilePath kPath1 = FilePath::FromUTF8Unsafe("/fake/file1");
+  const FilePath kPath2 = FilePath::FromUTF8Unsafe("/fake/file2");
+  const FilePath kPath3 = FilePath::FromUTF8Unsafe("/fake/file3");
+  const uint64_t kMB = 1024 * 1024;
+  const base::Time kTime = base::Time::Now();
+
+  auto b = std::make_unique<BlobDataBuilder>("uuid");
+  // A small item at a large offset in a large file.
+  b->AppendFile(kPath1, 20 * kMB, kMB, kTime);
+  // An item larger than the 16MB that are prefetched at most.
+  b->AppendFile(kPath2, 0, 17 * kMB, kTime);
+  // An item of unknown length, which resolves to 2MB.
+  b->AppendFile(kPath3, kMB, std::numeric_limits<uint64_t>::max(), kTime);
+  this->InitializeReader(std::move(b));
+  ExpectLocalFileCall(kPath1, kTime, 20 * kMB,
+                      new FakeFileStreamReader("", 64 * kMB));
+  ExpectLocalFileCall(kPath2, kTime, 0, new FakeFileStreamReader("", 17 * kMB));
+  ExpectLocalFileCall(kPath3, kTime, kMB,
+                      new FakeFileStreamReader("", 3 * kMB));
+
+  int size_result = -1;
+  EXPECT_EQ(BlobReader::Status::DONE, reader_->CalculateSize(base::BindOnce(
+                                          &SetValue<int>, &size_result)));
+  CheckSizeCalculatedSynchronously(20 * kMB, size_result);
+
+  // Start halfway through the first item, and stop 1KB before the end of the
+  // last one.
+  ExpectLocalFileCall(kPath1, kTime, 20 * kMB + kMB / 2,
+                      new FakeFileStreamReader("", 64 * kMB));
+  EXPECT_EQ(BlobReader::Status::DONE,
+            reader_->SetReadRange(kMB / 2, 20 * kMB - kMB / 2 - 1024));
+
+  // Only the ranges left to read are prefetched. The oversized item is skipped
+  // without ending the prefetch.
+  const auto ranges = reader_->GetFileItemPrefetchRanges();
+  ASSERT_EQ(2u, ranges.size());
+  EXPECT_EQ(kPath1, ranges[0].path);
+  EXPECT_EQ(20 * kMB + kMB / 2, ranges[0].offset);
+  EXPECT_EQ(kMB / 2, ranges[0].length);
+  EXPECT_EQ(kPath3, ranges[1].path);
+  EXPECT_EQ(kMB, ranges[1].offset);
+  EXPECT_EQ(2 * kMB - 1024, ranges[1].length);
+}
+
 TEST_F(BlobReaderTest, ReadableDataHandleSingle) {
   auto b = std::make_unique<BlobDataBuilder>("uuid");
   const std::string kOrigData = "12345 Test Blob Data 12345";
@@ -968,6 +1180,7 @@ TEST_F(BlobReaderTest, MixedContent) {
   CheckSizeNotCalculatedYet(size_result);
   base::RunLoop().RunUntilIdle();
   CheckSizeCalculatedAsynchronously(kDataSize, size_result);
+  EXPECT_FALSE(reader_->IsLocalFileItemsOnly());
 
   scoped_refptr<net::IOBuffer> buffer = CreateBuffer(kDataSize);
 
@@ -80,6 +80,7 @@ bool BlobStorageLimits::IsValid() const {
          max_shared_memory_size <= max_bytes_data_item_size &&
          min_page_file_size <= max_file_size &&
          min_page_file_size <= max_blob_in_memory_space &&
+         page_file_write_size > 0 &&
          effective_max_disk_space <= desired_max_disk_space;
 }
 
@@ -19,6 +19,7 @@ constexpr size_t kDefaultSharedMemorySize = 10u * 1024 * 1024;
 constexpr size_t kDefaultMaxBlobInMemorySpace = 500u * 1024 * 1024;
 constexpr uint64_t kDefaultMaxBlobDiskSpace = 0ull;
 constexpr uint64_t kDefaultMaxPageFileSize = 100ull * 1024 * 1024;
+constexpr size_t kDefaultPageFileWriteSize = 1024 * 1024;
 
 #if defined(OS_ANDROID)
 // On minimal Android maximum in-memory space can be as low as 5MB.
@@ -89,6 +90,10 @@ struct COMPONENT_EXPORT(STORAGE_BROWSER) BlobStorageLimits {
   uint64_t min_page_file_size = kDefaultMinPageFileSize;
   // This is the maximum file size we can create.
   uint64_t max_file_size = kDefaultMaxPageFileSize;
+  // Small items are coalesced into writes of this size when paging them to
+  // disk, and every write but the last one of a page file starts at a multiple
+  // of it.
+  size_t page_file_write_size = kDefaultPageFileWriteSize;
   // This overrides the minimum size for transporting a blob using the file
   // strategy. This allows perf tests to force file transportation. This is
   // usually set using the "blob-transport-by-file-min-size" switch (see
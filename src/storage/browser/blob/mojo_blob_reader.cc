@@ -4,6 +4,9 @@
 
 #include "storage/browser/blob/mojo_blob_reader.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "base/bind.h"
 #include "base/trace_event/trace_event.h"
 #include "net/base/io_buffer.h"
@@ -13,6 +16,14 @@
 
 namespace storage {
 
+namespace {
+
+// Largest read of the blob, as a multiple of the data pipe chunk size. Reads
+// grow up to it while the consumer keeps up with them.
+constexpr uint32_t kMaxReadChunkSizeMultiplier = 16;
+
+}  // namespace
+
 // static
 void MojoBlobReader::Create(
     const BlobDataHandle* handle,
@@ -32,6 +43,7 @@ MojoBlobReader::MojoBlobReader(
       byte_range_(range),
       blob_reader_(handle->CreateReader()),
       response_body_stream_(std::move(response_body_stream)),
+      read_chunk_size_(blink::BlobUtils::GetDataPipeChunkSize()),
       writable_handle_watcher_(FROM_HERE,
                                mojo::SimpleWatcher::ArmingPolicy::MANUAL,
                                base::SequencedTaskRunnerHandle::Get()),
@@ -182,6 +194,19 @@ void MojoBlobReader::StartReading() {
     return;
   }
 
+  // Optimized path for blobs made of local files, which includes blobs paged
+  // to disk. The files are read directly into the data pipe on a blocking
+  // sequence.
+  if (blob_reader_->IsLocalFileItemsOnly()) {
+    blob_reader_->ReadLocalFileItems(
+        std::move(response_body_stream_),
+        base::BindRepeating(&MojoBlobReader::DidWriteLocalFileItems,
+                            weak_factory_.GetWeakPtr()),
+        base::BindOnce(&MojoBlobReader::DidReadLocalFileItems,
+                       weak_factory_.GetWeakPtr()));
+    return;
+  }
+
   peer_closed_handle_watcher_.Watch(
       response_body_stream_.get(), MOJO_HANDLE_SIGNAL_PEER_CLOSED,
       MOJO_WATCH_CONDITION_SATISFIED,
@@ -209,7 +234,11 @@ void MojoBlobReader::ReadMore() {
   MojoResult result = network::NetToMojoPendingBuffer::BeginWrite(
       &response_body_stream_, &pending_write_, &num_bytes);
   if (result == MOJO_RESULT_SHOULD_WAIT) {
-    // The pipe is full. We need to wait for it to have more space.
+    // The pipe is full. We need to wait for it to have more space. The
+    // consumer is slower than the reads, so smaller reads are enough to keep
+    // it busy.
+    read_chunk_size_ = std::max(read_chunk_size_ / 2,
+                                blink::BlobUtils::GetDataPipeChunkSize());
     writable_handle_watcher_.ArmOrNotify();
     return;
   } else if (result != MOJO_RESULT_OK) {
@@ -220,7 +249,13 @@ void MojoBlobReader::ReadMore() {
     return;
   }
 
-  num_bytes = std::min(num_bytes, blink::BlobUtils::GetDataPipeChunkSize());
+  // The consumer drained most of the pipe since the last read, so read larger
+  // chunks to keep up with it with fewer reads.
+  const uint32_t max_read_chunk_size =
+      kMaxReadChunkSizeMultiplier * blink::BlobUtils::GetDataPipeChunkSize();
+  if (num_bytes >= 2 * read_chunk_size_)
+    read_chunk_size_ = std::min(2 * read_chunk_size_, max_read_chunk_size);
+  num_bytes = std::min(num_bytes, read_chunk_size_);
 
   TRACE_EVENT_NESTABLE_ASYNC_BEGIN0("Blob", "BlobReader::ReadMore",
                                     TRACE_ID_LOCAL(this));
@@ -280,6 +315,17 @@ void MojoBlobReader::DidRead(bool completed_synchronously, int num_bytes) {
   }
 }
 
+void MojoBlobReader::DidWriteLocalFileItems(int num_bytes) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  total_written_bytes_ += num_bytes;
+  delegate_->DidRead(num_bytes);
+}
+
+void MojoBlobReader::DidReadLocalFileItems(int result) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  NotifyCompletedAndDeleteIfNeeded(result);
+}
+
 void MojoBlobReader::OnResponseBodyStreamClosed(
     MojoResult result,
     const mojo::HandleSignalsState& state) {
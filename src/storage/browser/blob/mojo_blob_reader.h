@@ -91,6 +91,8 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) MojoBlobReader {
   void StartReading();
   void ReadMore();
   void DidRead(bool completed_synchronously, int num_bytes);
+  void DidWriteLocalFileItems(int num_bytes);
+  void DidReadLocalFileItems(int result);
   void OnResponseBodyStreamClosed(MojoResult result,
                                   const mojo::HandleSignalsState& state);
   void OnResponseBodyStreamReady(MojoResult result,
@@ -114,6 +116,11 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) MojoBlobReader {
   // the pipe's internal buffer where data should be written.
   scoped_refptr<network::NetToMojoPendingBuffer> pending_write_;
 
+  // Largest number of bytes read from the blob at once. Doubles while the
+  // consumer drains the data pipe faster than the blob is read, and halves
+  // when the data pipe fills up.
+  uint32_t read_chunk_size_;
+
   // Watchers to keep track of the state of the data pipe. One watches for the
   // pipe being writable, while the other watches for the pipe unexpectedly
   // closing.
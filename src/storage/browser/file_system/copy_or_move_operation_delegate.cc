@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <tuple>
 #include <utility>
@@ -438,8 +439,13 @@ class SnapshotCopyOrMoveImpl
   DISALLOW_COPY_AND_ASSIGN(SnapshotCopyOrMoveImpl);
 };
 
-// The size of buffer for StreamCopyHelper.
+// The initial and maximum sizes of buffer for StreamCopyHelper.
 const int kReadBufferSize = 32768;
+const int kMaxReadBufferSize = 1024 * 1024;
+
+// The number of files copied or moved at once. Copying several small files
+// concurrently hides the latency of opening and closing each of them.
+const size_t kMaxConcurrentFileCopies = 4;
 
 // To avoid too many progress callbacks, it should be called less
 // frequently than 50ms.
@@ -585,6 +591,7 @@ class StreamCopyOrMoveImpl
         std::make_unique<CopyOrMoveOperationDelegate::StreamCopyHelper>(
             std::move(reader_), std::move(writer_),
             dest_url_.mount_option().flush_policy(), kReadBufferSize,
+            kMaxReadBufferSize,
             base::BindRepeating(&StreamCopyOrMoveImpl::OnCopyOrMoveFileProgress,
                                 weak_factory_.GetWeakPtr()),
             base::TimeDelta::FromMilliseconds(
@@ -676,6 +683,7 @@ CopyOrMoveOperationDelegate::StreamCopyHelper::StreamCopyHelper(
     std::unique_ptr<FileStreamWriter> writer,
     FlushPolicy flush_policy,
     int buffer_size,
+    int max_buffer_size,
     FileSystemOperation::CopyFileProgressCallback file_progress_callback,
     const base::TimeDelta& min_progress_callback_invocation_span)
     : reader_(std::move(reader)),
@@ -683,11 +691,15 @@ CopyOrMoveOperationDelegate::StreamCopyHelper::StreamCopyHelper(
       flush_policy_(flush_policy),
       file_progress_callback_(std::move(file_progress_callback)),
       io_buffer_(base::MakeRefCounted<net::IOBufferWithSize>(buffer_size)),
+      max_buffer_size_(max_buffer_size),
+      last_read_filled_buffer_(false),
       num_copied_bytes_(0),
       previous_flush_offset_(0),
       min_progress_callback_invocation_span_(
           min_progress_callback_invocation_span),
-      cancel_requested_(false) {}
+      cancel_requested_(false) {
+  DCHECK_GE(max_buffer_size_, buffer_size);
+}
 
 CopyOrMoveOperationDelegate::StreamCopyHelper::~StreamCopyHelper() = default;
 
@@ -708,6 +720,13 @@ void CopyOrMoveOperationDelegate::StreamCopyHelper::Cancel() {
 }
 
 void CopyOrMoveOperationDelegate::StreamCopyHelper::Read() {
+  // The previous buffer may still be referenced by the DrainableIOBuffer of the
+  // last write, so a larger one is allocated rather than resized.
+  if (last_read_filled_buffer_ && io_buffer_->size() < max_buffer_size_) {
+    io_buffer_ = base::MakeRefCounted<net::IOBufferWithSize>(
+        std::min(io_buffer_->size() * 2, max_buffer_size_));
+  }
+
   int result = reader_->Read(
       io_buffer_.get(), io_buffer_->size(),
       base::BindOnce(&StreamCopyHelper::DidRead, weak_factory_.GetWeakPtr()));
@@ -735,6 +754,7 @@ void CopyOrMoveOperationDelegate::StreamCopyHelper::DidRead(int result) {
     return;
   }
 
+  last_read_filled_buffer_ = result == io_buffer_->size();
   Write(base::MakeRefCounted<net::DrainableIOBuffer>(io_buffer_, result));
 }
 
@@ -974,6 +994,10 @@ void CopyOrMoveOperationDelegate::OnCancel() {
     job.first->Cancel();
 }
 
+size_t CopyOrMoveOperationDelegate::GetMaxConcurrentFileOperations() const {
+  return kMaxConcurrentFileCopies;
+}
+
 void CopyOrMoveOperationDelegate::DidCopyOrMoveFile(
     StatusCallback callback,
     CopyOrMoveImpl* impl,
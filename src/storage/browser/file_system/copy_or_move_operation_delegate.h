@@ -38,7 +38,9 @@ class CopyOrMoveOperationDelegate : public RecursiveOperationDelegate {
 
   enum OperationType { OPERATION_COPY, OPERATION_MOVE };
 
-  // Helper to copy a file by reader and writer streams.
+  // Helper to copy a file by reader and writer streams. The buffer starts at
+  // |buffer_size| and doubles, up to |max_buffer_size|, while reads fill it,
+  // so that large files are copied in fewer, larger chunks.
   // Export for testing.
   class COMPONENT_EXPORT(STORAGE_BROWSER) StreamCopyHelper {
    public:
@@ -47,6 +49,7 @@ class CopyOrMoveOperationDelegate : public RecursiveOperationDelegate {
         std::unique_ptr<FileStreamWriter> writer,
         FlushPolicy flush_policy,
         int buffer_size,
+        int max_buffer_size,
         FileSystemOperation::CopyFileProgressCallback file_progress_callback,
         const base::TimeDelta& min_progress_callback_invocation_span);
     ~StreamCopyHelper();
@@ -76,6 +79,8 @@ class CopyOrMoveOperationDelegate : public RecursiveOperationDelegate {
     FileSystemOperation::CopyFileProgressCallback file_progress_callback_;
     StatusCallback completion_callback_;
     scoped_refptr<net::IOBufferWithSize> io_buffer_;
+    const int max_buffer_size_;
+    bool last_read_filled_buffer_;
     int64_t num_copied_bytes_;
     int64_t previous_flush_offset_;
     base::Time last_progress_callback_invocation_time_;
@@ -107,6 +112,7 @@ class CopyOrMoveOperationDelegate : public RecursiveOperationDelegate {
 
  protected:
   void OnCancel() override;
+  size_t GetMaxConcurrentFileOperations() const override;
 
  private:
   void DidCopyOrMoveFile(StatusCallback callback,
@@ -0,0 +1,158 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "storage/browser/file_system/file_system_backend.h"
+#include "storage/browser/file_system/file_system_context.h"
+#include "storage/browser/file_system/file_system_url.h"
+#include "storage/browser/quota/quota_manager_proxy.h"
+#include "storage/browser/test/async_file_test_helper.h"
+#include "storage/browser/test/test_file_system_context.h"
+#include "storage/common/file_system/file_system_types.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/blink/public/common/storage_key/storage_key.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace storage {
+namespace {
+
+constexpr char kOrigin[] = "http://example.com";
+
+// Shape of the copied tree: |kDirectories| directories of |kFilesPerDirectory|
+// files each.
+constexpr int kDirectories = 100;
+constexpr int kFilesPerDirectory = 100;
+
+struct CopyOrMoveOperationDelegatePerfTestParam {
+  const char* story;
+  size_t file_size;
+  // Type of the file system the tree is copied to, from a temporary one.
+  FileSystemType dest_type;
+};
+
+class CopyOrMoveOperationDelegatePerfTest
+    : public testing::TestWithParam<CopyOrMoveOperationDelegatePerfTestParam> {
+ public:
+  CopyOrMoveOperationDelegatePerfTest()
+      : task_environment_(base::test::TaskEnvironment::MainThreadType::IO) {}
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    file_system_context_ = CreateFileSystemContextForTesting(
+        /*quota_manager_proxy=*/nullptr, temp_dir_.GetPath());
+    OpenFileSystem(kFileSystemTypeTemporary);
+    OpenFileSystem(GetParam().dest_type);
+  }
+
+  void TearDown() override {
+    file_system_context_ = nullptr;
+    task_environment_.RunUntilIdle();
+  }
+
+ protected:
+  void OpenFileSystem(FileSystemType type) {
+    base::RunLoop run_loop;
+    file_system_context_->GetFileSystemBackend(type)->ResolveURL(
+        CreateURL(type, std::string()), OPEN_FILE_SYSTEM_CREATE_IF_NONEXISTENT,
+        base::BindOnce(
+            [](base::OnceClosure quit, const GURL& root_url,
+               const std::string& name, base::File::Error error) {
+              EXPECT_EQ(base::File::FILE_OK, error);
+              std::move(quit).Run();
+            },
+            run_loop.QuitClosure()));
+    run_loop.Run();
+  }
+
+  FileSystemURL CreateURL(FileSystemType type, const std::string& path) {
+    return file_system_context_->CreateCrackedFileSystemURL(
+        blink::StorageKey(url::Origin::Create(GURL(kOrigin))), type,
+        base::FilePath::FromUTF8Unsafe(path));
+  }
+
+  // Creates the source tree under |root| in the temporary file system.
+  void CreateSourceTree(const std::string& root) {
+    const std::string data(GetParam().file_size, 'x');
+    FileSystemContext* context = file_system_context_.get();
+    ASSERT_EQ(base::File::FILE_OK,
+              AsyncFileTestHelper::CreateDirectory(
+                  context, CreateURL(kFileSystemTypeTemporary, root)));
+    for (int i = 0; i < kDirectories; ++i) {
+      const std::string directory =
+          base::StringPrintf("%s/d%d", root.c_str(), i);
+      ASSERT_EQ(base::File::FILE_OK,
+                AsyncFileTestHelper::CreateDirectory(
+                    context, CreateURL(kFileSystemTypeTemporary, directory)));
+      for (int j = 0; j < kFilesPerDirectory; ++j) {
+        ASSERT_EQ(base::File::FILE_OK,
+                  AsyncFileTestHelper::CreateFileWithData(
+                      context,
+                      CreateURL(kFileSystemTypeTemporary,
+                                base::StringPrintf("%s/f%d", directory.c_str(),
+                                                   j)),
+                      data.data(), data.size()));
+      }
+    }
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  scoped_refptr<FileSystemContext> file_system_context_;
+};
+
+TEST_P(CopyOrMoveOperationDelegatePerfTest, CopyTree) {
+  CreateSourceTree("src");
+
+  const base::TimeTicks start = base::TimeTicks::Now();
+  ASSERT_EQ(base::File::FILE_OK,
+            AsyncFileTestHelper::Copy(
+                file_system_context_.get(),
+                CreateURL(kFileSystemTypeTemporary, "src"),
+                CreateURL(GetParam().dest_type, "dest")));
+  const base::TimeDelta total_time = base::TimeTicks::Now() - start;
+
+  EXPECT_TRUE(AsyncFileTestHelper::FileExists(
+      file_system_context_.get(),
+      CreateURL(GetParam().dest_type, "dest/d99/f99"), GetParam().file_size));
+
+  const int files = kDirectories * kFilesPerDirectory;
+  const double megabytes = files * GetParam().file_size / (1024.0 * 1024.0);
+  perf_test::PerfResultReporter reporter("copy_or_move_operation_delegate",
+                                         GetParam().story);
+  reporter.RegisterImportantMetric("_time_per_file", "us");
+  reporter.RegisterImportantMetric("_throughput", "MB/s");
+  reporter.AddResult("_time_per_file", total_time.InMicrosecondsF() / files);
+  reporter.AddResult("_throughput", megabytes / total_time.InSecondsF());
+}
+
+const CopyOrMoveOperationDelegatePerfTestParam kPerfTestParams[] = {
+    // Copies within a file system go through NativeFileUtil::CopyOrMoveFile.
+    {"10k_4kb_files_same_file_system", 4 * 1024, kFileSystemTypeTemporary},
+    {"10k_64kb_files_same_file_system", 64 * 1024, kFileSystemTypeTemporary},
+    // Copies across file systems go through StreamCopyHelper.
+    {"10k_4kb_files_cross_file_system", 4 * 1024, kFileSystemTypePersistent},
+    {"10k_64kb_files_cross_file_system", 64 * 1024, kFileSystemTypePersistent},
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         CopyOrMoveOperationDelegatePerfTest,
+                         testing::ValuesIn(kPerfTestParams));
+
+}  // namespace
+}  // namespace storage
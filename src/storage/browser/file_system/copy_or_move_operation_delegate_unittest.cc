@@ -891,6 +891,7 @@ TEST(LocalFileSystemCopyOrMoveOperationTest, StreamCopyHelper) {
   CopyOrMoveOperationDelegate::StreamCopyHelper helper(
       std::move(reader), std::move(writer), FlushPolicy::NO_FLUSH_ON_COMPLETION,
       10,  // buffer size
+      10,  // max buffer size
       base::BindRepeating(&RecordFileProgressCallback,
                           base::Unretained(&progress)),
       base::TimeDelta());  // For testing, we need all the progress.
@@ -913,6 +914,59 @@ TEST(LocalFileSystemCopyOrMoveOperationTest, StreamCopyHelper) {
   EXPECT_EQ(kTestData, content);
 }
 
+TEST(LocalFileSystemCopyOrMoveOperationTest, StreamCopyHelperGrowsBuffer) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath source_path = temp_dir.GetPath().AppendASCII("source");
+  base::FilePath dest_path = temp_dir.GetPath().AppendASCII("dest");
+  const char kTestData[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+  base::WriteFile(source_path, kTestData);
+
+  base::test::SingleThreadTaskEnvironment task_environment(
+      base::test::SingleThreadTaskEnvironment::MainThreadType::IO);
+  base::Thread file_thread("file_thread");
+  ASSERT_TRUE(file_thread.Start());
+  ScopedThreadStopper thread_stopper(&file_thread);
+  ASSERT_TRUE(thread_stopper.is_valid());
+
+  scoped_refptr<base::SingleThreadTaskRunner> task_runner =
+      file_thread.task_runner();
+
+  std::unique_ptr<FileStreamReader> reader =
+      FileStreamReader::CreateForLocalFile(task_runner.get(), source_path, 0,
+                                           base::Time());
+
+  std::unique_ptr<FileStreamWriter> writer =
+      FileStreamWriter::CreateForLocalFile(task_runner.get(), dest_path, 0,
+                                           FileStreamWriter::CREATE_NEW_FILE);
+
+  std::vector<int64_t> progress;
+  CopyOrMoveOperationDelegate::StreamCopyHelper helper(
+      std::move(reader), std::move(writer), FlushPolicy::NO_FLUSH_ON_COMPLETION,
+      10,  // buffer size
+      40,  // max buffer size
+      base::BindRepeating(&RecordFileProgressCallback,
+                          base::Unretained(&progress)),
+      base::TimeDelta());  // For testing, we need all the progress.
+
+  base::File::Error error = base::File::FILE_ERROR_FAILED;
+  base::RunLoop run_loop;
+  helper.Run(base::BindOnce(&AssignAndQuit, &run_loop, &error));
+  run_loop.Run();
+
+  // The buffer doubles after each full read: 10, 20, then 40 bytes.
+  EXPECT_EQ(base::File::FILE_OK, error);
+  ASSERT_EQ(4U, progress.size());
+  EXPECT_EQ(0, progress[0]);
+  EXPECT_EQ(10, progress[1]);
+  EXPECT_EQ(30, progress[2]);
+  EXPECT_EQ(36, progress[3]);
+
+  std::string content;
+  ASSERT_TRUE(base::ReadFileToString(dest_path, &content));
+  EXPECT_EQ(kTestData, content);
+}
+
 TEST(LocalFileSystemCopyOrMoveOperationTest, StreamCopyHelperWithFlush) {
   // Testing the same configuration as StreamCopyHelper, but with |need_flush|
   // parameter set to true. Since it is hard to test that the flush is indeed
@@ -947,6 +1001,7 @@ TEST(LocalFileSystemCopyOrMoveOperationTest, StreamCopyHelperWithFlush) {
   CopyOrMoveOperationDelegate::StreamCopyHelper helper(
       std::move(reader), std::move(writer), FlushPolicy::NO_FLUSH_ON_COMPLETION,
       10,  // buffer size
+      10,  // max buffer size
       base::BindRepeating(&RecordFileProgressCallback,
                           base::Unretained(&progress)),
       base::TimeDelta());  // For testing, we need all the progress.
@@ -999,6 +1054,7 @@ TEST(LocalFileSystemCopyOrMoveOperationTest, StreamCopyHelper_Cancel) {
   CopyOrMoveOperationDelegate::StreamCopyHelper helper(
       std::move(reader), std::move(writer), FlushPolicy::NO_FLUSH_ON_COMPLETION,
       10,  // buffer size
+      10,  // max buffer size
       base::BindRepeating(&RecordFileProgressCallback,
                           base::Unretained(&progress)),
       base::TimeDelta());  // For testing, we need all the progress.
@@ -10,12 +10,19 @@
 
 #include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
+#include "base/posix/eintr_wrapper.h"
 #include "build/build_config.h"
 #include "build/chromeos_buildflags.h"
 #include "storage/browser/file_system/file_system_operation_context.h"
 #include "storage/browser/file_system/file_system_url.h"
 #include "storage/common/file_system/file_system_mount_option.h"
 
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+#include <errno.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace storage {
 
 namespace {
@@ -39,9 +46,53 @@ bool SetPlatformSpecificDirectoryPermissions(const base::FilePath& dir_path) {
   return true;
 }
 
-// Copies a file |from| to |to|, and ensure the written content is synced to
-// the disk. This is essentially base::CopyFile followed by fsync().
-bool CopyFileAndSync(const base::FilePath& from, const base::FilePath& to) {
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+// Copies |infile| to |outfile| with copy_file_range(2), which lets the file
+// system share the data blocks of the files (reflink) or copy them without
+// moving them through user space. Sets |retry_slow| if the files can still be
+// copied with base::CopyFileContents().
+bool CopyFileContentsWithCopyFileRange(base::File& infile,
+                                       base::File& outfile,
+                                       bool& retry_slow) {
+  retry_slow = false;
+#if defined(__NR_copy_file_range)
+  const int64_t file_size = infile.GetLength();
+  if (file_size < 0)
+    return false;
+
+  int64_t copied = 0;
+  ssize_t result = 0;
+  while (copied < file_size) {
+    result = HANDLE_EINTR(syscall(__NR_copy_file_range,
+                                  infile.GetPlatformFile(), nullptr,
+                                  outfile.GetPlatformFile(), nullptr,
+                                  static_cast<size_t>(file_size - copied), 0));
+    if (result <= 0)
+      break;
+    copied += result;
+  }
+
+  // Older kernels don't support the system call, nor copies across mount
+  // points. Nothing was copied when these fail, so the file offsets are
+  // unchanged.
+  retry_slow = copied == 0 && result < 0 &&
+               (errno == ENOSYS || errno == EXDEV || errno == EINVAL ||
+                errno == EOPNOTSUPP || errno == EPERM);
+  return result >= 0;
+#else
+  retry_slow = true;
+  return false;
+#endif  // defined(__NR_copy_file_range)
+}
+#endif  // defined(OS_LINUX) || defined(OS_CHROMEOS)
+
+// Copies a file |from| to |to|. If |sync| is true, also ensures the written
+// content is synced to the disk.
+bool CopyFile(const base::FilePath& from, const base::FilePath& to, bool sync) {
+#if !defined(OS_LINUX) && !defined(OS_CHROMEOS)
+  if (!sync)
+    return base::CopyFile(from, to);
+#endif
   base::File infile(from, base::File::FLAG_OPEN | base::File::FLAG_READ);
   if (!infile.IsValid()) {
     return false;
@@ -53,25 +104,17 @@ bool CopyFileAndSync(const base::FilePath& from, const base::FilePath& to) {
     return false;
   }
 
-  const int kBufferSize = 32768;
-  std::vector<char> buffer(kBufferSize);
-
-  for (;;) {
-    int bytes_read = infile.ReadAtCurrentPos(&buffer[0], kBufferSize);
-    if (bytes_read < 0)
-      return false;
-    if (bytes_read == 0)
-      break;
-    for (int bytes_written = 0; bytes_written < bytes_read;) {
-      int bytes_written_partial = outfile.WriteAtCurrentPos(
-          &buffer[bytes_written], bytes_read - bytes_written);
-      if (bytes_written_partial < 0)
-        return false;
-      bytes_written += bytes_written_partial;
-    }
-  }
+  bool copied = false;
+#if defined(OS_LINUX) || defined(OS_CHROMEOS)
+  bool retry_slow = false;
+  copied = CopyFileContentsWithCopyFileRange(infile, outfile, retry_slow);
+  if (!copied && !retry_slow)
+    return false;
+#endif
+  if (!copied && !base::CopyFileContents(infile, outfile))
+    return false;
 
-  return outfile.Flush();
+  return !sync || outfile.Flush();
 }
 
 }  // namespace
@@ -284,11 +327,11 @@ base::File::Error NativeFileUtil::CopyOrMoveFile(
 
   switch (mode) {
     case COPY_NOSYNC:
-      if (!base::CopyFile(src_path, dest_path))
+      if (!CopyFile(src_path, dest_path, /*sync=*/false))
         return base::File::FILE_ERROR_FAILED;
       break;
     case COPY_SYNC:
-      if (!CopyFileAndSync(src_path, dest_path))
+      if (!CopyFile(src_path, dest_path, /*sync=*/true))
         return base::File::FILE_ERROR_FAILED;
       break;
     case MOVE:
@@ -18,6 +18,7 @@ namespace storage {
 RecursiveOperationDelegate::RecursiveOperationDelegate(
     FileSystemContext* file_system_context)
     : file_system_context_(file_system_context),
+      inflight_file_operations_(0),
       canceled_(false),
       error_behavior_(FileSystemOperation::ERROR_BEHAVIOR_ABORT),
       failed_some_operations_(false) {}
@@ -54,6 +55,10 @@ FileSystemOperationRunner* RecursiveOperationDelegate::operation_runner() {
 
 void RecursiveOperationDelegate::OnCancel() {}
 
+size_t RecursiveOperationDelegate::GetMaxConcurrentFileOperations() const {
+  return 1;
+}
+
 void RecursiveOperationDelegate::DidTryProcessFile(const FileSystemURL& root,
                                                    base::File::Error error) {
   DCHECK(pending_directory_stack_.empty());
@@ -129,7 +134,7 @@ void RecursiveOperationDelegate::DidReadDirectory(const FileSystemURL& parent,
 void RecursiveOperationDelegate::ProcessPendingFiles() {
   DCHECK(!pending_directory_stack_.empty());
 
-  if (pending_files_.empty() || canceled_) {
+  if ((pending_files_.empty() || canceled_) && inflight_file_operations_ == 0) {
     ProcessSubDirectory();
     return;
   }
@@ -138,10 +143,12 @@ void RecursiveOperationDelegate::ProcessPendingFiles() {
   if (canceled_)
     return;
 
-  // Run ProcessFile.
+  // Run ProcessFile for as many files as may be processed concurrently.
   scoped_refptr<base::SingleThreadTaskRunner> current_task_runner =
       base::ThreadTaskRunnerHandle::Get();
-  if (!pending_files_.empty()) {
+  while (!pending_files_.empty() &&
+         inflight_file_operations_ < GetMaxConcurrentFileOperations()) {
+    ++inflight_file_operations_;
     current_task_runner->PostTask(
         FROM_HERE,
         base::BindOnce(
@@ -155,6 +162,13 @@ void RecursiveOperationDelegate::ProcessPendingFiles() {
 
 void RecursiveOperationDelegate::DidProcessFile(const FileSystemURL& url,
                                                 base::File::Error error) {
+  DCHECK_GT(inflight_file_operations_, 0u);
+  --inflight_file_operations_;
+
+  // An earlier failure already completed the operation.
+  if (!callback_)
+    return;
+
   if (error != base::File::FILE_OK) {
     if (error_behavior_ == FileSystemOperation::ERROR_BEHAVIOR_ABORT) {
       // If an error occurs, invoke Done immediately (even if there remain
@@ -171,7 +185,8 @@ void RecursiveOperationDelegate::DidProcessFile(const FileSystemURL& url,
 }
 
 void RecursiveOperationDelegate::ProcessSubDirectory() {
-  DCHECK(pending_files_.empty());
+  DCHECK(pending_files_.empty() || canceled_);
+  DCHECK_EQ(0u, inflight_file_operations_);
   DCHECK(!pending_directory_stack_.empty());
 
   if (canceled_) {
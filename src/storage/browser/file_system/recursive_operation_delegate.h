@@ -124,6 +124,10 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) RecursiveOperationDelegate
   // in a derived class. By default, do nothing.
   virtual void OnCancel();
 
+  // Returns how many files of a directory may be processed concurrently. By
+  // default, files are processed one at a time.
+  virtual size_t GetMaxConcurrentFileOperations() const;
+
  private:
   void TryProcessFile(const FileSystemURL& root);
   void DidTryProcessFile(const FileSystemURL& root, base::File::Error error);
@@ -146,6 +150,8 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) RecursiveOperationDelegate
   base::stack<FileSystemURL> pending_directories_;
   base::stack<base::queue<FileSystemURL>> pending_directory_stack_;
   base::queue<FileSystemURL> pending_files_;
+  // Number of ProcessFile calls which haven't completed yet.
+  size_t inflight_file_operations_;
   bool canceled_;
   ErrorBehavior error_behavior_;
   bool failed_some_operations_;
@@ -10,6 +10,7 @@
 #include "base/callback_helpers.h"
 #include "base/containers/contains.h"
 #include "base/metrics/histogram_macros.h"
+#include "storage/browser/quota/usage_tracker.h"
 #include "third_party/blink/public/common/storage_key/storage_key.h"
 
 namespace storage {
@@ -69,14 +70,18 @@ struct ClientUsageTracker::AccumulateInfo {
 ClientUsageTracker::ClientUsageTracker(
     UsageTracker* tracker,
     mojom::QuotaClient* client,
+    QuotaClientType client_type,
     blink::mojom::StorageType type,
     scoped_refptr<SpecialStoragePolicy> special_storage_policy)
-    : client_(client),
+    : tracker_(tracker),
+      client_(client),
+      client_type_(client_type),
       type_(type),
       global_limited_usage_(0),
       global_unlimited_usage_(0),
       global_usage_retrieved_(false),
       special_storage_policy_(std::move(special_storage_policy)) {
+  DCHECK(tracker_);
   DCHECK(client_);
   if (special_storage_policy_.get())
     special_storage_policy_->AddObserver(this);
@@ -134,8 +139,10 @@ void ClientUsageTracker::UpdateUsageCache(const blink::StorageKey& storage_key,
 
     // Constrain |delta| to avoid negative usage values.
     // TODO(michaeln): crbug/463729
-    delta = std::max(delta, -cached_usage_by_host_[host][storage_key]);
-    cached_usage_by_host_[host][storage_key] += delta;
+    int64_t& usage = GetOrAddCachedStorageKeyUsage(storage_key);
+    delta = std::max(delta, -usage);
+    usage += delta;
+    tracker_->UpdateCachedStorageKeyUsage(client_type_, storage_key, delta);
     UpdateGlobalUsageValue(IsStorageUnlimited(storage_key)
                                ? &global_unlimited_usage_
                                : &global_limited_usage_,
@@ -149,16 +156,6 @@ void ClientUsageTracker::UpdateUsageCache(const blink::StorageKey& storage_key,
   GetHostUsage(host, base::DoNothing());
 }
 
-int64_t ClientUsageTracker::GetCachedUsage() const {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  int64_t usage = 0;
-  for (const auto& host_and_usage_map : cached_usage_by_host_) {
-    for (const auto& storage_key_and_usage : host_and_usage_map.second)
-      usage += storage_key_and_usage.second;
-  }
-  return usage;
-}
-
 std::map<std::string, int64_t> ClientUsageTracker::GetCachedHostsUsage() const {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   std::map<std::string, int64_t> host_usage;
@@ -169,28 +166,6 @@ std::map<std::string, int64_t> ClientUsageTracker::GetCachedHostsUsage() const {
   return host_usage;
 }
 
-std::map<blink::StorageKey, int64_t>
-ClientUsageTracker::GetCachedStorageKeysUsage() const {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  std::map<blink::StorageKey, int64_t> storage_key_usage;
-  for (const auto& host_and_usage_map : cached_usage_by_host_) {
-    for (const auto& storage_key_and_usage : host_and_usage_map.second)
-      storage_key_usage[storage_key_and_usage.first] +=
-          storage_key_and_usage.second;
-  }
-  return storage_key_usage;
-}
-
-std::set<blink::StorageKey> ClientUsageTracker::GetCachedStorageKeys() const {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  std::set<blink::StorageKey> storage_keys;
-  for (const auto& host_and_usage_map : cached_usage_by_host_) {
-    for (const auto& storage_key_and_usage : host_and_usage_map.second)
-      storage_keys.insert(storage_key_and_usage.first);
-  }
-  return storage_keys;
-}
-
 void ClientUsageTracker::SetUsageCacheEnabled(
     const blink::StorageKey& storage_key,
     bool enabled) {
@@ -206,6 +181,8 @@ void ClientUsageTracker::SetUsageCacheEnabled(
       if (storage_key_it != cached_usage_for_host.end()) {
         int64_t usage = storage_key_it->second;
         UpdateUsageCache(storage_key, -usage);
+        tracker_->RemoveCachedStorageKey(client_type_, storage_key,
+                                         storage_key_it->second);
         cached_usage_for_host.erase(storage_key_it);
         if (cached_usage_for_host.empty()) {
           cached_usage_by_host_.erase(host_it);
@@ -366,11 +343,11 @@ void ClientUsageTracker::AddCachedStorageKey(
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   DCHECK(IsUsageCacheEnabledForStorageKey(storage_key));
 
-  const std::string& host = storage_key.origin().host();
-  int64_t* usage = &cached_usage_by_host_[host][storage_key];
-  int64_t delta = new_usage - *usage;
-  *usage = new_usage;
+  int64_t& usage = GetOrAddCachedStorageKeyUsage(storage_key);
+  int64_t delta = new_usage - usage;
+  usage = new_usage;
   if (delta) {
+    tracker_->UpdateCachedStorageKeyUsage(client_type_, storage_key, delta);
     UpdateGlobalUsageValue(IsStorageUnlimited(storage_key)
                                ? &global_unlimited_usage_
                                : &global_limited_usage_,
@@ -383,6 +360,16 @@ void ClientUsageTracker::AddCachedHost(const std::string& host) {
   cached_hosts_.insert(host);
 }
 
+int64_t& ClientUsageTracker::GetOrAddCachedStorageKeyUsage(
+    const blink::StorageKey& storage_key) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  UsageMap& usage_map = cached_usage_by_host_[storage_key.origin().host()];
+  auto result = usage_map.emplace(storage_key, 0);
+  if (result.second)
+    tracker_->AddCachedStorageKey(client_type_, storage_key);
+  return result.first->second;
+}
+
 int64_t ClientUsageTracker::GetCachedHostUsage(const std::string& host) const {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   auto it = cached_usage_by_host_.find(host);
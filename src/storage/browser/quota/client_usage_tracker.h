@@ -17,6 +17,7 @@
 #include "base/sequence_checker.h"
 #include "components/services/storage/public/mojom/quota_client.mojom.h"
 #include "storage/browser/quota/quota_callbacks.h"
+#include "storage/browser/quota/quota_client_type.h"
 #include "storage/browser/quota/quota_task.h"
 #include "storage/browser/quota/special_storage_policy.h"
 #include "third_party/blink/public/mojom/quota/quota_types.mojom.h"
@@ -55,6 +56,7 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer {
   ClientUsageTracker(
       UsageTracker* tracker,
       mojom::QuotaClient* client,
+      QuotaClientType client_type,
       blink::mojom::StorageType type,
       scoped_refptr<SpecialStoragePolicy> special_storage_policy);
 
@@ -66,10 +68,7 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer {
   void GetGlobalUsage(GlobalUsageCallback callback);
   void GetHostUsage(const std::string& host, UsageCallback callback);
   void UpdateUsageCache(const blink::StorageKey& storage_key, int64_t delta);
-  int64_t GetCachedUsage() const;
   std::map<std::string, int64_t> GetCachedHostsUsage() const;
-  std::map<blink::StorageKey, int64_t> GetCachedStorageKeysUsage() const;
-  std::set<blink::StorageKey> GetCachedStorageKeys() const;
   bool IsUsageCacheEnabledForStorageKey(
       const blink::StorageKey& storage_key) const;
   void SetUsageCacheEnabled(const blink::StorageKey& storage_key, bool enabled);
@@ -105,6 +104,10 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer {
   void AddCachedStorageKey(const blink::StorageKey& storage_key, int64_t usage);
   void AddCachedHost(const std::string& host);
 
+  // Returns the cached usage of `storage_key`, adding the storage key to the
+  // cache and to the UsageTracker's ledger if it isn't cached yet.
+  int64_t& GetOrAddCachedStorageKeyUsage(const blink::StorageKey& storage_key);
+
   int64_t GetCachedHostUsage(const std::string& host) const;
   bool GetCachedStorageKeyUsage(const blink::StorageKey& storage_key,
                                 int64_t* usage) const;
@@ -120,7 +123,11 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer {
 
   bool IsStorageUnlimited(const blink::StorageKey& storage_key) const;
 
+  // Owns this instance, and keeps a ledger of the usage cached by all its
+  // ClientUsageTrackers.
+  UsageTracker* const tracker_;
   mojom::QuotaClient* client_;
+  const QuotaClientType client_type_;
   const blink::mojom::StorageType type_;
 
   int64_t global_limited_usage_;
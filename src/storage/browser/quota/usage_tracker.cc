@@ -39,7 +39,7 @@ UsageTracker::UsageTracker(
     mojom::QuotaClient* client = client_and_type.first;
     QuotaClientType client_type = client_and_type.second;
     client_tracker_map_[client_type].push_back(
-        std::make_unique<ClientUsageTracker>(this, client, type,
+        std::make_unique<ClientUsageTracker>(this, client, client_type, type,
                                              special_storage_policy));
     ++client_count;
   }
@@ -116,12 +116,14 @@ void UsageTracker::UpdateUsageCache(QuotaClientType client_type,
 
 int64_t UsageTracker::GetCachedUsage() const {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  int64_t usage = 0;
-  for (const auto& client_type_and_trackers : client_tracker_map_) {
-    for (const auto& client_tracker : client_type_and_trackers.second)
-      usage += client_tracker->GetCachedUsage();
-  }
-  return usage;
+  return cached_usage_;
+}
+
+int64_t UsageTracker::GetCachedUsageForClientType(
+    QuotaClientType client_type) const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = cached_usage_by_client_type_.find(client_type);
+  return it == cached_usage_by_client_type_.end() ? 0 : it->second;
 }
 
 std::map<std::string, int64_t> UsageTracker::GetCachedHostsUsage() const {
@@ -142,29 +144,37 @@ std::map<blink::StorageKey, int64_t> UsageTracker::GetCachedStorageKeysUsage()
     const {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   std::map<blink::StorageKey, int64_t> storage_key_usage;
-  for (const auto& client_type_and_trackers : client_tracker_map_) {
-    for (const auto& client_tracker : client_type_and_trackers.second) {
-      std::map<blink::StorageKey, int64_t> client_storage_key_usage =
-          client_tracker->GetCachedStorageKeysUsage();
-      for (const auto& storage_key_and_usage : client_storage_key_usage)
-        storage_key_usage[storage_key_and_usage.first] +=
-            storage_key_and_usage.second;
-    }
+  for (const auto& storage_key_and_usage : cached_usage_by_storage_key_) {
+    int64_t usage = 0;
+    for (const auto& client_type_and_usage : storage_key_and_usage.second)
+      usage += client_type_and_usage.second.usage;
+    storage_key_usage.emplace_hint(storage_key_usage.end(),
+                                   storage_key_and_usage.first, usage);
   }
   return storage_key_usage;
 }
 
+base::flat_map<QuotaClientType, int64_t>
+UsageTracker::GetCachedStorageKeyUsageByClientType(
+    const blink::StorageKey& storage_key) const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  base::flat_map<QuotaClientType, int64_t> client_type_usage;
+  auto it = cached_usage_by_storage_key_.find(storage_key);
+  if (it == cached_usage_by_storage_key_.end())
+    return client_type_usage;
+  for (const auto& client_type_and_usage : it->second) {
+    client_type_usage.emplace_hint(client_type_usage.end(),
+                                   client_type_and_usage.first,
+                                   client_type_and_usage.second.usage);
+  }
+  return client_type_usage;
+}
+
 std::set<blink::StorageKey> UsageTracker::GetCachedStorageKeys() const {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   std::set<blink::StorageKey> storage_keys;
-  for (const auto& client_type_and_trackers : client_tracker_map_) {
-    for (const auto& client_tracker : client_type_and_trackers.second) {
-      std::set<blink::StorageKey> client_storage_keys =
-          client_tracker->GetCachedStorageKeys();
-      for (const auto& client_storage_key : client_storage_keys)
-        storage_keys.insert(client_storage_key);
-    }
-  }
+  for (const auto& storage_key_and_usage : cached_usage_by_storage_key_)
+    storage_keys.insert(storage_keys.end(), storage_key_and_usage.first);
   return storage_keys;
 }
 
@@ -265,4 +275,43 @@ void UsageTracker::FinallySendHostUsageWithBreakdown(AccumulateInfo* info,
   }
 }
 
+void UsageTracker::AddCachedStorageKey(QuotaClientType client_type,
+                                       const blink::StorageKey& storage_key) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  ++cached_usage_by_storage_key_[storage_key][client_type].client_count;
+}
+
+void UsageTracker::UpdateCachedStorageKeyUsage(
+    QuotaClientType client_type,
+    const blink::StorageKey& storage_key,
+    int64_t delta) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = cached_usage_by_storage_key_.find(storage_key);
+  DCHECK(it != cached_usage_by_storage_key_.end());
+  auto client_type_it = it->second.find(client_type);
+  DCHECK(client_type_it != it->second.end());
+  client_type_it->second.usage += delta;
+  cached_usage_by_client_type_[client_type] += delta;
+  cached_usage_ += delta;
+}
+
+void UsageTracker::RemoveCachedStorageKey(QuotaClientType client_type,
+                                          const blink::StorageKey& storage_key,
+                                          int64_t usage) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = cached_usage_by_storage_key_.find(storage_key);
+  DCHECK(it != cached_usage_by_storage_key_.end());
+  auto client_type_it = it->second.find(client_type);
+  DCHECK(client_type_it != it->second.end());
+  DCHECK_GT(client_type_it->second.client_count, 0u);
+  client_type_it->second.usage -= usage;
+  cached_usage_by_client_type_[client_type] -= usage;
+  cached_usage_ -= usage;
+  if (--client_type_it->second.client_count > 0)
+    return;
+  it->second.erase(client_type_it);
+  if (it->second.empty())
+    cached_usage_by_storage_key_.erase(it);
+}
+
 }  // namespace storage
@@ -66,8 +66,11 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) UsageTracker
                         const blink::StorageKey& storage_key,
                         int64_t delta);
   int64_t GetCachedUsage() const;
+  int64_t GetCachedUsageForClientType(QuotaClientType client_type) const;
   std::map<std::string, int64_t> GetCachedHostsUsage() const;
   std::map<blink::StorageKey, int64_t> GetCachedStorageKeysUsage() const;
+  base::flat_map<QuotaClientType, int64_t> GetCachedStorageKeyUsageByClientType(
+      const blink::StorageKey& storage_key) const;
   std::set<blink::StorageKey> GetCachedStorageKeys() const;
   bool IsWorking() const {
     DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
@@ -82,6 +85,14 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) UsageTracker
   struct AccumulateInfo;
   friend class ClientUsageTracker;
 
+  // Usage of a storage key by the clients of one type, in the ledger below.
+  struct CachedUsage {
+    int64_t usage = 0;
+    // Number of ClientUsageTrackers of the type caching the usage of the
+    // storage key.
+    size_t client_count = 0;
+  };
+
   void AccumulateClientGlobalUsage(AccumulateInfo* info,
                                    int64_t usage,
                                    int64_t unlimited_usage);
@@ -93,12 +104,32 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) UsageTracker
   void FinallySendHostUsageWithBreakdown(AccumulateInfo* info,
                                          const std::string& host);
 
+  // Called by the ClientUsageTrackers to keep the ledger up to date.
+  void AddCachedStorageKey(QuotaClientType client_type,
+                           const blink::StorageKey& storage_key);
+  void UpdateCachedStorageKeyUsage(QuotaClientType client_type,
+                                   const blink::StorageKey& storage_key,
+                                   int64_t delta);
+  // `usage` is the usage the client had cached for `storage_key`.
+  void RemoveCachedStorageKey(QuotaClientType client_type,
+                              const blink::StorageKey& storage_key,
+                              int64_t usage);
+
   const blink::mojom::StorageType type_;
   base::flat_map<QuotaClientType,
                  std::vector<std::unique_ptr<ClientUsageTracker>>>
       client_tracker_map_;
   size_t client_count_;
 
+  // Ledger of the usage cached by the ClientUsageTrackers, per storage key
+  // and client type, with running totals. It is updated incrementally as usage
+  // is cached and modified, so that queries for the cached usage don't walk
+  // every client's cache.
+  std::map<blink::StorageKey, base::flat_map<QuotaClientType, CachedUsage>>
+      cached_usage_by_storage_key_;
+  base::flat_map<QuotaClientType, int64_t> cached_usage_by_client_type_;
+  int64_t cached_usage_ = 0;
+
   std::vector<GlobalUsageCallback> global_usage_callbacks_;
   std::map<std::string, std::vector<UsageWithBreakdownCallback>>
       host_usage_callbacks_;
@@ -0,0 +1,146 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/containers/flat_map.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/run_loop.h"
+#include "base/stl_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "storage/browser/quota/quota_client_type.h"
+#include "storage/browser/quota/usage_tracker.h"
+#include "storage/browser/test/mock_quota_client.h"
+#include "storage/browser/test/mock_special_storage_policy.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/blink/public/common/storage_key/storage_key.h"
+
+using ::blink::StorageKey;
+using ::blink::mojom::StorageType;
+
+namespace storage {
+namespace {
+
+// Number of queries or modifications timed by each benchmark.
+constexpr int kIterations = 1000;
+
+constexpr QuotaClientType kClientTypes[] = {
+    QuotaClientType::kFileSystem, QuotaClientType::kIndexedDatabase,
+    QuotaClientType::kServiceWorkerCache};
+
+struct UsageTrackerPerfTestParam {
+  const char* story;
+  int storage_key_count;
+  // Number of clients storing data for every storage key.
+  size_t client_count;
+};
+
+class UsageTrackerPerfTest
+    : public testing::TestWithParam<UsageTrackerPerfTestParam> {
+ public:
+  void SetUp() override {
+    std::vector<std::string> origins;
+    for (int i = 0; i < GetParam().storage_key_count; ++i)
+      origins.push_back(base::StringPrintf("https://host%d.example.com", i));
+    std::vector<MockStorageKeyData> mock_data;
+    for (int i = 0; i < GetParam().storage_key_count; ++i) {
+      mock_data.push_back(
+          {origins[i].c_str(), StorageType::kTemporary, 1024 * (i % 100 + 1)});
+      storage_keys_.push_back(
+          StorageKey::CreateFromStringForTesting(origins[i]));
+    }
+
+    base::flat_map<mojom::QuotaClient*, QuotaClientType> client_types;
+    ASSERT_LE(GetParam().client_count, base::size(kClientTypes));
+    for (size_t i = 0; i < GetParam().client_count; ++i) {
+      clients_.push_back(std::make_unique<MockQuotaClient>(
+          /*quota_manager_proxy=*/nullptr, mock_data, kClientTypes[i]));
+      client_types[clients_.back().get()] = kClientTypes[i];
+    }
+    usage_tracker_ = std::make_unique<UsageTracker>(
+        client_types, StorageType::kTemporary,
+        base::MakeRefCounted<MockSpecialStoragePolicy>());
+
+    // Fill the usage cache, like the quota manager does on startup.
+    base::RunLoop run_loop;
+    usage_tracker_->GetGlobalUsage(base::BindOnce(
+        [](base::OnceClosure quit, int64_t usage, int64_t unlimited_usage) {
+          std::move(quit).Run();
+        },
+        run_loop.QuitClosure()));
+    run_loop.Run();
+  }
+
+ protected:
+  void ReportResult(const char* metric, base::TimeDelta total_time) {
+    perf_test::PerfResultReporter reporter("usage_tracker", GetParam().story);
+    reporter.RegisterImportantMetric(metric, "us");
+    reporter.AddResult(metric, total_time.InMicrosecondsF() / kIterations);
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  std::vector<StorageKey> storage_keys_;
+  std::vector<std::unique_ptr<MockQuotaClient>> clients_;
+  std::unique_ptr<UsageTracker> usage_tracker_;
+};
+
+// Queries the total cached usage, like an eviction round does when there is
+// no storage pressure.
+TEST_P(UsageTrackerPerfTest, GetCachedUsage) {
+  int64_t usage = 0;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i)
+    usage += usage_tracker_->GetCachedUsage();
+  ReportResult("_get_cached_usage", base::TimeTicks::Now() - start);
+  EXPECT_GT(usage, 0);
+}
+
+// Notifies storage modifications, like NotifyStorageModified() does, each
+// followed by a query of the total cached usage.
+TEST_P(UsageTrackerPerfTest, UpdateUsageCache) {
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    usage_tracker_->UpdateUsageCache(
+        kClientTypes[i % GetParam().client_count],
+        storage_keys_[i % storage_keys_.size()], i % 2 ? 512 : -512);
+    usage_tracker_->GetCachedUsage();
+  }
+  ReportResult("_update_usage_cache", base::TimeTicks::Now() - start);
+}
+
+// Collects the usage of every storage key, like the quota manager does for
+// its eviction histograms.
+TEST_P(UsageTrackerPerfTest, GetCachedStorageKeysUsage) {
+  size_t storage_key_count = 0;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i)
+    storage_key_count += usage_tracker_->GetCachedStorageKeysUsage().size();
+  ReportResult("_get_cached_storage_keys_usage",
+               base::TimeTicks::Now() - start);
+  EXPECT_EQ(storage_keys_.size() * kIterations, storage_key_count);
+}
+
+const UsageTrackerPerfTestParam kPerfTestParams[] = {
+    {"1k_storage_keys_1_client", 1000, 1},
+    {"10k_storage_keys_1_client", 10000, 1},
+    {"10k_storage_keys_3_clients", 10000, 3},
+};
+
+INSTANTIATE_TEST_SUITE_P(All,
+                         UsageTrackerPerfTest,
+                         testing::ValuesIn(kPerfTestParams));
+
+}  // namespace
+}  // namespace storage
@@ -4,10 +4,13 @@
 
 #include <stdint.h>
 
+#include <map>
+#include <set>
 #include <utility>
 #include <vector>
 
 #include "base/bind.h"
+#include "base/containers/flat_map.h"
 #include "base/location.h"
 #include "base/macros.h"
 #include "base/memory/scoped_refptr.h"
@@ -317,6 +320,114 @@ TEST_F(UsageTrackerTest, CacheDisabledClientTest) {
   EXPECT_EQ(host_usage_breakdown_expected, host_usage_breakdown.second);
 }
 
+TEST_F(UsageTrackerTest, CachedUsageLedger) {
+  const StorageKey kStorageKey1 =
+      StorageKey::CreateFromStringForTesting("http://example.com");
+  const StorageKey kStorageKey2 =
+      StorageKey::CreateFromStringForTesting("http://example.com:8080");
+  const StorageKey kStorageKey3 =
+      StorageKey::CreateFromStringForTesting("http://other.com");
+
+  int64_t usage = 0;
+  int64_t unlimited_usage = 0;
+  UpdateUsageWithoutNotification(kStorageKey1, 100);
+  UpdateUsageWithoutNotification(kStorageKey2, 200);
+  UpdateUsageWithoutNotification(kStorageKey3, 300);
+  GetGlobalUsage(&usage, &unlimited_usage);
+  EXPECT_EQ(600, usage);
+  EXPECT_EQ(600, usage_tracker()->GetCachedUsage());
+  std::map<StorageKey, int64_t> expected_usage = {
+      {kStorageKey1, 100}, {kStorageKey2, 200}, {kStorageKey3, 300}};
+  EXPECT_EQ(expected_usage, usage_tracker()->GetCachedStorageKeysUsage());
+
+  // Notified modifications update the ledger without querying the client.
+  UpdateUsage(kStorageKey1, 50);
+  UpdateUsage(kStorageKey3, -100);
+  EXPECT_EQ(550, usage_tracker()->GetCachedUsage());
+  expected_usage = {
+      {kStorageKey1, 150}, {kStorageKey2, 200}, {kStorageKey3, 200}};
+  EXPECT_EQ(expected_usage, usage_tracker()->GetCachedStorageKeysUsage());
+
+  // Storage keys whose usage isn't cached leave the ledger.
+  SetUsageCacheEnabled(kStorageKey2, false);
+  EXPECT_EQ(350, usage_tracker()->GetCachedUsage());
+  EXPECT_EQ(std::set<StorageKey>({kStorageKey1, kStorageKey3}),
+            usage_tracker()->GetCachedStorageKeys());
+
+  // And are added back once cached again.
+  SetUsageCacheEnabled(kStorageKey2, true);
+  GetGlobalUsage(&usage, &unlimited_usage);
+  EXPECT_EQ(550, usage);
+  EXPECT_EQ(550, usage_tracker()->GetCachedUsage());
+  EXPECT_EQ(std::set<StorageKey>({kStorageKey1, kStorageKey2, kStorageKey3}),
+            usage_tracker()->GetCachedStorageKeys());
+}
+
+TEST_F(UsageTrackerTest, CachedUsageLedgerByClientType) {
+  const StorageKey kStorageKey1 =
+      StorageKey::CreateFromStringForTesting("http://example.com");
+  const StorageKey kStorageKey2 =
+      StorageKey::CreateFromStringForTesting("http://other.com");
+
+  UsageTrackerTestQuotaClient file_system_client;
+  UsageTrackerTestQuotaClient indexed_db_client;
+  base::flat_map<mojom::QuotaClient*, QuotaClientType> client_types = {
+      {&file_system_client, QuotaClientType::kFileSystem},
+      {&indexed_db_client, QuotaClientType::kIndexedDatabase}};
+  UsageTracker usage_tracker(client_types, StorageType::kTemporary,
+                             base::MakeRefCounted<MockSpecialStoragePolicy>());
+
+  file_system_client.SetUsage(kStorageKey1, 100);
+  indexed_db_client.SetUsage(kStorageKey1, 20);
+  indexed_db_client.SetUsage(kStorageKey2, 300);
+  bool done = false;
+  int64_t usage = 0;
+  int64_t unlimited_usage = 0;
+  usage_tracker.GetGlobalUsage(
+      base::BindOnce(&DidGetGlobalUsage, &done, &usage, &unlimited_usage));
+  base::RunLoop().RunUntilIdle();
+  ASSERT_TRUE(done);
+  EXPECT_EQ(420, usage);
+  EXPECT_EQ(420, usage_tracker.GetCachedUsage());
+  EXPECT_EQ(100, usage_tracker.GetCachedUsageForClientType(
+                     QuotaClientType::kFileSystem));
+  EXPECT_EQ(320, usage_tracker.GetCachedUsageForClientType(
+                     QuotaClientType::kIndexedDatabase));
+  EXPECT_EQ(0, usage_tracker.GetCachedUsageForClientType(
+                   QuotaClientType::kServiceWorkerCache));
+  base::flat_map<QuotaClientType, int64_t> expected_usage = {
+      {QuotaClientType::kFileSystem, 100},
+      {QuotaClientType::kIndexedDatabase, 20}};
+  EXPECT_EQ(expected_usage,
+            usage_tracker.GetCachedStorageKeyUsageByClientType(kStorageKey1));
+
+  // Notified modifications are accounted to the type of the client.
+  indexed_db_client.UpdateUsage(kStorageKey1, 30);
+  usage_tracker.UpdateUsageCache(QuotaClientType::kIndexedDatabase,
+                                 kStorageKey1, 30);
+  EXPECT_EQ(450, usage_tracker.GetCachedUsage());
+  EXPECT_EQ(100, usage_tracker.GetCachedUsageForClientType(
+                     QuotaClientType::kFileSystem));
+  EXPECT_EQ(350, usage_tracker.GetCachedUsageForClientType(
+                     QuotaClientType::kIndexedDatabase));
+  expected_usage = {{QuotaClientType::kFileSystem, 100},
+                    {QuotaClientType::kIndexedDatabase, 50}};
+  EXPECT_EQ(expected_usage,
+            usage_tracker.GetCachedStorageKeyUsageByClientType(kStorageKey1));
+
+  // Disabling the cache of one client type only removes its usage.
+  usage_tracker.SetUsageCacheEnabled(QuotaClientType::kFileSystem,
+                                     kStorageKey1, false);
+  EXPECT_EQ(350, usage_tracker.GetCachedUsage());
+  EXPECT_EQ(0, usage_tracker.GetCachedUsageForClientType(
+                   QuotaClientType::kFileSystem));
+  expected_usage = {{QuotaClientType::kIndexedDatabase, 50}};
+  EXPECT_EQ(expected_usage,
+            usage_tracker.GetCachedStorageKeyUsageByClientType(kStorageKey1));
+  EXPECT_EQ(std::set<StorageKey>({kStorageKey1, kStorageKey2}),
+            usage_tracker.GetCachedStorageKeys());
+}
+
 TEST_F(UsageTrackerTest, GlobalUsageUnlimitedUncached) {
   const StorageKey kNormal =
       StorageKey::CreateFromStringForTesting("http://normal");